@@ -29,6 +29,7 @@
 #include "cyber/component/component_base.h"
 #include "cyber/croutine/routine_factory.h"
 #include "cyber/data/data_visitor.h"
+#include "cyber/data/pending_queue_registry.h"
 #include "cyber/scheduler/scheduler.h"
 
 namespace apollo {
@@ -144,12 +145,14 @@ bool Component<M0, NullType, NullType, NullType>::Process(
   if (is_shutdown_.load()) {
     return true;
   }
+  profiler::ProcessScope scope(proc_block_, latency_block_);
   return Proc(msg);
 }
 
 inline bool Component<NullType, NullType, NullType>::Initialize(
     const ComponentConfig& config) {
   node_.reset(new Node(config.name()));
+  RegisterProfilerBlocks();
   LoadConfigFiles(config);
   if (!Init()) {
     AERROR << "Component Init() failed." << std::endl;
@@ -162,6 +165,7 @@ template <typename M0>
 bool Component<M0, NullType, NullType, NullType>::Initialize(
     const ComponentConfig& config) {
   node_.reset(new Node(config.name()));
+  RegisterProfilerBlocks();
   LoadConfigFiles(config);
 
   if (config.readers_size() < 1) {
@@ -180,6 +184,9 @@ bool Component<M0, NullType, NullType, NullType>::Initialize(
   reader_cfg.channel_name = config.readers(0).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(0).qos_profile());
   reader_cfg.pending_queue_size = config.readers(0).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(0).allocator_conf());
+  reader_cfg.pending_queue_conf.CopyFrom(
+      config.readers(0).pending_queue_conf());
 
   std::weak_ptr<Component<M0>> self =
       std::dynamic_pointer_cast<Component<M0>>(shared_from_this());
@@ -211,8 +218,11 @@ bool Component<M0, NullType, NullType, NullType>::Initialize(
   }
 
   data::VisitorConfig conf = {readers_[0]->ChannelId(),
-                              readers_[0]->PendingQueueSize()};
+                              readers_[0]->PendingQueueSize(),
+                              config.readers(0).pending_queue_conf()};
   auto dv = std::make_shared<data::DataVisitor<M0>>(conf);
+  data::PendingQueueRegistry::Instance()->Register(
+      config.readers(0).channel(), node_->Name(), dv->QueueStats());
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<M0>(func, dv);
   auto sched = scheduler::Instance();
@@ -225,6 +235,7 @@ bool Component<M0, M1, NullType, NullType>::Process(
   if (is_shutdown_.load()) {
     return true;
   }
+  profiler::ProcessScope scope(proc_block_, latency_block_);
   return Proc(msg0, msg1);
 }
 
@@ -232,6 +243,7 @@ template <typename M0, typename M1>
 bool Component<M0, M1, NullType, NullType>::Initialize(
     const ComponentConfig& config) {
   node_.reset(new Node(config.name()));
+  RegisterProfilerBlocks();
   LoadConfigFiles(config);
 
   if (config.readers_size() < 2) {
@@ -250,12 +262,14 @@ bool Component<M0, M1, NullType, NullType>::Initialize(
   reader_cfg.channel_name = config.readers(1).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(1).qos_profile());
   reader_cfg.pending_queue_size = config.readers(1).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(1).allocator_conf());
 
   auto reader1 = node_->template CreateReader<M1>(reader_cfg);
 
   reader_cfg.channel_name = config.readers(0).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(0).qos_profile());
   reader_cfg.pending_queue_size = config.readers(0).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(0).allocator_conf());
 
   std::shared_ptr<Reader<M0>> reader0 = nullptr;
   if (cyber_likely(is_reality_mode)) {
@@ -309,7 +323,8 @@ bool Component<M0, M1, NullType, NullType>::Initialize(
   for (auto& reader : readers_) {
     config_list.emplace_back(reader->ChannelId(), reader->PendingQueueSize());
   }
-  auto dv = std::make_shared<data::DataVisitor<M0, M1>>(config_list);
+  auto dv = std::make_shared<data::DataVisitor<M0, M1>>(config_list,
+                                                        config.fusion());
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<M0, M1>(func, dv);
   return sched->CreateTask(factory, node_->Name());
@@ -322,6 +337,7 @@ bool Component<M0, M1, M2, NullType>::Process(const std::shared_ptr<M0>& msg0,
   if (is_shutdown_.load()) {
     return true;
   }
+  profiler::ProcessScope scope(proc_block_, latency_block_);
   return Proc(msg0, msg1, msg2);
 }
 
@@ -329,6 +345,7 @@ template <typename M0, typename M1, typename M2>
 bool Component<M0, M1, M2, NullType>::Initialize(
     const ComponentConfig& config) {
   node_.reset(new Node(config.name()));
+  RegisterProfilerBlocks();
   LoadConfigFiles(config);
 
   if (config.readers_size() < 3) {
@@ -347,18 +364,21 @@ bool Component<M0, M1, M2, NullType>::Initialize(
   reader_cfg.channel_name = config.readers(1).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(1).qos_profile());
   reader_cfg.pending_queue_size = config.readers(1).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(1).allocator_conf());
 
   auto reader1 = node_->template CreateReader<M1>(reader_cfg);
 
   reader_cfg.channel_name = config.readers(2).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(2).qos_profile());
   reader_cfg.pending_queue_size = config.readers(2).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(2).allocator_conf());
 
   auto reader2 = node_->template CreateReader<M2>(reader_cfg);
 
   reader_cfg.channel_name = config.readers(0).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(0).qos_profile());
   reader_cfg.pending_queue_size = config.readers(0).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(0).allocator_conf());
   std::shared_ptr<Reader<M0>> reader0 = nullptr;
   if (cyber_likely(is_reality_mode)) {
     reader0 = node_->template CreateReader<M0>(reader_cfg);
@@ -419,7 +439,8 @@ bool Component<M0, M1, M2, NullType>::Initialize(
   for (auto& reader : readers_) {
     config_list.emplace_back(reader->ChannelId(), reader->PendingQueueSize());
   }
-  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2>>(config_list);
+  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2>>(config_list,
+                                                            config.fusion());
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<M0, M1, M2>(func, dv);
   return sched->CreateTask(factory, node_->Name());
@@ -433,12 +454,14 @@ bool Component<M0, M1, M2, M3>::Process(const std::shared_ptr<M0>& msg0,
   if (is_shutdown_.load()) {
     return true;
   }
+  profiler::ProcessScope scope(proc_block_, latency_block_);
   return Proc(msg0, msg1, msg2, msg3);
 }
 
 template <typename M0, typename M1, typename M2, typename M3>
 bool Component<M0, M1, M2, M3>::Initialize(const ComponentConfig& config) {
   node_.reset(new Node(config.name()));
+  RegisterProfilerBlocks();
   LoadConfigFiles(config);
 
   if (config.readers_size() < 4) {
@@ -457,24 +480,28 @@ bool Component<M0, M1, M2, M3>::Initialize(const ComponentConfig& config) {
   reader_cfg.channel_name = config.readers(1).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(1).qos_profile());
   reader_cfg.pending_queue_size = config.readers(1).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(1).allocator_conf());
 
   auto reader1 = node_->template CreateReader<M1>(reader_cfg);
 
   reader_cfg.channel_name = config.readers(2).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(2).qos_profile());
   reader_cfg.pending_queue_size = config.readers(2).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(2).allocator_conf());
 
   auto reader2 = node_->template CreateReader<M2>(reader_cfg);
 
   reader_cfg.channel_name = config.readers(3).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(3).qos_profile());
   reader_cfg.pending_queue_size = config.readers(3).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(3).allocator_conf());
 
   auto reader3 = node_->template CreateReader<M3>(reader_cfg);
 
   reader_cfg.channel_name = config.readers(0).channel();
   reader_cfg.qos_profile.CopyFrom(config.readers(0).qos_profile());
   reader_cfg.pending_queue_size = config.readers(0).pending_queue_size();
+  reader_cfg.allocator_conf.CopyFrom(config.readers(0).allocator_conf());
 
   std::shared_ptr<Reader<M0>> reader0 = nullptr;
   if (cyber_likely(is_reality_mode)) {
@@ -542,7 +569,8 @@ bool Component<M0, M1, M2, M3>::Initialize(const ComponentConfig& config) {
   for (auto& reader : readers_) {
     config_list.emplace_back(reader->ChannelId(), reader->PendingQueueSize());
   }
-  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2, M3>>(config_list);
+  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2, M3>>(
+      config_list, config.fusion());
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<M0, M1, M2, M3>(func, dv);
   return sched->CreateTask(factory, node_->Name());
@@ -30,6 +30,7 @@
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/node/node.h"
+#include "cyber/profiler/trace_collector.h"
 #include "cyber/scheduler/scheduler.h"
 
 namespace apollo {
@@ -64,6 +65,25 @@ class ComponentBase : public std::enable_shared_from_this<ComponentBase> {
     return common::GetProtoFromFile(config_file_path_, config);
   }
 
+  /**
+   * @brief Apply a gflags flag file, found through APOLLO_FLAG_PATH. Flags
+   * are process wide, so mainboard applies the flag files of all components
+   * one by one before it initializes components concurrently.
+   */
+  static void LoadFlagFile(const std::string& flag_file) {
+    if (flag_file.empty()) {
+      return;
+    }
+    std::string flag_file_path = flag_file;
+    if (!common::GetFilePathWithEnv(flag_file, "APOLLO_FLAG_PATH",
+                                    &flag_file_path)) {
+      AERROR << "flag file [" << flag_file << "] not found!";
+    } else {
+      AINFO << "use flag file: " << flag_file_path;
+    }
+    google::SetCommandLineOption("flagfile", flag_file_path.c_str());
+  }
+
  protected:
   virtual bool Init() = 0;
   virtual void Clear() { return; }
@@ -80,16 +100,7 @@ class ComponentBase : public std::enable_shared_from_this<ComponentBase> {
       }
     }
 
-    if (!config.flag_file_path().empty()) {
-      std::string flag_file_path = config.flag_file_path();
-      if (!common::GetFilePathWithEnv(config.flag_file_path(),
-                                      "APOLLO_FLAG_PATH", &flag_file_path)) {
-        AERROR << "flag file [" << config.flag_file_path() << "] not found!";
-      } else {
-        AINFO << "use flag file: " << flag_file_path;
-      }
-      google::SetCommandLineOption("flagfile", flag_file_path.c_str());
-    }
+    LoadFlagFile(config.flag_file_path());
   }
 
   void LoadConfigFiles(const TimerComponentConfig& config) {
@@ -103,22 +114,24 @@ class ComponentBase : public std::enable_shared_from_this<ComponentBase> {
       }
     }
 
-    if (!config.flag_file_path().empty()) {
-      std::string flag_file_path = config.flag_file_path();
-      if (!common::GetFilePathWithEnv(config.flag_file_path(),
-                                      "APOLLO_FLAG_PATH", &flag_file_path)) {
-        AERROR << "flag file [" << config.flag_file_path() << "] not found!";
-      } else {
-        AINFO << "use flag file: " << flag_file_path;
-      }
-      google::SetCommandLineOption("flagfile", flag_file_path.c_str());
-    }
+    LoadFlagFile(config.flag_file_path());
+  }
+
+  // Proc() time and the time from the data notification to the end of
+  // Proc(), reported as component/<node name>/proc and .../latency
+  void RegisterProfilerBlocks() {
+    auto collector = profiler::TraceCollector::Instance();
+    const std::string prefix = "component/" + node_->Name();
+    proc_block_ = collector->Register(prefix + "/proc");
+    latency_block_ = collector->Register(prefix + "/latency");
   }
 
   std::atomic<bool> is_shutdown_ = {false};
   std::shared_ptr<Node> node_ = nullptr;
   std::string config_file_path_ = "";
   std::vector<std::shared_ptr<ReaderBase>> readers_;
+  profiler::BlockStats* proc_block_ = nullptr;
+  profiler::BlockStats* latency_block_ = nullptr;
 };
 
 }  // namespace cyber
@@ -29,6 +29,7 @@ bool TimerComponent::Process() {
   if (is_shutdown_.load()) {
     return true;
   }
+  profiler::ProcessScope scope(proc_block_, latency_block_);
   return Proc();
 }
 
@@ -38,6 +39,7 @@ bool TimerComponent::Initialize(const TimerComponentConfig& config) {
     return false;
   }
   node_.reset(new Node(config.name()));
+  RegisterProfilerBlocks();
   LoadConfigFiles(config);
   if (!Init()) {
     return false;
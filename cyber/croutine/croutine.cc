@@ -30,6 +30,8 @@ namespace croutine {
 
 thread_local CRoutine *CRoutine::current_routine_ = nullptr;
 thread_local char *CRoutine::main_stack_ = nullptr;
+std::atomic<bool> CRoutine::notify_time_enabled_ = {false};
+std::atomic<bool> CRoutine::ready_time_enabled_ = {false};
 
 namespace {
 std::shared_ptr<base::CCObjectPool<RoutineContext>> context_pool = nullptr;
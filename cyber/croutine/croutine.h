@@ -37,6 +37,35 @@ using Duration = std::chrono::microseconds;
 
 enum class RoutineState { READY, FINISHED, SLEEP, IO_WAIT, DATA_WAIT };
 
+// Run time accounting of a routine. Only the processor running the routine
+// writes it, SysMo reads it and takes the maxima.
+struct RoutineStats {
+  std::atomic<uint64_t> runs = {0};
+  std::atomic<uint64_t> cpu_ns = {0};
+  std::atomic<uint64_t> wall_ns = {0};
+  std::atomic<uint64_t> wait_ns = {0};
+  std::atomic<uint64_t> max_run_ns = {0};
+  std::atomic<uint64_t> max_wait_ns = {0};
+
+  void AddRun(uint64_t cpu, uint64_t wall, uint64_t wait) {
+    Add(&runs, 1);
+    Add(&cpu_ns, cpu);
+    Add(&wall_ns, wall);
+    Add(&wait_ns, wait);
+    if (wall > max_run_ns.load(std::memory_order_relaxed)) {
+      max_run_ns.store(wall, std::memory_order_relaxed);
+    }
+    if (wait > max_wait_ns.load(std::memory_order_relaxed)) {
+      max_wait_ns.store(wait, std::memory_order_relaxed);
+    }
+  }
+
+  static void Add(std::atomic<uint64_t> *counter, uint64_t value) {
+    counter->store(counter->load(std::memory_order_relaxed) + value,
+                   std::memory_order_relaxed);
+  }
+};
+
 class CRoutine {
  public:
   explicit CRoutine(const RoutineFunc &func);
@@ -49,6 +78,18 @@ class CRoutine {
   static CRoutine *GetCurrentRoutine();
   static char **GetMainStack();
 
+  // whether SetUpdateFlag() keeps the time for TakeNotifyTime(), only the
+  // profiler needs it
+  static void EnableNotifyTime(bool enable) {
+    notify_time_enabled_.store(enable, std::memory_order_relaxed);
+  }
+
+  // whether the routine keeps the time for TakeReadyTime(), only the
+  // routine stats of the processors need it
+  static void EnableReadyTime(bool enable) {
+    ready_time_enabled_.store(enable, std::memory_order_relaxed);
+  }
+
   // public interfaces
   bool Acquire();
   void Release();
@@ -57,6 +98,14 @@ class CRoutine {
   // SetUpdateFlag().
   void SetUpdateFlag();
 
+  // steady clock time in ns of the first SetUpdateFlag() since the last
+  // call, 0 if there was none or EnableNotifyTime() is off
+  uint64_t TakeNotifyTime();
+
+  // steady clock time in ns the routine became ready at since the last
+  // call, 0 if unknown or EnableReadyTime() is off
+  uint64_t TakeReadyTime();
+
   // acquire && release should be called before Resume
   // when work-steal like mechanism used
   RoutineState Resume();
@@ -94,6 +143,12 @@ class CRoutine {
 
   const std::string &group_name() { return group_name_; }
 
+  // innermost open profiler block of the routine, it moves with the routine
+  // between processors
+  void **profiler_block() { return &profiler_block_; }
+
+  RoutineStats *stats() { return &stats_; }
+
  private:
   CRoutine(CRoutine &) = delete;
   CRoutine &operator=(CRoutine &) = delete;
@@ -118,8 +173,15 @@ class CRoutine {
 
   std::string group_name_;
 
+  std::atomic<uint64_t> notify_time_ns_ = {0};
+  std::atomic<uint64_t> ready_time_ns_ = {0};
+  void *profiler_block_ = nullptr;
+  RoutineStats stats_;
+
   static thread_local CRoutine *current_routine_;
   static thread_local char *main_stack_;
+  static std::atomic<bool> notify_time_enabled_;
+  static std::atomic<bool> ready_time_enabled_;
 };
 
 inline void CRoutine::Yield(const RoutineState &state) {
@@ -178,6 +240,13 @@ inline RoutineState CRoutine::UpdateState() {
   if (state_ == RoutineState::SLEEP &&
       std::chrono::steady_clock::now() > wake_time_) {
     state_ = RoutineState::READY;
+    if (ready_time_enabled_.load(std::memory_order_relaxed)) {
+      ready_time_ns_.store(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              wake_time_.time_since_epoch())
+              .count(),
+          std::memory_order_relaxed);
+    }
     return state_;
   }
 
@@ -203,9 +272,39 @@ inline void CRoutine::Release() {
 }
 
 inline void CRoutine::SetUpdateFlag() {
+  const bool stamp_notify =
+      notify_time_enabled_.load(std::memory_order_relaxed) &&
+      notify_time_ns_.load(std::memory_order_relaxed) == 0;
+  const bool stamp_ready =
+      ready_time_enabled_.load(std::memory_order_relaxed) &&
+      ready_time_ns_.load(std::memory_order_relaxed) == 0;
+  if (stamp_notify || stamp_ready) {
+    const uint64_t now =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    uint64_t expected = 0;
+    if (stamp_notify) {
+      notify_time_ns_.compare_exchange_strong(expected, now,
+                                              std::memory_order_relaxed);
+    }
+    expected = 0;
+    if (stamp_ready) {
+      ready_time_ns_.compare_exchange_strong(expected, now,
+                                             std::memory_order_relaxed);
+    }
+  }
   updated_.clear(std::memory_order_release);
 }
 
+inline uint64_t CRoutine::TakeNotifyTime() {
+  return notify_time_ns_.exchange(0, std::memory_order_relaxed);
+}
+
+inline uint64_t CRoutine::TakeReadyTime() {
+  return ready_time_ns_.exchange(0, std::memory_order_relaxed);
+}
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
@@ -17,15 +17,43 @@
 #ifndef CYBER_DATA_CACHE_BUFFER_H_
 #define CYBER_DATA_CACHE_BUFFER_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <vector>
 
+#include "cyber/proto/pending_queue_conf.pb.h"
+
 namespace apollo {
 namespace cyber {
 namespace data {
 
+using apollo::cyber::proto::PendingQueueConf;
+
+/**
+ * @brief Counters of a pending queue, updated under the lock of the queue
+ * and read by monitors from any thread without taking it.
+ */
+struct PendingQueueStats {
+  PendingQueueConf::Policy policy = PendingQueueConf::KEEP_LAST;
+  uint64_t capacity = 0;
+  std::atomic<uint64_t> enqueued = {0};
+  // overwritten before the reader took them
+  std::atomic<uint64_t> dropped = {0};
+  // CONFLATE: skipped for a newer message
+  std::atomic<uint64_t> conflated = {0};
+  // SAMPLE: not queued at all
+  std::atomic<uint64_t> sampled_out = {0};
+  std::atomic<uint64_t> block_timeouts = {0};
+  std::atomic<uint64_t> blocked_ns = {0};
+  std::atomic<uint64_t> depth = {0};
+  std::atomic<uint64_t> max_depth = {0};
+};
+
 template <typename T>
 class CacheBuffer {
  public:
@@ -36,15 +64,19 @@ class CacheBuffer {
   explicit CacheBuffer(uint64_t size) {
     capacity_ = size + 1;
     buffer_.resize(capacity_);
+    stats_->capacity = size;
   }
 
   CacheBuffer(const CacheBuffer& rhs) {
     std::lock_guard<std::mutex> lg(rhs.mutex_);
     head_ = rhs.head_;
     tail_ = rhs.tail_;
+    read_ = rhs.read_;
     buffer_ = rhs.buffer_;
     capacity_ = rhs.capacity_;
     fusion_callback_ = rhs.fusion_callback_;
+    queue_conf_ = rhs.queue_conf_;
+    stats_ = rhs.stats_;
   }
 
   T& operator[](const uint64_t& pos) { return buffer_[GetIndex(pos)]; }
@@ -65,10 +97,32 @@ class CacheBuffer {
     fusion_callback_ = callback;
   }
 
+  /**
+   * @brief Set how the buffer overflows, before anything is filled in.
+   * CONFLATE keeps only the newest message.
+   */
+  void SetQueueConf(const PendingQueueConf& conf) {
+    std::lock_guard<std::mutex> lg(mutex_);
+    queue_conf_ = conf;
+    stats_->policy = conf.policy();
+    if (conf.policy() == PendingQueueConf::CONFLATE && Empty()) {
+      capacity_ = 2;
+      buffer_.resize(capacity_);
+      stats_->capacity = 1;
+    }
+  }
+  const PendingQueueConf& QueueConf() const { return queue_conf_; }
+  const std::shared_ptr<PendingQueueStats>& Stats() const { return stats_; }
+
   void Fill(const T& value) {
     if (fusion_callback_) {
       fusion_callback_(value);
     } else {
+      const uint32_t interval = queue_conf_.sample_interval();
+      if (interval > 1 && sampled_++ % interval != 0) {
+        stats_->sampled_out.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
       if (Full()) {
         buffer_[GetIndex(head_)] = value;
         ++head_;
@@ -77,6 +131,49 @@ class CacheBuffer {
         buffer_[GetIndex(tail_ + 1)] = value;
         ++tail_;
       }
+      stats_->enqueued.fetch_add(1, std::memory_order_relaxed);
+      UpdateDepth();
+    }
+  }
+
+  /**
+   * @brief BLOCK: wait, with `lock` holding Mutex(), until the next Fill
+   * does not overwrite a message the reader has not taken yet, or until
+   * the timeout. Readers that never took a message are not waited for.
+   */
+  void WaitForRoom(std::unique_lock<std::mutex>* lock) {
+    if (queue_conf_.policy() != PendingQueueConf::BLOCK || !Overflowing()) {
+      return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (!room_cv_.wait_for(
+            *lock, std::chrono::milliseconds(queue_conf_.block_timeout_ms()),
+            [this]() { return !Overflowing(); })) {
+      stats_->block_timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+    stats_->blocked_ns.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count(),
+        std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The reader took the message at `pos` and skipped `skipped`
+   * before it, which it either could not keep up with or, with CONFLATE,
+   * chose to skip.
+   */
+  void MarkRead(uint64_t pos, uint64_t skipped) {
+    read_ = pos;
+    if (skipped > 0) {
+      auto& counter = queue_conf_.policy() == PendingQueueConf::CONFLATE
+                          ? stats_->conflated
+                          : stats_->dropped;
+      counter.fetch_add(skipped, std::memory_order_relaxed);
+    }
+    UpdateDepth();
+    if (queue_conf_.policy() == PendingQueueConf::BLOCK) {
+      room_cv_.notify_all();
     }
   }
 
@@ -86,12 +183,32 @@ class CacheBuffer {
   CacheBuffer& operator=(const CacheBuffer& other) = delete;
   uint64_t GetIndex(const uint64_t& pos) const { return pos % capacity_; }
 
+  // messages filled in and not taken by the reader yet
+  uint64_t Pending() const { return tail_ - std::max(read_, head_); }
+
+  bool Overflowing() const { return read_ != 0 && Full() && read_ < Head(); }
+
+  void UpdateDepth() {
+    const uint64_t depth = Pending();
+    stats_->depth.store(depth, std::memory_order_relaxed);
+    if (depth > stats_->max_depth.load(std::memory_order_relaxed)) {
+      stats_->max_depth.store(depth, std::memory_order_relaxed);
+    }
+  }
+
   uint64_t head_ = 0;
   uint64_t tail_ = 0;
+  // the position last taken by the reader, 0 before the first one
+  uint64_t read_ = 0;
+  uint64_t sampled_ = 0;
   uint64_t capacity_ = 0;
   std::vector<T> buffer_;
   mutable std::mutex mutex_;
+  std::condition_variable room_cv_;
   FusionCallback fusion_callback_;
+  PendingQueueConf queue_conf_;
+  std::shared_ptr<PendingQueueStats> stats_ =
+      std::make_shared<PendingQueueStats>();
 };
 
 }  // namespace data
@@ -61,18 +61,23 @@ bool ChannelBuffer<T>::Fetch(uint64_t* index,
     return false;
   }
 
+  uint64_t skipped = 0;
   if (*index == 0) {
     *index = buffer_->Tail();
   } else if (*index == buffer_->Tail() + 1) {
     return false;
+  } else if (buffer_->QueueConf().policy() == PendingQueueConf::CONFLATE) {
+    skipped = buffer_->Tail() - *index;
+    *index = buffer_->Tail();
   } else if (*index < buffer_->Head()) {
-    auto interval = buffer_->Tail() - *index;
+    skipped = buffer_->Tail() - *index;
     AWARN << "channel[" << GlobalData::GetChannelById(channel_id_) << "] "
-          << "read buffer overflow, drop_message[" << interval << "] pre_index["
+          << "read buffer overflow, drop_message[" << skipped << "] pre_index["
           << *index << "] current_index[" << buffer_->Tail() << "] ";
     *index = buffer_->Tail();
   }
   m = buffer_->at(*index);
+  buffer_->MarkRead(*index, skipped);
   return true;
 }
 
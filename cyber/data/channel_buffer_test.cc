@@ -98,6 +98,75 @@ TEST(ChannelBufferTest, FetchMulti) {
   EXPECT_EQ(2, *vector[1]);
 }
 
+TEST(ChannelBufferTest, QueueStats) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(2);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  auto stats = cache_buffer->Stats();
+  std::shared_ptr<int> msg;
+  uint64_t index = 0;
+  cache_buffer->Fill(std::make_shared<int>(1));
+  EXPECT_EQ(1, stats->depth);
+  EXPECT_TRUE(buffer->Fetch(&index, msg));
+  EXPECT_EQ(0, stats->depth);
+  index++;
+  for (int i = 2; i <= 5; ++i) {
+    cache_buffer->Fill(std::make_shared<int>(i));
+  }
+  EXPECT_EQ(2, stats->depth);
+  EXPECT_EQ(2, stats->max_depth);
+  // 2 and 3 were overwritten, 4 is skipped for 5
+  EXPECT_TRUE(buffer->Fetch(&index, msg));
+  EXPECT_EQ(5, *msg);
+  EXPECT_EQ(5, stats->enqueued);
+  EXPECT_EQ(3, stats->dropped);
+  EXPECT_EQ(0, stats->conflated);
+}
+
+TEST(ChannelBufferTest, Conflate) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(10);
+  PendingQueueConf conf;
+  conf.set_policy(PendingQueueConf::CONFLATE);
+  cache_buffer->SetQueueConf(conf);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  auto stats = cache_buffer->Stats();
+  EXPECT_EQ(1, stats->capacity);
+
+  std::shared_ptr<int> msg;
+  uint64_t index = 0;
+  cache_buffer->Fill(std::make_shared<int>(1));
+  EXPECT_TRUE(buffer->Fetch(&index, msg));
+  index++;
+  for (int i = 2; i <= 4; ++i) {
+    cache_buffer->Fill(std::make_shared<int>(i));
+  }
+  EXPECT_EQ(1, stats->max_depth);
+  EXPECT_TRUE(buffer->Fetch(&index, msg));
+  EXPECT_EQ(4, *msg);
+  index++;
+  EXPECT_FALSE(buffer->Fetch(&index, msg));
+  EXPECT_EQ(2, stats->conflated);
+  EXPECT_EQ(0, stats->dropped);
+}
+
+TEST(ChannelBufferTest, Sample) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(10);
+  PendingQueueConf conf;
+  conf.set_policy(PendingQueueConf::SAMPLE);
+  conf.set_sample_interval(3);
+  cache_buffer->SetQueueConf(conf);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  for (int i = 0; i < 7; ++i) {
+    cache_buffer->Fill(std::make_shared<int>(i));
+  }
+  std::vector<std::shared_ptr<int>> msgs;
+  EXPECT_TRUE(buffer->FetchMulti(10, &msgs));
+  ASSERT_EQ(3, msgs.size());
+  EXPECT_EQ(0, *msgs[0]);
+  EXPECT_EQ(3, *msgs[1]);
+  EXPECT_EQ(6, *msgs[2]);
+  EXPECT_EQ(4, cache_buffer->Stats()->sampled_out);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
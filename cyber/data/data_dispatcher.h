@@ -43,7 +43,11 @@ class DataDispatcher {
 
   void AddBuffer(const ChannelBuffer<T>& channel_buffer);
 
-  bool Dispatch(const uint64_t channel_id, const std::shared_ptr<T>& msg);
+  // `may_block` is true only on the writer's thread, i.e. for messages from
+  // the same process. The shm and rtps dispatcher threads are shared by all
+  // channels and never wait for a BLOCK reader.
+  bool Dispatch(const uint64_t channel_id, const std::shared_ptr<T>& msg,
+                bool may_block = false);
 
  private:
   DataNotifier* notifier_ = DataNotifier::Instance();
@@ -71,7 +75,8 @@ void DataDispatcher<T>::AddBuffer(const ChannelBuffer<T>& channel_buffer) {
 
 template <typename T>
 bool DataDispatcher<T>::Dispatch(const uint64_t channel_id,
-                                 const std::shared_ptr<T>& msg) {
+                                 const std::shared_ptr<T>& msg,
+                                 bool may_block) {
   BufferVector* buffers = nullptr;
   if (apollo::cyber::IsShutdown()) {
     return false;
@@ -79,7 +84,10 @@ bool DataDispatcher<T>::Dispatch(const uint64_t channel_id,
   if (buffers_map_.Get(channel_id, &buffers)) {
     for (auto& buffer_wptr : *buffers) {
       if (auto buffer = buffer_wptr.lock()) {
-        std::lock_guard<std::mutex> lock(buffer->Mutex());
+        std::unique_lock<std::mutex> lock(buffer->Mutex());
+        if (may_block) {
+          buffer->WaitForRoom(&lock);
+        }
         buffer->Fill(msg);
       }
     }
@@ -16,7 +16,9 @@
 
 #include "cyber/data/data_dispatcher.h"
 
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -58,6 +60,62 @@ TEST(DataDispatcher, Dispatch) {
   EXPECT_TRUE(dispatcher->Dispatch(channel0, msg));
 }
 
+TEST(DataDispatcher, Block) {
+  auto channel2 = common::Hash("/channel2");
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(1);
+  PendingQueueConf conf;
+  conf.set_policy(PendingQueueConf::BLOCK);
+  conf.set_block_timeout_ms(20);
+  cache_buffer->SetQueueConf(conf);
+  auto buffer = ChannelBuffer<int>(channel2, cache_buffer);
+  auto dispatcher = DataDispatcher<int>::Instance();
+  dispatcher->AddBuffer(buffer);
+  DataNotifier::Instance()->AddNotifier(channel2, std::make_shared<Notifier>());
+  auto stats = cache_buffer->Stats();
+
+  std::shared_ptr<int> msg;
+  uint64_t index = 0;
+  // nothing is held before the reader took its first message
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, std::make_shared<int>(1), true));
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, std::make_shared<int>(2), true));
+  EXPECT_EQ(0, stats->blocked_ns);
+  EXPECT_TRUE(buffer.Fetch(&index, msg));
+  EXPECT_EQ(2, *msg);
+  index++;
+
+  // the reader takes 3 while 4 waits for it
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, std::make_shared<int>(3), true));
+  std::thread reader([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(buffer.Fetch(&index, msg));
+    index++;
+  });
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, std::make_shared<int>(4), true));
+  reader.join();
+  EXPECT_EQ(3, *msg);
+  EXPECT_GT(stats->blocked_ns, 0);
+  EXPECT_EQ(0, stats->block_timeouts);
+
+  // nobody takes 4, 5 overwrites it after the timeout
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, std::make_shared<int>(5), true));
+  EXPECT_EQ(1, stats->block_timeouts);
+  EXPECT_GE(stats->blocked_ns, 20000000);
+  EXPECT_TRUE(buffer.Fetch(&index, msg));
+  EXPECT_EQ(5, *msg);
+  EXPECT_EQ(1, stats->dropped);
+  index++;
+
+  // messages from other processes never hold the shared dispatcher thread
+  const uint64_t blocked_ns = stats->blocked_ns;
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, std::make_shared<int>(6)));
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, std::make_shared<int>(7)));
+  EXPECT_EQ(blocked_ns, stats->blocked_ns);
+  EXPECT_EQ(1, stats->block_timeouts);
+  EXPECT_TRUE(buffer.Fetch(&index, msg));
+  EXPECT_EQ(7, *msg);
+  EXPECT_EQ(2, stats->dropped);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
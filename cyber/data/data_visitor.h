@@ -22,11 +22,14 @@
 #include <memory>
 #include <vector>
 
+#include "cyber/proto/component_conf.pb.h"
+
 #include "cyber/common/log.h"
 #include "cyber/data/channel_buffer.h"
 #include "cyber/data/data_dispatcher.h"
 #include "cyber/data/data_visitor_base.h"
 #include "cyber/data/fusion/all_latest.h"
+#include "cyber/data/fusion/approximate_time.h"
 #include "cyber/data/fusion/data_fusion.h"
 
 namespace apollo {
@@ -34,12 +37,17 @@ namespace cyber {
 namespace data {
 
 struct VisitorConfig {
-  VisitorConfig(uint64_t id, uint32_t size)
-      : channel_id(id), queue_size(size) {}
+  VisitorConfig(uint64_t id, uint32_t size,
+                const PendingQueueConf& conf = PendingQueueConf())
+      : channel_id(id), queue_size(size), queue_conf(conf) {}
   uint64_t channel_id;
   uint32_t queue_size;
+  // applied by visitors of a single channel
+  PendingQueueConf queue_conf;
 };
 
+using apollo::cyber::proto::FusionConfig;
+
 template <typename T>
 using BufferType = CacheBuffer<std::shared_ptr<T>>;
 
@@ -47,7 +55,8 @@ template <typename M0, typename M1 = NullType, typename M2 = NullType,
           typename M3 = NullType>
 class DataVisitor : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(const std::vector<VisitorConfig>& configs,
+                       const FusionConfig& fusion_config = FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -61,8 +70,17 @@ class DataVisitor : public DataVisitorBase {
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     DataDispatcher<M3>::Instance()->AddBuffer(buffer_m3_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
-        buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    if (fusion_config.policy() == FusionConfig::APPROXIMATE_TIME) {
+      // a set may be completed by a message of any channel
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m3_.channel_id(), notifier_);
+      data_fusion_ = new fusion::ApproximateTime<M0, M1, M2, M3>(
+          fusion_config, buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
+          buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    }
   }
 
   ~DataVisitor() {
@@ -92,7 +110,8 @@ class DataVisitor : public DataVisitorBase {
 template <typename M0, typename M1, typename M2>
 class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(const std::vector<VisitorConfig>& configs,
+                       const FusionConfig& fusion_config = FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -103,8 +122,15 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ =
-        new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_, buffer_m2_);
+    if (fusion_config.policy() == FusionConfig::APPROXIMATE_TIME) {
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+      data_fusion_ = new fusion::ApproximateTime<M0, M1, M2>(
+          fusion_config, buffer_m0_, buffer_m1_, buffer_m2_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_,
+                                                       buffer_m2_);
+    }
   }
 
   ~DataVisitor() {
@@ -133,7 +159,8 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
 template <typename M0, typename M1>
 class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(const std::vector<VisitorConfig>& configs,
+                       const FusionConfig& fusion_config = FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -141,7 +168,13 @@ class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    if (fusion_config.policy() == FusionConfig::APPROXIMATE_TIME) {
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_fusion_ = new fusion::ApproximateTime<M0, M1>(
+          fusion_config, buffer_m0_, buffer_m1_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    }
   }
 
   ~DataVisitor() {
@@ -170,6 +203,13 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
  public:
   explicit DataVisitor(const VisitorConfig& configs)
       : buffer_(configs.channel_id, new BufferType<M0>(configs.queue_size)) {
+    if (configs.queue_conf.policy() == proto::PendingQueueConf::BLOCK) {
+      AWARN << "BLOCK pending queue of channel "
+            << common::GlobalData::GetChannelById(configs.channel_id)
+            << " only holds writers of this process, messages from other "
+               "processes overwrite the oldest one.";
+    }
+    buffer_.Buffer()->SetQueueConf(configs.queue_conf);
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_);
     data_notifier_->AddNotifier(buffer_.channel_id(), notifier_);
   }
@@ -188,6 +228,10 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
     return false;
   }
 
+  std::shared_ptr<PendingQueueStats> QueueStats() const {
+    return buffer_.Buffer()->Stats();
+  }
+
  private:
   ChannelBuffer<M0> buffer_;
 };
@@ -139,6 +139,32 @@ TEST(DataVisitorTest, four_channel) {
   EXPECT_FALSE(dv->TryFetch(msg0, msg1, msg2, msg3));
 }
 
+TEST(DataVisitorTest, approximate_time) {
+  std::vector<VisitorConfig> configs;
+  configs.emplace_back(str_hash("/approximate0"), 10);
+  configs.emplace_back(str_hash("/approximate1"), 10);
+  FusionConfig fusion_config;
+  fusion_config.set_policy(FusionConfig::APPROXIMATE_TIME);
+  fusion_config.set_slop_ms(1000.0);
+  auto dv = std::make_shared<DataVisitor<RawMessage, RawMessage>>(
+      configs, fusion_config);
+  int notified = 0;
+  dv->RegisterNotifyCallback([&notified]() { ++notified; });
+
+  std::shared_ptr<RawMessage> msg0;
+  std::shared_ptr<RawMessage> msg1;
+  DispatchMessage(configs[0].channel_id, 1);
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1));
+  // the second channel completes the set and wakes the visitor too
+  DispatchMessage(configs[1].channel_id, 1);
+  EXPECT_EQ(2, notified);
+  EXPECT_TRUE(dv->TryFetch(msg0, msg1));
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1));
+  // every message is fused at most once
+  DispatchMessage(configs[0].channel_id, 1);
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1));
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
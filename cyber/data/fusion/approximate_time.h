@@ -0,0 +1,384 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+#define CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cyber/proto/component_conf.pb.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/common/types.h"
+#include "cyber/data/cache_buffer.h"
+#include "cyber/data/channel_buffer.h"
+#include "cyber/data/fusion/data_fusion.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+/**
+ * @brief The time in ns ApproximateTime matches a message on. Messages with
+ * a header().timestamp_sec() use it, others the time they were received.
+ * Specialize it to match a message type on another field.
+ */
+template <typename M, typename Enable = void>
+struct MessageTimestamp {
+  static uint64_t Get(const M& msg, uint64_t receive_ns) {
+    (void)msg;
+    return receive_ns;
+  }
+};
+
+template <typename M>
+struct MessageTimestamp<
+    M, decltype(void(std::declval<const M&>().header().timestamp_sec()))> {
+  static uint64_t Get(const M& msg, uint64_t receive_ns) {
+    double sec = msg.header().timestamp_sec();
+    return sec > 0.0 ? static_cast<uint64_t>(sec * 1e9) : receive_ns;
+  }
+};
+
+/**
+ * @brief FIFO of fixed capacity that drops its oldest element when full.
+ */
+template <typename T>
+class FixedQueue {
+ public:
+  explicit FixedQueue(uint32_t capacity)
+      : slots_(std::max<uint32_t>(capacity, 1)) {}
+
+  bool Empty() const { return size_ == 0; }
+  uint32_t Size() const { return size_; }
+  const T& operator[](uint32_t i) const {
+    return slots_[(head_ + i) % slots_.size()];
+  }
+
+  void Push(const T& value) {
+    if (size_ == slots_.size()) {
+      Pop(1);
+    }
+    slots_[(head_ + size_) % slots_.size()] = value;
+    ++size_;
+  }
+
+  void Pop(uint32_t num) {
+    num = std::min(num, size_);
+    for (uint32_t i = 0; i < num; ++i) {
+      // release what the slot holds now rather than when it is reused
+      slots_[head_] = T();
+      head_ = (head_ + 1) % slots_.size();
+    }
+    size_ -= num;
+  }
+
+ private:
+  std::vector<T> slots_;
+  uint32_t head_ = 0;
+  uint32_t size_ = 0;
+};
+
+/**
+ * @brief Matching shared by the ApproximateTime fusions of 2 to 4 channels,
+ * after the ApproximateTime policy of ROS message_filters: it fuses one
+ * message of every channel once their timestamps lie within `slop` of each
+ * other, and drops the messages that can no longer be part of such a set.
+ *
+ * Every set holds a message of the channel whose oldest pending message is
+ * the newest, the pivot, so on any other channel the messages more than
+ * `slop` before the pivot are dropped, and of the rest the one nearest to
+ * the pivot is taken. Unlike ROS it fuses as soon as a set is complete
+ * rather than waiting to know that no better one can follow.
+ *
+ * The pending messages and fused sets live in rings allocated up front.
+ */
+template <typename... Ms>
+class ApproximateTimeSync {
+ public:
+  using FusionDataType = std::tuple<std::shared_ptr<Ms>...>;
+  static constexpr size_t kChannelNum = sizeof...(Ms);
+
+  ApproximateTimeSync(const proto::FusionConfig& config,
+                      const ChannelBuffer<Ms>&... buffers)
+      : buffers_(buffers...),
+        slop_ns_(static_cast<uint64_t>(
+            std::max(config.slop_ms(), 0.0) * 1000000.0)),
+        stamps_(kChannelNum, FixedQueue<uint64_t>(config.queue_size())),
+        queues_(FixedQueue<std::shared_ptr<Ms>>(config.queue_size())...),
+        fused_(std::get<0>(buffers_).Buffer()->Capacity() - uint64_t(1)) {
+    last_stamps_.fill(0);
+    SetFusionCallbacks(std::index_sequence_for<Ms...>());
+  }
+
+  ~ApproximateTimeSync() {
+    ClearFusionCallbacks(std::index_sequence_for<Ms...>());
+  }
+
+  bool Fetch(uint64_t* index, FusionDataType* data) {
+    std::lock_guard<std::mutex> lg(mutex_);
+    if (fused_.Empty()) {
+      return false;
+    }
+
+    if (*index == 0) {
+      *index = fused_.Tail();
+    } else if (*index == fused_.Tail() + 1) {
+      return false;
+    } else if (*index < fused_.Head()) {
+      auto interval = fused_.Tail() - *index;
+      AWARN << "channel["
+            << GlobalData::GetChannelById(
+                   std::get<0>(buffers_).channel_id())
+            << "] fusion buffer overflow, drop_message[" << interval
+            << "] pre_index[" << *index << "] current_index["
+            << fused_.Tail() << "] ";
+      *index = fused_.Tail();
+    }
+    *data = fused_.at(*index);
+    return true;
+  }
+
+ private:
+  template <size_t I>
+  using MessageType = typename std::tuple_element<I, std::tuple<Ms...>>::type;
+  using Picks = std::array<uint32_t, kChannelNum>;
+
+  template <size_t... Is>
+  void SetFusionCallbacks(std::index_sequence<Is...>) {
+    (std::get<Is>(buffers_).Buffer()->SetFusionCallback(
+         [this](const std::shared_ptr<MessageType<Is>>& msg) {
+           Add<Is>(msg);
+         }),
+     ...);
+  }
+
+  template <size_t... Is>
+  void ClearFusionCallbacks(std::index_sequence<Is...>) {
+    auto clear = [](const auto& buffer) {
+      std::lock_guard<std::mutex> lg(buffer->Mutex());
+      buffer->SetFusionCallback(nullptr);
+    };
+    (clear(std::get<Is>(buffers_).Buffer()), ...);
+  }
+
+  template <size_t I>
+  void Add(const std::shared_ptr<MessageType<I>>& msg) {
+    uint64_t stamp = MessageTimestamp<MessageType<I>>::Get(
+        *msg, Time::Now().ToNanosecond());
+    std::lock_guard<std::mutex> lg(mutex_);
+    if (stamp < last_stamps_[I]) {
+      ADEBUG << "drop message older than its predecessor on channel " << I;
+      return;
+    }
+    last_stamps_[I] = stamp;
+    stamps_[I].Push(stamp);
+    std::get<I>(queues_).Push(msg);
+    Match();
+  }
+
+  void Match() {
+    Picks picks;
+    while (Pick(&picks)) {
+      Emit(picks, std::index_sequence_for<Ms...>());
+    }
+  }
+
+  // Choose the position of the fused message on every channel, dropping
+  // what can no longer be matched. False while some channel has nothing.
+  bool Pick(Picks* picks) {
+    for (;;) {
+      for (const auto& stamps : stamps_) {
+        if (stamps.Empty()) {
+          return false;
+        }
+      }
+      size_t pivot = 0;
+      for (size_t i = 1; i < kChannelNum; ++i) {
+        if (stamps_[i][0] > stamps_[pivot][0]) {
+          pivot = i;
+        }
+      }
+      const uint64_t pivot_ns = stamps_[pivot][0];
+      (*picks)[pivot] = 0;
+
+      bool dropped = false;
+      for (size_t i = 0; i < kChannelNum; ++i) {
+        if (i == pivot) {
+          continue;
+        }
+        const auto& stamps = stamps_[i];
+        // the latest message not after the pivot, there is at least one
+        uint32_t before = 0;
+        while (before + 1 < stamps.Size() && stamps[before + 1] <= pivot_ns) {
+          ++before;
+        }
+        if (pivot_ns - stamps[before] > slop_ns_) {
+          Drop(i, before + 1);
+          dropped = true;
+          continue;
+        }
+        (*picks)[i] = before;
+      }
+      if (dropped) {
+        continue;
+      }
+
+      // take a message after the pivot instead where it is nearer and the
+      // set still fits into the slop
+      for (size_t i = 0; i < kChannelNum; ++i) {
+        const auto& stamps = stamps_[i];
+        uint32_t after = (*picks)[i] + 1;
+        if (i == pivot || after >= stamps.Size()) {
+          continue;
+        }
+        if (stamps[after] - pivot_ns >= pivot_ns - stamps[(*picks)[i]]) {
+          continue;
+        }
+        Picks tentative = *picks;
+        tentative[i] = after;
+        if (Spread(tentative) <= slop_ns_) {
+          *picks = tentative;
+        }
+      }
+      return true;
+    }
+  }
+
+  uint64_t Spread(const Picks& picks) const {
+    uint64_t lo = stamps_[0][picks[0]];
+    uint64_t hi = lo;
+    for (size_t i = 1; i < kChannelNum; ++i) {
+      lo = std::min(lo, stamps_[i][picks[i]]);
+      hi = std::max(hi, stamps_[i][picks[i]]);
+    }
+    return hi - lo;
+  }
+
+  void Drop(size_t channel, uint32_t num) {
+    DropImpl(channel, num, std::index_sequence_for<Ms...>());
+  }
+
+  template <size_t... Is>
+  void DropImpl(size_t channel, uint32_t num, std::index_sequence<Is...>) {
+    stamps_[channel].Pop(num);
+    ((Is == channel ? std::get<Is>(queues_).Pop(num) : void()), ...);
+  }
+
+  template <size_t... Is>
+  void Emit(const Picks& picks, std::index_sequence<Is...>) {
+    fused_.Fill(FusionDataType(std::get<Is>(queues_)[picks[Is]]...));
+    // the fused messages and everything older are done with
+    (stamps_[Is].Pop(picks[Is] + 1), ...);
+    (std::get<Is>(queues_).Pop(picks[Is] + 1), ...);
+  }
+
+  std::tuple<ChannelBuffer<Ms>...> buffers_;
+  uint64_t slop_ns_;
+
+  std::mutex mutex_;
+  std::array<uint64_t, kChannelNum> last_stamps_;
+  std::vector<FixedQueue<uint64_t>> stamps_;
+  std::tuple<FixedQueue<std::shared_ptr<Ms>>...> queues_;
+  CacheBuffer<FusionDataType> fused_;
+};
+
+template <typename M0, typename M1 = NullType, typename M2 = NullType,
+          typename M3 = NullType>
+class ApproximateTime : public DataFusion<M0, M1, M2, M3> {
+ public:
+  ApproximateTime(const proto::FusionConfig& config,
+                  const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1,
+                  const ChannelBuffer<M2>& buffer_2,
+                  const ChannelBuffer<M3>& buffer_3)
+      : sync_(config, buffer_0, buffer_1, buffer_2, buffer_3) {}
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2, std::shared_ptr<M3>& m3) override {
+    typename ApproximateTimeSync<M0, M1, M2, M3>::FusionDataType fusion_data;
+    if (!sync_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    std::tie(m0, m1, m2, m3) = std::move(fusion_data);
+    return true;
+  }
+
+ private:
+  ApproximateTimeSync<M0, M1, M2, M3> sync_;
+};
+
+template <typename M0, typename M1, typename M2>
+class ApproximateTime<M0, M1, M2, NullType> : public DataFusion<M0, M1, M2> {
+ public:
+  ApproximateTime(const proto::FusionConfig& config,
+                  const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1,
+                  const ChannelBuffer<M2>& buffer_2)
+      : sync_(config, buffer_0, buffer_1, buffer_2) {}
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2) override {
+    typename ApproximateTimeSync<M0, M1, M2>::FusionDataType fusion_data;
+    if (!sync_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    std::tie(m0, m1, m2) = std::move(fusion_data);
+    return true;
+  }
+
+ private:
+  ApproximateTimeSync<M0, M1, M2> sync_;
+};
+
+template <typename M0, typename M1>
+class ApproximateTime<M0, M1, NullType, NullType> : public DataFusion<M0, M1> {
+ public:
+  ApproximateTime(const proto::FusionConfig& config,
+                  const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1)
+      : sync_(config, buffer_0, buffer_1) {}
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,
+              std::shared_ptr<M1>& m1) override {
+    typename ApproximateTimeSync<M0, M1>::FusionDataType fusion_data;
+    if (!sync_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    std::tie(m0, m1) = std::move(fusion_data);
+    return true;
+  }
+
+ private:
+  ApproximateTimeSync<M0, M1> sync_;
+};
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
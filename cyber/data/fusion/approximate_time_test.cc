@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/fusion/approximate_time.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cyber/message/raw_message.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+using apollo::cyber::message::RawMessage;
+using apollo::cyber::proto::FusionConfig;
+
+struct StampedHeader {
+  double timestamp_sec() const { return stamp; }
+  double stamp;
+};
+
+struct Stamped {
+  Stamped(const std::string& msg_name, double stamp)
+      : name(msg_name), stamped_header{stamp} {}
+  const StampedHeader& header() const { return stamped_header; }
+  std::string name;
+  StampedHeader stamped_header;
+};
+
+using StampedBuffer = CacheBuffer<std::shared_ptr<Stamped>>;
+
+void FillStamped(StampedBuffer* cache, const std::string& name,
+                 double stamp) {
+  cache->Fill(std::make_shared<Stamped>(name, stamp));
+}
+
+FusionConfig ApproximateTimeConfig(double slop_ms) {
+  FusionConfig config;
+  config.set_policy(FusionConfig::APPROXIMATE_TIME);
+  config.set_slop_ms(slop_ms);
+  config.set_queue_size(4);
+  return config;
+}
+
+TEST(ApproximateTimeTest, timestamp) {
+  EXPECT_EQ(1500000000UL, fusion::MessageTimestamp<Stamped>::Get(
+                              Stamped("m", 1.5), 7));
+  EXPECT_EQ(7UL, fusion::MessageTimestamp<Stamped>::Get(Stamped("m", 0), 7));
+  EXPECT_EQ(7UL, fusion::MessageTimestamp<RawMessage>::Get(RawMessage(), 7));
+}
+
+TEST(ApproximateTimeTest, two_channels) {
+  auto cache0 = new StampedBuffer(10);
+  auto cache1 = new StampedBuffer(10);
+  ChannelBuffer<Stamped> buffer0(static_cast<uint64_t>(0), cache0);
+  ChannelBuffer<Stamped> buffer1(static_cast<uint64_t>(1), cache1);
+  std::shared_ptr<Stamped> m0;
+  std::shared_ptr<Stamped> m1;
+  uint64_t index = 0;
+  fusion::ApproximateTime<Stamped, Stamped> fusion(ApproximateTimeConfig(10),
+                                                   buffer0, buffer1);
+
+  // a set needs a message of every channel, whichever comes last
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  FillStamped(cache1, "1-0", 1.004);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  FillStamped(cache0, "0-0", 1.0);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-0", m0->name);
+  EXPECT_EQ("1-0", m1->name);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // skewed channels: 0-1 has no partner within the slop and is dropped
+  // rather than paired with the latest 1-x
+  FillStamped(cache0, "0-1", 1.1);
+  FillStamped(cache0, "0-2", 1.2);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  FillStamped(cache1, "1-1", 1.195);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-2", m0->name);
+  EXPECT_EQ("1-1", m1->name);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // of the candidates the one nearest to the pivot is taken
+  FillStamped(cache1, "1-2", 1.291);
+  FillStamped(cache1, "1-3", 1.301);
+  FillStamped(cache0, "0-3", 1.3);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-3", m0->name);
+  EXPECT_EQ("1-3", m1->name);
+
+  // older than what was already fused on its channel
+  FillStamped(cache1, "1-4", 1.25);
+  FillStamped(cache0, "0-4", 1.25);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+}
+
+TEST(ApproximateTimeTest, three_channels) {
+  auto cache0 = new StampedBuffer(10);
+  auto cache1 = new StampedBuffer(10);
+  auto cache2 = new StampedBuffer(10);
+  ChannelBuffer<Stamped> buffer0(static_cast<uint64_t>(0), cache0);
+  ChannelBuffer<Stamped> buffer1(static_cast<uint64_t>(1), cache1);
+  ChannelBuffer<Stamped> buffer2(static_cast<uint64_t>(2), cache2);
+  std::shared_ptr<Stamped> m0;
+  std::shared_ptr<Stamped> m1;
+  std::shared_ptr<Stamped> m2;
+  uint64_t index = 0;
+  fusion::ApproximateTime<Stamped, Stamped, Stamped> fusion(
+      ApproximateTimeConfig(25), buffer0, buffer1, buffer2);
+
+  // camera at 10 Hz, lidar 15 ms behind it and radar at 20 Hz: the radar
+  // message 30 ms before the camera is skipped for the one 20 ms after
+  for (int i = 0; i < 3; ++i) {
+    double t = 1.0 + 0.1 * i;
+    FillStamped(cache2, "2-" + std::to_string(2 * i), t - 0.03);
+    FillStamped(cache2, "2-" + std::to_string(2 * i + 1), t + 0.02);
+    FillStamped(cache0, "0-" + std::to_string(i), t);
+    EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+    FillStamped(cache1, "1-" + std::to_string(i), t + 0.015);
+    ASSERT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+    index++;
+    EXPECT_EQ("0-" + std::to_string(i), m0->name);
+    EXPECT_EQ("1-" + std::to_string(i), m1->name);
+    EXPECT_EQ("2-" + std::to_string(2 * i + 1), m2->name);
+  }
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
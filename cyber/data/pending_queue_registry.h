@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_PENDING_QUEUE_REGISTRY_H_
+#define CYBER_DATA_PENDING_QUEUE_REGISTRY_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "cyber/data/cache_buffer.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+/**
+ * @brief The pending queues of the readers of the process, for monitors to
+ * report on. Queues leave once their reader is gone.
+ */
+class PendingQueueRegistry {
+ public:
+  struct Entry {
+    std::string channel_name;
+    std::string node_name;
+    std::shared_ptr<PendingQueueStats> stats;
+  };
+
+  void Register(const std::string& channel_name, const std::string& node_name,
+                const std::shared_ptr<PendingQueueStats>& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back({channel_name, node_name, stats});
+  }
+
+  // the queues still in use, forgetting the others
+  std::vector<Entry> Entries() {
+    std::vector<Entry> entries;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto alive = entries_.begin();
+    for (auto& entry : entries_) {
+      auto stats = entry.stats.lock();
+      if (stats == nullptr) {
+        continue;
+      }
+      entries.push_back({entry.channel_name, entry.node_name, stats});
+      *alive++ = std::move(entry);
+    }
+    entries_.erase(alive, entries_.end());
+    return entries;
+  }
+
+ private:
+  struct WeakEntry {
+    std::string channel_name;
+    std::string node_name;
+    std::weak_ptr<PendingQueueStats> stats;
+  };
+
+  std::mutex mutex_;
+  std::vector<WeakEntry> entries_;
+
+  DECLARE_SINGLETON(PendingQueueRegistry)
+};
+
+inline PendingQueueRegistry::PendingQueueRegistry() {}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_PENDING_QUEUE_REGISTRY_H_
@@ -33,7 +33,9 @@
 #include "cyber/common/global_data.h"
 #include "cyber/data/data_dispatcher.h"
 #include "cyber/logger/async_logger.h"
+#include "cyber/logger/binary_logger.h"
 #include "cyber/node/node.h"
+#include "cyber/profiler/exporter.h"
 #include "cyber/scheduler/scheduler.h"
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/sysmo/sysmo.h"
@@ -102,7 +104,9 @@ bool Init(const char* binary_name) {
   InitLogger(binary_name);
   auto thread = const_cast<std::thread*>(async_logger->LogThread());
   scheduler::Instance()->SetInnerThreadAttr("async_log", thread);
+  logger::BinaryLogger::Instance();
   SysMo::Instance();
+  profiler::Exporter::Instance();
   std::signal(SIGINT, OnShutdown);
   // Register exit handlers
   if (!g_atexit_registered) {
@@ -136,11 +140,13 @@ void Clear() {
     return;
   }
   SysMo::CleanUp();
+  profiler::Exporter::CleanUp();
   TaskManager::CleanUp();
   TimingWheel::CleanUp();
   scheduler::CleanUp();
   service_discovery::TopologyManager::CleanUp();
   transport::Transport::CleanUp();
+  logger::BinaryLogger::CleanUp();
   StopLogger();
   SetState(STATE_SHUTDOWN);
 }
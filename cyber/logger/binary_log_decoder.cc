@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_log_decoder.h"
+
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <vector>
+
+#include "cyber/logger/binary_log_format.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+namespace {
+
+template <typename T>
+bool ReadValue(std::istream* in, T* value) {
+  return static_cast<bool>(
+      in->read(reinterpret_cast<char*>(value), sizeof(*value)));
+}
+
+bool ReadString(std::istream* in, std::string* value) {
+  uint32_t size = 0;
+  if (!ReadValue(in, &size)) {
+    return false;
+  }
+  value->resize(size);
+  return size == 0 || static_cast<bool>(in->read(&(*value)[0], size));
+}
+
+std::string Basename(const std::string& path) {
+  auto pos = path.rfind('/');
+  return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+// the prefix glog writes, "I1017 03:50:53.123456  1234 file.cc:42] "
+void WritePrefix(char severity, uint64_t time_ns, uint32_t tid,
+                 const std::string& file, uint32_t line, std::ostream* out) {
+  time_t seconds = static_cast<time_t>(time_ns / 1000000000);
+  struct tm tm_time;
+  localtime_r(&seconds, &tm_time);
+  *out << severity << std::setfill('0') << std::setw(2)
+       << 1 + tm_time.tm_mon << std::setw(2) << tm_time.tm_mday << ' '
+       << std::setw(2) << tm_time.tm_hour << ':' << std::setw(2)
+       << tm_time.tm_min << ':' << std::setw(2) << tm_time.tm_sec << '.'
+       << std::setw(6) << (time_ns / 1000) % 1000000 << ' '
+       << std::setfill(' ') << std::setw(5) << tid << ' ' << Basename(file)
+       << ':' << line << "] ";
+}
+
+}  // namespace
+
+bool BinaryLogDecoder::Decode(std::istream* in, std::ostream* out) {
+  char magic[sizeof(kBinaryLogMagic)];
+  if (!in->read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kBinaryLogMagic, sizeof(magic)) != 0) {
+    return false;
+  }
+  static const char kSeverityChar[] = {'I', 'I', 'W', 'E'};
+
+  uint8_t type = 0;
+  std::vector<char> args;
+  std::string message;
+  while (ReadValue(in, &type)) {
+    uint32_t site_id = 0;
+    if (!ReadValue(in, &site_id)) {
+      return false;
+    }
+    if (type == kSiteEntry) {
+      Site site;
+      if (!ReadValue(in, &site.severity) || !ReadValue(in, &site.line) ||
+          !ReadString(in, &site.file) || !ReadString(in, &site.module) ||
+          !ReadString(in, &site.format) || site.severity > 3) {
+        return false;
+      }
+      sites_[site_id] = std::move(site);
+    } else if (type == kRecordEntry) {
+      uint32_t tid = 0;
+      uint64_t time_ns = 0;
+      uint32_t length = 0;
+      if (!ReadValue(in, &tid) || !ReadValue(in, &time_ns) ||
+          !ReadValue(in, &length)) {
+        return false;
+      }
+      args.resize(length);
+      if (length > 0 && !in->read(args.data(), length)) {
+        return false;
+      }
+      auto itr = sites_.find(site_id);
+      if (itr == sites_.end()) {
+        return false;
+      }
+      const Site& site = itr->second;
+      message.clear();
+      if (!RenderMessage(site.format, args.data(), args.size(), &message)) {
+        message += " <malformed arguments>";
+      }
+      WritePrefix(kSeverityChar[site.severity], time_ns, tid, site.file,
+                  site.line, out);
+      *out << (site.severity == 0 ? "[DEBUG] " : "") << message << '\n';
+    } else if (type == kDropEntry) {
+      uint64_t dropped = 0;
+      if (!ReadValue(in, &dropped)) {
+        return false;
+      }
+      auto itr = sites_.find(site_id);
+      *out << "--- " << dropped << " records of "
+           << (itr == sites_.end() ? std::string("an unknown site")
+                                   : Basename(itr->second.file) + ":" +
+                                         std::to_string(itr->second.line))
+           << " dropped so far, their thread's ring was full\n";
+    } else {
+      return false;
+    }
+  }
+  return in->eof();
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
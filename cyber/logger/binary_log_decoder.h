@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_LOGGER_BINARY_LOG_DECODER_H_
+#define CYBER_LOGGER_BINARY_LOG_DECODER_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+/**
+ * @brief Renders a binary log file written by BinaryLogger into the text
+ * glog would have written, one line per record.
+ */
+class BinaryLogDecoder {
+ public:
+  /**
+   * @brief Decode `in` into `out`.
+   *
+   * @return False if `in` is not a binary log, or if it ends in the middle
+   * of an entry, as the file of a crashed process may. Everything before is
+   * rendered either way.
+   */
+  bool Decode(std::istream* in, std::ostream* out);
+
+ private:
+  struct Site {
+    uint8_t severity = 0;
+    uint32_t line = 0;
+    std::string file;
+    std::string module;
+    std::string format;
+  };
+
+  std::unordered_map<uint32_t, Site> sites_;
+};
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_BINARY_LOG_DECODER_H_
@@ -0,0 +1,45 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <fstream>
+#include <iostream>
+
+#include "cyber/logger/binary_log_decoder.h"
+
+// Renders the binary logs of LogConf.binary as text:
+//   binary_log_decoder planning.log.BIN.20231017-035053.1234 | less
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <binary log file>..." << std::endl;
+    return 1;
+  }
+  int result = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream in(argv[i], std::ios::binary);
+    if (!in) {
+      std::cerr << "can not open " << argv[i] << std::endl;
+      result = 1;
+      continue;
+    }
+    apollo::cyber::logger::BinaryLogDecoder decoder;
+    if (!decoder.Decode(&in, &std::cout)) {
+      std::cerr << argv[i] << " is not a binary log or is truncated"
+                << std::endl;
+      result = 1;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_log_format.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+namespace {
+
+// renders one argument the way an ostream would, returns the bytes read or
+// 0 if the argument is malformed
+size_t RenderArg(const char* args, size_t size, std::string* out) {
+  if (size < 1) {
+    return 0;
+  }
+  const auto type = static_cast<ArgType>(args[0]);
+  char buf[32];
+  if (type == kStringArg) {
+    uint32_t length = 0;
+    if (size < 1 + sizeof(length)) {
+      return 0;
+    }
+    std::memcpy(&length, args + 1, sizeof(length));
+    if (size < 1 + sizeof(length) + length) {
+      return 0;
+    }
+    out->append(args + 1 + sizeof(length), length);
+    return 1 + sizeof(length) + length;
+  }
+
+  uint64_t bits = 0;
+  if (size < 1 + sizeof(bits)) {
+    return 0;
+  }
+  std::memcpy(&bits, args + 1, sizeof(bits));
+  switch (type) {
+    case kIntArg: {
+      int64_t value = 0;
+      std::memcpy(&value, &bits, sizeof(value));
+      snprintf(buf, sizeof(buf), "%" PRId64, value);
+      break;
+    }
+    case kUintArg:
+      snprintf(buf, sizeof(buf), "%" PRIu64, bits);
+      break;
+    case kDoubleArg: {
+      double value = 0.0;
+      std::memcpy(&value, &bits, sizeof(value));
+      snprintf(buf, sizeof(buf), "%g", value);
+      break;
+    }
+    case kBoolArg:
+      snprintf(buf, sizeof(buf), "%d", bits != 0 ? 1 : 0);
+      break;
+    case kCharArg:
+      snprintf(buf, sizeof(buf), "%c", static_cast<char>(bits));
+      break;
+    case kPointerArg:
+      snprintf(buf, sizeof(buf), "0x%" PRIx64, bits);
+      break;
+    default:
+      return 0;
+  }
+  out->append(buf);
+  return 1 + sizeof(bits);
+}
+
+}  // namespace
+
+bool RenderMessage(const std::string& format, const char* args,
+                   size_t args_size, std::string* message) {
+  size_t offset = 0;
+  for (size_t i = 0; i < format.size(); ++i) {
+    if (format[i] == '{' && i + 1 < format.size()) {
+      if (format[i + 1] == '{') {
+        message->push_back('{');
+        ++i;
+        continue;
+      }
+      if (format[i + 1] == '}' && offset < args_size) {
+        size_t read = RenderArg(args + offset, args_size - offset, message);
+        if (read == 0) {
+          return false;
+        }
+        offset += read;
+        ++i;
+        continue;
+      }
+    }
+    message->push_back(format[i]);
+  }
+  while (offset < args_size) {
+    message->push_back(' ');
+    size_t read = RenderArg(args + offset, args_size - offset, message);
+    if (read == 0) {
+      return false;
+    }
+    offset += read;
+  }
+  return true;
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,212 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Layout of the binary log records and of their arguments.
+ *
+ * A binary log file starts with kBinaryLogMagic and is followed by entries
+ * that each start with a one byte EntryType:
+ *   kSiteEntry   u32 site, u8 severity, u32 line, str file, str module,
+ *                str format
+ *   kRecordEntry u32 site, u32 tid, u64 time in ns since the epoch,
+ *                u32 length, arguments
+ *   kDropEntry   u32 site, u64 records of the site dropped so far
+ * where str is a u32 length followed by the bytes. A site is written to a
+ * file before the first record that refers to it. The arguments are a
+ * sequence of an ArgType byte and the value: 8 bytes for the numbers, a
+ * u32 length and the bytes for strings. Everything is in host byte order.
+ */
+
+#ifndef CYBER_LOGGER_BINARY_LOG_FORMAT_H_
+#define CYBER_LOGGER_BINARY_LOG_FORMAT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+constexpr char kBinaryLogMagic[8] = {'C', 'Y', 'B', 'L', 'O', 'G', '1', '\0'};
+
+enum EntryType : uint8_t {
+  kSiteEntry = 1,
+  kRecordEntry = 2,
+  kDropEntry = 3,
+};
+
+enum ArgType : uint8_t {
+  kIntArg = 1,
+  kUintArg = 2,
+  kDoubleArg = 3,
+  kBoolArg = 4,
+  kCharArg = 5,
+  kStringArg = 6,
+  kPointerArg = 7,
+};
+
+/**
+ * @brief Size and encoding of one logged argument. Numbers are widened to
+ * 64 bits, strings are copied, pointers are logged as addresses.
+ */
+template <typename T, typename Enable = void>
+struct ArgCodec;
+
+template <typename T>
+inline char* EncodeValue(char* out, ArgType type, T value) {
+  *out++ = static_cast<char>(type);
+  std::memcpy(out, &value, sizeof(value));
+  return out + sizeof(value);
+}
+
+inline char* EncodeString(char* out, const char* data, uint32_t size) {
+  *out++ = static_cast<char>(kStringArg);
+  std::memcpy(out, &size, sizeof(size));
+  std::memcpy(out + sizeof(size), data, size);
+  return out + sizeof(size) + size;
+}
+
+template <typename T>
+constexpr bool kIsSignedInt = std::is_integral<T>::value &&
+                              std::is_signed<T>::value &&
+                              !std::is_same<T, char>::value;
+
+template <typename T>
+constexpr bool kIsUnsignedInt =
+    std::is_integral<T>::value && std::is_unsigned<T>::value &&
+    !std::is_same<T, bool>::value && !std::is_same<T, char>::value;
+
+template <typename T>
+constexpr bool kIsChar = std::is_same<std::remove_cv_t<T>, char>::value;
+
+template <typename T>
+struct ArgCodec<T, std::enable_if_t<kIsSignedInt<T>>> {
+  static size_t Size(T) { return 1 + sizeof(int64_t); }
+  static char* Encode(char* out, T value) {
+    return EncodeValue(out, kIntArg, static_cast<int64_t>(value));
+  }
+};
+
+template <typename T>
+struct ArgCodec<T, std::enable_if_t<kIsUnsignedInt<T>>> {
+  static size_t Size(T) { return 1 + sizeof(uint64_t); }
+  static char* Encode(char* out, T value) {
+    return EncodeValue(out, kUintArg, static_cast<uint64_t>(value));
+  }
+};
+
+template <typename T>
+struct ArgCodec<T, std::enable_if_t<std::is_enum<T>::value>> {
+  static size_t Size(T) { return 1 + sizeof(int64_t); }
+  static char* Encode(char* out, T value) {
+    return EncodeValue(out, kIntArg, static_cast<int64_t>(value));
+  }
+};
+
+template <typename T>
+struct ArgCodec<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+  static size_t Size(T) { return 1 + sizeof(double); }
+  static char* Encode(char* out, T value) {
+    return EncodeValue(out, kDoubleArg, static_cast<double>(value));
+  }
+};
+
+template <>
+struct ArgCodec<bool> {
+  static size_t Size(bool) { return 1 + sizeof(uint64_t); }
+  static char* Encode(char* out, bool value) {
+    return EncodeValue(out, kBoolArg, static_cast<uint64_t>(value));
+  }
+};
+
+template <>
+struct ArgCodec<char> {
+  static size_t Size(char) { return 1 + sizeof(uint64_t); }
+  static char* Encode(char* out, char value) {
+    return EncodeValue(out, kCharArg, static_cast<uint64_t>(value));
+  }
+};
+
+template <>
+struct ArgCodec<const char*> {
+  static size_t Size(const char* value) {
+    return 1 + sizeof(uint32_t) + (value == nullptr ? 0 : std::strlen(value));
+  }
+  static char* Encode(char* out, const char* value) {
+    return value == nullptr
+               ? EncodeString(out, "", 0)
+               : EncodeString(out, value,
+                              static_cast<uint32_t>(std::strlen(value)));
+  }
+};
+
+template <>
+struct ArgCodec<char*> : public ArgCodec<const char*> {};
+
+template <>
+struct ArgCodec<std::string> {
+  static size_t Size(const std::string& value) {
+    return 1 + sizeof(uint32_t) + value.size();
+  }
+  static char* Encode(char* out, const std::string& value) {
+    return EncodeString(out, value.data(),
+                        static_cast<uint32_t>(value.size()));
+  }
+};
+
+template <>
+struct ArgCodec<std::string_view> {
+  static size_t Size(std::string_view value) {
+    return 1 + sizeof(uint32_t) + value.size();
+  }
+  static char* Encode(char* out, std::string_view value) {
+    return EncodeString(out, value.data(),
+                        static_cast<uint32_t>(value.size()));
+  }
+};
+
+template <typename T>
+struct ArgCodec<T*, std::enable_if_t<!kIsChar<T>>> {
+  static size_t Size(T*) { return 1 + sizeof(uint64_t); }
+  static char* Encode(char* out, T* value) {
+    auto address = reinterpret_cast<uintptr_t>(value);
+    return EncodeValue(out, kPointerArg, static_cast<uint64_t>(address));
+  }
+};
+
+// string literals and char arrays are logged as strings
+template <typename T>
+using ArgCodecOf = ArgCodec<typename std::decay<T>::type>;
+
+/**
+ * @brief Render `format`, replacing every "{}" with the next encoded
+ * argument in order; "{{" is a literal brace. Arguments without a "{}" are
+ * appended, separated by spaces.
+ *
+ * @return False if the arguments are truncated or malformed.
+ */
+bool RenderMessage(const std::string& format, const char* args,
+                   size_t args_size, std::string* message);
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_BINARY_LOG_FORMAT_H_
@@ -0,0 +1,375 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_logger.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <ctime>
+
+#include "cyber/common/global_data.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+namespace {
+
+constexpr uint32_t kMinRingSize = 4096;
+
+struct ThreadRingHolder {
+  ~ThreadRingHolder() {
+    if (ring != nullptr) {
+      ring->Retire();
+    }
+  }
+  std::shared_ptr<LogRing> ring;
+};
+
+thread_local ThreadRingHolder thread_ring;
+
+uint32_t RoundUpPowerOfTwo(uint32_t value) {
+  uint32_t result = kMinRingSize;
+  while (result < value && result < (1U << 30)) {
+    result <<= 1;
+  }
+  return result;
+}
+
+template <typename T>
+void WriteValue(FILE* file, T value) {
+  fwrite(&value, sizeof(value), 1, file);
+}
+
+void WriteString(FILE* file, const std::string& value) {
+  WriteValue(file, static_cast<uint32_t>(value.size()));
+  fwrite(value.data(), 1, value.size(), file);
+}
+
+std::string OutputPath(const std::string& module) {
+  char time_pid[64];
+  time_t now = time(nullptr);
+  struct tm tm_time;
+  localtime_r(&now, &tm_time);
+  snprintf(time_pid, sizeof(time_pid), "%04d%02d%02d-%02d%02d%02d.%d",
+           1900 + tm_time.tm_year, 1 + tm_time.tm_mon, tm_time.tm_mday,
+           tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec,
+           static_cast<int>(getpid()));
+  std::string path = module + ".log.BIN." + time_pid;
+  if (!FLAGS_log_dir.empty()) {
+    path = FLAGS_log_dir + "/" + path;
+  }
+  return path;
+}
+
+}  // namespace
+
+LogRing::LogRing(uint32_t size, pid_t tid)
+    : buffer_(new char[size]), size_(size), tid_(tid) {}
+
+char* LogRing::Reserve(uint32_t size) {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  uint32_t pos = static_cast<uint32_t>(head & (size_ - 1));
+  uint32_t to_end = size_ - pos;
+  uint64_t needed = size <= to_end ? size : to_end + size;
+  if (head + needed - cached_tail_ > size_) {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    if (head + needed - cached_tail_ > size_) {
+      return nullptr;
+    }
+  }
+  if (size > to_end) {
+    // records are multiples of 8, so there is room for the marker
+    const uint32_t marker = kWrapMarker;
+    std::memcpy(buffer_.get() + pos, &marker, sizeof(marker));
+    head += to_end;
+    pos = 0;
+  }
+  reserved_head_ = head + size;
+  return buffer_.get() + pos;
+}
+
+void LogRing::Commit() {
+  head_.store(reserved_head_, std::memory_order_release);
+}
+
+const char* LogRing::Front(uint32_t* size) {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  uint64_t head = head_.load(std::memory_order_acquire);
+  if (tail == head) {
+    return nullptr;
+  }
+  uint32_t pos = static_cast<uint32_t>(tail & (size_ - 1));
+  uint32_t record_size = 0;
+  std::memcpy(&record_size, buffer_.get() + pos, sizeof(record_size));
+  if (record_size == kWrapMarker) {
+    tail += size_ - pos;
+    tail_.store(tail, std::memory_order_release);
+    if (tail == head) {
+      return nullptr;
+    }
+    pos = 0;
+    std::memcpy(&record_size, buffer_.get(), sizeof(record_size));
+  }
+  *size = record_size;
+  return buffer_.get() + pos;
+}
+
+void LogRing::Pop(uint32_t size) {
+  tail_.store(tail_.load(std::memory_order_relaxed) + size,
+              std::memory_order_release);
+}
+
+BinaryLogger::BinaryLogger() {
+  conf_ = common::GlobalData::Instance()->Config().log_conf();
+  ring_size_ = RoundUpPowerOfTwo(conf_.ring_size());
+  if (conf_.binary()) {
+    enabled_.store(true, std::memory_order_release);
+    log_thread_ = std::thread(&BinaryLogger::RunThread, this);
+  }
+}
+
+uint32_t BinaryLogger::RegisterSite(Severity severity, const char* file,
+                                    int line, const char* module,
+                                    const char* format) {
+  std::lock_guard<std::mutex> lock(sites_mutex_);
+  sites_.emplace_back();
+  auto& site = sites_.back();
+  site.id = static_cast<uint32_t>(sites_.size() - 1);
+  site.severity = severity;
+  site.file = file;
+  site.line = line;
+  site.module = module;
+  site.format = format;
+  return site.id;
+}
+
+LogSite* BinaryLogger::Site(uint32_t site_id) {
+  std::lock_guard<std::mutex> lock(sites_mutex_);
+  return &sites_[site_id];
+}
+
+void BinaryLogger::LogText(LogSite* site, const std::string& args) {
+  std::string message;
+  RenderMessage(site->format, args.data(), args.size(), &message);
+  static const google::LogSeverity glog_severity[] = {
+      google::INFO, google::INFO, google::WARNING, google::ERROR};
+  google::LogMessage(site->file.c_str(), site->line,
+                     glog_severity[site->severity])
+          .stream()
+      << LEFT_BRACKET << site->module << RIGHT_BRACKET
+      << (site->severity == kDebug ? "[DEBUG] " : "") << message;
+}
+
+LogRing* BinaryLogger::ThreadRing() {
+  if (cyber_likely(thread_ring.ring != nullptr)) {
+    return thread_ring.ring.get();
+  }
+  auto tid = static_cast<pid_t>(syscall(SYS_gettid));
+  thread_ring.ring = std::make_shared<LogRing>(ring_size_, tid);
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  rings_.push_back(thread_ring.ring);
+  return thread_ring.ring.get();
+}
+
+char* BinaryLogger::Reserve(LogRing* ring, LogSite* site, uint32_t size) {
+  if (size <= ring->size() / 4 &&
+      conf_.overflow_policy() == proto::LogConf::BLOCK) {
+    while (enabled()) {
+      RequestDrain();
+      std::this_thread::yield();
+      char* record = ring->Reserve(size);
+      if (record != nullptr) {
+        return record;
+      }
+    }
+  }
+  site->dropped.fetch_add(1, std::memory_order_relaxed);
+  RequestDrain();
+  return nullptr;
+}
+
+void BinaryLogger::RequestDrain() {
+  if (!drain_requested_.exchange(true, std::memory_order_acq_rel)) {
+    drain_cv_.notify_one();
+  }
+}
+
+uint64_t BinaryLogger::DroppedCount() {
+  std::lock_guard<std::mutex> lock(sites_mutex_);
+  uint64_t dropped = 0;
+  for (auto& site : sites_) {
+    dropped += site.dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+void BinaryLogger::Flush() {
+  std::lock_guard<std::mutex> lock(drain_mutex_);
+  Drain();
+}
+
+void BinaryLogger::Shutdown() {
+  if (!enabled_.exchange(false)) {
+    return;
+  }
+  drain_cv_.notify_one();
+  if (log_thread_.joinable()) {
+    log_thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(drain_mutex_);
+  Drain();
+  for (auto& output : outputs_) {
+    if (output.second.file != nullptr) {
+      fclose(output.second.file);
+      output.second.file = nullptr;
+    }
+  }
+}
+
+void BinaryLogger::RunThread() {
+  const auto interval =
+      std::chrono::milliseconds(std::max(1U, conf_.flush_interval_ms()));
+  std::unique_lock<std::mutex> lock(drain_mutex_);
+  while (enabled()) {
+    drain_cv_.wait_for(lock, interval, [this]() {
+      return drain_requested_.load(std::memory_order_acquire) || !enabled();
+    });
+    drain_requested_.store(false, std::memory_order_release);
+    Drain();
+  }
+}
+
+void BinaryLogger::Drain() {
+  std::vector<std::shared_ptr<LogRing>> rings;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings = rings_;
+  }
+  RefreshSites();
+
+  for (auto& ring : rings) {
+    uint32_t size = 0;
+    const char* record = nullptr;
+    while ((record = ring->Front(&size)) != nullptr) {
+      uint32_t site_id = 0;
+      uint32_t length = 0;
+      std::memcpy(&site_id, record + 4, sizeof(site_id));
+      std::memcpy(&length, record + 16, sizeof(length));
+      if (site_id >= drain_sites_.size()) {
+        // registered after the refresh above
+        RefreshSites();
+      }
+      const LogSite* site = drain_sites_[site_id];
+      OutputFile* output = site_outputs_[site_id];
+      if (output == nullptr) {
+        output = Output(site->module);
+        site_outputs_[site_id] = output;
+      }
+      if (output->file != nullptr) {
+        WriteSite(*site, output);
+        WriteValue(output->file, static_cast<uint8_t>(kRecordEntry));
+        WriteValue(output->file, site_id);
+        WriteValue(output->file, static_cast<uint32_t>(ring->tid()));
+        fwrite(record + 8, 1, 8, output->file);
+        WriteValue(output->file, length);
+        fwrite(record + kRecordHeaderSize, 1, length, output->file);
+      }
+      ring->Pop(size);
+    }
+  }
+
+  for (auto site : drain_sites_) {
+    uint64_t dropped = site->dropped.load(std::memory_order_relaxed);
+    if (dropped == reported_drops_[site->id]) {
+      continue;
+    }
+    reported_drops_[site->id] = dropped;
+    OutputFile* output = site_outputs_[site->id];
+    if (output == nullptr) {
+      output = Output(site->module);
+      site_outputs_[site->id] = output;
+    }
+    if (output->file != nullptr) {
+      WriteSite(*site, output);
+      WriteValue(output->file, static_cast<uint8_t>(kDropEntry));
+      WriteValue(output->file, site->id);
+      WriteValue(output->file, dropped);
+    }
+  }
+
+  for (auto& output : outputs_) {
+    if (output.second.file != nullptr) {
+      fflush(output.second.file);
+    }
+  }
+
+  // rings of exited threads go once they are drained
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                              [](const std::shared_ptr<LogRing>& ring) {
+                                return ring->retired() && ring->Used() == 0;
+                              }),
+               rings_.end());
+}
+
+void BinaryLogger::RefreshSites() {
+  std::lock_guard<std::mutex> lock(sites_mutex_);
+  for (size_t i = drain_sites_.size(); i < sites_.size(); ++i) {
+    drain_sites_.push_back(&sites_[i]);
+    site_outputs_.push_back(nullptr);
+    reported_drops_.push_back(0);
+  }
+}
+
+BinaryLogger::OutputFile* BinaryLogger::Output(const std::string& module) {
+  auto itr = outputs_.find(module);
+  if (itr != outputs_.end()) {
+    return &itr->second;
+  }
+  auto& output = outputs_[module];
+  const std::string path = OutputPath(module);
+  output.file = fopen(path.c_str(), "wb");
+  if (output.file == nullptr) {
+    AERROR << "failed to open binary log " << path;
+    return &output;
+  }
+  fwrite(kBinaryLogMagic, 1, sizeof(kBinaryLogMagic), output.file);
+  return &output;
+}
+
+void BinaryLogger::WriteSite(const LogSite& site, OutputFile* output) {
+  if (output->written_sites.size() <= site.id) {
+    output->written_sites.resize(site.id + 1, false);
+  }
+  if (output->written_sites[site.id]) {
+    return;
+  }
+  output->written_sites[site.id] = true;
+  WriteValue(output->file, static_cast<uint8_t>(kSiteEntry));
+  WriteValue(output->file, site.id);
+  WriteValue(output->file, static_cast<uint8_t>(site.severity));
+  WriteValue(output->file, static_cast<uint32_t>(site.line));
+  WriteString(output->file, site.file);
+  WriteString(output->file, site.module);
+  WriteString(output->file, site.format);
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,258 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_LOGGER_BINARY_LOGGER_H_
+#define CYBER_LOGGER_BINARY_LOGGER_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/proto/log_conf.pb.h"
+
+#include "cyber/base/macros.h"
+#include "cyber/common/log.h"
+#include "cyber/common/macros.h"
+#include "cyber/logger/binary_log_format.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+enum Severity : uint8_t {
+  kDebug = 0,
+  kInfo = 1,
+  kWarn = 2,
+  kError = 3,
+};
+
+/**
+ * @brief A call site of a binary log macro. Registered once and never
+ * freed; the module it logs to is resolved when it registers.
+ */
+struct LogSite {
+  uint32_t id;
+  Severity severity;
+  std::string file;
+  int line;
+  std::string module;
+  std::string format;
+  // records of the site that found the ring of their thread full
+  std::atomic<uint64_t> dropped = {0};
+};
+
+/**
+ * @brief Byte ring of the binary log records of one thread. The thread
+ * reserves and commits records, the log thread reads and releases them, and
+ * neither takes a lock. A record never wraps around the end of the ring.
+ */
+class LogRing {
+ public:
+  LogRing(uint32_t size, pid_t tid);
+
+  /**
+   * @brief Room for a record of `size` bytes, a multiple of 8 of at most a
+   * quarter of the ring, or nullptr if the ring has no room right now.
+   */
+  char* Reserve(uint32_t size);
+  void Commit();
+
+  /**
+   * @brief The oldest committed record and its size, or nullptr.
+   */
+  const char* Front(uint32_t* size);
+  void Pop(uint32_t size);
+
+  uint64_t Used() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+  uint32_t size() const { return size_; }
+  pid_t tid() const { return tid_; }
+  bool retired() const { return retired_.load(std::memory_order_acquire); }
+  void Retire() { retired_.store(true, std::memory_order_release); }
+
+ private:
+  static constexpr uint32_t kWrapMarker = 0xFFFFFFFF;
+
+  std::unique_ptr<char[]> buffer_;
+  uint32_t size_;
+  pid_t tid_;
+  alignas(64) std::atomic<uint64_t> head_ = {0};
+  uint64_t reserved_head_ = 0;
+  uint64_t cached_tail_ = 0;
+  alignas(64) std::atomic<uint64_t> tail_ = {0};
+  std::atomic<bool> retired_ = {false};
+};
+
+/**
+ * @brief Backend of ABDEBUG, ABINFO, ABWARN and ABERROR. With
+ * LogConf.binary set a log call copies the id of its site, a timestamp and
+ * the raw bytes of its arguments into the ring of its thread and returns;
+ * the log thread writes the records into one binary file per module and
+ * formatting is left to binary_log_decoder. Otherwise the message is
+ * formatted right away and logged through glog.
+ */
+class BinaryLogger {
+ public:
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  uint32_t RegisterSite(Severity severity, const char* file, int line,
+                        const char* module, const char* format);
+
+  template <typename... Args>
+  void Log(uint32_t site_id, const Args&... args);
+
+  /**
+   * @brief Records dropped so far because the ring of their thread was full
+   * or they did not fit into it.
+   */
+  uint64_t DroppedCount();
+
+  /**
+   * @brief Write everything committed so far to the files.
+   */
+  void Flush();
+
+  void Shutdown();
+
+ private:
+  // u32 record size, u32 site, u64 time, u32 argument bytes, u32 padding
+  static constexpr uint32_t kRecordHeaderSize = 24;
+
+  struct OutputFile {
+    FILE* file = nullptr;
+    std::vector<bool> written_sites;
+  };
+
+  LogRing* ThreadRing();
+  char* Reserve(LogRing* ring, LogSite* site, uint32_t size);
+  void RequestDrain();
+  LogSite* Site(uint32_t site_id);
+  void LogText(LogSite* site, const std::string& args);
+  void RunThread();
+  void Drain();
+  void RefreshSites();
+  OutputFile* Output(const std::string& module);
+  void WriteSite(const LogSite& site, OutputFile* output);
+
+  std::atomic<bool> enabled_ = {false};
+  proto::LogConf conf_;
+  uint32_t ring_size_ = 0;
+
+  std::mutex sites_mutex_;
+  std::deque<LogSite> sites_;
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<LogRing>> rings_;
+
+  std::thread log_thread_;
+  std::mutex drain_mutex_;
+  std::condition_variable drain_cv_;
+  std::atomic<bool> drain_requested_ = {false};
+  // owned by whoever holds drain_mutex_
+  std::vector<LogSite*> drain_sites_;
+  std::vector<OutputFile*> site_outputs_;
+  std::vector<uint64_t> reported_drops_;
+  std::unordered_map<std::string, OutputFile> outputs_;
+
+  DECLARE_SINGLETON(BinaryLogger)
+};
+
+template <typename... Args>
+void BinaryLogger::Log(uint32_t site_id, const Args&... args) {
+  const size_t args_size = (size_t{0} + ... + ArgCodecOf<Args>::Size(args));
+  if (cyber_unlikely(!enabled())) {
+    std::string encoded(args_size, '\0');
+    char* out = &encoded[0];
+    ((out = ArgCodecOf<Args>::Encode(out, args)), ...);
+    LogText(Site(site_id), encoded);
+    return;
+  }
+
+  const size_t size = (kRecordHeaderSize + args_size + 7) & ~size_t{7};
+  LogRing* ring = ThreadRing();
+  char* record = nullptr;
+  if (size <= ring->size() / 4) {
+    record = ring->Reserve(static_cast<uint32_t>(size));
+  }
+  if (record == nullptr) {
+    record = Reserve(ring, Site(site_id), static_cast<uint32_t>(size));
+    if (record == nullptr) {
+      return;
+    }
+  }
+  const uint32_t header[2] = {static_cast<uint32_t>(size), site_id};
+  const uint64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  const uint32_t length = static_cast<uint32_t>(args_size);
+  std::memcpy(record, header, sizeof(header));
+  std::memcpy(record + 8, &now_ns, sizeof(now_ns));
+  std::memcpy(record + 16, &length, sizeof(length));
+  char* out = record + kRecordHeaderSize;
+  ((out = ArgCodecOf<Args>::Encode(out, args)), ...);
+  ring->Commit();
+  if (ring->Used() > ring->size() / 2) {
+    RequestDrain();
+  }
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#define ABINARY_LOG_IS_ON_kDebug VLOG_IS_ON(4)
+#define ABINARY_LOG_IS_ON_kInfo (FLAGS_minloglevel <= google::INFO)
+#define ABINARY_LOG_IS_ON_kWarn (FLAGS_minloglevel <= google::WARNING)
+#define ABINARY_LOG_IS_ON_kError (FLAGS_minloglevel <= google::ERROR)
+
+/**
+ * Log `format` with every "{}" replaced by the next argument, e.g.
+ *   ABINFO("planned {} points in {} ms", points.size(), elapsed_ms);
+ * The site, and with it the module, is registered on its first call.
+ */
+#define ALOG_BINARY(severity, format, ...)                                 \
+  do {                                                                     \
+    if (ABINARY_LOG_IS_ON_##severity) {                                    \
+      static const uint32_t cyber_binary_log_site =                        \
+          ::apollo::cyber::logger::BinaryLogger::Instance()->RegisterSite( \
+              ::apollo::cyber::logger::severity, __FILE__, __LINE__,       \
+              MODULE_NAME, format);                                        \
+      ::apollo::cyber::logger::BinaryLogger::Instance()->Log(              \
+          cyber_binary_log_site, ##__VA_ARGS__);                           \
+    }                                                                      \
+  } while (0)
+
+#define ABDEBUG(format, ...) ALOG_BINARY(kDebug, format, ##__VA_ARGS__)
+#define ABINFO(format, ...) ALOG_BINARY(kInfo, format, ##__VA_ARGS__)
+#define ABWARN(format, ...) ALOG_BINARY(kWarn, format, ##__VA_ARGS__)
+#define ABERROR(format, ...) ALOG_BINARY(kError, format, ##__VA_ARGS__)
+
+#endif  // CYBER_LOGGER_BINARY_LOGGER_H_
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_logger.h"
+
+#include <dirent.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/logger/binary_log_decoder.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+template <typename... Args>
+std::string Render(const std::string& format, const Args&... args) {
+  std::string encoded((size_t{0} + ... + ArgCodecOf<Args>::Size(args)), '\0');
+  char* out = &encoded[0];
+  ((out = ArgCodecOf<Args>::Encode(out, args)), ...);
+  std::string message;
+  EXPECT_TRUE(RenderMessage(format, encoded.data(), encoded.size(), &message));
+  return message;
+}
+
+TEST(BinaryLoggerTest, render) {
+  enum Mode { kAuto = 3 };
+  const std::string name = "lidar";
+  EXPECT_EQ("lidar top: 120000 points in 1.5 ms, mode 3 x 1 {}",
+            Render("{} {}: {} points in {} ms, mode {} {} {} {{}", name,
+                   "top", uint64_t{120000}, 1.5, kAuto, 'x', true));
+  EXPECT_EQ("-7 trailing", Render("{}", int8_t{-7}, std::string("trailing")));
+  EXPECT_EQ("{} {}", Render("{} {}"));
+}
+
+TEST(BinaryLoggerTest, ring) {
+  LogRing ring(64, 1);
+  uint32_t size = 0;
+  EXPECT_EQ(nullptr, ring.Front(&size));
+
+  // 24 + 24 fit, the third record would overwrite the first
+  for (uint32_t i = 0; i < 2; ++i) {
+    char* record = ring.Reserve(24);
+    ASSERT_NE(nullptr, record);
+    uint32_t header[2] = {24, i};
+    std::memcpy(record, header, sizeof(header));
+    ring.Commit();
+  }
+  EXPECT_EQ(nullptr, ring.Reserve(24));
+
+  const char* record = ring.Front(&size);
+  ASSERT_NE(nullptr, record);
+  EXPECT_EQ(24U, size);
+  ring.Pop(size);
+
+  // 16 bytes are left before the end, the record goes to the start
+  char* wrapped = ring.Reserve(24);
+  ASSERT_NE(nullptr, wrapped);
+  uint32_t header[2] = {24, 2};
+  std::memcpy(wrapped, header, sizeof(header));
+  ring.Commit();
+
+  for (uint32_t i = 1; i < 3; ++i) {
+    record = ring.Front(&size);
+    ASSERT_NE(nullptr, record);
+    uint32_t site = 0;
+    std::memcpy(&site, record + 4, sizeof(site));
+    EXPECT_EQ(i, site);
+    ring.Pop(size);
+  }
+  EXPECT_EQ(nullptr, ring.Front(&size));
+  EXPECT_EQ(0U, ring.Used());
+}
+
+TEST(BinaryLoggerTest, binary_log) {
+  char dir_template[] = "/tmp/binary_logger_test.XXXXXX";
+  const std::string dir = mkdtemp(dir_template);
+  ASSERT_EQ(0, system(("mkdir -p " + dir + "/conf").c_str()));
+  std::ofstream(dir + "/conf/cyber.pb.conf")
+      << "log_conf { binary: true ring_size: 4096 }\n";
+  setenv("CYBER_PATH", dir.c_str(), 1);
+  FLAGS_log_dir = dir;
+
+  auto logger = BinaryLogger::Instance();
+  ASSERT_TRUE(logger->enabled());
+  for (int i = 0; i < 3; ++i) {
+    ABINFO("frame {} of {}", i, std::string("camera"));
+  }
+  ABERROR("no {}", "calibration");
+  // more than a quarter of the ring
+  ABWARN("{}", std::string(2048, 'x'));
+  logger->Flush();
+  EXPECT_EQ(1U, logger->DroppedCount());
+  logger->Shutdown();
+
+  std::vector<std::string> files;
+  DIR* entries = opendir(dir.c_str());
+  ASSERT_NE(nullptr, entries);
+  while (auto entry = readdir(entries)) {
+    std::string name = entry->d_name;
+    if (name.find(".log.BIN.") != std::string::npos) {
+      files.push_back(dir + "/" + name);
+    }
+  }
+  closedir(entries);
+  ASSERT_EQ(1U, files.size());
+
+  std::ifstream in(files[0], std::ios::binary);
+  std::ostringstream text;
+  BinaryLogDecoder decoder;
+  ASSERT_TRUE(decoder.Decode(&in, &text));
+  const std::string decoded = text.str();
+  EXPECT_NE(std::string::npos, decoded.find("binary_logger_test.cc:"));
+  EXPECT_NE(std::string::npos, decoded.find("] frame 2 of camera\n"));
+  EXPECT_NE(std::string::npos, decoded.find("] no calibration\n"));
+  auto line_begin = decoded.rfind('\n', decoded.find("] no calibration"));
+  EXPECT_EQ('E', decoded[line_begin == std::string::npos ? 0 : line_begin + 1]);
+  EXPECT_NE(std::string::npos, decoded.find("--- 1 records of"));
+  system(("rm -rf " + dir).c_str());
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
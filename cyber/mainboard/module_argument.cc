@@ -19,6 +19,9 @@
 #include <getopt.h>
 #include <libgen.h>
 
+#include <algorithm>
+#include <cstdlib>
+
 using apollo::cyber::common::GlobalData;
 
 namespace apollo {
@@ -38,6 +41,10 @@ void ModuleArgument::DisplayUsage() {
            "plugin\n"
         << "    --disable_plugin_autoload : default enable autoload "
            "mode of plugins, use disable_plugin_autoload to ingore autoload\n"
+        << "    --init_threads=N: initialize up to N independent components "
+           "concurrently, default 1. With N > 1 the flag files of all "
+           "components are applied before the first Init(), so a component "
+           "also sees the flags of the components after it\n"
         << "Example:\n"
         << "    " << binary_name_ << " -h\n"
         << "    " << binary_name_ << " -d dag_conf_file1 -d dag_conf_file2 "
@@ -78,6 +85,7 @@ void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
       {"plugin", required_argument, nullptr, ARGS_OPT_CODE_PLUGIN},
       {"disable_plugin_autoload", no_argument, nullptr,
        ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD},
+      {"init_threads", required_argument, nullptr, ARGS_OPT_CODE_INIT_THREADS},
       {NULL, no_argument, nullptr, 0}};
 
   // log command for info
@@ -122,6 +130,10 @@ void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
       case ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD:
           disable_plugin_autoload_ = true;
         break;
+      case ARGS_OPT_CODE_INIT_THREADS:
+        init_threads_ = static_cast<uint32_t>(
+            std::max(1, std::atoi(optarg)));
+        break;
       case 'h':
         DisplayUsage();
         exit(0);
@@ -34,6 +34,7 @@ static const char DEFAULT_sched_name_[] = "CYBER_DEFAULT";
 // code for command line arguments without short parameters
 static const int ARGS_OPT_CODE_PLUGIN = 1001;
 static const int ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD = 1002;
+static const int ARGS_OPT_CODE_INIT_THREADS = 1003;
 
 class ModuleArgument {
  public:
@@ -48,6 +49,7 @@ class ModuleArgument {
   const std::list<std::string>& GetDAGConfList() const;
   const std::list<std::string>& GetPluginDescriptionList() const;
   const bool& GetDisablePluginsAutoLoad() const;
+  uint32_t GetInitThreads() const;
 
  private:
   std::list<std::string> dag_conf_list_;
@@ -56,6 +58,7 @@ class ModuleArgument {
   std::string process_group_;
   std::string sched_name_;
   bool disable_plugin_autoload_ = false;
+  uint32_t init_threads_ = 1;
 };
 
 inline const std::string& ModuleArgument::GetBinaryName() const {
@@ -83,6 +86,10 @@ inline const bool& ModuleArgument::GetDisablePluginsAutoLoad() const {
   return disable_plugin_autoload_;
 }
 
+inline uint32_t ModuleArgument::GetInitThreads() const {
+  return init_threads_;
+}
+
 }  // namespace mainboard
 }  // namespace cyber
 }  // namespace apollo
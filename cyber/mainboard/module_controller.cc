@@ -27,6 +27,22 @@ namespace apollo {
 namespace cyber {
 namespace mainboard {
 
+namespace {
+
+std::vector<std::string> ReaderChannels(const proto::ComponentConfig& config) {
+  std::vector<std::string> channels;
+  for (auto& reader : config.readers()) {
+    channels.push_back(reader.channel());
+  }
+  return channels;
+}
+
+std::vector<std::string> ReaderChannels(const proto::TimerComponentConfig&) {
+  return {};
+}
+
+}  // namespace
+
 void ModuleController::Clear() {
   for (auto& component : component_list_) {
     component->Shutdown();
@@ -70,6 +86,63 @@ bool ModuleController::LoadAll() {
       return false;
     }
   }
+
+  // with one init thread every component was initialized right after it
+  // was created, as it always used to be
+  if (args_.GetInitThreads() <= 1) {
+    return true;
+  }
+
+  // libraries are loaded one by one, the class loader holds a global lock
+  // while it registers the classes of a library; Init() of independent
+  // components may run concurrently
+  if (!startup_graph_.Resolve()) {
+    return false;
+  }
+  bool success = startup_graph_.Run(args_.GetInitThreads());
+  for (size_t i = 0; i < startup_graph_.Size(); ++i) {
+    if (startup_graph_.At(i).initialized) {
+      component_list_.emplace_back(std::move(startup_components_[i]));
+    }
+  }
+  startup_components_.clear();
+  AINFO << startup_graph_.Report();
+  return success;
+}
+
+template <typename ComponentInfoT>
+bool ModuleController::AddComponent(const ComponentInfoT& info) {
+  std::shared_ptr<ComponentBase> base =
+      class_loader_manager_.CreateClassObj<ComponentBase>(info.class_name());
+  if (base == nullptr) {
+    return false;
+  }
+  auto config = info.config();
+  if (args_.GetInitThreads() <= 1) {
+    if (!base->Initialize(config)) {
+      return false;
+    }
+    component_list_.emplace_back(std::move(base));
+    return true;
+  }
+
+  // gflags are process wide and not safe to set while other components
+  // read them in Init(), so flag files are applied here, one by one in DAG
+  // order, before any component is initialized. Unlike the serial path, an
+  // earlier component thus sees the flags of the later flag files too.
+  ComponentBase::LoadFlagFile(config.flag_file_path());
+  config.clear_flag_file_path();
+  StartupGraph::Component component;
+  component.name = info.config().name();
+  component.class_name = info.class_name();
+  component.depends_on.assign(info.depends_on().begin(),
+                              info.depends_on().end());
+  component.reader_channels = ReaderChannels(info.config());
+  component.writer_channels.assign(info.writer_channels().begin(),
+                                   info.writer_channels().end());
+  component.init = [base, config]() { return base->Initialize(config); };
+  startup_graph_.AddComponent(std::move(component));
+  startup_components_.emplace_back(std::move(base));
   return true;
 }
 
@@ -87,23 +160,15 @@ bool ModuleController::LoadModule(const DagConfig& dag_config) {
     class_loader_manager_.LoadLibrary(load_path);
 
     for (auto& component : module_config.components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
+      if (!AddComponent(component)) {
         return false;
       }
-      component_list_.emplace_back(std::move(base));
     }
 
     for (auto& component : module_config.timer_components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
+      if (!AddComponent(component)) {
         return false;
       }
-      component_list_.emplace_back(std::move(base));
     }
   }
   return true;
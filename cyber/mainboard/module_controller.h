@@ -25,6 +25,7 @@
 #include "cyber/class_loader/class_loader_manager.h"
 #include "cyber/component/component.h"
 #include "cyber/mainboard/module_argument.h"
+#include "cyber/mainboard/startup_graph.h"
 
 namespace apollo {
 namespace cyber {
@@ -44,6 +45,8 @@ class ModuleController {
  private:
   bool LoadModule(const std::string& path);
   bool LoadModule(const DagConfig& dag_config);
+  template <typename ComponentInfoT>
+  bool AddComponent(const ComponentInfoT& info);
   int GetComponentNum(const std::string& path);
   int total_component_nums = 0;
   bool has_timer_component = false;
@@ -51,6 +54,9 @@ class ModuleController {
   ModuleArgument args_;
   class_loader::ClassLoaderManager class_loader_manager_;
   std::vector<std::shared_ptr<ComponentBase>> component_list_;
+  // created but not initialized yet, indexed as in startup_graph_
+  std::vector<std::shared_ptr<ComponentBase>> startup_components_;
+  StartupGraph startup_graph_;
 };
 
 inline ModuleController::ModuleController(const ModuleArgument& args)
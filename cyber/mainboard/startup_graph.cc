@@ -0,0 +1,288 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/mainboard/startup_graph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+namespace {
+
+double ToMs(uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+}  // namespace
+
+size_t StartupGraph::AddComponent(Component component) {
+  components_.emplace_back(std::move(component));
+  return components_.size() - 1;
+}
+
+bool StartupGraph::Resolve() {
+  std::unordered_map<std::string, size_t> index_of_name;
+  std::unordered_map<std::string, std::vector<size_t>> writers_of_channel;
+  for (size_t i = 0; i < components_.size(); ++i) {
+    if (!index_of_name.emplace(components_[i].name, i).second) {
+      AWARN << "component name [" << components_[i].name
+            << "] is not unique, depends_on refers to the first one";
+    }
+    for (auto& channel : components_[i].writer_channels) {
+      writers_of_channel[channel].push_back(i);
+    }
+  }
+
+  for (size_t i = 0; i < components_.size(); ++i) {
+    auto& component = components_[i];
+    std::set<size_t> deps;
+    for (auto& name : component.depends_on) {
+      auto itr = index_of_name.find(name);
+      if (itr == index_of_name.end() || itr->second == i) {
+        AERROR << "component [" << component.name
+               << "] depends on unknown component [" << name << "]";
+        return false;
+      }
+      deps.insert(itr->second);
+    }
+    for (auto& channel : component.reader_channels) {
+      auto itr = writers_of_channel.find(channel);
+      if (itr == writers_of_channel.end()) {
+        continue;
+      }
+      for (auto writer : itr->second) {
+        if (writer < i) {
+          deps.insert(writer);
+        }
+      }
+    }
+    component.deps.assign(deps.begin(), deps.end());
+    component.dependents.clear();
+  }
+  for (size_t i = 0; i < components_.size(); ++i) {
+    for (auto dep : components_[i].deps) {
+      components_[dep].dependents.push_back(i);
+    }
+  }
+
+  // Kahn's algorithm, whatever is left over is on a cycle
+  std::vector<size_t> pending(components_.size());
+  std::vector<size_t> ready;
+  for (size_t i = 0; i < components_.size(); ++i) {
+    pending[i] = components_[i].deps.size();
+    if (pending[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+  size_t sorted = 0;
+  while (!ready.empty()) {
+    size_t index = ready.back();
+    ready.pop_back();
+    ++sorted;
+    for (auto dependent : components_[index].dependents) {
+      if (--pending[dependent] == 0) {
+        ready.push_back(dependent);
+      }
+    }
+  }
+  if (sorted != components_.size()) {
+    std::string cycle;
+    for (size_t i = 0; i < components_.size(); ++i) {
+      if (pending[i] > 0) {
+        cycle += " " + components_[i].name;
+      }
+    }
+    AERROR << "components depend on each other in a cycle:" << cycle;
+    return false;
+  }
+  return true;
+}
+
+bool StartupGraph::Run(uint32_t threads) {
+  threads_ = std::max(threads, 1U);
+  std::mutex mutex;
+  std::condition_variable cv;
+  // started in the order they were added, as far as dependencies allow
+  std::set<size_t> ready;
+  std::vector<size_t> pending(components_.size());
+  for (size_t i = 0; i < components_.size(); ++i) {
+    pending[i] = components_[i].deps.size();
+    if (pending[i] == 0) {
+      ready.insert(i);
+    }
+  }
+  size_t running = 0;
+  bool failed = false;
+  const uint64_t start_ns = Time::MonoTime().ToNanosecond();
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [&]() { return !ready.empty() || running == 0 || failed; });
+      if (failed || ready.empty()) {
+        break;
+      }
+      auto& component = components_[*ready.begin()];
+      ready.erase(ready.begin());
+      ++running;
+      component.started = true;
+      component.begin_ns = Time::MonoTime().ToNanosecond() - start_ns;
+      lock.unlock();
+
+      bool ok = component.init();
+      // let go of what init holds, a component that failed with it
+      component.init = nullptr;
+
+      lock.lock();
+      component.end_ns = Time::MonoTime().ToNanosecond() - start_ns;
+      component.initialized = ok;
+      --running;
+      if (!ok) {
+        AERROR << "component [" << component.name << "] failed to initialize";
+        failed = true;
+      } else {
+        for (auto dependent : component.dependents) {
+          if (--pending[dependent] == 0) {
+            ready.insert(dependent);
+          }
+        }
+      }
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  size_t thread_num = std::min<size_t>(threads_, components_.size());
+  for (size_t i = 1; i < thread_num; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  total_ns_ = Time::MonoTime().ToNanosecond() - start_ns;
+  return !failed;
+}
+
+std::vector<size_t> StartupGraph::CriticalPath() const {
+  const size_t size = components_.size();
+  std::vector<uint64_t> path_ns(size, 0);
+  std::vector<size_t> prev(size, size);
+  std::vector<size_t> pending(size);
+  std::vector<size_t> ready;
+  for (size_t i = 0; i < size; ++i) {
+    pending[i] = components_[i].deps.size();
+    if (pending[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+  size_t last = size;
+  while (!ready.empty()) {
+    size_t index = ready.back();
+    ready.pop_back();
+    auto& component = components_[index];
+    path_ns[index] +=
+        component.started ? component.end_ns - component.begin_ns : 0;
+    if (last == size || path_ns[index] > path_ns[last]) {
+      last = index;
+    }
+    for (auto dependent : component.dependents) {
+      if (prev[dependent] == size || path_ns[index] > path_ns[dependent]) {
+        path_ns[dependent] = path_ns[index];
+        prev[dependent] = index;
+      }
+      if (--pending[dependent] == 0) {
+        ready.push_back(dependent);
+      }
+    }
+  }
+
+  std::vector<size_t> path;
+  for (size_t index = last; index != size; index = prev[index]) {
+    path.push_back(index);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+std::string StartupGraph::Report() const {
+  std::vector<size_t> order;
+  uint64_t init_ns = 0;
+  for (size_t i = 0; i < components_.size(); ++i) {
+    order.push_back(i);
+    if (components_[i].started) {
+      init_ns += components_[i].end_ns - components_[i].begin_ns;
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    auto& lhs = components_[a];
+    auto& rhs = components_[b];
+    return lhs.started != rhs.started ? lhs.started
+                                      : lhs.begin_ns < rhs.begin_ns;
+  });
+  auto path = CriticalPath();
+  std::set<size_t> on_path(path.begin(), path.end());
+
+  std::ostringstream report;
+  report << std::fixed << std::setprecision(1) << "startup of "
+         << components_.size() << " components on " << threads_
+         << " threads took " << ToMs(total_ns_) << " ms, " << ToMs(init_ns)
+         << " ms of init:\n"
+         << "  start ms   init ms  component\n";
+  for (auto index : order) {
+    auto& component = components_[index];
+    if (component.started) {
+      report << std::setw(10) << ToMs(component.begin_ns) << std::setw(10)
+             << ToMs(component.end_ns - component.begin_ns);
+    } else {
+      report << std::setw(20) << "not started";
+    }
+    report << (on_path.count(index) > 0 ? "  * " : "    ") << component.name
+           << " (" << component.class_name << ")";
+    if (component.started && !component.initialized) {
+      report << " failed";
+    }
+    for (size_t i = 0; i < component.deps.size(); ++i) {
+      report << (i == 0 ? " <- " : ", ") << components_[component.deps[i]].name;
+    }
+    report << "\n";
+  }
+
+  uint64_t path_ns = 0;
+  std::string names;
+  for (auto index : path) {
+    auto& component = components_[index];
+    path_ns += component.started ? component.end_ns - component.begin_ns : 0;
+    names += (names.empty() ? "" : " -> ") + component.name;
+  }
+  report << "critical path " << ToMs(path_ns) << " ms: " << names;
+  return report.str();
+}
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
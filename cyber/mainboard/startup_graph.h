@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_MAINBOARD_STARTUP_GRAPH_H_
+#define CYBER_MAINBOARD_STARTUP_GRAPH_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+/**
+ * @brief The components of a mainboard process and the order their Init()
+ * may run in. A component waits for the components it depends on, either
+ * declared by name or inferred: a component that reads a channel another
+ * component, listed before it, declares to write waits for that one.
+ * Writers listed after their readers are not waited for, so that the
+ * feedback loops of a pipeline do not turn into cycles.
+ *
+ * Run() starts independent components concurrently on a bounded number of
+ * threads, the calling thread being one of them, and records when each
+ * of them started and finished initializing.
+ */
+class StartupGraph {
+ public:
+  struct Component {
+    std::string name;
+    std::string class_name;
+    std::vector<std::string> depends_on;
+    std::vector<std::string> reader_channels;
+    std::vector<std::string> writer_channels;
+    std::function<bool()> init;
+
+    // filled by Resolve()
+    std::vector<size_t> deps;
+    std::vector<size_t> dependents;
+    // filled by Run(), in ns since its start
+    uint64_t begin_ns = 0;
+    uint64_t end_ns = 0;
+    bool started = false;
+    bool initialized = false;
+  };
+
+  /**
+   * @brief Add a component, returns its index.
+   */
+  size_t AddComponent(Component component);
+
+  /**
+   * @brief Turn names and channels into dependencies, fails on unknown
+   * names and on cycles.
+   */
+  bool Resolve();
+
+  /**
+   * @brief Initialize all components, with up to `threads` at a time.
+   * After the first failure no component is started anymore.
+   */
+  bool Run(uint32_t threads);
+
+  /**
+   * @brief The chain of dependencies with the longest total init duration,
+   * which no number of threads makes start faster.
+   */
+  std::vector<size_t> CriticalPath() const;
+
+  /**
+   * @brief Per-component start and init duration of the last Run(), with
+   * the critical path marked.
+   */
+  std::string Report() const;
+
+  size_t Size() const { return components_.size(); }
+  const Component& At(size_t index) const { return components_[index]; }
+
+ private:
+  std::vector<Component> components_;
+  uint32_t threads_ = 1;
+  uint64_t total_ns_ = 0;
+};
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_MAINBOARD_STARTUP_GRAPH_H_
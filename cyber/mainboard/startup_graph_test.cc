@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/mainboard/startup_graph.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+StartupGraph::Component Component(const std::string& name,
+                                  std::vector<std::string> depends_on = {},
+                                  std::vector<std::string> readers = {},
+                                  std::vector<std::string> writers = {},
+                                  int init_ms = 0) {
+  StartupGraph::Component component;
+  component.name = name;
+  component.class_name = name + "Component";
+  component.depends_on = std::move(depends_on);
+  component.reader_channels = std::move(readers);
+  component.writer_channels = std::move(writers);
+  component.init = [init_ms]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(init_ms));
+    return true;
+  };
+  return component;
+}
+
+TEST(StartupGraphTest, resolve) {
+  StartupGraph graph;
+  graph.AddComponent(Component("camera", {}, {"/planning"}, {"/obstacles"}));
+  graph.AddComponent(Component("lidar", {}, {}, {"/obstacles"}));
+  graph.AddComponent(Component("map", {"lidar"}));
+  graph.AddComponent(Component("planning", {}, {"/obstacles"}, {"/planning"}));
+  ASSERT_TRUE(graph.Resolve());
+
+  EXPECT_TRUE(graph.At(0).deps.empty());  // planning is listed after it
+  EXPECT_TRUE(graph.At(1).deps.empty());
+  EXPECT_EQ(std::vector<size_t>({1}), graph.At(2).deps);
+  EXPECT_EQ(std::vector<size_t>({0, 1}), graph.At(3).deps);
+  EXPECT_EQ(std::vector<size_t>({2, 3}), graph.At(1).dependents);
+
+  StartupGraph unknown;
+  unknown.AddComponent(Component("camera", {"radar"}));
+  EXPECT_FALSE(unknown.Resolve());
+
+  StartupGraph cycle;
+  cycle.AddComponent(Component("camera", {"lidar"}));
+  cycle.AddComponent(Component("lidar", {"camera"}));
+  EXPECT_FALSE(cycle.Resolve());
+}
+
+TEST(StartupGraphTest, run) {
+  StartupGraph graph;
+  std::atomic<int> started = {0};
+  // returns only once both of them started
+  auto independent = [&started]() {
+    started++;
+    for (int i = 0; i < 1000 && started < 2; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return started >= 2;
+  };
+  auto camera = Component("camera", {}, {}, {}, 0);
+  camera.init = independent;
+  auto lidar = Component("lidar", {}, {}, {}, 0);
+  lidar.init = independent;
+  graph.AddComponent(std::move(camera));
+  graph.AddComponent(std::move(lidar));
+  graph.AddComponent(Component("fusion", {"camera", "lidar"}, {}, {}, 5));
+  ASSERT_TRUE(graph.Resolve());
+  ASSERT_TRUE(graph.Run(4));
+
+  for (size_t i = 0; i < graph.Size(); ++i) {
+    EXPECT_TRUE(graph.At(i).initialized);
+  }
+  EXPECT_GE(graph.At(2).begin_ns, graph.At(0).end_ns);
+  EXPECT_GE(graph.At(2).begin_ns, graph.At(1).end_ns);
+}
+
+TEST(StartupGraphTest, failure) {
+  StartupGraph graph;
+  auto camera = Component("camera");
+  camera.init = []() { return false; };
+  graph.AddComponent(std::move(camera));
+  graph.AddComponent(Component("fusion", {"camera"}));
+  ASSERT_TRUE(graph.Resolve());
+  EXPECT_FALSE(graph.Run(1));
+  EXPECT_TRUE(graph.At(0).started);
+  EXPECT_FALSE(graph.At(0).initialized);
+  EXPECT_FALSE(graph.At(1).started);
+}
+
+TEST(StartupGraphTest, critical_path) {
+  StartupGraph graph;
+  graph.AddComponent(Component("map", {}, {}, {}, 40));
+  graph.AddComponent(Component("lidar", {}, {}, {}, 5));
+  graph.AddComponent(Component("localization", {"map", "lidar"}, {}, {}, 5));
+  graph.AddComponent(Component("camera", {}, {}, {}, 20));
+  ASSERT_TRUE(graph.Resolve());
+  ASSERT_TRUE(graph.Run(4));
+
+  EXPECT_EQ(std::vector<size_t>({0, 2}), graph.CriticalPath());
+  const std::string report = graph.Report();
+  EXPECT_NE(std::string::npos, report.find("map -> localization")) << report;
+  EXPECT_NE(std::string::npos,
+            report.find("localization (localizationComponent) <- map, lidar"))
+      << report;
+}
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,177 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_MESSAGE_MESSAGE_ALLOCATOR_H_
+#define CYBER_MESSAGE_MESSAGE_ALLOCATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message.h"
+
+#include "cyber/proto/message_allocator_conf.pb.h"
+
+#include "cyber/base/concurrent_object_pool.h"
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+using apollo::cyber::proto::MessageAllocatorConf;
+
+/**
+ * @brief Allocates the messages a channel receives, before they are parsed.
+ * A message allocated from a pool goes back to it when its last shared_ptr
+ * drops; while the pool is exhausted messages come from the heap.
+ *
+ * POOL messages are handed out again as they were released, so the strings
+ * and repeated fields of a protobuf message keep their memory for the next
+ * parse. ARENA messages are created on a protobuf arena that is reset when
+ * the message is released, and that keeps its first block, so parsing does
+ * not touch the heap as long as the message fits into it.
+ */
+template <typename MessageT>
+class MessageAllocator {
+ public:
+  using MessagePtr = std::shared_ptr<MessageT>;
+
+  explicit MessageAllocator(const MessageAllocatorConf& conf);
+
+  /**
+   * @brief The allocator of channel `channel_id`, created with `conf` if the
+   * channel has none yet.
+   */
+  static std::shared_ptr<MessageAllocator> ForChannel(
+      uint64_t channel_id, const MessageAllocatorConf& conf);
+
+  MessagePtr Allocate();
+
+  MessageAllocatorConf::Policy policy() const { return policy_; }
+
+ private:
+  static constexpr bool kArenaAllocatable =
+      std::is_base_of<google::protobuf::Message, MessageT>::value;
+
+  // an arena whose first block lives as long as it does
+  struct ArenaSlot {
+    explicit ArenaSlot(uint32_t block_size)
+        : block(new char[block_size]),
+          arena(Options(block.get(), block_size)) {}
+
+    static google::protobuf::ArenaOptions Options(char* block,
+                                                  uint32_t block_size) {
+      google::protobuf::ArenaOptions options;
+      options.initial_block = block;
+      options.initial_block_size = block_size;
+      return options;
+    }
+
+    std::unique_ptr<char[]> block;
+    google::protobuf::Arena arena;
+  };
+
+  template <typename T = MessageT>
+  typename std::enable_if<std::is_base_of<google::protobuf::Message, T>::value,
+                          MessagePtr>::type
+  AllocateFromArena() {
+    auto slot = arena_pool_->GetObject();
+    if (slot == nullptr) {
+      return nullptr;
+    }
+    T* msg = google::protobuf::Arena::CreateMessage<T>(&slot->arena);
+    return MessagePtr(msg, [slot](T*) mutable {
+      slot->arena.Reset();
+      slot.reset();
+    });
+  }
+
+  template <typename T = MessageT>
+  typename std::enable_if<!std::is_base_of<google::protobuf::Message, T>::value,
+                          MessagePtr>::type
+  AllocateFromArena() {
+    return nullptr;
+  }
+
+  MessageAllocatorConf::Policy policy_;
+  std::shared_ptr<base::CCObjectPool<MessageT>> message_pool_ = nullptr;
+  std::shared_ptr<base::CCObjectPool<ArenaSlot>> arena_pool_ = nullptr;
+};
+
+template <typename MessageT>
+MessageAllocator<MessageT>::MessageAllocator(const MessageAllocatorConf& conf)
+    : policy_(conf.policy()) {
+  if (policy_ == MessageAllocatorConf::ARENA && !kArenaAllocatable) {
+    policy_ = MessageAllocatorConf::POOL;
+  }
+  if (conf.pool_size() == 0) {
+    policy_ = MessageAllocatorConf::HEAP;
+  }
+
+  if (policy_ == MessageAllocatorConf::POOL) {
+    message_pool_ =
+        std::make_shared<base::CCObjectPool<MessageT>>(conf.pool_size());
+    message_pool_->ConstructAll();
+  } else if (policy_ == MessageAllocatorConf::ARENA) {
+    arena_pool_ =
+        std::make_shared<base::CCObjectPool<ArenaSlot>>(conf.pool_size());
+    arena_pool_->ConstructAll(conf.arena_block_size());
+  }
+}
+
+template <typename MessageT>
+auto MessageAllocator<MessageT>::ForChannel(uint64_t channel_id,
+                                            const MessageAllocatorConf& conf)
+    -> std::shared_ptr<MessageAllocator> {
+  static std::mutex mutex;
+  static std::unordered_map<uint64_t, std::weak_ptr<MessageAllocator>>
+      allocators;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto allocator = allocators[channel_id].lock();
+  if (allocator == nullptr) {
+    allocator = std::make_shared<MessageAllocator>(conf);
+    allocators[channel_id] = allocator;
+  } else if (allocator->policy() != conf.policy()) {
+    ADEBUG << "channel[" << channel_id << "] keeps allocator policy "
+           << MessageAllocatorConf::Policy_Name(allocator->policy());
+  }
+  return allocator;
+}
+
+template <typename MessageT>
+auto MessageAllocator<MessageT>::Allocate() -> MessagePtr {
+  MessagePtr msg = nullptr;
+  if (policy_ == MessageAllocatorConf::POOL) {
+    msg = message_pool_->GetObject();
+  } else if (policy_ == MessageAllocatorConf::ARENA) {
+    msg = AllocateFromArena();
+  }
+  if (msg == nullptr) {
+    msg = std::make_shared<MessageT>();
+  }
+  return msg;
+}
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_MESSAGE_MESSAGE_ALLOCATOR_H_
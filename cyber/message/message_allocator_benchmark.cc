@@ -0,0 +1,175 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Allocator pressure of parsing received point clouds with the HEAP, POOL
+// and ARENA MessageAllocator policies, while a reader holds the last few
+// messages as its pending queue does. RSS is process wide, so measure one
+// policy per run:
+//
+//   bazel run -c opt //cyber/message:message_allocator_benchmark -- \
+//       --benchmark_filter='BM_RssOverTime/0/'
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/message/message_allocator.h"
+
+namespace {
+
+std::atomic<uint64_t> allocations = {0};
+
+}  // namespace
+
+// count what goes through operator new, which protobuf and std::string use
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+namespace {
+
+constexpr size_t kPendingQueueSize = 4;
+
+std::string SerializedCloud(int points) {
+  proto::BenchmarkPointCloud cloud;
+  cloud.set_timestamp(1);
+  cloud.set_frame_id("velodyne128");
+  for (int i = 0; i < points; ++i) {
+    auto point = cloud.add_point();
+    point->set_x(static_cast<float>(i));
+    point->set_y(static_cast<float>(i) * 0.5f);
+    point->set_z(1.0f);
+    point->set_intensity(i % 256);
+    point->set_timestamp(1000 + i);
+  }
+  return cloud.SerializeAsString();
+}
+
+MessageAllocatorConf Conf(int64_t policy) {
+  MessageAllocatorConf conf;
+  conf.set_policy(static_cast<MessageAllocatorConf::Policy>(policy));
+  conf.set_pool_size(kPendingQueueSize + 2);
+  conf.set_arena_block_size(8 << 20);
+  return conf;
+}
+
+double RssMb() {
+  long pages = 0;  // NOLINT
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm == nullptr) {
+    return 0.0;
+  }
+  if (fscanf(statm, "%*s %ld", &pages) != 1) {  // NOLINT
+    pages = 0;
+  }
+  fclose(statm);
+  return static_cast<double>(pages) * static_cast<double>(getpagesize()) /
+         (1024.0 * 1024.0);
+}
+
+}  // namespace
+
+// Clouds of a fixed size, reports operator new calls per received message.
+static void BM_ParseCloud(benchmark::State& state) {
+  MessageAllocator<proto::BenchmarkPointCloud> allocator(Conf(state.range(0)));
+  const std::string data = SerializedCloud(static_cast<int>(state.range(1)));
+  std::deque<std::shared_ptr<proto::BenchmarkPointCloud>> pending;
+
+  uint64_t begin_allocations = allocations.load();
+  for (auto _ : state) {
+    auto msg = allocator.Allocate();
+    msg->ParseFromString(data);
+    pending.emplace_back(std::move(msg));
+    if (pending.size() > kPendingQueueSize) {
+      pending.pop_front();
+    }
+  }
+  state.counters["allocs_per_msg"] = benchmark::Counter(
+      static_cast<double>(allocations.load() - begin_allocations) /
+      static_cast<double>(state.iterations()));
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ParseCloud)
+    ->ArgsProduct({{MessageAllocatorConf::HEAP, MessageAllocatorConf::POOL,
+                    MessageAllocatorConf::ARENA},
+                   {1000, 30000, 120000}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Clouds from 10k to 120k points as a lidar with a varying field of view
+// sends them, reports the RSS after each quarter of the run.
+static void BM_RssOverTime(benchmark::State& state) {
+  constexpr int kMessages = 4000;
+  std::vector<std::string> clouds;
+  for (int points = 10000; points <= 120000; points += 10000) {
+    clouds.emplace_back(SerializedCloud(points));
+  }
+  std::mt19937 rand(42);
+  std::uniform_int_distribution<size_t> pick(0, clouds.size() - 1);
+
+  for (auto _ : state) {
+    MessageAllocator<proto::BenchmarkPointCloud> allocator(
+        Conf(state.range(0)));
+    std::deque<std::shared_ptr<proto::BenchmarkPointCloud>> pending;
+    state.counters["rss_mb_0"] = RssMb();
+    for (int i = 1; i <= kMessages; ++i) {
+      auto msg = allocator.Allocate();
+      msg->ParseFromString(clouds[pick(rand)]);
+      pending.emplace_back(std::move(msg));
+      if (pending.size() > kPendingQueueSize) {
+        pending.pop_front();
+      }
+      if (i % (kMessages / 4) == 0) {
+        state.counters["rss_mb_" + std::to_string(i / (kMessages / 4))] =
+            RssMb();
+      }
+    }
+  }
+}
+BENCHMARK(BM_RssOverTime)
+    ->DenseRange(MessageAllocatorConf::HEAP, MessageAllocatorConf::ARENA)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
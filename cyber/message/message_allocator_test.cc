@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/message/message_allocator.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/message/raw_message.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+using apollo::cyber::proto::Chatter;
+
+MessageAllocatorConf AllocatorConf(MessageAllocatorConf::Policy policy,
+                                   uint32_t pool_size) {
+  MessageAllocatorConf conf;
+  conf.set_policy(policy);
+  conf.set_pool_size(pool_size);
+  conf.set_arena_block_size(4096);
+  return conf;
+}
+
+TEST(MessageAllocatorTest, heap) {
+  MessageAllocator<Chatter> allocator(
+      AllocatorConf(MessageAllocatorConf::HEAP, 2));
+  auto msg = allocator.Allocate();
+  ASSERT_NE(nullptr, msg);
+  EXPECT_EQ(nullptr, msg->GetArena());
+}
+
+TEST(MessageAllocatorTest, pool) {
+  MessageAllocator<Chatter> allocator(
+      AllocatorConf(MessageAllocatorConf::POOL, 2));
+  EXPECT_EQ(MessageAllocatorConf::POOL, allocator.policy());
+
+  auto msg = allocator.Allocate();
+  msg->set_content(std::string(1024, 'a'));
+  Chatter* recycled = msg.get();
+  msg.reset();
+
+  // the pool hands out the released message, whose fields keep their memory
+  msg = allocator.Allocate();
+  EXPECT_EQ(recycled, msg.get());
+  EXPECT_GE(msg->mutable_content()->capacity(), 1024);
+  Chatter parsed;
+  parsed.set_seq(1);
+  ASSERT_TRUE(msg->ParseFromString(parsed.SerializeAsString()));
+  EXPECT_FALSE(msg->has_content());
+  EXPECT_EQ(1, msg->seq());
+
+  // beyond the pool messages come from the heap
+  std::vector<std::shared_ptr<Chatter>> msgs;
+  for (int i = 0; i < 4; ++i) {
+    msgs.emplace_back(allocator.Allocate());
+    ASSERT_NE(nullptr, msgs.back());
+  }
+}
+
+TEST(MessageAllocatorTest, arena) {
+  MessageAllocator<Chatter> allocator(
+      AllocatorConf(MessageAllocatorConf::ARENA, 1));
+  EXPECT_EQ(MessageAllocatorConf::ARENA, allocator.policy());
+
+  auto msg = allocator.Allocate();
+  ASSERT_NE(nullptr, msg->GetArena());
+  auto arena = msg->GetArena();
+  // larger than the first block of the arena
+  msg->set_content(std::string(8192, 'a'));
+  auto overflow = allocator.Allocate();
+  EXPECT_EQ(nullptr, overflow->GetArena());
+  msg.reset();
+
+  msg = allocator.Allocate();
+  EXPECT_EQ(arena, msg->GetArena());
+  EXPECT_FALSE(msg->has_content());
+}
+
+TEST(MessageAllocatorTest, non_protobuf) {
+  MessageAllocator<RawMessage> allocator(
+      AllocatorConf(MessageAllocatorConf::ARENA, 2));
+  EXPECT_EQ(MessageAllocatorConf::POOL, allocator.policy());
+  ASSERT_NE(nullptr, allocator.Allocate());
+
+  MessageAllocator<RawMessage> empty_pool(
+      AllocatorConf(MessageAllocatorConf::POOL, 0));
+  EXPECT_EQ(MessageAllocatorConf::HEAP, empty_pool.policy());
+  ASSERT_NE(nullptr, empty_pool.Allocate());
+}
+
+TEST(MessageAllocatorTest, for_channel) {
+  auto pool_conf = AllocatorConf(MessageAllocatorConf::POOL, 2);
+  auto heap_conf = AllocatorConf(MessageAllocatorConf::HEAP, 2);
+  auto allocator = MessageAllocator<Chatter>::ForChannel(1, pool_conf);
+  // the first reader of a channel decides
+  EXPECT_EQ(allocator, MessageAllocator<Chatter>::ForChannel(1, heap_conf));
+  EXPECT_EQ(MessageAllocatorConf::HEAP,
+            MessageAllocator<Chatter>::ForChannel(2, heap_conf)->policy());
+
+  allocator.reset();
+  EXPECT_EQ(MessageAllocatorConf::HEAP,
+            MessageAllocator<Chatter>::ForChannel(1, heap_conf)->policy());
+}
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
@@ -31,6 +31,10 @@ namespace cyber {
 template <typename M0, typename M1, typename M2, typename M3>
 class Component;
 class TimerComponent;
+class SysMo;
+namespace profiler {
+class Exporter;
+}  // namespace profiler
 
 /**
  * @class Node
@@ -46,6 +50,8 @@ class Node {
   template <typename M0, typename M1, typename M2, typename M3>
   friend class Component;
   friend class TimerComponent;
+  friend class profiler::Exporter;
+  friend class SysMo;
   friend bool Init(const char*);
   friend std::unique_ptr<Node> CreateNode(const std::string&,
                                           const std::string&);
@@ -48,7 +48,9 @@ struct ReaderConfig {  ///< configurations for a Reader
   ReaderConfig(const ReaderConfig& other)
       : channel_name(other.channel_name),
         qos_profile(other.qos_profile),
-        pending_queue_size(other.pending_queue_size) {}
+        pending_queue_size(other.pending_queue_size),
+        allocator_conf(other.allocator_conf),
+        pending_queue_conf(other.pending_queue_conf) {}
 
   std::string channel_name;       //< channel reads
   proto::QosProfile qos_profile;  //< the qos configuration
@@ -57,6 +59,16 @@ struct ReaderConfig {  ///< configurations for a Reader
    * Older messages will dropped if you have no time to handle
    */
   uint32_t pending_queue_size;
+  /**
+   * @brief how received messages are allocated, shared by the readers of
+   * the channel in this process and decided by the first of them
+   */
+  proto::MessageAllocatorConf allocator_conf;
+  /**
+   * @brief what happens once the ChannelBuffer is full, for readers with a
+   * callback
+   */
+  proto::PendingQueueConf pending_queue_conf;
 };
 
 /**
@@ -194,6 +206,8 @@ auto NodeChannelImpl::CreateReader(const ReaderConfig& config,
   proto::RoleAttributes role_attr;
   role_attr.set_channel_name(config.channel_name);
   role_attr.mutable_qos_profile()->CopyFrom(config.qos_profile);
+  role_attr.mutable_allocator_conf()->CopyFrom(config.allocator_conf);
+  role_attr.mutable_pending_queue_conf()->CopyFrom(config.pending_queue_conf);
   return this->template CreateReader<MessageT>(role_attr, reader_func,
                                                config.pending_queue_size);
 }
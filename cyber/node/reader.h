@@ -32,6 +32,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/croutine/routine_factory.h"
 #include "cyber/data/data_visitor.h"
+#include "cyber/data/pending_queue_registry.h"
 #include "cyber/node/reader_base.h"
 #include "cyber/scheduler/scheduler_factory.h"
 #include "cyber/service_discovery/topology_manager.h"
@@ -62,7 +63,10 @@ const uint32_t DEFAULT_PENDING_QUEUE_SIZE = 1;
  * it's passed through the `pending_queue_size` param. pending_queue_size is
  * default set to 1, So, If you handle slower than writer sending, older
  * messages that are not handled will be lost. You can increase
- * `pending_queue_size` to resolve this problem.
+ * `pending_queue_size` to resolve this problem, or choose another overflow
+ * policy, e.g. conflating to the latest message, through the
+ * `pending_queue_conf` of the RoleAttributes. Losses are counted in the
+ * PendingQueueRegistry and reported by SysMo.
  */
 template <typename MessageT>
 class Reader : public ReaderBase {
@@ -270,8 +274,18 @@ bool Reader<MessageT>::Init() {
   }
   auto sched = scheduler::Instance();
   croutine_name_ = role_attr_.node_name() + "_" + role_attr_.channel_name();
-  auto dv = std::make_shared<data::DataVisitor<MessageT>>(
-      role_attr_.channel_id(), pending_queue_size_);
+  // readers without a callback only feed the blocker, the queue policy is
+  // up to whoever processes the channel, e.g. their component
+  data::VisitorConfig visitor_conf(role_attr_.channel_id(),
+                                   pending_queue_size_);
+  if (reader_func_ != nullptr) {
+    visitor_conf.queue_conf.CopyFrom(role_attr_.pending_queue_conf());
+  }
+  auto dv = std::make_shared<data::DataVisitor<MessageT>>(visitor_conf);
+  if (reader_func_ != nullptr) {
+    data::PendingQueueRegistry::Instance()->Register(
+        role_attr_.channel_name(), role_attr_.node_name(), dv->QueueStats());
+  }
   // Using factory to wrap templates.
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<MessageT>(std::move(func), dv);
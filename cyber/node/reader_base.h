@@ -215,7 +215,8 @@ auto ReceiverManager<MessageT>::GetReceiver(
                   TransPerf::DISPATCH, reader_attr.channel_id(),
                   msg_info.seq_num());
               data::DataDispatcher<MessageT>::Instance()->Dispatch(
-                  reader_attr.channel_id(), msg);
+                  reader_attr.channel_id(), msg,
+                  transport::IntraDispatcher::InDelivery());
               PerfEventCache::Instance()->AddTransportEvent(
                   TransPerf::NOTIFY, reader_attr.channel_id(),
                   msg_info.seq_num());
@@ -84,6 +84,27 @@ class Writer : public WriterBase {
    */
   virtual bool Write(const std::shared_ptr<MessageT>& msg_ptr);
 
+  /**
+   * @brief Borrow a shared memory block to fill a serialized MessageT in
+   * place, avoiding the serialize-and-copy of Write. Only available while a
+   * reader of another process on this host is connected.
+   *
+   * @param size the maximum serialized size of the message
+   * @return the loan, or nullptr if the shm path is unavailable, in which case
+   * the caller should fall back to Write
+   */
+  transport::ShmLoanPtr Loan(std::size_t size);
+
+  /**
+   * @brief Publish a block obtained from Loan. Call `loan->set_size()` first
+   * if fewer bytes than requested were written.
+   *
+   * @param loan the filled loan
+   * @return true if publish successfully
+   * @return false if publish failed
+   */
+  bool Publish(const transport::ShmLoanPtr& loan);
+
   /**
    * @brief Is there any Reader that subscribes our Channel?
    * You can publish message when this return true
@@ -169,6 +190,18 @@ bool Writer<MessageT>::Write(const std::shared_ptr<MessageT>& msg_ptr) {
   return transmitter_->Transmit(msg_ptr);
 }
 
+template <typename MessageT>
+transport::ShmLoanPtr Writer<MessageT>::Loan(std::size_t size) {
+  RETURN_VAL_IF(!WriterBase::IsInit(), nullptr);
+  return transmitter_->Loan(size);
+}
+
+template <typename MessageT>
+bool Writer<MessageT>::Publish(const transport::ShmLoanPtr& loan) {
+  RETURN_VAL_IF(!WriterBase::IsInit(), false);
+  return transmitter_->Publish(loan);
+}
+
 template <typename MessageT>
 void Writer<MessageT>::JoinTheTopology() {
   // add listener
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/profiler/exporter.h"
+
+#include <unistd.h>
+
+#include <csignal>
+#include <ctime>
+
+#include "cyber/binary.h"
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/profiler/trace_collector.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+using apollo::cyber::common::GlobalData;
+
+std::atomic<bool> Exporter::dump_requested_ = {false};
+
+Exporter::Exporter() { Start(); }
+
+void Exporter::Start() {
+  const auto& conf = GlobalData::Instance()->Config().profiler_conf();
+  trace_dir_ = conf.trace_dir();
+  if (!conf.enable()) {
+    return;
+  }
+  start_ = true;
+  summary_interval_ns_ =
+      static_cast<uint64_t>(conf.summary_interval_ms()) * 1000000;
+  if (summary_interval_ns_ > 0) {
+    node_.reset(new Node("profiler_" + std::to_string(getpid())));
+    writer_ = node_->CreateWriter<proto::ProfilerSummary>(
+        conf.summary_channel());
+    if (writer_ == nullptr) {
+      AERROR << "Create profiler summary writer failed.";
+    }
+  }
+  last_publish_time_ = Time::Now().ToNanosecond();
+  std::signal(SIGUSR2, &Exporter::OnDumpSignal);
+  thread_ = std::thread(&Exporter::Run, this);
+}
+
+void Exporter::Shutdown() {
+  if (!start_ || shut_down_.exchange(true)) {
+    return;
+  }
+
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  writer_.reset();
+  node_.reset();
+}
+
+void Exporter::OnDumpSignal(int sig) {
+  (void)sig;
+  // only async-signal-safe work here, the exporter thread does the dump
+  dump_requested_.store(true);
+}
+
+void Exporter::Run() {
+  while (cyber_unlikely(!shut_down_.load())) {
+    if (dump_requested_.exchange(false)) {
+      DumpTrace();
+    }
+    if (writer_ != nullptr &&
+        Time::Now().ToNanosecond() - last_publish_time_ >=
+            summary_interval_ns_) {
+      Publish();
+    }
+    std::unique_lock<std::mutex> lk(lk_);
+    cv_.wait_for(lk, std::chrono::milliseconds(poll_interval_ms_));
+  }
+}
+
+void Exporter::Publish() {
+  proto::ProfilerSummary summary;
+  uint64_t now = Time::Now().ToNanosecond();
+  summary.set_process_name(binary::GetName());
+  summary.set_pid(static_cast<int32_t>(getpid()));
+  summary.set_begin_time(last_publish_time_);
+  summary.set_end_time(now);
+  last_publish_time_ = now;
+  TraceCollector::Instance()->Summarize(true, &summary);
+  if (summary.blocks_size() > 0) {
+    writer_->Write(summary);
+  }
+}
+
+std::string Exporter::DumpTrace() {
+  time_t now = time(nullptr);
+  struct tm local;
+  localtime_r(&now, &local);
+  char stamp[32];
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+  std::string path = trace_dir_ + "/" + binary::GetName() + "." +
+                     std::to_string(getpid()) + "." + stamp + ".trace.json";
+  if (!TraceCollector::Instance()->DumpChromeTrace(path)) {
+    return "";
+  }
+  AINFO << "Dumped trace events to " << path;
+  return path;
+}
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
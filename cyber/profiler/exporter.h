@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_PROFILER_EXPORTER_H_
+#define CYBER_PROFILER_EXPORTER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "cyber/proto/profiler.pb.h"
+
+#include "cyber/common/macros.h"
+#include "cyber/node/node.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+/**
+ * @brief Publishes the latency summaries of TraceCollector on
+ * ProfilerConf.summary_channel, and dumps its trace buffers as Chrome trace
+ * JSON to ProfilerConf.trace_dir when the process receives SIGUSR2.
+ */
+class Exporter {
+ public:
+  void Start();
+  void Shutdown();
+
+  /**
+   * @brief Dump the trace buffers now.
+   *
+   * @return the path written, empty on failure.
+   */
+  std::string DumpTrace();
+
+ private:
+  void Run();
+  void Publish();
+  static void OnDumpSignal(int sig);
+
+  static std::atomic<bool> dump_requested_;
+
+  std::atomic<bool> shut_down_{false};
+  bool start_ = false;
+  std::string trace_dir_;
+  uint64_t summary_interval_ns_ = 0;
+  uint64_t last_publish_time_ = 0;
+
+  std::unique_ptr<Node> node_;
+  std::shared_ptr<Writer<proto::ProfilerSummary>> writer_;
+
+  int poll_interval_ms_ = 100;
+  std::condition_variable cv_;
+  std::mutex lk_;
+  std::thread thread_;
+
+  DECLARE_SINGLETON(Exporter)
+};
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_PROFILER_EXPORTER_H_
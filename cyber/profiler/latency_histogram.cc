@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/profiler/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+LatencyHistogram::LatencyHistogram()
+    : min_(std::numeric_limits<uint64_t>::max()) {
+  for (auto& count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+uint32_t LatencyHistogram::BucketIndex(uint64_t value_ns) {
+  if (value_ns < kSubBucketNum) {
+    return static_cast<uint32_t>(value_ns);
+  }
+  uint32_t exponent = 63 - __builtin_clzll(value_ns);
+  if (exponent > kMaxExponent) {
+    return kBucketNum - 1;
+  }
+  // the top kSubBucketBits + 1 bits, without the leading one
+  uint32_t sub_bucket = static_cast<uint32_t>(
+      (value_ns >> (exponent - kSubBucketBits)) - kSubBucketNum);
+  return (exponent - kSubBucketBits + 1) * kSubBucketNum + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(uint32_t index) {
+  if (index < kSubBucketNum) {
+    return index;
+  }
+  uint32_t exponent = index / kSubBucketNum + kSubBucketBits - 1;
+  uint64_t sub_bucket = index % kSubBucketNum;
+  uint32_t shift = exponent - kSubBucketBits;
+  return ((kSubBucketNum + sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value_ns) {
+  counts_[BucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value_ns, std::memory_order_relaxed);
+  uint64_t min = min_.load(std::memory_order_relaxed);
+  while (value_ns < min &&
+         !min_.compare_exchange_weak(min, value_ns,
+                                     std::memory_order_relaxed)) {
+  }
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (value_ns > max &&
+         !max_.compare_exchange_weak(max, value_ns,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Snapshot(HistogramSnapshot* snapshot) const {
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    snapshot->counts[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+  snapshot->count = count_.load(std::memory_order_relaxed);
+  snapshot->sum = sum_.load(std::memory_order_relaxed);
+  snapshot->min = snapshot->count == 0
+                      ? 0
+                      : min_.load(std::memory_order_relaxed);
+  snapshot->max = max_.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Drain(HistogramSnapshot* snapshot) {
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    snapshot->counts[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+  }
+  snapshot->count = count_.exchange(0, std::memory_order_relaxed);
+  snapshot->sum = sum_.exchange(0, std::memory_order_relaxed);
+  uint64_t min = min_.exchange(std::numeric_limits<uint64_t>::max(),
+                               std::memory_order_relaxed);
+  snapshot->min = snapshot->count == 0 ? 0 : min;
+  snapshot->max = max_.exchange(0, std::memory_order_relaxed);
+}
+
+uint64_t HistogramSnapshot::ValueAtPercentile(double percentile) const {
+  uint64_t total = 0;
+  for (auto bucket_count : counts) {
+    total += bucket_count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  auto rank = static_cast<uint64_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(total)));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < LatencyHistogram::kBucketNum; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      // never report more than was actually recorded
+      return std::min(LatencyHistogram::BucketUpperBound(i), max);
+    }
+  }
+  return max;
+}
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_PROFILER_LATENCY_HISTOGRAM_H_
+#define CYBER_PROFILER_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+struct HistogramSnapshot;
+
+/**
+ * @brief Log-linear histogram of durations in ns, in the manner of
+ * HdrHistogram: every power of two is split into 32 linear buckets, so a
+ * value is known to within 1/32 (3%) of itself up to 2^40 ns (18 min).
+ * Record() is wait-free and may be called from any thread.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr uint32_t kSubBucketBits = 5;
+  static constexpr uint32_t kSubBucketNum = 1U << kSubBucketBits;
+  static constexpr uint32_t kMaxExponent = 40;
+  static constexpr uint32_t kBucketNum =
+      (kMaxExponent - kSubBucketBits + 2) * kSubBucketNum;
+
+  LatencyHistogram();
+
+  void Record(uint64_t value_ns);
+
+  /**
+   * @brief Copy the counts recorded so far.
+   */
+  void Snapshot(HistogramSnapshot* snapshot) const;
+
+  /**
+   * @brief Move the counts recorded so far into `snapshot` and start over,
+   * for summaries per interval. Values recorded concurrently land in either
+   * interval.
+   */
+  void Drain(HistogramSnapshot* snapshot);
+
+  static uint32_t BucketIndex(uint64_t value_ns);
+  // the largest value that falls into `index`
+  static uint64_t BucketUpperBound(uint32_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketNum> counts_;
+  std::atomic<uint64_t> count_ = {0};
+  std::atomic<uint64_t> sum_ = {0};
+  std::atomic<uint64_t> min_;
+  std::atomic<uint64_t> max_ = {0};
+};
+
+struct HistogramSnapshot {
+  std::array<uint64_t, LatencyHistogram::kBucketNum> counts = {};
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t min = 0;
+  uint64_t max = 0;
+
+  /**
+   * @brief The value below which `percentile` (0 - 100) of the recorded
+   * values fall, 0 if nothing was recorded.
+   */
+  uint64_t ValueAtPercentile(double percentile) const;
+  uint64_t Mean() const { return count == 0 ? 0 : sum / count; }
+};
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_PROFILER_LATENCY_HISTOGRAM_H_
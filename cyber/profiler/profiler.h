@@ -19,13 +19,12 @@
 
 #include "cyber/profiler/block.h"
 #include "cyber/profiler/block_manager.h"
+#include "cyber/profiler/trace_collector.h"
 
 namespace apollo {
 namespace cyber {
 namespace profiler {
 
-#if ENABLE_PROFILER
-
 #if defined(__GNUC__) || defined(__GNUG__)
 #define AFUNC __PRETTY_FUNCTION__
 #elif defined(__clang__)
@@ -36,25 +35,45 @@ namespace profiler {
 
 #define TOKEN_JOIN(x, y) x ## y
 #define UNIQUE_NAME(x) TOKEN_JOIN(prefix_perf, x)
+#define UNIQUE_STATS_NAME(x) TOKEN_JOIN(prefix_perf_stats, x)
+#define UNIQUE_SCOPE_NAME(x) TOKEN_JOIN(prefix_perf_scope, x)
+
+// Always compiled in: the latency of the block goes into the histogram of
+// its name and into the trace buffer of the thread, see TraceCollector. The
+// name is looked up once per call site, so it has to be the same on every
+// pass.
+#define PERF_TRACE_BLOCK(name)                                            \
+  static apollo::cyber::profiler::BlockStats* UNIQUE_STATS_NAME(          \
+      __LINE__) =                                                         \
+      apollo::cyber::profiler::TraceCollector::Instance()->Register(name); \
+  apollo::cyber::profiler::ScopedBlock UNIQUE_SCOPE_NAME(__LINE__)(       \
+      UNIQUE_STATS_NAME(__LINE__));
+
+#define PERF_TRACE_BLOCK_END \
+  apollo::cyber::profiler::ScopedBlock::EndInnermost();
+
+#if ENABLE_PROFILER
 
+// every frame of blocks is also written to the perf log
 #define PERF_BLOCK(name, ...)                                    \
+  PERF_TRACE_BLOCK(name)                                         \
   apollo::cyber::profiler::Block UNIQUE_NAME(__LINE__)(name);    \
   apollo::cyber::profiler::BlockManager::Instance()->StartBlock( \
       &UNIQUE_NAME(__LINE__));
 
-#define PERF_BLOCK_END \
-  apollo::cyber::profiler::BlockManager::Instance()->EndBlock();
-
-#define PERF_FUNCTION(...) PERF_BLOCK(AFUNC, ## __VA_ARGS__)
+#define PERF_BLOCK_END                                          \
+  apollo::cyber::profiler::BlockManager::Instance()->EndBlock(); \
+  PERF_TRACE_BLOCK_END
 
 #else
 
-#define PERF_BLOCK(...)
-#define PERF_BLOCK_END
-#define PERF_FUNCTION(...)
+#define PERF_BLOCK(name, ...) PERF_TRACE_BLOCK(name)
+#define PERF_BLOCK_END PERF_TRACE_BLOCK_END
 
 #endif  // #if ENABLE_PROFILER
 
+#define PERF_FUNCTION(...) PERF_BLOCK(AFUNC, ## __VA_ARGS__)
+
 }  // namespace profiler
 }  // namespace cyber
 }  // namespace apollo
@@ -14,10 +14,29 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <fstream>
+#include <sstream>
+#include <string>
+
 #include "gtest/gtest.h"
 
+#include "cyber/profiler/latency_histogram.h"
 #include "cyber/profiler/profiler.h"
 
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+const proto::BlockLatency* FindBlock(const proto::ProfilerSummary& summary,
+                              const std::string& name) {
+  for (const auto& block : summary.blocks()) {
+    if (block.name() == name) {
+      return &block;
+    }
+  }
+  return nullptr;
+}
+
 TEST(ProfilerTest, single_block) {
   PERF_BLOCK("block")
   for (int i = 0; i < 1000; ++i) {
@@ -60,3 +79,74 @@ TEST(ProfilerTest, function) {
   for (int i = 0; i < 1000; ++i) {
   }
 }
+
+TEST(ProfilerTest, histogram) {
+  for (uint64_t value = 1; value < (1ULL << 41); value = value * 3 + 1) {
+    auto index = LatencyHistogram::BucketIndex(value);
+    ASSERT_LT(index, LatencyHistogram::kBucketNum);
+    EXPECT_GE(LatencyHistogram::BucketUpperBound(index), value);
+    if (index > 0 && value < (1ULL << LatencyHistogram::kMaxExponent)) {
+      EXPECT_LT(LatencyHistogram::BucketUpperBound(index - 1), value);
+    }
+  }
+
+  LatencyHistogram histogram;
+  for (uint64_t us = 1; us <= 10000; ++us) {
+    histogram.Record(us * 1000);
+  }
+  HistogramSnapshot snapshot;
+  histogram.Snapshot(&snapshot);
+  EXPECT_EQ(10000, snapshot.count);
+  EXPECT_EQ(1000, snapshot.min);
+  EXPECT_EQ(10000000, snapshot.max);
+  EXPECT_NEAR(5000000.0, snapshot.ValueAtPercentile(50.0), 5000000.0 / 32);
+  EXPECT_NEAR(9900000.0, snapshot.ValueAtPercentile(99.0), 9900000.0 / 32);
+  EXPECT_EQ(10000000, snapshot.ValueAtPercentile(100.0));
+
+  histogram.Drain(&snapshot);
+  EXPECT_EQ(10000, snapshot.count);
+  histogram.Snapshot(&snapshot);
+  EXPECT_EQ(0, snapshot.count);
+  EXPECT_EQ(0, snapshot.ValueAtPercentile(50.0));
+}
+
+TEST(ProfilerTest, summary_and_trace) {
+  auto collector = TraceCollector::Instance();
+  // off by default
+  EXPECT_FALSE(collector->enabled());
+  collector->Enable(true);
+  for (int i = 0; i < 10; ++i) {
+    PERF_BLOCK("summary_outer")
+    PERF_BLOCK("summary_inner")
+    PERF_BLOCK_END
+    PERF_BLOCK_END
+  }
+  proto::ProfilerSummary summary;
+  collector->Summarize(false, &summary);
+  auto outer = FindBlock(summary, "summary_outer");
+  auto inner = FindBlock(summary, "summary_inner");
+  ASSERT_NE(nullptr, outer);
+  ASSERT_NE(nullptr, inner);
+  EXPECT_EQ(10, outer->count());
+  EXPECT_EQ(10, inner->count());
+  EXPECT_LE(outer->p50_ns(), outer->max_ns());
+
+  const std::string path = "/tmp/profiler_test.trace.json";
+  ASSERT_TRUE(collector->DumpChromeTrace(path));
+  std::ifstream in(path);
+  std::stringstream content;
+  content << in.rdbuf();
+  EXPECT_NE(std::string::npos, content.str().find("\"traceEvents\""));
+  EXPECT_NE(std::string::npos, content.str().find("\"summary_inner\""));
+  EXPECT_NE(std::string::npos, content.str().find("\"thread_name\""));
+
+  summary.Clear();
+  collector->Summarize(true, &summary);
+  summary.Clear();
+  collector->Summarize(true, &summary);
+  EXPECT_EQ(nullptr, FindBlock(summary, "summary_outer"));
+}
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
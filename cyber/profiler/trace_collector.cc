@@ -0,0 +1,357 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/profiler/trace_collector.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/croutine/croutine.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+namespace {
+
+// trace buffers of exited threads that are kept for the next dump
+constexpr size_t kMaxRetiredBuffers = 16;
+constexpr uint32_t kMinBufferCapacity = 64;
+
+struct ThreadBufferHolder {
+  ~ThreadBufferHolder() {
+    if (buffer != nullptr) {
+      buffer->Retire();
+    }
+  }
+  std::shared_ptr<TraceBuffer> buffer;
+};
+
+thread_local ThreadBufferHolder thread_buffer;
+thread_local ScopedBlock* thread_innermost = nullptr;
+
+uint32_t RoundUpPowerOfTwo(uint32_t value) {
+  uint32_t result = kMinBufferCapacity;
+  while (result < value && result < (1U << 31)) {
+    result <<= 1;
+  }
+  return result;
+}
+
+std::string ThreadName(pid_t tid) {
+  std::ifstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+  std::string name;
+  if (!std::getline(comm, name) || name.empty()) {
+    name = "thread-" + std::to_string(tid);
+  }
+  return name;
+}
+
+void WriteJsonString(const std::string& value, std::ostream* out) {
+  *out << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        *out << "\\\"";
+        break;
+      case '\\':
+        *out << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          *out << escaped;
+        } else {
+          *out << c;
+        }
+    }
+  }
+  *out << '"';
+}
+
+// Chrome trace timestamps are in us
+void WriteMicroseconds(uint64_t ns, std::ostream* out) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%" PRIu64 ".%03" PRIu64, ns / 1000,
+           ns % 1000);
+  *out << buffer;
+}
+
+}  // namespace
+
+TraceBuffer::TraceBuffer(uint32_t capacity, pid_t tid)
+    : slots_(new Slot[capacity]), capacity_(capacity), tid_(tid) {}
+
+void TraceBuffer::Push(const BlockStats* block, uint64_t begin_ns,
+                       uint64_t end_ns) {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  auto& slot = slots_[head & (capacity_ - 1)];
+  slot.block.store(block, std::memory_order_relaxed);
+  slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+  slot.end_ns.store(end_ns, std::memory_order_relaxed);
+  head_.store(head + 1, std::memory_order_release);
+}
+
+void TraceBuffer::Collect(std::vector<Event>* events) const {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t begin = head > capacity_ ? head - capacity_ : 0;
+  std::vector<Event> copied;
+  copied.reserve(head - begin);
+  for (uint64_t i = begin; i < head; ++i) {
+    const auto& slot = slots_[i & (capacity_ - 1)];
+    copied.push_back({slot.block.load(std::memory_order_relaxed),
+                      slot.begin_ns.load(std::memory_order_relaxed),
+                      slot.end_ns.load(std::memory_order_relaxed)});
+  }
+  // the writer may have wrapped around while we copied, and the slot of
+  // the event it is writing now is not valid either
+  uint64_t new_head = head_.load(std::memory_order_acquire);
+  uint64_t valid_begin = new_head >= capacity_ ? new_head - capacity_ + 1 : 0;
+  for (uint64_t i = std::max(begin, valid_begin); i < head; ++i) {
+    const auto& event = copied[i - begin];
+    if (event.block != nullptr) {
+      events->push_back(event);
+    }
+  }
+}
+
+TraceCollector::TraceCollector() {
+  const auto& conf = common::GlobalData::Instance()->Config().profiler_conf();
+  buffer_capacity_ = RoundUpPowerOfTwo(conf.trace_buffer_size());
+  Enable(conf.enable());
+}
+
+void TraceCollector::Enable(bool enable) {
+  enabled_.store(enable, std::memory_order_relaxed);
+  croutine::CRoutine::EnableNotifyTime(enable);
+}
+
+BlockStats* TraceCollector::Register(const std::string& name) {
+  std::lock_guard<std::mutex> lock(blocks_mutex_);
+  auto& block = blocks_[name];
+  if (block == nullptr) {
+    block.reset(new BlockStats(name));
+  }
+  return block.get();
+}
+
+TraceBuffer* TraceCollector::ThreadBuffer() {
+  if (cyber_likely(thread_buffer.buffer != nullptr)) {
+    return thread_buffer.buffer.get();
+  }
+  auto tid = static_cast<pid_t>(syscall(SYS_gettid));
+  thread_buffer.buffer = std::make_shared<TraceBuffer>(buffer_capacity_, tid);
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  size_t retired = std::count_if(
+      buffers_.begin(), buffers_.end(),
+      [](const std::shared_ptr<TraceBuffer>& buffer) {
+        return buffer->retired();
+      });
+  for (auto it = buffers_.begin();
+       it != buffers_.end() && retired > kMaxRetiredBuffers;) {
+    if ((*it)->retired()) {
+      it = buffers_.erase(it);
+      --retired;
+    } else {
+      ++it;
+    }
+  }
+  buffers_.push_back(thread_buffer.buffer);
+  return thread_buffer.buffer.get();
+}
+
+void TraceCollector::Record(BlockStats* block, uint64_t begin_ns,
+                            uint64_t end_ns) {
+  if (!enabled() || block == nullptr) {
+    return;
+  }
+  block->histogram.Record(end_ns - begin_ns);
+  ThreadBuffer()->Push(block, begin_ns, end_ns);
+}
+
+void TraceCollector::RecordLatency(BlockStats* block, uint64_t latency_ns) {
+  if (!enabled() || block == nullptr) {
+    return;
+  }
+  block->histogram.Record(latency_ns);
+}
+
+void TraceCollector::Summarize(bool drain, proto::ProfilerSummary* summary) {
+  std::map<std::string, BlockStats*> blocks;
+  {
+    std::lock_guard<std::mutex> lock(blocks_mutex_);
+    for (auto& item : blocks_) {
+      blocks.emplace(item.first, item.second.get());
+    }
+  }
+  HistogramSnapshot snapshot;
+  for (auto& item : blocks) {
+    if (drain) {
+      item.second->histogram.Drain(&snapshot);
+    } else {
+      item.second->histogram.Snapshot(&snapshot);
+    }
+    if (snapshot.count == 0) {
+      continue;
+    }
+    auto latency = summary->add_blocks();
+    latency->set_name(item.first);
+    latency->set_count(snapshot.count);
+    latency->set_min_ns(snapshot.min);
+    latency->set_mean_ns(snapshot.Mean());
+    latency->set_p50_ns(snapshot.ValueAtPercentile(50.0));
+    latency->set_p90_ns(snapshot.ValueAtPercentile(90.0));
+    latency->set_p99_ns(snapshot.ValueAtPercentile(99.0));
+    latency->set_p999_ns(snapshot.ValueAtPercentile(99.9));
+    latency->set_max_ns(snapshot.max);
+  }
+}
+
+bool TraceCollector::DumpChromeTrace(const std::string& path) {
+  std::vector<std::shared_ptr<TraceBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers = buffers_;
+  }
+  std::ofstream out(path);
+  if (!out) {
+    AERROR << "Open trace file failed: " << path;
+    return false;
+  }
+  const int pid = static_cast<int>(getpid());
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&out, &first]() {
+    if (!first) {
+      out << ",";
+    }
+    first = false;
+    out << "\n";
+  };
+  std::vector<TraceBuffer::Event> events;
+  for (const auto& buffer : buffers) {
+    events.clear();
+    buffer->Collect(&events);
+    if (events.empty()) {
+      continue;
+    }
+    separator();
+    out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid
+        << ",\"tid\":" << buffer->tid() << ",\"args\":{\"name\":";
+    WriteJsonString(ThreadName(buffer->tid()), &out);
+    out << "}}";
+    for (const auto& event : events) {
+      separator();
+      out << "{\"ph\":\"X\",\"cat\":\"cyber\",\"name\":";
+      WriteJsonString(event.block->name, &out);
+      out << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid()
+          << ",\"ts\":";
+      WriteMicroseconds(event.begin_ns, &out);
+      out << ",\"dur\":";
+      WriteMicroseconds(event.end_ns - event.begin_ns, &out);
+      out << "}";
+    }
+  }
+  out << "\n]}\n";
+  out.close();
+  if (!out) {
+    AERROR << "Write trace file failed: " << path;
+    return false;
+  }
+  return true;
+}
+
+ScopedBlock** ScopedBlock::Innermost() {
+  auto routine = croutine::CRoutine::GetCurrentRoutine();
+  if (routine != nullptr) {
+    return reinterpret_cast<ScopedBlock**>(routine->profiler_block());
+  }
+  return &thread_innermost;
+}
+
+ScopedBlock::ScopedBlock(BlockStats* block) : block_(block) {
+  if (block_ == nullptr || !TraceCollector::Instance()->enabled()) {
+    return;
+  }
+  auto innermost = Innermost();
+  parent_ = *innermost;
+  *innermost = this;
+  open_ = true;
+  begin_ns_ = NowNs();
+}
+
+ScopedBlock::~ScopedBlock() { End(); }
+
+void ScopedBlock::End() {
+  if (!open_) {
+    return;
+  }
+  open_ = false;
+  TraceCollector::Instance()->Record(block_, begin_ns_, NowNs());
+  // unlink, this is the innermost block unless blocks were ended out of
+  // order
+  auto link = Innermost();
+  while (*link != nullptr && *link != this) {
+    link = &(*link)->parent_;
+  }
+  if (*link == this) {
+    *link = parent_;
+  }
+}
+
+void ScopedBlock::EndInnermost() {
+  auto innermost = *Innermost();
+  if (innermost != nullptr) {
+    innermost->End();
+  }
+}
+
+ProcessScope::ProcessScope(BlockStats* proc, BlockStats* latency)
+    : proc_(proc), latency_(latency) {
+  if (!TraceCollector::Instance()->enabled()) {
+    return;
+  }
+  begin_ns_ = NowNs();
+  auto routine = croutine::CRoutine::GetCurrentRoutine();
+  if (routine != nullptr) {
+    notify_ns_ = routine->TakeNotifyTime();
+  }
+}
+
+ProcessScope::~ProcessScope() {
+  if (begin_ns_ == 0) {
+    return;
+  }
+  auto collector = TraceCollector::Instance();
+  uint64_t end_ns = NowNs();
+  collector->Record(proc_, begin_ns_, end_ns);
+  if (notify_ns_ != 0 && notify_ns_ <= end_ns) {
+    collector->RecordLatency(latency_, end_ns - notify_ns_);
+  }
+}
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_PROFILER_TRACE_COLLECTOR_H_
+#define CYBER_PROFILER_TRACE_COLLECTOR_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/proto/profiler.pb.h"
+
+#include "cyber/common/macros.h"
+#include "cyber/profiler/latency_histogram.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+inline uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief A named block and the histogram of its latencies. Registered once
+ * and never freed, so call sites can keep the pointer.
+ */
+struct BlockStats {
+  explicit BlockStats(const std::string& block_name) : name(block_name) {}
+  const std::string name;
+  LatencyHistogram histogram;
+};
+
+/**
+ * @brief Ring of the latest trace events of one thread. Only the owning
+ * thread writes, readers copy the ring and drop the slots that were
+ * overwritten meanwhile.
+ */
+class TraceBuffer {
+ public:
+  struct Event {
+    const BlockStats* block;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+  };
+
+  TraceBuffer(uint32_t capacity, pid_t tid);
+
+  void Push(const BlockStats* block, uint64_t begin_ns, uint64_t end_ns);
+  void Collect(std::vector<Event>* events) const;
+
+  pid_t tid() const { return tid_; }
+  bool retired() const { return retired_.load(std::memory_order_acquire); }
+  void Retire() { retired_.store(true, std::memory_order_release); }
+
+ private:
+  struct Slot {
+    std::atomic<const BlockStats*> block = {nullptr};
+    std::atomic<uint64_t> begin_ns = {0};
+    std::atomic<uint64_t> end_ns = {0};
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  uint64_t capacity_;
+  std::atomic<uint64_t> head_ = {0};
+  pid_t tid_;
+  std::atomic<bool> retired_ = {false};
+};
+
+/**
+ * @brief Collector behind PERF_BLOCK, Component::Proc and the scheduler,
+ * enabled by ProfilerConf.enable. Every finished block goes into the
+ * histogram of its name and into the trace buffer of the thread it ended on;
+ * neither takes a lock.
+ */
+class TraceCollector {
+ public:
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Turn recording on or off after ProfilerConf.enable set it at
+   * start, e.g. in tests. The Exporter only runs if the conf enables it.
+   */
+  void Enable(bool enable);
+
+  /**
+   * @brief The stats of block `name`, created on first use.
+   */
+  BlockStats* Register(const std::string& name);
+
+  /**
+   * @brief Record a block that ran on the calling thread.
+   */
+  void Record(BlockStats* block, uint64_t begin_ns, uint64_t end_ns);
+
+  /**
+   * @brief Record a latency that is not a span of the calling thread, such
+   * as the time from a message arrival to the end of its processing. It
+   * goes into the histogram only.
+   */
+  void RecordLatency(BlockStats* block, uint64_t latency_ns);
+
+  /**
+   * @brief Latency percentiles of every block recorded since the start, or
+   * since the last draining call if `drain` is set.
+   */
+  void Summarize(bool drain, proto::ProfilerSummary* summary);
+
+  /**
+   * @brief Write the events in the trace buffers as Chrome trace event JSON,
+   * which chrome://tracing and Perfetto open.
+   *
+   * @return True for success, false for not.
+   */
+  bool DumpChromeTrace(const std::string& path);
+
+ private:
+  TraceBuffer* ThreadBuffer();
+
+  std::atomic<bool> enabled_ = {false};
+  uint32_t buffer_capacity_ = 0;
+
+  std::mutex blocks_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<BlockStats>> blocks_;
+
+  std::mutex buffers_mutex_;
+  std::vector<std::shared_ptr<TraceBuffer>> buffers_;
+
+  DECLARE_SINGLETON(TraceCollector)
+};
+
+/**
+ * @brief A block that is recorded when End() is called or when it goes out
+ * of scope. Blocks nest per croutine, or per thread outside of croutines.
+ */
+class ScopedBlock {
+ public:
+  explicit ScopedBlock(BlockStats* block);
+  ~ScopedBlock();
+
+  void End();
+
+  /**
+   * @brief End the innermost open block of the current croutine or thread,
+   * for PERF_BLOCK_END.
+   */
+  static void EndInnermost();
+
+ private:
+  static ScopedBlock** Innermost();
+
+  BlockStats* block_;
+  ScopedBlock* parent_ = nullptr;
+  uint64_t begin_ns_ = 0;
+  bool open_ = false;
+};
+
+/**
+ * @brief Times Component::Proc into `proc`, and the time from the data
+ * notification that woke the component croutine to the end of Proc into
+ * `latency`.
+ */
+class ProcessScope {
+ public:
+  ProcessScope(BlockStats* proc, BlockStats* latency);
+  ~ProcessScope();
+
+ private:
+  BlockStats* proc_;
+  BlockStats* latency_;
+  uint64_t begin_ns_ = 0;
+  uint64_t notify_ns_ = 0;
+};
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_PROFILER_TRACE_COLLECTOR_H_
@@ -0,0 +1,349 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/chunk_codec.h"
+
+#include <bzlib.h>
+#include <lz4frame.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::CompressType;
+
+namespace {
+
+constexpr size_t kBufferSize = kChunkStreamBlockSize;
+constexpr int kBz2DefaultLevel = 9;
+
+class Bz2OutputStream : public ChunkOutputStream {
+ public:
+  Bz2OutputStream(int level, int fd)
+      : ChunkOutputStream(fd), out_(kBufferSize) {
+    memset(&stream_, 0, sizeof(stream_));
+    level = level <= 0 ? kBz2DefaultLevel : std::min(level, 9);
+    init_ = BZ2_bzCompressInit(&stream_, level, 0, 0) == BZ_OK;
+    if (!init_) {
+      AERROR << "BZ2_bzCompressInit failed, level: " << level;
+    }
+  }
+
+  ~Bz2OutputStream() {
+    if (init_) {
+      BZ2_bzCompressEnd(&stream_);
+    }
+  }
+
+  bool Write(const void* buffer, int size) override {
+    raw_size_ += size;
+    stream_.next_in = static_cast<char*>(const_cast<void*>(buffer));
+    stream_.avail_in = static_cast<unsigned int>(size);
+    while (init_ && stream_.avail_in > 0) {
+      if (!Compress(BZ_RUN, BZ_RUN_OK)) {
+        return false;
+      }
+    }
+    return init_;
+  }
+
+  bool Finish() override {
+    int ret = BZ_FINISH_OK;
+    while (init_ && ret == BZ_FINISH_OK) {
+      stream_.next_out = out_.data();
+      stream_.avail_out = static_cast<unsigned int>(out_.size());
+      ret = BZ2_bzCompress(&stream_, BZ_FINISH);
+      if (!WriteFd(out_.data(), out_.size() - stream_.avail_out)) {
+        return false;
+      }
+    }
+    return ret == BZ_STREAM_END;
+  }
+
+ private:
+  bool Compress(int action, int expected) {
+    stream_.next_out = out_.data();
+    stream_.avail_out = static_cast<unsigned int>(out_.size());
+    int ret = BZ2_bzCompress(&stream_, action);
+    if (ret != expected) {
+      AERROR << "BZ2_bzCompress failed, ret: " << ret;
+      return false;
+    }
+    return WriteFd(out_.data(), out_.size() - stream_.avail_out);
+  }
+
+  bz_stream stream_;
+  bool init_ = false;
+  std::vector<char> out_;
+};
+
+class Bz2InputStream : public ChunkInputStream {
+ public:
+  Bz2InputStream(int fd, int64_t size)
+      : ChunkInputStream(fd, size), in_(kBufferSize) {
+    memset(&stream_, 0, sizeof(stream_));
+    init_ = BZ2_bzDecompressInit(&stream_, 0, 0) == BZ_OK;
+    if (!init_) {
+      AERROR << "BZ2_bzDecompressInit failed.";
+    }
+  }
+
+  ~Bz2InputStream() {
+    if (init_) {
+      BZ2_bzDecompressEnd(&stream_);
+    }
+  }
+
+  int Read(void* buffer, int size) override {
+    if (!init_) {
+      return -1;
+    }
+    stream_.next_out = static_cast<char*>(buffer);
+    stream_.avail_out = static_cast<unsigned int>(size);
+    while (!finished_ && stream_.avail_out == static_cast<unsigned int>(size)) {
+      if (stream_.avail_in == 0) {
+        int count = ReadFd(in_.data(), in_.size());
+        if (count <= 0) {
+          // section exhausted before the end of the bz2 stream
+          return -1;
+        }
+        stream_.next_in = in_.data();
+        stream_.avail_in = static_cast<unsigned int>(count);
+      }
+      int ret = BZ2_bzDecompress(&stream_);
+      if (ret == BZ_STREAM_END) {
+        finished_ = true;
+      } else if (ret != BZ_OK) {
+        AERROR << "BZ2_bzDecompress failed, ret: " << ret;
+        return -1;
+      }
+    }
+    return size - static_cast<int>(stream_.avail_out);
+  }
+
+ private:
+  bz_stream stream_;
+  bool init_ = false;
+  bool finished_ = false;
+  std::vector<char> in_;
+};
+
+class Lz4OutputStream : public ChunkOutputStream {
+ public:
+  Lz4OutputStream(int level, int fd) : ChunkOutputStream(fd) {
+    memset(&prefs_, 0, sizeof(prefs_));
+    prefs_.compressionLevel = level;
+    prefs_.frameInfo.blockSizeID = LZ4F_max256KB;
+    out_.resize(std::max<size_t>(LZ4F_compressBound(kBufferSize, &prefs_),
+                                 LZ4F_HEADER_SIZE_MAX));
+    if (LZ4F_isError(
+            LZ4F_createCompressionContext(&context_, LZ4F_VERSION))) {
+      AERROR << "LZ4F_createCompressionContext failed.";
+      context_ = nullptr;
+    }
+  }
+
+  ~Lz4OutputStream() {
+    if (context_ != nullptr) {
+      LZ4F_freeCompressionContext(context_);
+    }
+  }
+
+  bool Write(const void* buffer, int size) override {
+    if (context_ == nullptr || !Begin()) {
+      return false;
+    }
+    raw_size_ += size;
+    auto data = static_cast<const char*>(buffer);
+    while (size > 0) {
+      size_t piece = std::min(static_cast<size_t>(size), kBufferSize);
+      size_t ret = LZ4F_compressUpdate(context_, out_.data(), out_.size(),
+                                       data, piece, nullptr);
+      if (LZ4F_isError(ret)) {
+        AERROR << "LZ4F_compressUpdate failed: " << LZ4F_getErrorName(ret);
+        return false;
+      }
+      if (!WriteFd(out_.data(), ret)) {
+        return false;
+      }
+      data += piece;
+      size -= static_cast<int>(piece);
+    }
+    return true;
+  }
+
+  bool Finish() override {
+    if (context_ == nullptr || !Begin()) {
+      return false;
+    }
+    size_t ret = LZ4F_compressEnd(context_, out_.data(), out_.size(), nullptr);
+    if (LZ4F_isError(ret)) {
+      AERROR << "LZ4F_compressEnd failed: " << LZ4F_getErrorName(ret);
+      return false;
+    }
+    return WriteFd(out_.data(), ret);
+  }
+
+ private:
+  bool Begin() {
+    if (begun_) {
+      return true;
+    }
+    size_t ret =
+        LZ4F_compressBegin(context_, out_.data(), out_.size(), &prefs_);
+    if (LZ4F_isError(ret)) {
+      AERROR << "LZ4F_compressBegin failed: " << LZ4F_getErrorName(ret);
+      return false;
+    }
+    begun_ = true;
+    return WriteFd(out_.data(), ret);
+  }
+
+  LZ4F_compressionContext_t context_ = nullptr;
+  LZ4F_preferences_t prefs_;
+  bool begun_ = false;
+  std::vector<char> out_;
+};
+
+class Lz4InputStream : public ChunkInputStream {
+ public:
+  Lz4InputStream(int fd, int64_t size)
+      : ChunkInputStream(fd, size), in_(kBufferSize) {
+    if (LZ4F_isError(
+            LZ4F_createDecompressionContext(&context_, LZ4F_VERSION))) {
+      AERROR << "LZ4F_createDecompressionContext failed.";
+      context_ = nullptr;
+    }
+  }
+
+  ~Lz4InputStream() {
+    if (context_ != nullptr) {
+      LZ4F_freeDecompressionContext(context_);
+    }
+  }
+
+  int Read(void* buffer, int size) override {
+    if (context_ == nullptr) {
+      return -1;
+    }
+    auto out = static_cast<char*>(buffer);
+    size_t produced = 0;
+    while (!finished_ && produced == 0) {
+      if (in_pos_ == in_size_) {
+        int count = ReadFd(in_.data(), in_.size());
+        if (count <= 0) {
+          return -1;
+        }
+        in_pos_ = 0;
+        in_size_ = static_cast<size_t>(count);
+      }
+      size_t dst_size = static_cast<size_t>(size);
+      size_t src_size = in_size_ - in_pos_;
+      size_t ret = LZ4F_decompress(context_, out, &dst_size,
+                                   in_.data() + in_pos_, &src_size, nullptr);
+      if (LZ4F_isError(ret)) {
+        AERROR << "LZ4F_decompress failed: " << LZ4F_getErrorName(ret);
+        return -1;
+      }
+      in_pos_ += src_size;
+      produced = dst_size;
+      finished_ = ret == 0;
+    }
+    return static_cast<int>(produced);
+  }
+
+ private:
+  LZ4F_decompressionContext_t context_ = nullptr;
+  bool finished_ = false;
+  std::vector<char> in_;
+  size_t in_pos_ = 0;
+  size_t in_size_ = 0;
+};
+
+}  // namespace
+
+bool ChunkOutputStream::WriteFd(const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t count = write(fd_, data, size);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    data += count;
+    size -= static_cast<size_t>(count);
+    compressed_size_ += static_cast<uint64_t>(count);
+  }
+  return true;
+}
+
+int ChunkInputStream::ReadFd(char* buf, size_t size) {
+  if (remaining_ <= 0) {
+    return 0;
+  }
+  size = std::min(size, static_cast<size_t>(remaining_));
+  ssize_t count;
+  do {
+    count = read(fd_, buf, size);
+  } while (count < 0 && errno == EINTR);
+  if (count < 0) {
+    AERROR << "Read fd failed, fd: " << fd_ << ", errno: " << errno;
+    return -1;
+  }
+  if (count == 0) {
+    truncated_ = true;
+  }
+  remaining_ -= count;
+  return static_cast<int>(count);
+}
+
+std::unique_ptr<ChunkOutputStream> NewChunkOutputStream(CompressType type,
+                                                        int level, int fd) {
+  switch (type) {
+    case CompressType::COMPRESS_BZ2:
+      return std::unique_ptr<ChunkOutputStream>(new Bz2OutputStream(level, fd));
+    case CompressType::COMPRESS_LZ4:
+      return std::unique_ptr<ChunkOutputStream>(new Lz4OutputStream(level, fd));
+    default:
+      return nullptr;
+  }
+}
+
+std::unique_ptr<ChunkInputStream> NewChunkInputStream(CompressType type,
+                                                      int fd, int64_t size) {
+  switch (type) {
+    case CompressType::COMPRESS_BZ2:
+      return std::unique_ptr<ChunkInputStream>(new Bz2InputStream(fd, size));
+    case CompressType::COMPRESS_LZ4:
+      return std::unique_ptr<ChunkInputStream>(new Lz4InputStream(fd, size));
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_RECORD_FILE_CHUNK_CODEC_H_
+#define CYBER_RECORD_FILE_CHUNK_CODEC_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+
+#include "cyber/proto/record.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+// block size of the protobuf adaptors wrapped around the codec streams
+constexpr size_t kChunkStreamBlockSize = 64 * 1024;
+
+/**
+ * @brief Compresses a serialized chunk body straight into a file descriptor.
+ * Use it through a CopyingOutputStreamAdaptor and call Finish() after the
+ * adaptor has been flushed.
+ */
+class ChunkOutputStream : public google::protobuf::io::CopyingOutputStream {
+ public:
+  explicit ChunkOutputStream(int fd) : fd_(fd) {}
+  virtual ~ChunkOutputStream() = default;
+
+  /**
+   * @brief Write the trailer of the compressed stream.
+   *
+   * @return True if all compressed bytes reached the file.
+   */
+  virtual bool Finish() = 0;
+
+  uint64_t raw_size() const { return raw_size_; }
+  uint64_t compressed_size() const { return compressed_size_; }
+
+ protected:
+  bool WriteFd(const char* data, size_t size);
+
+  int fd_;
+  uint64_t raw_size_ = 0;
+  uint64_t compressed_size_ = 0;
+};
+
+/**
+ * @brief Decompresses `size` bytes of a chunk body section read from a file
+ * descriptor. Use it through a CopyingInputStreamAdaptor.
+ */
+class ChunkInputStream : public google::protobuf::io::CopyingInputStream {
+ public:
+  ChunkInputStream(int fd, int64_t size) : fd_(fd), remaining_(size) {}
+  virtual ~ChunkInputStream() = default;
+
+  /**
+   * @brief Whether the file ended before the section did.
+   */
+  bool truncated() const { return truncated_; }
+
+ protected:
+  // Reads at most `size` bytes of the section, 0 when it is exhausted.
+  int ReadFd(char* buf, size_t size);
+
+  int fd_;
+  int64_t remaining_;
+  bool truncated_ = false;
+};
+
+/**
+ * @brief Create the compressor for `type`, nullptr for COMPRESS_NONE.
+ *
+ * @param type
+ * @param level codec level, 0 selects the codec default
+ * @param fd
+ */
+std::unique_ptr<ChunkOutputStream> NewChunkOutputStream(
+    proto::CompressType type, int level, int fd);
+
+/**
+ * @brief Create the decompressor for `type`, nullptr for COMPRESS_NONE.
+ */
+std::unique_ptr<ChunkInputStream> NewChunkInputStream(proto::CompressType type,
+                                                      int fd, int64_t size);
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_RECORD_FILE_CHUNK_CODEC_H_
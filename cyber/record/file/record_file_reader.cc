@@ -17,6 +17,7 @@
 #include "cyber/record/file/record_file_reader.h"
 
 #include "cyber/common/file.h"
+#include "cyber/record/file/chunk_codec.h"
 
 namespace apollo {
 namespace cyber {
@@ -114,6 +115,35 @@ bool RecordFileReader::ReadIndex() {
   return true;
 }
 
+bool RecordFileReader::ReadCompressedSection(
+    int64_t size, google::protobuf::Message* message) {
+  int64_t pos = CurrentPosition();
+  auto stream = NewChunkInputStream(header_.compress(), fd_, size);
+  if (stream == nullptr) {
+    AERROR << "Unsupported compress type: " << header_.compress();
+    return false;
+  }
+  bool parsed = false;
+  {
+    google::protobuf::io::CopyingInputStreamAdaptor adaptor(
+        stream.get(), static_cast<int>(kChunkStreamBlockSize));
+    parsed = message->ParseFromZeroCopyStream(&adaptor);
+  }
+  if (stream->truncated()) {
+    end_of_file_ = true;
+  }
+  if (!parsed) {
+    AERROR << "Parse compressed section message failed.";
+    return false;
+  }
+  // the codec stream may end before the section does
+  if (!SetPosition(pos + size)) {
+    AERROR << "Skip to the end of compressed section failed.";
+    return false;
+  }
+  return true;
+}
+
 bool RecordFileReader::ReadSection(Section* section) {
   ssize_t count = read(fd_, section, sizeof(struct Section));
   if (count < 0) {
@@ -24,6 +24,7 @@
 #include <utility>
 
 #include <limits>
+#include <type_traits>
 #include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/message.h"
@@ -58,6 +59,7 @@ class RecordFileReader : public RecordFileBase {
 
  private:
   bool ReadHeader();
+  bool ReadCompressedSection(int64_t size, google::protobuf::Message* message);
   bool end_of_file_ = false;
 };
 
@@ -68,6 +70,10 @@ bool RecordFileReader::ReadSection(int64_t size, T* message) {
     AERROR << "Size value greater than the range of int value.";
     return false;
   }
+  if (std::is_same<T, proto::ChunkBody>::value &&
+      header_.compress() != proto::CompressType::COMPRESS_NONE) {
+    return ReadCompressedSection(size, message);
+  }
   FileInputStream raw_input(fd_, static_cast<int>(size));
   CodedInputStream coded_input(&raw_input);
   CodedInputStream::Limit limit = coded_input.PushLimit(static_cast<int>(size));
@@ -14,6 +14,7 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <sys/stat.h>
 #include <unistd.h>
 #include <atomic>
 #include <string>
@@ -33,6 +34,7 @@ namespace record {
 using apollo::cyber::proto::Channel;
 using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkHeader;
+using apollo::cyber::proto::CompressType;
 using apollo::cyber::proto::Header;
 using apollo::cyber::proto::SectionType;
 using apollo::cyber::proto::SingleMessage;
@@ -308,6 +310,161 @@ TEST(RecordFileTest, TestIndex) {
   }
 }
 
+TEST(RecordFileTest, TestCompressedChunks) {
+  const std::string content(200, 'x');
+  const int msg_num = 50;
+  for (auto type : {CompressType::COMPRESS_BZ2, CompressType::COMPRESS_LZ4}) {
+    {
+      RecordFileWriter rfw;
+      ASSERT_TRUE(rfw.Open(kTestFile1));
+      Header header = HeaderBuilder::GetHeaderWithChunkParams(0, 1024);
+      header.set_segment_interval(0);
+      header.set_segment_raw_size(0);
+      header.set_compress(type);
+      ASSERT_TRUE(rfw.WriteHeader(header));
+
+      Channel chan1;
+      chan1.set_name(kChan1);
+      chan1.set_message_type(kMsgType);
+      ASSERT_TRUE(rfw.WriteChannel(chan1));
+
+      for (int i = 0; i < msg_num; ++i) {
+        SingleMessage msg;
+        msg.set_channel_name(chan1.name());
+        msg.set_content(content + std::to_string(i));
+        msg.set_time(i + 1);
+        ASSERT_TRUE(rfw.WriteMessage(msg));
+      }
+      rfw.Close();
+      ASSERT_EQ(msg_num, rfw.GetHeader().message_number());
+      ASSERT_LT(1, rfw.GetHeader().chunk_number());
+    }
+
+    RecordFileReader rfr;
+    ASSERT_TRUE(rfr.Open(kTestFile1));
+    ASSERT_EQ(type, rfr.GetHeader().compress());
+
+    // every chunk body in the index shrank
+    ASSERT_TRUE(rfr.ReadIndex());
+    for (const auto& row : rfr.GetIndex().indexes()) {
+      if (row.type() == SectionType::SECTION_CHUNK_BODY) {
+        EXPECT_LT(row.chunk_body_cache().compressed_size(),
+                  row.chunk_body_cache().raw_size());
+      }
+    }
+
+    int count = 0;
+    Section section;
+    while (rfr.ReadSection(&section)) {
+      if (section.type == SectionType::SECTION_INDEX) {
+        break;
+      }
+      if (section.type != SectionType::SECTION_CHUNK_BODY) {
+        ASSERT_TRUE(rfr.SkipSection(section.size));
+        continue;
+      }
+      ChunkBody chunk_body;
+      ASSERT_TRUE(rfr.ReadSection<ChunkBody>(section.size, &chunk_body));
+      for (const auto& msg : chunk_body.messages()) {
+        EXPECT_EQ(content + std::to_string(count), msg.content());
+        EXPECT_EQ(count + 1, msg.time());
+        ++count;
+      }
+    }
+    EXPECT_EQ(msg_num, count);
+    ASSERT_FALSE(remove(kTestFile1));
+  }
+}
+
+TEST(RecordFileTest, TestFlushBackPressure) {
+  const std::string content(200, 'x');
+  const int msg_num = 2000;
+  for (auto policy : {BackPressurePolicy::BLOCK, BackPressurePolicy::DROP,
+                      BackPressurePolicy::SPILL}) {
+    FlushOptions options;
+    options.chunk_buffer_num = 2;
+    options.policy = policy;
+    options.channel_priority[kChan1] = 1;
+    options.max_spill_chunks = 4;
+    options.preallocate_size = 16 * 1024 * 1024;
+    options.drop_written_pages = true;
+    FlushStats stats;
+    {
+      RecordFileWriter rfw(options);
+      ASSERT_TRUE(rfw.Open(kTestFile1));
+      // bz2 keeps the flush thread busy so that the buffers run out
+      Header header = HeaderBuilder::GetHeaderWithChunkParams(0, 1024);
+      header.set_segment_interval(0);
+      header.set_segment_raw_size(0);
+      header.set_compress(CompressType::COMPRESS_BZ2);
+      ASSERT_TRUE(rfw.WriteHeader(header));
+      for (auto name : {kChan1, kChan2}) {
+        Channel chan;
+        chan.set_name(name);
+        chan.set_message_type(kMsgType);
+        ASSERT_TRUE(rfw.WriteChannel(chan));
+      }
+      for (int i = 0; i < msg_num; ++i) {
+        SingleMessage msg;
+        msg.set_channel_name(i % 2 == 0 ? kChan1 : kChan2);
+        msg.set_content(content);
+        msg.set_time(i + 1);
+        ASSERT_TRUE(rfw.WriteMessage(msg));
+      }
+      rfw.Close();
+      stats = rfw.GetFlushStats();
+      EXPECT_EQ(rfw.GetHeader().chunk_number(), stats.written_chunks);
+      EXPECT_EQ(msg_num - stats.dropped_messages,
+                rfw.GetHeader().message_number());
+    }
+    EXPECT_EQ(0, stats.queued_chunks);
+    EXPECT_LE(stats.max_queued_chunks,
+              options.chunk_buffer_num - 1 + options.max_spill_chunks);
+    EXPECT_LE(stats.max_write_latency_ns, stats.total_write_latency_ns);
+    if (policy != BackPressurePolicy::DROP) {
+      EXPECT_EQ(0, stats.dropped_messages);
+    }
+    if (policy != BackPressurePolicy::SPILL) {
+      EXPECT_EQ(0, stats.spilled_chunks);
+    }
+
+    // the unused preallocated space is not part of the file
+    struct stat file_stat;
+    ASSERT_EQ(0, stat(kTestFile1, &file_stat));
+    EXPECT_LT(file_stat.st_size, options.preallocate_size);
+
+    RecordFileReader rfr;
+    ASSERT_TRUE(rfr.Open(kTestFile1));
+    uint64_t last_time = 0;
+    int kept = 0;
+    int count = 0;
+    Section section;
+    while (rfr.ReadSection(&section)) {
+      if (section.type == SectionType::SECTION_INDEX) {
+        break;
+      }
+      if (section.type != SectionType::SECTION_CHUNK_BODY) {
+        ASSERT_TRUE(rfr.SkipSection(section.size));
+        continue;
+      }
+      ChunkBody chunk_body;
+      ASSERT_TRUE(rfr.ReadSection<ChunkBody>(section.size, &chunk_body));
+      for (const auto& msg : chunk_body.messages()) {
+        EXPECT_LT(last_time, msg.time());
+        last_time = msg.time();
+        if (msg.channel_name() == kChan1) {
+          ++kept;
+        }
+        ++count;
+      }
+    }
+    // only the low priority channel is dropped
+    EXPECT_EQ(msg_num / 2, kept);
+    EXPECT_EQ(msg_num - stats.dropped_messages, count);
+    ASSERT_FALSE(remove(kTestFile1));
+  }
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
@@ -18,7 +18,10 @@
 
 #include <fcntl.h>
 
+#include <algorithm>
+
 #include "cyber/common/file.h"
+#include "cyber/record/file/chunk_codec.h"
 #include "cyber/time/time.h"
 
 namespace apollo {
@@ -35,7 +38,24 @@ using apollo::cyber::proto::Header;
 using apollo::cyber::proto::SectionType;
 using apollo::cyber::proto::SingleIndex;
 
-RecordFileWriter::RecordFileWriter() : is_writing_(false) {}
+void FlushStats::Merge(const FlushStats& other) {
+  queued_chunks = other.queued_chunks;
+  max_queued_chunks = std::max(max_queued_chunks, other.max_queued_chunks);
+  written_chunks += other.written_chunks;
+  blocked_writes += other.blocked_writes;
+  dropped_messages += other.dropped_messages;
+  spilled_chunks += other.spilled_chunks;
+  last_write_latency_ns = other.last_write_latency_ns;
+  max_write_latency_ns =
+      std::max(max_write_latency_ns, other.max_write_latency_ns);
+  total_write_latency_ns += other.total_write_latency_ns;
+}
+
+RecordFileWriter::RecordFileWriter()
+    : is_writing_(false), saturated_(false) {}
+
+RecordFileWriter::RecordFileWriter(const FlushOptions& options)
+    : options_(options), is_writing_(false), saturated_(false) {}
 
 RecordFileWriter::~RecordFileWriter() { Close(); }
 
@@ -52,8 +72,23 @@ bool RecordFileWriter::Open(const std::string& path) {
            << ", errno: " << errno;
     return false;
   }
+  if (options_.preallocate_size > 0 &&
+      fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0,
+                static_cast<off_t>(options_.preallocate_size)) < 0) {
+    AWARN << "Preallocate file failed, file: " << path_
+          << ", errno: " << errno;
+  }
   chunk_active_.reset(new Chunk());
-  chunk_flush_.reset(new Chunk());
+  free_chunks_.clear();
+  flush_queue_.clear();
+  uint32_t chunk_buffer_num = std::max(options_.chunk_buffer_num, 2U);
+  for (uint32_t i = 1; i < chunk_buffer_num; ++i) {
+    free_chunks_.emplace_back(new Chunk());
+  }
+  spilled_chunks_ = 0;
+  saturated_ = false;
+  stats_ = FlushStats();
+  synced_position_ = 0;
   is_writing_ = true;
   flush_thread_ = std::make_shared<std::thread>([this]() { this->Flush(); });
   if (flush_thread_ == nullptr) {
@@ -65,37 +100,19 @@ bool RecordFileWriter::Open(const std::string& path) {
 
 void RecordFileWriter::Close() {
   if (is_writing_) {
-    // wait for the flush operation that may exist now
-    while (1) {
-      {
-        std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-        if (chunk_flush_->empty()) {
-          break;
-        }
-      }
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-
-    // last swap
     {
       std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-      chunk_flush_.swap(chunk_active_);
-      flush_cv_.notify_one();
-    }
-
-    // wait for the last flush operation
-    while (1) {
-      {
-        std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-        if (chunk_flush_->empty()) {
-          break;
-        }
+      if (!chunk_active_->empty()) {
+        flush_queue_.push_back(std::move(chunk_active_));
+        chunk_active_.reset(new Chunk());
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      flush_cv_.notify_all();
+      // wait for every queued chunk to reach the file
+      flush_cv_.wait(flush_lock,
+                     [this] { return flush_queue_.empty() && !flushing_; });
+      is_writing_ = false;
+      flush_cv_.notify_all();
     }
-
-    is_writing_ = false;
-    flush_cv_.notify_all();
     if (flush_thread_ && flush_thread_->joinable()) {
       flush_thread_->join();
       flush_thread_ = nullptr;
@@ -104,12 +121,21 @@ void RecordFileWriter::Close() {
     if (!WriteIndex()) {
       AERROR << "Write index section failed, file: " << path_;
     }
+    int64_t end = CurrentPosition();
 
     header_.set_is_complete(true);
     if (!WriteHeader(header_)) {
       AERROR << "Overwrite header section failed, file: " << path_;
     }
 
+    // give back the preallocated blocks the recording did not use
+    if (options_.preallocate_size > static_cast<uint64_t>(end) &&
+        fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, end,
+                  static_cast<off_t>(options_.preallocate_size) - end) < 0) {
+      AWARN << "Release preallocated space failed, file: " << path_
+            << ", errno: " << errno;
+    }
+
     if (close(fd_) < 0) {
       AERROR << "Close file failed, file: " << path_ << ", fd: " << fd_
              << ", errno: " << errno;
@@ -187,9 +213,19 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   single_index->set_allocated_chunk_header_cache(chunk_header_cache);
 
   pos = CurrentPosition();
-  if (!WriteSection<ChunkBody>(chunk_body)) {
-    AERROR << "Write chunk body fail";
-    return false;
+  ChunkBodyCache chunk_body_cache;
+  if (header_.compress() != proto::CompressType::COMPRESS_NONE) {
+    if (!WriteCompressedSection(chunk_body, &chunk_body_cache)) {
+      AERROR << "Write compressed chunk body fail";
+      return false;
+    }
+  } else {
+    if (!WriteSection<ChunkBody>(chunk_body)) {
+      AERROR << "Write chunk body fail";
+      return false;
+    }
+    chunk_body_cache.set_raw_size(chunk_body.ByteSizeLong());
+    chunk_body_cache.set_compressed_size(chunk_body.ByteSizeLong());
   }
   header_.set_chunk_number(header_.chunk_number() + 1);
   if (header_.begin_time() == 0) {
@@ -201,13 +237,85 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   single_index = index_.add_indexes();
   single_index->set_type(SectionType::SECTION_CHUNK_BODY);
   single_index->set_position(pos);
-  ChunkBodyCache* chunk_body_cache = new ChunkBodyCache();
-  chunk_body_cache->set_message_number(chunk_body.messages_size());
-  single_index->set_allocated_chunk_body_cache(chunk_body_cache);
+  chunk_body_cache.set_message_number(chunk_body.messages_size());
+  *single_index->mutable_chunk_body_cache() = chunk_body_cache;
+  if (options_.drop_written_pages) {
+    DropWrittenPages(static_cast<int64_t>(single_index->position()),
+                     CurrentPosition());
+  }
+  return true;
+}
+
+void RecordFileWriter::DropWrittenPages(int64_t begin, int64_t end) {
+  // start write-back of the new chunk, then wait for the data written before
+  // it, which has had a whole chunk of time to reach the disk, and drop it
+  // from the page cache
+  sync_file_range(fd_, begin, end - begin, SYNC_FILE_RANGE_WRITE);
+  if (synced_position_ < begin) {
+    sync_file_range(fd_, synced_position_, begin - synced_position_,
+                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                        SYNC_FILE_RANGE_WAIT_AFTER);
+    posix_fadvise(fd_, synced_position_, begin - synced_position_,
+                  POSIX_FADV_DONTNEED);
+    synced_position_ = begin;
+  }
+}
+
+bool RecordFileWriter::WriteCompressedSection(
+    const ChunkBody& chunk_body, ChunkBodyCache* chunk_body_cache) {
+  // the compressed size is unknown up front, patch the section afterwards
+  uint64_t pos = CurrentPosition();
+  Section section;
+  /// zero out whole struct even if padded
+  memset(&section, 0, sizeof(section));
+  section = {SectionType::SECTION_CHUNK_BODY, 0};
+  ssize_t count = write(fd_, &section, sizeof(section));
+  if (count != sizeof(section)) {
+    AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+    return false;
+  }
+
+  auto stream =
+      NewChunkOutputStream(header_.compress(), header_.compress_level(), fd_);
+  if (stream == nullptr) {
+    AERROR << "Unsupported compress type: " << header_.compress();
+    return false;
+  }
+  {
+    google::protobuf::io::CopyingOutputStreamAdaptor adaptor(
+        stream.get(), static_cast<int>(kChunkStreamBlockSize));
+    if (!chunk_body.SerializeToZeroCopyStream(&adaptor) || !adaptor.Flush()) {
+      AERROR << "Compress chunk body failed.";
+      return false;
+    }
+  }
+  if (!stream->Finish()) {
+    AERROR << "Finish compressed chunk body failed.";
+    return false;
+  }
+
+  section.size = static_cast<int64_t>(stream->compressed_size());
+  count = pwrite(fd_, &section, sizeof(section), static_cast<off_t>(pos));
+  if (count != sizeof(section)) {
+    AERROR << "Patch section size failed, fd: " << fd_ << ", errno: " << errno;
+    return false;
+  }
+  chunk_body_cache->set_raw_size(stream->raw_size());
+  chunk_body_cache->set_compressed_size(stream->compressed_size());
+  header_.set_size(CurrentPosition());
   return true;
 }
 
 bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
+  if (!is_writing_) {
+    AERROR << "Write message to a closed file, file: " << path_;
+    return false;
+  }
+  if (ShouldDrop(message.channel_name())) {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    ++stats_.dropped_messages;
+    return true;
+  }
   chunk_active_->add(message);
   auto it = channel_message_number_map_.find(message.channel_name());
   if (it != channel_message_number_map_.end()) {
@@ -229,32 +337,87 @@ bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
   if (!need_flush) {
     return true;
   }
-  {
-    std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-    chunk_flush_.swap(chunk_active_);
-    flush_cv_.notify_one();
+  return QueueActiveChunk();
+}
+
+bool RecordFileWriter::ShouldDrop(const std::string& channel_name) const {
+  if (options_.policy != BackPressurePolicy::DROP || !saturated_) {
+    return false;
+  }
+  auto it = options_.channel_priority.find(channel_name);
+  int priority = it == options_.channel_priority.end() ? 0 : it->second;
+  return priority < options_.drop_priority;
+}
+
+bool RecordFileWriter::QueueActiveChunk() {
+  std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+  std::unique_ptr<Chunk> next = nullptr;
+  if (free_chunks_.empty() && options_.policy == BackPressurePolicy::SPILL &&
+      spilled_chunks_ < options_.max_spill_chunks) {
+    next.reset(new Chunk());
+    ++spilled_chunks_;
+    ++stats_.spilled_chunks;
+  } else {
+    if (free_chunks_.empty()) {
+      ++stats_.blocked_writes;
+      flush_cv_.wait(flush_lock, [this] { return !free_chunks_.empty(); });
+    }
+    next = std::move(free_chunks_.back());
+    free_chunks_.pop_back();
   }
+  flush_queue_.push_back(std::move(chunk_active_));
+  chunk_active_ = std::move(next);
+  saturated_ = free_chunks_.empty();
+  stats_.queued_chunks = flush_queue_.size();
+  stats_.max_queued_chunks =
+      std::max(stats_.max_queued_chunks, stats_.queued_chunks);
+  flush_cv_.notify_all();
   return true;
 }
 
 void RecordFileWriter::Flush() {
-  while (is_writing_) {
-    std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+  std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+  while (true) {
     flush_cv_.wait(flush_lock,
-                   [this] { return !chunk_flush_->empty() || !is_writing_; });
-    if (!is_writing_) {
+                   [this] { return !flush_queue_.empty() || !is_writing_; });
+    if (flush_queue_.empty()) {
       break;
     }
-    if (chunk_flush_->empty()) {
-      continue;
-    }
-    if (!WriteChunk(chunk_flush_->header_, *(chunk_flush_->body_.get()))) {
+    std::unique_ptr<Chunk> chunk = std::move(flush_queue_.front());
+    flush_queue_.pop_front();
+    flushing_ = true;
+    // compress and write without blocking WriteMessage, chunks still reach
+    // the file in queue order since this is the only writer
+    flush_lock.unlock();
+    uint64_t start = Time::MonoTime().ToNanosecond();
+    if (!WriteChunk(chunk->header_, *(chunk->body_.get()))) {
       AERROR << "Write chunk fail.";
     }
-    chunk_flush_->clear();
+    uint64_t latency = Time::MonoTime().ToNanosecond() - start;
+    chunk->clear();
+    flush_lock.lock();
+    flushing_ = false;
+    if (spilled_chunks_ > 0) {
+      --spilled_chunks_;
+    } else {
+      free_chunks_.push_back(std::move(chunk));
+    }
+    saturated_ = free_chunks_.empty();
+    stats_.queued_chunks = flush_queue_.size();
+    ++stats_.written_chunks;
+    stats_.last_write_latency_ns = latency;
+    stats_.max_write_latency_ns =
+        std::max(stats_.max_write_latency_ns, latency);
+    stats_.total_write_latency_ns += latency;
+    flush_cv_.notify_all();
   }
 }
 
+FlushStats RecordFileWriter::GetFlushStats() {
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+  return stats_;
+}
+
 uint64_t RecordFileWriter::GetMessageNumber(
     const std::string& channel_name) const {
   auto search = channel_message_number_map_.find(channel_name);
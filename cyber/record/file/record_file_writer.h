@@ -18,6 +18,7 @@
 #define CYBER_RECORD_FILE_RECORD_FILE_WRITER_H_
 
 #include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -25,6 +26,7 @@
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/message.h"
@@ -43,7 +45,12 @@ struct Chunk {
   Chunk() { clear(); }
 
   inline void clear() {
-    body_.reset(new proto::ChunkBody());
+    // keep the allocated messages of a recycled chunk for reuse
+    if (body_ == nullptr) {
+      body_.reset(new proto::ChunkBody());
+    } else {
+      body_->Clear();
+    }
     header_.set_begin_time(0);
     header_.set_end_time(0);
     header_.set_message_number(0);
@@ -74,9 +81,60 @@ struct Chunk {
   std::unique_ptr<proto::ChunkBody> body_ = nullptr;
 };
 
+/**
+ * @brief What the writer does when a chunk is full and every chunk buffer is
+ * still waiting for the disk.
+ */
+enum class BackPressurePolicy {
+  // wait for the flush thread to free a buffer
+  BLOCK = 0,
+  // drop messages of channels below drop_priority while no buffer is free,
+  // wait for the flush thread when a kept channel fills the chunk
+  DROP = 1,
+  // queue up to max_spill_chunks extra chunks on the heap, then block
+  SPILL = 2,
+};
+
+struct FlushOptions {
+  // chunk buffers allocated at open, including the one being filled
+  uint32_t chunk_buffer_num = 4;
+  BackPressurePolicy policy = BackPressurePolicy::BLOCK;
+  // priority of each channel, 0 for channels not listed
+  std::unordered_map<std::string, int> channel_priority;
+  int drop_priority = 1;
+  uint32_t max_spill_chunks = 16;
+  // bytes reserved with fallocate when the file is opened, 0 to disable.
+  // Off by default, cyber_recorder record reserves the segment size with
+  // -P/--preallocate.
+  uint64_t preallocate_size = 0;
+  // start write-back after every chunk and drop the written pages from the
+  // page cache, so a long recording does not build up dirty memory. Off by
+  // default, cyber_recorder record enables it with -D/--drop-page-cache.
+  bool drop_written_pages = false;
+};
+
+struct FlushStats {
+  uint64_t queued_chunks = 0;
+  uint64_t max_queued_chunks = 0;
+  uint64_t written_chunks = 0;
+  uint64_t blocked_writes = 0;
+  uint64_t dropped_messages = 0;
+  uint64_t spilled_chunks = 0;
+  uint64_t last_write_latency_ns = 0;
+  uint64_t max_write_latency_ns = 0;
+  uint64_t total_write_latency_ns = 0;
+
+  /**
+   * @brief Accumulate the counters of another writer, e.g. of a previous
+   * segment. The queue depth is taken from `other`.
+   */
+  void Merge(const FlushStats& other);
+};
+
 class RecordFileWriter : public RecordFileBase {
  public:
   RecordFileWriter();
+  explicit RecordFileWriter(const FlushOptions& options);
   virtual ~RecordFileWriter();
   bool Open(const std::string& path) override;
   void Close() override;
@@ -84,17 +142,34 @@ class RecordFileWriter : public RecordFileBase {
   bool WriteChannel(const proto::Channel& channel);
   bool WriteMessage(const proto::SingleMessage& message);
   uint64_t GetMessageNumber(const std::string& channel_name) const;
+  FlushStats GetFlushStats();
 
  private:
   bool WriteChunk(const proto::ChunkHeader& chunk_header,
                   const proto::ChunkBody& chunk_body);
   template <typename T>
   bool WriteSection(const T& message);
+  bool WriteCompressedSection(const proto::ChunkBody& chunk_body,
+                              proto::ChunkBodyCache* chunk_body_cache);
   bool WriteIndex();
+  bool ShouldDrop(const std::string& channel_name) const;
+  bool QueueActiveChunk();
+  void DropWrittenPages(int64_t begin, int64_t end);
   void Flush();
+  FlushOptions options_;
   std::atomic_bool is_writing_;
   std::unique_ptr<Chunk> chunk_active_ = nullptr;
-  std::unique_ptr<Chunk> chunk_flush_ = nullptr;
+  // chunk buffers ready to be filled, and full chunks waiting for the disk
+  std::vector<std::unique_ptr<Chunk>> free_chunks_;
+  std::deque<std::unique_ptr<Chunk>> flush_queue_;
+  // chunk the flush thread is writing, outside flush_queue_
+  bool flushing_ = false;
+  // chunks allocated past chunk_buffer_num by SPILL that are still in use
+  uint32_t spilled_chunks_ = 0;
+  // no chunk buffer is free, read by DROP without taking flush_mutex_
+  std::atomic_bool saturated_;
+  FlushStats stats_;
+  int64_t synced_position_ = 0;
   std::shared_ptr<std::thread> flush_thread_ = nullptr;
   std::mutex flush_mutex_;
   std::condition_variable flush_cv_;
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Full read throughput of RecordReader over a synthetic record, reported in
+// bytes/s of message content and messages/s. Argument: compress type (0
+// none, 1 bz2, 2 lz4).
+//
+//   bazel run -c opt //cyber/record:record_read_benchmark
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "cyber/record/header_builder.h"
+#include "cyber/record/record_reader.h"
+#include "cyber/record/record_writer.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+namespace {
+
+constexpr char kChannelName[] = "/apollo/benchmark/read";
+constexpr uint64_t kMessageSize = 1024;
+constexpr uint64_t kMessageNum = 256 * 1024;
+constexpr uint64_t kStepNs = 1000 * 1000ULL;
+
+std::string SyntheticRecord(proto::CompressType compress) {
+  const std::string path = "/tmp/record_read_benchmark_" +
+                           std::to_string(compress) + ".record";
+  if (common::PathExists(path)) {
+    return path;
+  }
+  auto header = HeaderBuilder::GetHeader();
+  header.set_compress(compress);
+  header.set_segment_interval(0);
+  header.set_segment_raw_size(0);
+  RecordWriter writer(header);
+  if (!writer.Open(path) ||
+      !writer.WriteChannel(kChannelName, "apollo.cyber.proto.Chatter", "")) {
+    return "";
+  }
+  std::string content(kMessageSize, ' ');
+  for (uint64_t i = 0; i < kMessageNum; ++i) {
+    // partly compressible, like serialized sensor messages
+    for (uint64_t j = 0; j < kMessageSize; j += 8) {
+      content[j] = static_cast<char>((i * 31 + j) & 0xff);
+    }
+    writer.WriteMessage<std::string>(kChannelName, content, (i + 1) * kStepNs);
+  }
+  writer.Close();
+  return path;
+}
+
+}  // namespace
+
+static void BM_RecordRead(benchmark::State& state) {
+  const auto compress = static_cast<proto::CompressType>(state.range(0));
+  const std::string path = SyntheticRecord(compress);
+  if (path.empty()) {
+    state.SkipWithError("write synthetic record failed");
+    return;
+  }
+  uint64_t bytes = 0;
+  uint64_t messages = 0;
+  for (auto _ : state) {
+    RecordReader reader(path);
+    RecordMessage message;
+    while (reader.ReadMessage(&message)) {
+      bytes += message.content.size();
+      ++messages;
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  state.counters["msgs"] = benchmark::Counter(
+      static_cast<double>(messages), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RecordRead)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
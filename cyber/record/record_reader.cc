@@ -16,6 +16,7 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace apollo {
@@ -53,10 +54,100 @@ RecordReader::RecordReader(const std::string& file) {
       channel_info_.insert(
           std::make_pair(channel_cache->name(), *channel_cache));
     }
+    BuildChunkIndex();
   }
   file_reader_->Reset();
 }
 
+void RecordReader::BuildChunkIndex() {
+  chunk_positions_.clear();
+  uint64_t max_end_time = 0;
+  for (const auto& single_idx : index_.indexes()) {
+    if (single_idx.type() != SectionType::SECTION_CHUNK_HEADER ||
+        !single_idx.has_chunk_header_cache()) {
+      continue;
+    }
+    const auto& cache = single_idx.chunk_header_cache();
+    max_end_time = std::max(max_end_time, cache.end_time());
+    chunk_positions_.push_back({static_cast<int64_t>(single_idx.position()),
+                                cache.begin_time(), max_end_time});
+  }
+  std::sort(chunk_positions_.begin(), chunk_positions_.end(),
+            [](const ChunkPosition& lhs, const ChunkPosition& rhs) {
+              return lhs.position < rhs.position;
+            });
+  chunk_index_ready_ = true;
+}
+
+bool RecordReader::ScanChunkIndex() {
+  // walk the chunk headers only, bodies are skipped with a seek
+  int64_t origin = file_reader_->CurrentPosition();
+  file_reader_->Reset();
+  chunk_positions_.clear();
+  uint64_t max_end_time = 0;
+  Section section;
+  while (true) {
+    int64_t pos = file_reader_->CurrentPosition();
+    if (!file_reader_->ReadSection(&section) ||
+        section.type == SectionType::SECTION_INDEX) {
+      break;
+    }
+    if (section.type != SectionType::SECTION_CHUNK_HEADER) {
+      if (!file_reader_->SkipSection(section.size)) {
+        break;
+      }
+      continue;
+    }
+    ChunkHeader header;
+    if (!file_reader_->ReadSection<ChunkHeader>(section.size, &header)) {
+      break;
+    }
+    max_end_time = std::max(max_end_time, header.end_time());
+    chunk_positions_.push_back({pos, header.begin_time(), max_end_time});
+  }
+  chunk_index_ready_ = true;
+  return file_reader_->SetPosition(origin);
+}
+
+void RecordReader::SkipToChunk(uint64_t begin_time) {
+  if (chunk_positions_.empty()) {
+    return;
+  }
+  int64_t pos = file_reader_->CurrentPosition();
+  auto next = std::lower_bound(
+      chunk_positions_.begin(), chunk_positions_.end(), pos,
+      [](const ChunkPosition& chunk, int64_t position) {
+        return chunk.position < position;
+      });
+  if (next == chunk_positions_.end() || next->max_end_time >= begin_time) {
+    return;
+  }
+  // max_end_time is monotonic, so this is the first chunk that can hold a
+  // message at or after begin_time
+  auto target = std::lower_bound(
+      next, chunk_positions_.end(), begin_time,
+      [](const ChunkPosition& chunk, uint64_t time) {
+        return chunk.max_end_time < time;
+      });
+  if (target == chunk_positions_.end()) {
+    reach_end_ = true;
+    return;
+  }
+  file_reader_->SetPosition(target->position);
+}
+
+bool RecordReader::Seek(uint64_t time) {
+  if (!is_valid_) {
+    return false;
+  }
+  if (!chunk_index_ready_ && !ScanChunkIndex()) {
+    return false;
+  }
+  Reset();
+  SkipToChunk(time);
+  return true;
+}
+
 void RecordReader::Reset() {
   file_reader_->Reset();
   reach_end_ = false;
@@ -110,6 +201,13 @@ bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
 }
 
 bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
+  if (!reach_end_) {
+    // files without a usable index pay for one header scan on the first seek
+    if (!chunk_index_ready_ && begin_time > header_.begin_time()) {
+      ScanChunkIndex();
+    }
+    SkipToChunk(begin_time);
+  }
   bool skip_next_chunk_body = false;
   while (!reach_end_) {
     Section section;
@@ -22,6 +22,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/proto/record.pb.h"
 
@@ -77,6 +78,17 @@ class RecordReader : public RecordBase {
    */
   void Reset();
 
+  /**
+   * @brief Jump to the first chunk that may hold messages at or after `time`.
+   * Uses the chunk headers of the index section, or a scan of chunk headers
+   * when the file has no usable index.
+   *
+   * @param time
+   *
+   * @return True for success, false for not.
+   */
+  bool Seek(uint64_t time);
+
   /**
    * @brief Get message number by channel name.
    *
@@ -114,13 +126,25 @@ class RecordReader : public RecordBase {
   std::set<std::string> GetChannelList() const override;
 
  private:
+  struct ChunkPosition {
+    int64_t position;
+    uint64_t begin_time;
+    // max end time of this chunk and all chunks before it in the file
+    uint64_t max_end_time;
+  };
+
   bool ReadNextChunk(uint64_t begin_time, uint64_t end_time);
+  void BuildChunkIndex();
+  bool ScanChunkIndex();
+  void SkipToChunk(uint64_t begin_time);
 
   bool is_valid_ = false;
   bool reach_end_ = false;
   std::unique_ptr<proto::ChunkBody> chunk_ = nullptr;
   proto::Index index_;
   int message_index_ = 0;
+  bool chunk_index_ready_ = false;
+  std::vector<ChunkPosition> chunk_positions_;
   ChannelInfoMap channel_info_;
   FileReaderPtr file_reader_;
 };
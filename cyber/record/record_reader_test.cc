@@ -20,6 +20,7 @@
 
 #include "gtest/gtest.h"
 
+#include "cyber/record/header_builder.h"
 #include "cyber/record/record_writer.h"
 
 namespace apollo {
@@ -122,6 +123,47 @@ TEST(RecordTest, TestReaderOrder) {
   ASSERT_FALSE(remove(kTestFile));
 }
 
+TEST(RecordTest, TestSeek) {
+  const uint32_t message_num = 1000;
+  // flush a chunk every few messages so that seeking has chunks to skip
+  RecordWriter writer(HeaderBuilder::GetHeaderWithChunkParams(0, 64));
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  writer.Open(kTestFile);
+  writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc);
+  for (uint32_t i = 0; i < message_num; ++i) {
+    auto msg = std::make_shared<RawMessage>(kStr10B + std::to_string(i));
+    writer.WriteMessage(kChannelName1, msg, (i + 1) * 10);
+  }
+  writer.Close();
+
+  RecordReader reader(kTestFile);
+  ASSERT_LT(1, reader.GetHeader().chunk_number());
+  RecordMessage message;
+  for (uint32_t i : {0u, 1u, 337u, 500u, 998u, 999u}) {
+    ASSERT_TRUE(reader.Seek((i + 1) * 10));
+    ASSERT_TRUE(reader.ReadMessage(&message, (i + 1) * 10));
+    EXPECT_EQ((i + 1) * 10, message.time);
+    EXPECT_EQ(kStr10B + std::to_string(i), message.content);
+  }
+
+  // a time between two messages yields the next one
+  ASSERT_TRUE(reader.Seek(4005));
+  ASSERT_TRUE(reader.ReadMessage(&message, 4005));
+  EXPECT_EQ(4010, message.time);
+
+  // reading with a later begin time skips chunks without Seek
+  reader.Reset();
+  ASSERT_TRUE(reader.ReadMessage(&message, 7000));
+  EXPECT_EQ(7000, message.time);
+  ASSERT_TRUE(reader.ReadMessage(&message, 9000));
+  EXPECT_EQ(9000, message.time);
+
+  ASSERT_TRUE(reader.Seek((message_num + 1) * 10));
+  ASSERT_FALSE(reader.ReadMessage(&message, (message_num + 1) * 10));
+  ASSERT_FALSE(remove(kTestFile));
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
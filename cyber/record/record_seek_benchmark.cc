@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Seek latency on a synthetic record: the chunk header walk that
+// RecordReader used to do on every jump against RecordReader::Seek and a
+// RecordViewer rebuilt at the target time, as the player does. Sizes are in
+// MB, the files are written once to /tmp and reused across runs.
+//
+//   bazel run -c opt //cyber/record:record_seek_benchmark -- \
+//       --benchmark_filter=/4096
+
+#include <memory>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "cyber/record/file/record_file_reader.h"
+#include "cyber/record/header_builder.h"
+#include "cyber/record/record_reader.h"
+#include "cyber/record/record_viewer.h"
+#include "cyber/record/record_writer.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+namespace {
+
+constexpr char kChannelName[] = "/apollo/benchmark/seek";
+constexpr uint64_t kMessageSize = 64 * 1024;
+constexpr uint64_t kStepNs = 10 * 1000 * 1000ULL;
+constexpr uint64_t kBeginNs = 1000 * kStepNs;
+
+uint64_t MessageNum(int64_t size_mb) {
+  return static_cast<uint64_t>(size_mb) * 1024 * 1024 / kMessageSize;
+}
+
+std::string SyntheticRecord(int64_t size_mb) {
+  const std::string path =
+      "/tmp/record_seek_benchmark_" + std::to_string(size_mb) + ".record";
+  if (common::PathExists(path)) {
+    return path;
+  }
+  auto header = HeaderBuilder::GetHeaderWithChunkParams(0, 1024 * 1024ULL);
+  header.set_segment_interval(0);
+  header.set_segment_raw_size(0);
+  RecordWriter writer(header);
+  if (!writer.Open(path) ||
+      !writer.WriteChannel(kChannelName, "apollo.cyber.proto.Chatter", "")) {
+    return "";
+  }
+  const std::string content(kMessageSize, 'x');
+  for (uint64_t i = 0; i < MessageNum(size_mb); ++i) {
+    writer.WriteMessage<std::string>(kChannelName, content,
+                                     kBeginNs + i * kStepNs);
+  }
+  writer.Close();
+  return path;
+}
+
+// Uniformly spread seek targets, fixed seed so every variant sees the same.
+class SeekTargets {
+ public:
+  explicit SeekTargets(int64_t size_mb)
+      : dist_(kBeginNs, kBeginNs + (MessageNum(size_mb) - 1) * kStepNs) {}
+  uint64_t Next() { return dist_(engine_); }
+
+ private:
+  std::mt19937_64 engine_{42};
+  std::uniform_int_distribution<uint64_t> dist_;
+};
+
+}  // namespace
+
+// Reading every chunk header from the start of the file and seeking over
+// bodies that end before the target, which is what ReadNextChunk did, then
+// decoding the chunk that holds the target.
+static void BM_RecordHeaderScanSeek(benchmark::State& state) {
+  const std::string path = SyntheticRecord(state.range(0));
+  RecordFileReader file_reader;
+  if (path.empty() || !file_reader.Open(path)) {
+    state.SkipWithError("open synthetic record failed");
+    return;
+  }
+  SeekTargets targets(state.range(0));
+  for (auto _ : state) {
+    const uint64_t target = targets.Next();
+    file_reader.Reset();
+    Section section;
+    proto::ChunkHeader header;
+    proto::ChunkBody body;
+    bool found = false;
+    while (file_reader.ReadSection(&section)) {
+      if (section.type == proto::SectionType::SECTION_INDEX) {
+        break;
+      }
+      if (section.type == proto::SectionType::SECTION_CHUNK_HEADER) {
+        file_reader.ReadSection<proto::ChunkHeader>(section.size, &header);
+        found = header.end_time() >= target;
+        continue;
+      }
+      if (found && section.type == proto::SectionType::SECTION_CHUNK_BODY) {
+        file_reader.ReadSection<proto::ChunkBody>(section.size, &body);
+        break;
+      }
+      file_reader.SkipSection(section.size);
+    }
+    benchmark::DoNotOptimize(body.messages_size());
+  }
+}
+BENCHMARK(BM_RecordHeaderScanSeek)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+// RecordReader::Seek plus the first message at the target.
+static void BM_RecordReaderSeek(benchmark::State& state) {
+  const std::string path = SyntheticRecord(state.range(0));
+  RecordReader reader(path);
+  if (path.empty() || !reader.IsValid()) {
+    state.SkipWithError("open synthetic record failed");
+    return;
+  }
+  SeekTargets targets(state.range(0));
+  RecordMessage message;
+  for (auto _ : state) {
+    const uint64_t target = targets.Next();
+    if (!reader.Seek(target) || !reader.ReadMessage(&message, target)) {
+      state.SkipWithError("seek failed");
+      break;
+    }
+    benchmark::DoNotOptimize(message.time);
+  }
+}
+BENCHMARK(BM_RecordReaderSeek)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+// A RecordViewer created at the target, as PlayTaskProducer::Reset does.
+static void BM_RecordViewerSeek(benchmark::State& state) {
+  const std::string path = SyntheticRecord(state.range(0));
+  auto reader = std::make_shared<RecordReader>(path);
+  if (path.empty() || !reader->IsValid()) {
+    state.SkipWithError("open synthetic record failed");
+    return;
+  }
+  SeekTargets targets(state.range(0));
+  for (auto _ : state) {
+    RecordViewer viewer(reader, targets.Next());
+    auto it = viewer.begin();
+    if (it == viewer.end()) {
+      state.SkipWithError("seek failed");
+      break;
+    }
+    benchmark::DoNotOptimize(it->time);
+  }
+}
+BENCHMARK(BM_RecordViewerSeek)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
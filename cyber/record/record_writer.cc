@@ -48,7 +48,8 @@ bool RecordWriter::Open(const std::string& file) {
   } else {
     path_ = file_;
   }
-  file_writer_.reset(new RecordFileWriter());
+  flush_stats_ = FlushStats();
+  file_writer_ = NewFileWriter();
   if (!file_writer_->Open(path_)) {
     AERROR << "Failed to open output record file: " << path_;
     return false;
@@ -69,8 +70,12 @@ void RecordWriter::Close() {
   }
 }
 
+RecordWriter::FileWriterPtr RecordWriter::NewFileWriter() const {
+  return FileWriterPtr(new RecordFileWriter(flush_options_));
+}
+
 bool RecordWriter::SplitOutfile() {
-  file_writer_.reset(new RecordFileWriter());
+  file_writer_ = NewFileWriter();
   if (file_index_ > 99999) {
     AWARN << "More than 99999 record files had been recored, will restart "
           << "counting from 0.";
@@ -147,6 +152,7 @@ bool RecordWriter::WriteMessage(const SingleMessage& message) {
        segment_raw_size_ > header_.segment_raw_size())) {
     file_writer_backup_.swap(file_writer_);
     file_writer_backup_->Close();
+    flush_stats_.Merge(file_writer_backup_->GetFlushStats());
     if (!SplitOutfile()) {
       AERROR << "Split out file is failed.";
       return false;
@@ -173,6 +179,24 @@ bool RecordWriter::SetIntervalOfFileSegmentation(uint64_t time_sec) {
   return true;
 }
 
+bool RecordWriter::SetFlushOptions(const FlushOptions& options) {
+  if (is_opened_) {
+    AWARN << "Please call this interface before opening file.";
+    return false;
+  }
+  flush_options_ = options;
+  return true;
+}
+
+FlushStats RecordWriter::GetFlushStats() {
+  std::lock_guard<std::mutex> lg(mutex_);
+  FlushStats stats = flush_stats_;
+  if (file_writer_ != nullptr) {
+    stats.Merge(file_writer_->GetFlushStats());
+  }
+  return stats;
+}
+
 bool RecordWriter::IsNewChannel(const std::string& channel_name) const {
   return channel_message_number_map_.find(channel_name) ==
          channel_message_number_map_.end();
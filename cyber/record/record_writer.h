@@ -126,6 +126,23 @@ class RecordWriter : public RecordBase {
    */
   bool SetIntervalOfFileSegmentation(uint64_t time_sec);
 
+  /**
+   * @brief Set the chunk buffers and back-pressure policy of the file
+   * writers.
+   *
+   * @param options
+   *
+   * @return True for success, false for fail.
+   */
+  bool SetFlushOptions(const FlushOptions& options);
+
+  /**
+   * @brief Get the flush counters summed over all segments written so far.
+   *
+   * @return Flush counters.
+   */
+  FlushStats GetFlushStats();
+
   /**
    * @brief Get message number by channel name.
    *
@@ -172,6 +189,7 @@ class RecordWriter : public RecordBase {
  private:
   bool WriteMessage(const proto::SingleMessage& single_msg);
   bool SplitOutfile();
+  FileWriterPtr NewFileWriter() const;
   void OnNewChannel(const std::string& channel_name,
                     const std::string& message_type,
                     const std::string& proto_desc);
@@ -186,6 +204,9 @@ class RecordWriter : public RecordBase {
   MessageProtoDescMap channel_proto_desc_map_;
   FileWriterPtr file_writer_ = nullptr;
   FileWriterPtr file_writer_backup_ = nullptr;
+  FlushOptions flush_options_;
+  // counters of the segments already closed
+  FlushStats flush_stats_;
   std::mutex mutex_;
   std::stringstream sstream_;
 };
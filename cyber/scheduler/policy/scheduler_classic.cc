@@ -23,6 +23,7 @@
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/policy/work_stealing_context.h"
 #include "cyber/scheduler/processor.h"
 
 namespace apollo {
@@ -94,9 +95,17 @@ void SchedulerClassic::CreateProcessor() {
     auto processor_prio = group.processor_prio();
     std::vector<int> cpuset;
     ParseCpuset(group.cpuset(), &cpuset);
+    if (group.work_stealing()) {
+      stealing_groups_.insert(group_name);
+    }
 
     for (uint32_t i = 0; i < proc_num; i++) {
-      auto ctx = std::make_shared<ClassicContext>(group_name);
+      std::shared_ptr<ProcessorContext> ctx;
+      if (group.work_stealing()) {
+        ctx = std::make_shared<WorkStealingContext>(group_name);
+      } else {
+        ctx = std::make_shared<ClassicContext>(group_name);
+      }
       pctxs_.emplace_back(ctx);
 
       auto proc = std::make_shared<Processor>();
@@ -147,6 +156,15 @@ bool SchedulerClassic::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
     cr->set_priority(MAX_PRIO - 1);
   }
 
+  if (IsWorkStealing(cr->group_name())) {
+    if (!WorkStealingContext::AddCRoutine(cr)) {
+      WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+      id_cr_.erase(cr->id());
+      return false;
+    }
+    return true;
+  }
+
   // Enqueue task.
   {
     WriteLockGuard<AtomicRWLock> lk(
@@ -169,6 +187,10 @@ bool SchedulerClassic::NotifyProcessor(uint64_t crid) {
     ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
     if (id_cr_.find(crid) != id_cr_.end()) {
       auto cr = id_cr_[crid];
+      if (IsWorkStealing(cr->group_name())) {
+        return WorkStealingContext::NotifyCRoutine(crid);
+      }
+
       if (cr->state() == RoutineState::DATA_WAIT ||
           cr->state() == RoutineState::IO_WAIT) {
         cr->SetUpdateFlag();
@@ -216,9 +238,16 @@ bool SchedulerClassic::RemoveCRoutine(uint64_t crid) {
       return false;
     }
   }
+  if (IsWorkStealing(cr->group_name())) {
+    return WorkStealingContext::RemoveCRoutine(cr);
+  }
   return ClassicContext::RemoveCRoutine(cr);
 }
 
+bool SchedulerClassic::IsWorkStealing(const std::string& group_name) const {
+  return stealing_groups_.find(group_name) != stealing_groups_.end();
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cyber/croutine/croutine.h"
@@ -46,8 +47,10 @@ class SchedulerClassic : public Scheduler {
 
   void CreateProcessor();
   bool NotifyProcessor(uint64_t crid) override;
+  bool IsWorkStealing(const std::string& group_name) const;
 
   std::unordered_map<std::string, ClassicTask> cr_confs_;
+  std::unordered_set<std::string> stealing_groups_;
 
   ClassicConf classic_conf_;
 };
@@ -0,0 +1,397 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/work_stealing_context.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::base::AtomicRWLock;
+using apollo::cyber::base::ReadLockGuard;
+using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::RoutineState;
+
+namespace {
+
+constexpr uint64_t kMinQueueSize = 1024;
+constexpr int64_t kMaxParkMs = 1000;
+
+void FutexWait(std::atomic<int>* word, int expected,
+               const std::chrono::nanoseconds& timeout) {
+  struct timespec ts;
+  ts.tv_sec = timeout.count() / 1000000000;
+  ts.tv_nsec = timeout.count() % 1000000000;
+  syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAIT_PRIVATE,
+          expected, &ts, nullptr, 0);
+}
+
+void FutexWake(std::atomic<int>* word) {
+  syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAKE_PRIVATE, 1,
+          nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+std::mutex WorkStealingContext::groups_mutex_;
+std::unordered_map<std::string, std::unique_ptr<StealingGroup>>
+    WorkStealingContext::groups_;
+AtomicRWLock WorkStealingContext::tasks_lock_;
+std::unordered_map<uint64_t, StealableTaskPtr> WorkStealingContext::tasks_;
+
+WorkStealingContext::WorkStealingContext(const std::string& group_name)
+    : group_name_(group_name) {
+  uint64_t queue_size = kMinQueueSize;
+  auto& global_conf = GlobalData::Instance()->Config();
+  if (global_conf.has_scheduler_conf() &&
+      global_conf.scheduler_conf().has_routine_num()) {
+    queue_size = std::max<uint64_t>(queue_size,
+                                    global_conf.scheduler_conf().routine_num());
+  }
+  for (auto& queue : ready_queues_) {
+    queue.Init(queue_size);
+  }
+
+  // processors of a group are created before any croutine is dispatched, so
+  // the context list is only written under the mutex during startup.
+  std::lock_guard<std::mutex> lk(groups_mutex_);
+  auto& group = groups_[group_name];
+  if (group == nullptr) {
+    group.reset(new StealingGroup());
+  }
+  group_ = group.get();
+  index_ = static_cast<int>(group_->contexts.size());
+  group_->contexts.emplace_back(this);
+}
+
+WorkStealingContext::~WorkStealingContext() {
+  std::lock_guard<std::mutex> lk(groups_mutex_);
+  auto& contexts = group_->contexts;
+  auto it = std::find(contexts.begin(), contexts.end(), this);
+  if (it != contexts.end()) {
+    *it = nullptr;
+  }
+}
+
+StealingGroup* WorkStealingContext::FindGroup(const std::string& group_name) {
+  std::lock_guard<std::mutex> lk(groups_mutex_);
+  auto it = groups_.find(group_name);
+  if (it == groups_.end()) {
+    return nullptr;
+  }
+  return it->second.get();
+}
+
+bool WorkStealingContext::AddCRoutine(const std::shared_ptr<CRoutine>& cr) {
+  auto group = FindGroup(cr->group_name());
+  if (cyber_unlikely(group == nullptr)) {
+    AERROR << "no work stealing processor for group " << cr->group_name();
+    return false;
+  }
+
+  auto task = std::make_shared<StealableTask>(cr, group);
+  {
+    WriteLockGuard<AtomicRWLock> lk(tasks_lock_);
+    if (tasks_.find(cr->id()) != tasks_.end()) {
+      return false;
+    }
+    tasks_[cr->id()] = task;
+  }
+  task->scheduled.store(true);
+  Schedule(task);
+  return true;
+}
+
+bool WorkStealingContext::NotifyCRoutine(uint64_t crid) {
+  StealableTaskPtr task = nullptr;
+  {
+    ReadLockGuard<AtomicRWLock> lk(tasks_lock_);
+    auto it = tasks_.find(crid);
+    if (it == tasks_.end()) {
+      return false;
+    }
+    task = it->second;
+  }
+
+  auto& cr = task->cr;
+  if (cr->state() == RoutineState::DATA_WAIT ||
+      cr->state() == RoutineState::IO_WAIT) {
+    cr->SetUpdateFlag();
+  }
+  // a task that is queued, running or sleeping picks the flag up by itself
+  if (!task->scheduled.exchange(true)) {
+    Schedule(task);
+  }
+  return true;
+}
+
+bool WorkStealingContext::RemoveCRoutine(const std::shared_ptr<CRoutine>& cr) {
+  {
+    WriteLockGuard<AtomicRWLock> lk(tasks_lock_);
+    auto it = tasks_.find(cr->id());
+    if (it == tasks_.end() || it->second->cr != cr) {
+      return false;
+    }
+    tasks_.erase(it);
+  }
+
+  // stale queue entries finish on their next Resume and are dropped
+  cr->Stop();
+  while (!cr->Acquire()) {
+    std::this_thread::sleep_for(std::chrono::microseconds(1));
+    AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
+  }
+  cr->Release();
+  return true;
+}
+
+void WorkStealingContext::Schedule(const StealableTaskPtr& task) {
+  auto group = task->group;
+  auto& contexts = group->contexts;
+  int proc_num = static_cast<int>(contexts.size());
+  if (cyber_unlikely(proc_num == 0)) {
+    task->scheduled.store(false);
+    return;
+  }
+  int target = task->last_processor.load();
+  if (target < 0 || target >= proc_num || contexts[target] == nullptr) {
+    target = static_cast<int>(group->round_robin.fetch_add(1) % proc_num);
+  }
+
+  // fall back to the siblings when the preferred queue is full
+  for (int i = 0; i < proc_num; ++i) {
+    auto ctx = contexts[(target + i) % proc_num];
+    if (ctx != nullptr && ctx->Push(task)) {
+      target = (target + i) % proc_num;
+      break;
+    }
+    if (i == proc_num - 1) {
+      AERROR << "ready queues of group " << task->cr->group_name()
+             << " are full, drop task " << task->cr->name();
+      task->scheduled.store(false);
+      return;
+    }
+  }
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (contexts[target]->IsParked()) {
+    contexts[target]->WakeUp();
+    return;
+  }
+  // the owner is busy, let an idle sibling steal the task
+  for (int i = 1; i < proc_num; ++i) {
+    auto ctx = contexts[(target + i) % proc_num];
+    if (ctx != nullptr && ctx->IsParked()) {
+      ctx->WakeUp();
+      return;
+    }
+  }
+}
+
+bool WorkStealingContext::Push(const StealableTaskPtr& task) {
+  return ready_queues_[task->cr->priority()].Enqueue(task);
+}
+
+StealableTaskPtr WorkStealingContext::Pop() {
+  StealableTaskPtr task = nullptr;
+  for (int i = MAX_PRIO - 1; i >= 0; --i) {
+    if (ready_queues_[i].Dequeue(&task)) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+StealableTaskPtr WorkStealingContext::Steal() {
+  auto& contexts = group_->contexts;
+  int proc_num = static_cast<int>(contexts.size());
+  StealableTaskPtr task = nullptr;
+  for (int i = MAX_PRIO - 1; i >= 0; --i) {
+    for (int j = 1; j < proc_num; ++j) {
+      auto ctx = contexts[(index_ + j) % proc_num];
+      if (ctx != nullptr && ctx->ready_queues_[i].Dequeue(&task)) {
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<CRoutine> WorkStealingContext::NextRoutine() {
+  if (cyber_unlikely(stop_.load())) {
+    return nullptr;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  for (auto it = sleeping_.begin(); it != sleeping_.end(); ++it) {
+    auto& cr = (*it)->cr;
+    if (cr->wake_time() < now && cr->Acquire()) {
+      if (cr->UpdateState() == RoutineState::READY) {
+        running_ = *it;
+        sleeping_.erase(it);
+        running_->last_processor.store(index_);
+        return running_->cr;
+      }
+      cr->Release();
+    }
+  }
+
+  auto task = Pop();
+  if (task == nullptr) {
+    task = Steal();
+  }
+  while (task != nullptr) {
+    auto& cr = task->cr;
+    if (!cr->Acquire()) {
+      // held by a yielding processor or by RemoveCRoutine; retry later
+      if (!Push(task)) {
+        Schedule(task);
+      }
+      return nullptr;
+    }
+
+    auto state = cr->UpdateState();
+    if (state == RoutineState::READY) {
+      running_ = task;
+      task->last_processor.store(index_);
+      return cr;
+    }
+    if (state == RoutineState::SLEEP) {
+      sleeping_.emplace_back(task);
+    } else if (state != RoutineState::FINISHED) {
+      Unschedule(task);
+    }
+    cr->Release();
+    task = Pop();
+  }
+  return nullptr;
+}
+
+void WorkStealingContext::OnRoutineYield(const std::shared_ptr<CRoutine>& cr) {
+  auto task = running_;
+  running_ = nullptr;
+  if (cyber_unlikely(task == nullptr || task->cr != cr)) {
+    return;
+  }
+
+  switch (cr->state()) {
+    case RoutineState::READY:
+      // the task stays scheduled while it moves to a sibling, Schedule clears
+      // the flag if it could not be queued anywhere
+      if (!Push(task)) {
+        Schedule(task);
+      }
+      break;
+    case RoutineState::SLEEP:
+      sleeping_.emplace_back(task);
+      break;
+    case RoutineState::DATA_WAIT:
+    case RoutineState::IO_WAIT:
+      // the lock is only missed when someone else already owns the task
+      if (cr->Acquire()) {
+        Unschedule(task);
+        cr->Release();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void WorkStealingContext::Unschedule(const StealableTaskPtr& task) {
+  task->scheduled.store(false);
+  // pairs with SetUpdateFlag() + exchange in NotifyCRoutine
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (task->cr->UpdateState() == RoutineState::READY &&
+      !task->scheduled.exchange(true)) {
+    if (!Push(task)) {
+      Schedule(task);
+    }
+  }
+}
+
+bool WorkStealingContext::HasWork() {
+  for (auto& queue : ready_queues_) {
+    if (queue.Size() > 0) {
+      return true;
+    }
+  }
+  for (auto ctx : group_->contexts) {
+    if (ctx == nullptr || ctx == this) {
+      continue;
+    }
+    for (auto& queue : ctx->ready_queues_) {
+      if (queue.Size() > 0) {
+        return true;
+      }
+    }
+  }
+  auto now = std::chrono::steady_clock::now();
+  for (auto& task : sleeping_) {
+    if (task->cr->wake_time() < now) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingContext::Wait() {
+  auto timeout = std::chrono::nanoseconds(
+      std::chrono::milliseconds(kMaxParkMs));
+  auto now = std::chrono::steady_clock::now();
+  for (auto& task : sleeping_) {
+    timeout = std::min<std::chrono::nanoseconds>(
+        timeout, task->cr->wake_time() - now);
+  }
+  if (timeout.count() <= 0) {
+    return;
+  }
+
+  // snapshot the word before the last check, so that a push racing with the
+  // check bumps it and the futex call returns immediately
+  int seq = futex_word_.load();
+  parked_.store(true);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!stop_.load() && !HasWork()) {
+    FutexWait(&futex_word_, seq, timeout);
+  }
+  parked_.store(false);
+}
+
+void WorkStealingContext::WakeUp() {
+  futex_word_.fetch_add(1);
+  FutexWake(&futex_word_);
+}
+
+void WorkStealingContext::Shutdown() {
+  stop_.store(true);
+  WakeUp();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
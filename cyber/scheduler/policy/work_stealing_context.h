@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+#define CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest_prod.h"
+
+#include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/bounded_queue.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/processor_context.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+class WorkStealingContext;
+
+struct StealingGroup {
+  std::vector<WorkStealingContext *> contexts;
+  std::atomic<uint32_t> round_robin = {0};
+};
+
+// A croutine registered in a work stealing group. `scheduled` is set while the
+// task sits in a ready queue, runs, or sleeps, so it is queued at most once.
+struct StealableTask {
+  StealableTask(const std::shared_ptr<CRoutine> &croutine,
+                StealingGroup *stealing_group)
+      : cr(croutine), group(stealing_group) {}
+
+  std::shared_ptr<CRoutine> cr;
+  StealingGroup *group;
+  std::atomic<bool> scheduled = {false};
+  std::atomic<int> last_processor = {-1};
+};
+using StealableTaskPtr = std::shared_ptr<StealableTask>;
+
+/**
+ * @class WorkStealingContext
+ * @brief Classic policy variant: every processor owns lock-free ready queues
+ * per priority. A croutine is pushed when it is dispatched or when its
+ * DATA_WAIT/IO_WAIT ends, instead of being polled by a scan over the whole
+ * group. Idle processors steal from their siblings and park on a futex.
+ */
+class WorkStealingContext : public ProcessorContext {
+ public:
+  explicit WorkStealingContext(const std::string &group_name);
+  virtual ~WorkStealingContext();
+
+  std::shared_ptr<CRoutine> NextRoutine() override;
+  void Wait() override;
+  void Shutdown() override;
+  void OnRoutineYield(const std::shared_ptr<CRoutine> &cr) override;
+
+  static bool AddCRoutine(const std::shared_ptr<CRoutine> &cr);
+  static bool NotifyCRoutine(uint64_t crid);
+  static bool RemoveCRoutine(const std::shared_ptr<CRoutine> &cr);
+
+ private:
+  FRIEND_TEST(SchedulerClassicTest, work_stealing_fallback);
+
+  using ReadyQueue = base::BoundedQueue<StealableTaskPtr>;
+
+  static void Schedule(const StealableTaskPtr &task);
+  static StealingGroup *FindGroup(const std::string &group_name);
+
+  bool Push(const StealableTaskPtr &task);
+  StealableTaskPtr Pop();
+  StealableTaskPtr Steal();
+  bool HasWork();
+  bool IsParked() const { return parked_.load(); }
+  void WakeUp();
+  // called with the croutine acquired, after it stopped being READY
+  void Unschedule(const StealableTaskPtr &task);
+
+  std::string group_name_;
+  StealingGroup *group_ = nullptr;
+  int index_ = 0;
+
+  std::array<ReadyQueue, MAX_PRIO> ready_queues_;
+  // tasks in SLEEP are only polled by the processor that ran them
+  std::vector<StealableTaskPtr> sleeping_;
+  StealableTaskPtr running_ = nullptr;
+
+  alignas(CACHELINE_SIZE) std::atomic<int> futex_word_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<bool> parked_ = {false};
+
+  static std::mutex groups_mutex_;
+  static std::unordered_map<std::string, std::unique_ptr<StealingGroup>>
+      groups_;
+  static base::AtomicRWLock tasks_lock_;
+  static std::unordered_map<uint64_t, StealableTaskPtr> tasks_;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
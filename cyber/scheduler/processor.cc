@@ -21,6 +21,7 @@
 #include <sys/syscall.h>
 
 #include <chrono>
+#include <ctime>
 
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
@@ -33,6 +34,18 @@ namespace scheduler {
 
 using apollo::cyber::common::GlobalData;
 
+namespace {
+
+uint64_t ThreadCpuNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000UL + ts.tv_nsec;
+}
+
+}  // namespace
+
+std::atomic<bool> Processor::routine_stats_enabled_ = {false};
+
 Processor::Processor() { running_.store(true); }
 
 Processor::~Processor() { Stop(); }
@@ -42,16 +55,43 @@ void Processor::Run() {
   AINFO << "processor_tid: " << tid_;
   snap_shot_->processor_id.store(tid_);
 
+  auto collector = profiler::TraceCollector::Instance();
   while (cyber_likely(running_.load())) {
     if (cyber_likely(context_ != nullptr)) {
       auto croutine = context_->NextRoutine();
       if (croutine) {
         snap_shot_->execute_start_time.store(cyber::Time::Now().ToNanosecond());
         snap_shot_->routine_name = croutine->name();
+        const bool profile = collector->enabled();
+        const bool account =
+            routine_stats_enabled_.load(std::memory_order_relaxed);
+        const uint64_t ready_ns = account ? croutine->TakeReadyTime() : 0;
+        uint64_t begin_ns = profile || account ? profiler::NowNs() : 0;
+        // back to back runs share the reading of the thread cpu clock, so a
+        // run is also charged for being picked
+        if (account && last_cpu_ns_ == 0) {
+          last_cpu_ns_ = ThreadCpuNs();
+        } else if (!account) {
+          last_cpu_ns_ = 0;
+        }
         croutine->Resume();
+        if (begin_ns != 0) {
+          uint64_t end_ns = profiler::NowNs();
+          if (profile) {
+            collector->Record(RoutineBlock(croutine), begin_ns, end_ns);
+          }
+          if (account) {
+            uint64_t cpu_ns = ThreadCpuNs();
+            Account(croutine.get(), ready_ns, begin_ns, end_ns,
+                    cpu_ns - last_cpu_ns_);
+            last_cpu_ns_ = cpu_ns;
+          }
+        }
         croutine->Release();
+        context_->OnRoutineYield(croutine);
       } else {
         snap_shot_->execute_start_time.store(0);
+        last_cpu_ns_ = 0;
         context_->Wait();
       }
     } else {
@@ -61,6 +101,27 @@ void Processor::Run() {
   }
 }
 
+profiler::BlockStats* Processor::RoutineBlock(
+    const std::shared_ptr<CRoutine>& cr) {
+  auto& block = routine_blocks_[cr->id()];
+  if (cyber_unlikely(block == nullptr)) {
+    block = profiler::TraceCollector::Instance()->Register("croutine/" +
+                                                           cr->name());
+  }
+  return block;
+}
+
+void Processor::Account(CRoutine* cr, uint64_t ready_ns, uint64_t begin_ns,
+                        uint64_t end_ns, uint64_t cpu_ns) {
+  uint64_t wall_ns = end_ns - begin_ns;
+  uint64_t wait_ns =
+      ready_ns != 0 && ready_ns < begin_ns ? begin_ns - ready_ns : 0;
+  cr->stats()->AddRun(cpu_ns, wall_ns, wait_ns);
+  croutine::RoutineStats::Add(&snap_shot_->switches, 1);
+  croutine::RoutineStats::Add(&snap_shot_->cpu_ns, cpu_ns);
+  croutine::RoutineStats::Add(&snap_shot_->busy_ns, wall_ns);
+}
+
 void Processor::Stop() {
   if (!running_.exchange(false)) {
     return;
@@ -23,11 +23,13 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "cyber/proto/scheduler_conf.pb.h"
 
 #include "cyber/croutine/croutine.h"
+#include "cyber/profiler/trace_collector.h"
 #include "cyber/scheduler/processor_context.h"
 
 namespace apollo {
@@ -40,6 +42,10 @@ struct Snapshot {
   std::atomic<uint64_t> execute_start_time = {0};
   std::atomic<pid_t> processor_id = {0};
   std::string routine_name;
+  // totals of the routines run here while the routine stats are enabled
+  std::atomic<uint64_t> switches = {0};
+  std::atomic<uint64_t> cpu_ns = {0};
+  std::atomic<uint64_t> busy_ns = {0};
 };
 
 class Processor {
@@ -55,7 +61,24 @@ class Processor {
 
   std::shared_ptr<Snapshot> ProcSnapshot() { return snap_shot_; }
 
+  /**
+   * @brief Account the thread cpu time, wall time and ready-to-run wait of
+   * every run into croutine::RoutineStats and the processor snapshots.
+   * Costs one clock_gettime(CLOCK_THREAD_CPUTIME_ID) per run, and one more
+   * for the first run after idling.
+   */
+  static void EnableRoutineStats(bool enable) {
+    routine_stats_enabled_.store(enable, std::memory_order_relaxed);
+    croutine::CRoutine::EnableReadyTime(enable);
+  }
+
  private:
+  profiler::BlockStats* RoutineBlock(const std::shared_ptr<CRoutine>& cr);
+  void Account(CRoutine* cr, uint64_t ready_ns, uint64_t begin_ns,
+               uint64_t end_ns, uint64_t cpu_ns);
+
+  static std::atomic<bool> routine_stats_enabled_;
+
   std::shared_ptr<ProcessorContext> context_;
 
   std::condition_variable cv_ctx_;
@@ -67,6 +90,13 @@ class Processor {
   std::atomic<bool> running_{false};
 
   std::shared_ptr<Snapshot> snap_shot_ = std::make_shared<Snapshot>();
+
+  // profiler blocks of the routines run here by id, only touched by thread_
+  std::unordered_map<uint64_t, profiler::BlockStats*> routine_blocks_;
+
+  // thread cpu clock at the end of the last run, 0 after idling, only
+  // touched by thread_
+  uint64_t last_cpu_ns_ = 0;
 };
 
 }  // namespace scheduler
@@ -36,6 +36,10 @@ class ProcessorContext {
   virtual std::shared_ptr<CRoutine> NextRoutine() = 0;
   virtual void Wait() = 0;
 
+  // Called by the processor after a routine returned from Resume() and was
+  // released, so that push based contexts can requeue it.
+  virtual void OnRoutineYield(const std::shared_ptr<CRoutine>& cr) {}
+
  protected:
   std::atomic<bool> stop_{false};
 };
@@ -122,6 +122,15 @@ void Scheduler::CheckSchedStatus() {
   snap_info.clear();
 }
 
+void Scheduler::GetRoutines(
+    std::vector<std::shared_ptr<CRoutine>>* routines) {
+  ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+  routines->reserve(routines->size() + id_cr_.size());
+  for (auto& cr : id_cr_) {
+    routines->emplace_back(cr.second);
+  }
+}
+
 void Scheduler::Shutdown() {
   if (cyber_unlikely(stop_.exchange(true))) {
     return;
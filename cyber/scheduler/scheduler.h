@@ -79,6 +79,12 @@ class Scheduler {
 
   void CheckSchedStatus();
 
+  // the routines and processors of the scheduler, for SysMo
+  void GetRoutines(std::vector<std::shared_ptr<CRoutine>>* routines);
+  const std::vector<std::shared_ptr<Processor>>& Processors() const {
+    return processors_;
+  }
+
   void SetInnerThreadConfs(
       const std::unordered_map<std::string, InnerThread>& confs) {
     inner_thr_confs_ = confs;
@@ -22,6 +22,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/cyber.h"
 #include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/policy/work_stealing_context.h"
 #include "cyber/scheduler/processor.h"
 #include "cyber/scheduler/scheduler_factory.h"
 #include "cyber/task/task.h"
@@ -60,6 +61,90 @@ TEST(SchedulerClassicTest, classic) {
   processor->Stop();
 }
 
+TEST(SchedulerClassicTest, work_stealing) {
+  const std::string group = "work_stealing_test_grp";
+  std::vector<std::shared_ptr<Processor>> processors;
+  std::vector<std::shared_ptr<WorkStealingContext>> contexts;
+  FOR_EACH(i, 0, 2) {
+    contexts.emplace_back(std::make_shared<WorkStealingContext>(group));
+    processors.emplace_back(std::make_shared<Processor>());
+  }
+  FOR_EACH(i, 0, 2) { processors[i]->BindContext(contexts[i]); }
+
+  std::atomic<int> count = {0};
+  auto cr = std::make_shared<CRoutine>([&count]() {
+    for (;;) {
+      count++;
+      CRoutine::GetCurrentRoutine()->HangUp();
+    }
+  });
+  cr->set_id(GlobalData::RegisterTaskName("work_stealing_task"));
+  cr->set_name("work_stealing_task");
+  cr->set_group_name(group);
+  EXPECT_TRUE(WorkStealingContext::AddCRoutine(cr));
+  EXPECT_FALSE(WorkStealingContext::AddCRoutine(cr));
+
+  FOR_EACH(i, 0, 10) {
+    int expected = count.load() + 1;
+    EXPECT_TRUE(WorkStealingContext::NotifyCRoutine(cr->id()));
+    FOR_EACH(retry, 0, 1000) {
+      if (count.load() >= expected) {
+        break;
+      }
+      cyber::SleepFor(std::chrono::milliseconds(1));
+    }
+    EXPECT_GE(count.load(), expected);
+  }
+
+  EXPECT_TRUE(WorkStealingContext::RemoveCRoutine(cr));
+  EXPECT_FALSE(WorkStealingContext::NotifyCRoutine(cr->id()));
+  for (auto& processor : processors) {
+    processor->Stop();
+  }
+}
+
+TEST(SchedulerClassicTest, work_stealing_fallback) {
+  const std::string group = "work_stealing_fallback_grp";
+  std::vector<std::shared_ptr<WorkStealingContext>> contexts;
+  FOR_EACH(i, 0, 2) {
+    contexts.emplace_back(std::make_shared<WorkStealingContext>(group));
+  }
+
+  auto cr = std::make_shared<CRoutine>(func);
+  cr->set_id(GlobalData::RegisterTaskName("work_stealing_fallback_task"));
+  cr->set_name("work_stealing_fallback_task");
+  cr->set_group_name(group);
+  ASSERT_TRUE(WorkStealingContext::AddCRoutine(cr));
+  auto task = WorkStealingContext::tasks_[cr->id()];
+  const uint32_t prio = cr->priority();
+  auto filler = std::make_shared<StealableTask>(
+      std::make_shared<CRoutine>(func), task->group);
+
+  // the task yields READY while the queue of its processor is full, and
+  // moves to the sibling
+  ASSERT_EQ(cr, contexts[0]->NextRoutine());
+  while (contexts[0]->Push(filler)) {
+  }
+  cr->Release();
+  contexts[0]->OnRoutineYield(cr);
+  EXPECT_TRUE(task->scheduled.load());
+  EXPECT_EQ(1U, contexts[1]->ready_queues_[prio].Size());
+
+  // a notify must not queue it a second time
+  EXPECT_TRUE(WorkStealingContext::NotifyCRoutine(cr->id()));
+  EXPECT_EQ(1U, contexts[1]->ready_queues_[prio].Size());
+
+  // with every queue full the task is dropped and can be notified again
+  ASSERT_EQ(cr, contexts[1]->NextRoutine());
+  while (contexts[1]->Push(filler)) {
+  }
+  cr->Release();
+  contexts[1]->OnRoutineYield(cr);
+  EXPECT_FALSE(task->scheduled.load());
+
+  EXPECT_TRUE(WorkStealingContext::RemoveCRoutine(cr));
+}
+
 TEST(SchedulerClassicTest, sched_classic) {
   // read example_sched_classic.conf
   GlobalData::Instance()->SetProcessGroup("example_sched_classic");
@@ -0,0 +1,217 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Wake-up latency of many low duty cycle croutines that spend most of their
+// time in DATA_WAIT, for the shared-scan ClassicContext and the work stealing
+// context. Each iteration notifies one routine and waits until it ran.
+//
+//   bazel run -c opt //cyber/scheduler:scheduler_latency_benchmark
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/policy/work_stealing_context.h"
+#include "cyber/scheduler/processor.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+namespace {
+
+using apollo::cyber::base::AtomicRWLock;
+using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::croutine::RoutineState;
+
+constexpr int kProcessorNum = 4;
+constexpr int kMaxRoutineNum = 512;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct Probe {
+  std::atomic<int64_t> notify_ns = {0};
+  std::atomic<int64_t> latency_ns = {-1};
+};
+
+class Bench {
+ public:
+  virtual ~Bench() {
+    for (auto& proc : processors_) {
+      proc->Stop();
+    }
+  }
+
+  void Start(const std::shared_ptr<ProcessorContext>& ctx) {
+    auto proc = std::make_shared<Processor>();
+    proc->BindContext(ctx);
+    processors_.emplace_back(proc);
+    contexts_.emplace_back(ctx);
+  }
+
+  std::shared_ptr<CRoutine> NewRoutine(const std::string& group, int id,
+                                       Probe* probe) {
+    auto cr = std::make_shared<CRoutine>([probe]() {
+      for (;;) {
+        auto notify_ns = probe->notify_ns.load();
+        if (notify_ns > 0) {
+          probe->latency_ns.store(NowNs() - notify_ns);
+        }
+        CRoutine::GetCurrentRoutine()->HangUp();
+      }
+    });
+    cr->set_id(id);
+    cr->set_name(group + "_" + std::to_string(id));
+    cr->set_group_name(group);
+    return cr;
+  }
+
+  virtual void Add(const std::shared_ptr<CRoutine>& cr) = 0;
+  virtual void Notify(const std::shared_ptr<CRoutine>& cr) = 0;
+  virtual void Remove(const std::shared_ptr<CRoutine>& cr) = 0;
+
+ private:
+  std::vector<std::shared_ptr<Processor>> processors_;
+  std::vector<std::shared_ptr<ProcessorContext>> contexts_;
+};
+
+class ClassicBench : public Bench {
+ public:
+  void Add(const std::shared_ptr<CRoutine>& cr) override {
+    WriteLockGuard<AtomicRWLock> lk(
+        ClassicContext::rq_locks_[cr->group_name()].at(cr->priority()));
+    ClassicContext::cr_group_[cr->group_name()]
+        .at(cr->priority())
+        .emplace_back(cr);
+  }
+  void Notify(const std::shared_ptr<CRoutine>& cr) override {
+    if (cr->state() == RoutineState::DATA_WAIT) {
+      cr->SetUpdateFlag();
+    }
+    ClassicContext::Notify(cr->group_name());
+  }
+  void Remove(const std::shared_ptr<CRoutine>& cr) override {
+    ClassicContext::RemoveCRoutine(cr);
+  }
+};
+
+class StealingBench : public Bench {
+ public:
+  void Add(const std::shared_ptr<CRoutine>& cr) override {
+    WorkStealingContext::AddCRoutine(cr);
+  }
+  void Notify(const std::shared_ptr<CRoutine>& cr) override {
+    WorkStealingContext::NotifyCRoutine(cr->id());
+  }
+  void Remove(const std::shared_ptr<CRoutine>& cr) override {
+    WorkStealingContext::RemoveCRoutine(cr);
+  }
+};
+
+template <typename BenchT, typename ContextT>
+void RunWakeLatency(benchmark::State& state, const std::string& prefix) {
+  static int run = 0;
+  const int routine_num = static_cast<int>(state.range(0));
+  const std::string group = prefix + std::to_string(run++);
+
+  BenchT bench;
+  for (int i = 0; i < kProcessorNum; ++i) {
+    bench.Start(std::make_shared<ContextT>(group));
+  }
+
+  std::vector<Probe> probes(routine_num);
+  std::vector<std::shared_ptr<CRoutine>> croutines;
+  for (int i = 0; i < routine_num; ++i) {
+    auto cr = bench.NewRoutine(group, i + 1, &probes[i]);
+    croutines.emplace_back(cr);
+    bench.Add(cr);
+  }
+  // let every routine run once and park in DATA_WAIT
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  std::vector<int64_t> latencies;
+  int next = 0;
+  for (auto _ : state) {
+    auto& probe = probes[next];
+    probe.latency_ns.store(-1);
+    probe.notify_ns.store(NowNs());
+    bench.Notify(croutines[next]);
+    while (probe.latency_ns.load() < 0) {
+      cpu_relax();
+    }
+    latencies.emplace_back(probe.latency_ns.load());
+    next = (next + 1) % routine_num;
+  }
+
+  for (auto& cr : croutines) {
+    bench.Remove(cr);
+  }
+
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&latencies](double p) {
+      auto idx = static_cast<size_t>(p * static_cast<double>(latencies.size()));
+      return static_cast<double>(
+          latencies[std::min(idx, latencies.size() - 1)]);
+    };
+    state.counters["p50_us"] = pct(0.5) / 1e3;
+    state.counters["p99_us"] = pct(0.99) / 1e3;
+    state.counters["max_us"] = static_cast<double>(latencies.back()) / 1e3;
+  }
+}
+
+}  // namespace
+
+static void BM_ClassicWakeLatency(benchmark::State& state) {
+  RunWakeLatency<ClassicBench, ClassicContext>(state, "bm_classic_");
+}
+BENCHMARK(BM_ClassicWakeLatency)
+    ->RangeMultiplier(4)
+    ->Range(8, kMaxRoutineNum)
+    ->UseRealTime();
+
+static void BM_WorkStealingWakeLatency(benchmark::State& state) {
+  RunWakeLatency<StealingBench, WorkStealingContext>(state, "bm_stealing_");
+}
+BENCHMARK(BM_WorkStealingWakeLatency)
+    ->RangeMultiplier(4)
+    ->Range(8, kMaxRoutineNum)
+    ->UseRealTime();
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  // size the routine context pool for the largest run up front
+  apollo::cyber::common::GlobalData::Instance()->SetComponentNums(
+      apollo::cyber::scheduler::kMaxRoutineNum);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -17,6 +17,7 @@
 #ifndef CYBER_SERVICE_CLIENT_H_
 #define CYBER_SERVICE_CLIENT_H_
 
+#include <algorithm>
 #include <future>
 #include <map>
 #include <memory>
@@ -25,11 +26,13 @@
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/log.h"
 #include "cyber/common/types.h"
 #include "cyber/node/node_channel_impl.h"
 #include "cyber/service/client_base.h"
+#include "cyber/service/pending_call.h"
 
 namespace apollo {
 namespace cyber {
@@ -52,6 +55,7 @@ class Client : public ClientBase {
   using SharedPromise = std::shared_ptr<Promise>;
   using SharedFuture = std::shared_future<SharedResponse>;
   using CallbackType = std::function<void(SharedFuture)>;
+  using SharedCall = std::shared_ptr<PendingCall<Response>>;
 
   /**
    * @brief Construct a new Client object
@@ -82,26 +86,59 @@ class Client : public ClientBase {
   bool Init();
 
   /**
-   * @brief Request the Service with a shared ptr Request type
+   * @brief Request the Service with a shared ptr Request type, see Await
+   * for how the caller waits
    *
    * @param request shared ptr of Request type
-   * @param timeout_s request timeout, if timeout, response will be empty
+   * @param timeout request timeout, if timeout, response will be empty
    * @return SharedResponse result of this request
    */
   SharedResponse SendRequest(
       SharedRequest request,
-      const std::chrono::seconds& timeout_s = std::chrono::seconds(5));
+      const std::chrono::milliseconds& timeout = std::chrono::seconds(5));
 
   /**
    * @brief Request the Service with a Request object
    *
    * @param request Request object
-   * @param timeout_s request timeout, if timeout, response will be empty
+   * @param timeout request timeout, if timeout, response will be empty
    * @return SharedResponse result of this request
    */
   SharedResponse SendRequest(
       const Request& request,
-      const std::chrono::seconds& timeout_s = std::chrono::seconds(5));
+      const std::chrono::milliseconds& timeout = std::chrono::seconds(5));
+
+  /**
+   * @brief Send a Request without waiting for its response, any number of
+   * calls can be in flight at a time
+   *
+   * @param request Request shared ptr
+   * @param timeout the call completes without response after it, right away
+   * if it is zero and never if it is CallBase::kNoTimeout
+   * @return SharedCall the call to Await, nullptr if the Client is not
+   * initialized
+   */
+  SharedCall AsyncCall(
+      SharedRequest request,
+      const std::chrono::milliseconds& timeout = std::chrono::seconds(5));
+
+  /**
+   * @brief Send several Requests back to back, in order
+   *
+   * @return std::vector<SharedCall> the calls in the order of `requests`
+   */
+  std::vector<SharedCall> AsyncCall(
+      const std::vector<SharedRequest>& requests,
+      const std::chrono::milliseconds& timeout = std::chrono::seconds(5));
+
+  /**
+   * @brief Wait for the response of `call`. In a croutine, e.g. in
+   * Component::Proc, the routine yields instead of blocking its processor
+   * and resumes once the response arrives or the call times out.
+   *
+   * @return SharedResponse the response, nullptr on timeout
+   */
+  SharedResponse Await(const SharedCall& call);
 
   /**
    * @brief Send Request shared ptr asynchronously
@@ -164,6 +201,12 @@ class Client : public ClientBase {
                      std::tuple<SharedPromise, CallbackType, SharedFuture>>
       pending_requests_;
   std::mutex pending_requests_mutex_;
+  std::unordered_map<uint64_t, std::weak_ptr<PendingCall<Response>>>
+      pending_calls_;
+  // pending_calls_ drops the calls nobody waits for any more when it grows
+  // past this, which follows the number of calls in flight
+  static constexpr size_t kMinPendingCallsLimit = 64;
+  size_t pending_calls_limit_ = kMinPendingCallsLimit;
 
   std::shared_ptr<transport::Transmitter<Request>> request_transmitter_;
   std::shared_ptr<transport::Receiver<Response>> response_receiver_;
@@ -222,32 +265,86 @@ bool Client<Request, Response>::Init() {
 
 template <typename Request, typename Response>
 typename Client<Request, Response>::SharedResponse
-Client<Request, Response>::SendRequest(SharedRequest request,
-                                       const std::chrono::seconds& timeout_s) {
+Client<Request, Response>::SendRequest(
+    SharedRequest request, const std::chrono::milliseconds& timeout) {
   if (!IsInit()) {
     return nullptr;
   }
-  auto future = AsyncSendRequest(request);
-  if (!future.valid()) {
+  return Await(AsyncCall(request, timeout));
+}
+
+template <typename Request, typename Response>
+typename Client<Request, Response>::SharedResponse
+Client<Request, Response>::SendRequest(
+    const Request& request, const std::chrono::milliseconds& timeout) {
+  if (!IsInit()) {
     return nullptr;
   }
-  auto status = future.wait_for(timeout_s);
-  if (status == std::future_status::ready) {
-    return future.get();
-  } else {
-    return nullptr;
+  auto request_ptr = std::make_shared<const Request>(request);
+  return SendRequest(request_ptr, timeout);
+}
+
+template <typename Request, typename Response>
+typename Client<Request, Response>::SharedCall
+Client<Request, Response>::AsyncCall(
+    SharedRequest request, const std::chrono::milliseconds& timeout) {
+  auto calls = AsyncCall(std::vector<SharedRequest>{request}, timeout);
+  return calls.empty() ? nullptr : calls.front();
+}
+
+template <typename Request, typename Response>
+std::vector<typename Client<Request, Response>::SharedCall>
+Client<Request, Response>::AsyncCall(
+    const std::vector<SharedRequest>& requests,
+    const std::chrono::milliseconds& timeout) {
+  std::vector<SharedCall> calls;
+  if (!IsInit()) {
+    return calls;
+  }
+  calls.reserve(requests.size());
+  std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+  if (pending_calls_.empty()) {
+    pending_calls_limit_ = kMinPendingCallsLimit;
   }
+  if (pending_calls_.size() + requests.size() > pending_calls_limit_) {
+    for (auto it = pending_calls_.begin(); it != pending_calls_.end();) {
+      auto call = it->second.lock();
+      if (call == nullptr || call->done()) {
+        it = pending_calls_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    // grows and shrinks with the calls in flight
+    pending_calls_limit_ = std::max(
+        kMinPendingCallsLimit, 2 * (pending_calls_.size() + requests.size()));
+  }
+  for (auto& request : requests) {
+    sequence_number_++;
+    transport::MessageInfo info(writer_id_, sequence_number_, writer_id_);
+    // registered before sending, the response is handled under the same
+    // lock
+    auto call = PendingCall<Response>::Create(info.seq_num(), timeout);
+    pending_calls_[info.seq_num()] = call;
+    request_transmitter_->Transmit(request, info);
+    calls.emplace_back(std::move(call));
+  }
+  return calls;
 }
 
 template <typename Request, typename Response>
 typename Client<Request, Response>::SharedResponse
-Client<Request, Response>::SendRequest(const Request& request,
-                                       const std::chrono::seconds& timeout_s) {
-  if (!IsInit()) {
+Client<Request, Response>::Await(const SharedCall& call) {
+  if (call == nullptr) {
     return nullptr;
   }
-  auto request_ptr = std::make_shared<const Request>(request);
-  return SendRequest(request_ptr, timeout_s);
+  call->Wait();
+  auto response = call->response();
+  if (response == nullptr) {
+    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+    pending_calls_.erase(call->seq_num());
+  }
+  return response;
 }
 
 template <typename Request, typename Response>
@@ -292,11 +389,21 @@ void Client<Request, Response>::HandleResponse(
     const std::shared_ptr<Response>& response,
     const transport::MessageInfo& request_header) {
   ADEBUG << "client recv response.";
-  std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+  std::unique_lock<std::mutex> lock(pending_requests_mutex_);
   if (request_header.spare_id() != writer_id_) {
     return;
   }
   uint64_t sequence_number = request_header.seq_num();
+  auto call_it = pending_calls_.find(sequence_number);
+  if (call_it != pending_calls_.end()) {
+    auto call = call_it->second.lock();
+    pending_calls_.erase(call_it);
+    lock.unlock();
+    if (call != nullptr) {
+      call->Complete(response);
+    }
+    return;
+  }
   if (this->pending_requests_.count(sequence_number) == 0) {
     return;
   }
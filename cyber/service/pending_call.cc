@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/service/pending_call.h"
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/time/time.h"
+#include "cyber/timer/timer_task.h"
+#include "cyber/timer/timing_wheel.h"
+
+namespace apollo {
+namespace cyber {
+
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::croutine::RoutineState;
+
+void CallBase::Wait() {
+  auto routine = CRoutine::GetCurrentRoutine();
+  if (routine == nullptr) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return done_; });
+    return;
+  }
+
+  const RoutineState state = routine->state();
+  for (;;) {
+    // in IO_WAIT before checking, so that Finish either sees the routine
+    // waiting or is seen here
+    routine->set_state(RoutineState::IO_WAIT);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (done_) {
+        waiter_ = 0;
+        break;
+      }
+      waiter_ = routine->id();
+    }
+    // other notifications of the routine wake it up as well
+    CRoutine::Yield();
+  }
+  routine->set_state(state);
+}
+
+bool CallBase::done() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return done_;
+}
+
+void CallBase::StartTimer(const std::chrono::milliseconds& timeout) {
+  std::weak_ptr<CallBase> weak_call = shared_from_this();
+  auto timer = std::make_shared<TimerTask>(seq_num_);
+  timer->deadline_ns = Time::MonoTime().ToNanosecond() +
+                       static_cast<uint64_t>(timeout.count()) * 1000000;
+  timer->callback = [weak_call]() {
+    auto call = weak_call.lock();
+    if (call != nullptr) {
+      call->Finish(nullptr);
+    }
+  };
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timer_ = timer;
+  }
+  TimingWheel::Instance()->AddTask(timer);
+}
+
+bool CallBase::Finish(const std::shared_ptr<void>& result) {
+  uint64_t waiter = 0;
+  std::shared_ptr<TimerTask> timer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_) {
+      return false;
+    }
+    done_ = true;
+    result_ = result;
+    waiter = waiter_;
+    timer.swap(timer_);
+  }
+  cv_.notify_all();
+  if (waiter != 0) {
+    scheduler::Instance()->NotifyTask(waiter);
+  }
+  return true;
+}
+
+std::shared_ptr<void> CallBase::result() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return result_;
+}
+
+}  // namespace cyber
+}  // namespace apollo
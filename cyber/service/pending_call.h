@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SERVICE_PENDING_CALL_H_
+#define CYBER_SERVICE_PENDING_CALL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace apollo {
+namespace cyber {
+
+struct TimerTask;
+
+/**
+ * @brief A service request in flight. It completes with its response, or
+ * without one once its timeout expires. The caller waiting for it yields
+ * when it runs in a croutine, so that its processor keeps running the other
+ * routines meanwhile, and blocks its thread otherwise.
+ */
+class CallBase : public std::enable_shared_from_this<CallBase> {
+ public:
+  // the timeout of a call that waits for its response however long it takes
+  static constexpr std::chrono::milliseconds kNoTimeout =
+      std::chrono::milliseconds::max();
+
+  virtual ~CallBase() = default;
+
+  /**
+   * @brief Wait until the call completes. In a croutine the routine waits in
+   * IO_WAIT and gets its state back afterwards.
+   */
+  void Wait();
+
+  bool done() const;
+
+  uint64_t seq_num() const { return seq_num_; }
+
+ protected:
+  explicit CallBase(uint64_t seq_num) : seq_num_(seq_num) {}
+
+  // complete the call without a response at now + timeout
+  void StartTimer(const std::chrono::milliseconds& timeout);
+
+  /**
+   * @return False if the call completed already, e.g. a response arriving
+   * after the timeout.
+   */
+  bool Finish(const std::shared_ptr<void>& result);
+
+  std::shared_ptr<void> result() const;
+
+ private:
+  const uint64_t seq_num_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool done_ = false;
+  std::shared_ptr<void> result_;
+  // id of the croutine waiting, 0 if none
+  uint64_t waiter_ = 0;
+  // the timing wheel only holds a weak reference, dropping it cancels
+  std::shared_ptr<TimerTask> timer_;
+};
+
+template <typename Response>
+class PendingCall : public CallBase {
+ public:
+  /**
+   * @param timeout the call completes without a response after it, right
+   * away if it is not positive and never if it is kNoTimeout
+   */
+  static std::shared_ptr<PendingCall> Create(
+      uint64_t seq_num, const std::chrono::milliseconds& timeout) {
+    std::shared_ptr<PendingCall> call(new PendingCall(seq_num));
+    if (timeout == kNoTimeout) {
+      return call;
+    }
+    if (timeout.count() > 0) {
+      call->StartTimer(timeout);
+    } else {
+      call->Finish(nullptr);
+    }
+    return call;
+  }
+
+  bool Complete(const std::shared_ptr<Response>& response) {
+    return Finish(response);
+  }
+
+  // nullptr until the call completes, and if it timed out
+  std::shared_ptr<Response> response() const {
+    return std::static_pointer_cast<Response>(result());
+  }
+
+ private:
+  explicit PendingCall(uint64_t seq_num) : CallBase(seq_num) {}
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SERVICE_PENDING_CALL_H_
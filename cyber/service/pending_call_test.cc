@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/service/pending_call.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/proto/unit_test.pb.h"
+#include "cyber/scheduler/scheduler_factory.h"
+
+namespace apollo {
+namespace cyber {
+
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::croutine::RoutineState;
+using apollo::cyber::proto::Chatter;
+
+TEST(PendingCallTest, complete) {
+  auto call = PendingCall<Chatter>::Create(1, CallBase::kNoTimeout);
+  EXPECT_FALSE(call->done());
+  EXPECT_EQ(nullptr, call->response());
+  auto response = std::make_shared<Chatter>();
+  response->set_seq(7);
+  std::thread responder([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(call->Complete(response));
+  });
+  call->Wait();
+  responder.join();
+  EXPECT_TRUE(call->done());
+  ASSERT_NE(nullptr, call->response());
+  EXPECT_EQ(7, call->response()->seq());
+  // only the first completion counts
+  EXPECT_FALSE(call->Complete(nullptr));
+  EXPECT_EQ(7, call->response()->seq());
+}
+
+TEST(PendingCallTest, timeout) {
+  auto begin = std::chrono::steady_clock::now();
+  auto call = PendingCall<Chatter>::Create(2, std::chrono::milliseconds(20));
+  call->Wait();
+  auto elapsed = std::chrono::steady_clock::now() - begin;
+  EXPECT_TRUE(call->done());
+  EXPECT_EQ(nullptr, call->response());
+  EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+  EXPECT_LT(elapsed, std::chrono::seconds(1));
+  // a late response is dropped
+  EXPECT_FALSE(call->Complete(std::make_shared<Chatter>()));
+  EXPECT_EQ(nullptr, call->response());
+}
+
+TEST(PendingCallTest, no_wait) {
+  // a zero timeout does not wait for the response, as before
+  auto call = PendingCall<Chatter>::Create(4, std::chrono::milliseconds(0));
+  EXPECT_TRUE(call->done());
+  call->Wait();
+  EXPECT_EQ(nullptr, call->response());
+  EXPECT_FALSE(call->Complete(std::make_shared<Chatter>()));
+}
+
+TEST(PendingCallTest, croutine) {
+  auto sched = scheduler::Instance();
+  auto call = PendingCall<Chatter>::Create(3, std::chrono::seconds(5));
+  std::atomic<bool> waiting = {false};
+  std::atomic<bool> done = {false};
+  RoutineState state_after = RoutineState::READY;
+  EXPECT_TRUE(sched->CreateTask(
+      [&]() {
+        auto routine = CRoutine::GetCurrentRoutine();
+        ASSERT_NE(nullptr, routine);
+        routine->set_state(RoutineState::DATA_WAIT);
+        waiting = true;
+        call->Wait();
+        state_after = routine->state();
+        done = true;
+      },
+      "pending_call_waiter"));
+  while (!waiting.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(done.load());
+  EXPECT_TRUE(call->Complete(std::make_shared<Chatter>()));
+  for (int i = 0; i < 1000 && !done.load(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(done.load());
+  EXPECT_NE(nullptr, call->response());
+  // the routine gets back the state it waited in
+  EXPECT_EQ(RoutineState::DATA_WAIT, state_after);
+  sched->Shutdown();
+}
+
+}  // namespace cyber
+}  // namespace apollo
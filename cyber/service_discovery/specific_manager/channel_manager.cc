@@ -135,6 +135,28 @@ void ChannelManager::GetReadersOfChannel(const std::string& channel_name,
   channel_readers_.Search(key, readers);
 }
 
+bool ChannelManager::GetWritersOfChannel(uint64_t channel_id,
+                                         RolePtrVec* writers) {
+  RETURN_VAL_IF_NULL(writers, false);
+  return channel_writers_.Search(channel_id, writers);
+}
+
+bool ChannelManager::GetReadersOfChannel(uint64_t channel_id,
+                                         RolePtrVec* readers) {
+  RETURN_VAL_IF_NULL(readers, false);
+  return channel_readers_.Search(channel_id, readers);
+}
+
+bool ChannelManager::GetWritersOfNode(uint64_t node_id, RolePtrVec* writers) {
+  RETURN_VAL_IF_NULL(writers, false);
+  return node_writers_.Search(node_id, writers);
+}
+
+bool ChannelManager::GetReadersOfNode(uint64_t node_id, RolePtrVec* readers) {
+  RETURN_VAL_IF_NULL(readers, false);
+  return node_readers_.Search(node_id, readers);
+}
+
 void ChannelManager::GetUpstreamOfNode(const std::string& node_name,
                                        RoleAttrVec* upstream_nodes) {
   RETURN_IF_NULL(upstream_nodes);
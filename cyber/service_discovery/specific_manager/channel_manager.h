@@ -17,6 +17,7 @@
 #ifndef CYBER_SERVICE_DISCOVERY_SPECIFIC_MANAGER_CHANNEL_MANAGER_H_
 #define CYBER_SERVICE_DISCOVERY_SPECIFIC_MANAGER_CHANNEL_MANAGER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -44,6 +45,7 @@ class ChannelManager : public Manager {
 
  public:
   using RoleAttrVec = std::vector<proto::RoleAttributes>;
+  using RolePtrVec = std::vector<RolePtr>;
   using WriterWarehouse = MultiValueWarehouse;
   using ReaderWarehouse = MultiValueWarehouse;
   using ExemptedMessageTypes = std::unordered_set<std::string>;
@@ -149,6 +151,35 @@ class ChannelManager : public Manager {
   void GetReadersOfChannel(const std::string& channel_name,
                            RoleAttrVec* readers);
 
+  /**
+   * @brief Get the Writers Of Channel object by id, sharing the roles of the
+   * topology instead of copying their attributes. The roles are never
+   * modified once added, so they stay valid after they leave the topology.
+   *
+   * @param channel_id channel's id we want to inquire
+   * @param writers result RolePtr vector
+   * @return true if there is at least one Writer
+   */
+  bool GetWritersOfChannel(uint64_t channel_id, RolePtrVec* writers);
+
+  /**
+   * @brief Get the Readers Of Channel object by id, see the RolePtrVec
+   * overload of GetWritersOfChannel
+   */
+  bool GetReadersOfChannel(uint64_t channel_id, RolePtrVec* readers);
+
+  /**
+   * @brief Get the Writers Of Node object by id, see the RolePtrVec overload
+   * of GetWritersOfChannel
+   */
+  bool GetWritersOfNode(uint64_t node_id, RolePtrVec* writers);
+
+  /**
+   * @brief Get the Readers Of Node object by id, see the RolePtrVec overload
+   * of GetWritersOfChannel
+   */
+  bool GetReadersOfNode(uint64_t node_id, RolePtrVec* readers);
+
   /**
    * @brief Get the Upstream Of Node object.
    * If Node A has writer that publishes channel-1, and Node B has reader that
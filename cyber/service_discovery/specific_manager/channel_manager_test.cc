@@ -271,6 +271,83 @@ TEST_F(ChannelManagerTest, change) {
   EXPECT_TRUE(channel_manager_.HasWriter("channel_0"));
 }
 
+TEST_F(ChannelManagerTest, changes_since) {
+  const uint64_t epoch = channel_manager_.epoch();
+  EXPECT_EQ(epoch, 2 * channel_num_);
+
+  std::vector<proto::ChangeMsg> changes;
+  uint64_t current_epoch = 0;
+  EXPECT_TRUE(
+      channel_manager_.GetChangesSince(epoch, &changes, &current_epoch));
+  EXPECT_TRUE(changes.empty());
+  EXPECT_EQ(current_epoch, epoch);
+
+  EXPECT_TRUE(
+      channel_manager_.GetChangesSince(epoch - 2, &changes, &current_epoch));
+  ASSERT_EQ(changes.size(), 2);
+  EXPECT_EQ(changes[1].role_type(), RoleType::ROLE_READER);
+  EXPECT_EQ(changes[1].role_attr().channel_name(),
+            "channel_" + std::to_string(channel_num_ - 1));
+
+  RoleAttributes role_attr;
+  role_attr.set_host_name(common::GlobalData::Instance()->HostName());
+  role_attr.set_process_id(common::GlobalData::Instance()->ProcessId());
+  role_attr.set_node_name("node_0");
+  role_attr.set_node_id(common::GlobalData::RegisterNode("node_0"));
+  role_attr.set_channel_name("channel_delta");
+  role_attr.set_channel_id(
+      common::GlobalData::Instance()->RegisterChannel("channel_delta"));
+  role_attr.set_proto_desc("not kept in the change log");
+  transport::Identity id;
+  role_attr.set_id(id.HashValue());
+  channel_manager_.Join(role_attr, RoleType::ROLE_WRITER);
+  channel_manager_.Leave(role_attr, RoleType::ROLE_WRITER);
+
+  changes.clear();
+  EXPECT_TRUE(
+      channel_manager_.GetChangesSince(epoch, &changes, &current_epoch));
+  EXPECT_EQ(current_epoch, epoch + 2);
+  ASSERT_EQ(changes.size(), 2);
+  EXPECT_EQ(changes[0].operate_type(), OperateType::OPT_JOIN);
+  EXPECT_EQ(changes[1].operate_type(), OperateType::OPT_LEAVE);
+  EXPECT_EQ(changes[0].role_attr().channel_name(), "channel_delta");
+  EXPECT_TRUE(changes[0].role_attr().proto_desc().empty());
+
+  // epochs from the future or too old to replay call for a new snapshot
+  changes.clear();
+  EXPECT_FALSE(channel_manager_.GetChangesSince(current_epoch + 1, &changes,
+                                                &current_epoch));
+  for (int i = 0; i < 1024; ++i) {
+    channel_manager_.Join(role_attr, RoleType::ROLE_WRITER);
+  }
+  EXPECT_FALSE(
+      channel_manager_.GetChangesSince(epoch, &changes, &current_epoch));
+  EXPECT_TRUE(changes.empty());
+}
+
+TEST_F(ChannelManagerTest, get_roles_by_id) {
+  ChannelManager::RolePtrVec roles;
+  uint64_t channel_id = common::GlobalData::RegisterChannel("channel_0");
+  EXPECT_TRUE(channel_manager_.GetWritersOfChannel(channel_id, &roles));
+  ASSERT_EQ(roles.size(), 1);
+  EXPECT_EQ(roles[0]->attributes().node_name(), "node_0");
+  EXPECT_TRUE(channel_manager_.GetReadersOfChannel(channel_id, &roles));
+  EXPECT_EQ(roles.size(), 2);
+
+  roles.clear();
+  uint64_t node_id = common::GlobalData::RegisterNode("node_1");
+  EXPECT_TRUE(channel_manager_.GetWritersOfNode(node_id, &roles));
+  EXPECT_TRUE(channel_manager_.GetReadersOfNode(node_id, &roles));
+  ASSERT_EQ(roles.size(), 2);
+  EXPECT_EQ(roles[1]->attributes().channel_name(), "channel_1");
+
+  roles.clear();
+  node_id = common::GlobalData::RegisterNode("node_without_roles");
+  EXPECT_FALSE(channel_manager_.GetWritersOfNode(node_id, &roles));
+  EXPECT_FALSE(channel_manager_.GetReadersOfNode(node_id, &roles));
+  EXPECT_TRUE(roles.empty());
+}
+
 TEST_F(ChannelManagerTest, get_upstream_downstream) {
   std::vector<proto::RoleAttributes> nodes;
   for (int i = 0; i < channel_num_; ++i) {
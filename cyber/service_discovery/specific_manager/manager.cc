@@ -32,6 +32,8 @@ namespace service_discovery {
 using transport::AttributesFiller;
 using transport::QosProfileConf;
 
+constexpr std::size_t Manager::kChangeLogSize;
+
 Manager::Manager()
     : is_shutdown_(false),
       is_discovery_started_(false),
@@ -137,6 +139,25 @@ void Manager::RemoveChangeListener(const ChangeConnection& conn) {
   local_conn.Disconnect();
 }
 
+uint64_t Manager::epoch() {
+  std::lock_guard<std::mutex> lg(change_log_mutex_);
+  return epoch_;
+}
+
+bool Manager::GetChangesSince(uint64_t epoch, std::vector<ChangeMsg>* changes,
+                              uint64_t* current_epoch) {
+  RETURN_VAL_IF_NULL(changes, false);
+  RETURN_VAL_IF_NULL(current_epoch, false);
+  std::lock_guard<std::mutex> lg(change_log_mutex_);
+  *current_epoch = epoch_;
+  if (epoch > epoch_ || epoch_ - epoch > change_log_.size()) {
+    return false;
+  }
+  auto first = change_log_.end() - static_cast<std::ptrdiff_t>(epoch_ - epoch);
+  changes->insert(changes->end(), first, change_log_.end());
+  return true;
+}
+
 bool Manager::CreatePublisher(RtpsParticipant* participant) {
   RtpsPublisherAttr pub_attr;
   RETURN_VAL_IF(
@@ -183,7 +204,18 @@ void Manager::Convert(const RoleAttributes& attr, RoleType role,
   }
 }
 
-void Manager::Notify(const ChangeMsg& msg) { signal_(msg); }
+void Manager::Notify(const ChangeMsg& msg) {
+  {
+    std::lock_guard<std::mutex> lg(change_log_mutex_);
+    change_log_.emplace_back(msg);
+    change_log_.back().mutable_role_attr()->clear_proto_desc();
+    if (change_log_.size() > kChangeLogSize) {
+      change_log_.pop_front();
+    }
+    ++epoch_;
+  }
+  signal_(msg);
+}
 
 void Manager::OnRemoteChange(const std::string& msg_str) {
   if (is_shutdown_.load()) {
@@ -18,9 +18,12 @@
 #define CYBER_SERVICE_DISCOVERY_SPECIFIC_MANAGER_MANAGER_H_
 
 #include <atomic>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "fastrtps/Domain.h"
 #include "fastrtps/attributes/PublisherAttributes.h"
@@ -126,6 +129,26 @@ class Manager {
    */
   void RemoveChangeListener(const ChangeConnection& conn);
 
+  /**
+   * @brief The epoch of the topology, advanced by every change applied.
+   * Read it before taking a snapshot with the Get queries and follow up
+   * with `GetChangesSince`; changes applied in between show in both.
+   */
+  uint64_t epoch();
+
+  /**
+   * @brief Get the changes applied after `epoch`, oldest first, without the
+   * proto_desc of writers, which is queried by channel instead
+   *
+   * @param epoch a value of `epoch()` or a previous `current_epoch`
+   * @param changes result vector
+   * @param current_epoch the epoch the changes lead to
+   * @return false if changes after `epoch` are no longer kept, in which case
+   * the topology has to be snapshot again
+   */
+  bool GetChangesSince(uint64_t epoch, std::vector<ChangeMsg>* changes,
+                       uint64_t* current_epoch);
+
   /**
    * @brief Called when a process' topology manager instance leave
    *
@@ -164,6 +187,12 @@ class Manager {
   SubscriberListener* listener_;
 
   ChangeSignal signal_;
+
+  // the latest changes, the last one applied at epoch_
+  static constexpr std::size_t kChangeLogSize = 1024;
+  std::mutex change_log_mutex_;
+  std::deque<ChangeMsg> change_log_;
+  uint64_t epoch_ = 0;
 };
 
 }  // namespace service_discovery
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Keeping up with a topology of 1000 channels, each with a writer and two
+// readers, by polling snapshots as cyber_monitor does against following the
+// changes since an epoch, and name based queries of a channel against id
+// based ones:
+//
+//   bazel run -c opt //cyber/service_discovery:topology_benchmark
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/service_discovery/specific_manager/channel_manager.h"
+#include "cyber/transport/common/identity.h"
+
+namespace apollo {
+namespace cyber {
+namespace service_discovery {
+
+namespace {
+
+constexpr int kChannels = 1000;
+constexpr int kNodes = 50;
+// about the size of the descriptors of a typical module message
+constexpr size_t kProtoDescSize = 4096;
+
+RoleAttributes Attr(int channel, int node) {
+  RoleAttributes attr;
+  attr.set_host_name(common::GlobalData::Instance()->HostName());
+  attr.set_process_id(common::GlobalData::Instance()->ProcessId());
+  attr.set_node_name("node_" + std::to_string(node));
+  attr.set_node_id(common::GlobalData::RegisterNode(attr.node_name()));
+  attr.set_channel_name("/apollo/channel_" + std::to_string(channel));
+  attr.set_channel_id(
+      common::GlobalData::RegisterChannel(attr.channel_name()));
+  attr.set_message_type("apollo.benchmark.Message");
+  transport::Identity id;
+  attr.set_id(id.HashValue());
+  return attr;
+}
+
+class Topology {
+ public:
+  Topology() {
+    for (int i = 0; i < kChannels; ++i) {
+      auto writer = Attr(i, i % kNodes);
+      writer.set_proto_desc(std::string(kProtoDescSize, 'd'));
+      manager_.Join(writer, RoleType::ROLE_WRITER, false);
+      for (int j = 1; j <= 2; ++j) {
+        manager_.Join(Attr(i, (i + j) % kNodes), RoleType::ROLE_READER,
+                      false);
+      }
+    }
+    churn_ = Attr(kChannels, 0);
+    churn_.set_proto_desc(std::string(kProtoDescSize, 'd'));
+  }
+  ~Topology() { manager_.Shutdown(); }
+
+  // a reader that comes and goes, as when a tool attaches to a channel
+  void Churn(int64_t changes) {
+    for (int64_t i = 0; i < changes; ++i) {
+      if (i % 2 == 0) {
+        manager_.Join(churn_, RoleType::ROLE_READER, false);
+      } else {
+        manager_.Leave(churn_, RoleType::ROLE_READER);
+      }
+    }
+  }
+
+  ChannelManager* manager() { return &manager_; }
+
+ private:
+  ChannelManager manager_;
+  RoleAttributes churn_;
+};
+
+}  // namespace
+
+// Copy all the writers and readers every refresh, `range(0)` changes apart.
+static void BM_PollSnapshot(benchmark::State& state) {
+  Topology topology;
+  for (auto _ : state) {
+    state.PauseTiming();
+    topology.Churn(state.range(0));
+    state.ResumeTiming();
+    ChannelManager::RoleAttrVec writers;
+    ChannelManager::RoleAttrVec readers;
+    topology.manager()->GetWriters(&writers);
+    topology.manager()->GetReaders(&readers);
+    benchmark::DoNotOptimize(writers.data());
+    benchmark::DoNotOptimize(readers.data());
+  }
+}
+BENCHMARK(BM_PollSnapshot)->Arg(0)->Arg(10)->Unit(benchmark::kMicrosecond);
+
+// Snapshot once, then fetch the changes since the last refresh.
+static void BM_PollChanges(benchmark::State& state) {
+  Topology topology;
+  uint64_t epoch = topology.manager()->epoch();
+  ChannelManager::RoleAttrVec writers;
+  ChannelManager::RoleAttrVec readers;
+  topology.manager()->GetWriters(&writers);
+  topology.manager()->GetReaders(&readers);
+  for (auto _ : state) {
+    state.PauseTiming();
+    topology.Churn(state.range(0));
+    state.ResumeTiming();
+    std::vector<proto::ChangeMsg> changes;
+    if (!topology.manager()->GetChangesSince(epoch, &changes, &epoch)) {
+      state.SkipWithError("change log overrun");
+      break;
+    }
+    benchmark::DoNotOptimize(changes.data());
+  }
+}
+BENCHMARK(BM_PollChanges)->Arg(0)->Arg(10)->Unit(benchmark::kMicrosecond);
+
+static void BM_QueryChannelByName(benchmark::State& state) {
+  Topology topology;
+  int channel = 0;
+  for (auto _ : state) {
+    const std::string name =
+        "/apollo/channel_" + std::to_string(channel++ % kChannels);
+    ChannelManager::RoleAttrVec writers;
+    ChannelManager::RoleAttrVec readers;
+    topology.manager()->GetWritersOfChannel(name, &writers);
+    topology.manager()->GetReadersOfChannel(name, &readers);
+    benchmark::DoNotOptimize(writers.data());
+    benchmark::DoNotOptimize(readers.data());
+  }
+}
+BENCHMARK(BM_QueryChannelByName);
+
+static void BM_QueryChannelById(benchmark::State& state) {
+  Topology topology;
+  std::vector<uint64_t> ids;
+  for (int i = 0; i < kChannels; ++i) {
+    ids.push_back(common::GlobalData::RegisterChannel(
+        "/apollo/channel_" + std::to_string(i)));
+  }
+  int channel = 0;
+  for (auto _ : state) {
+    ChannelManager::RolePtrVec writers;
+    ChannelManager::RolePtrVec readers;
+    const uint64_t id = ids[channel++ % kChannels];
+    topology.manager()->GetWritersOfChannel(id, &writers);
+    topology.manager()->GetReadersOfChannel(id, &readers);
+    benchmark::DoNotOptimize(writers.data());
+    benchmark::DoNotOptimize(readers.data());
+  }
+}
+BENCHMARK(BM_QueryChannelById);
+
+}  // namespace service_discovery
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
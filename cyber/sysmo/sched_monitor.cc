@@ -0,0 +1,188 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/sysmo/sched_monitor.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cyber/binary.h"
+#include "cyber/common/log.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/profiler/trace_collector.h"
+#include "cyber/scheduler/processor.h"
+#include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::scheduler::Processor;
+
+namespace {
+
+// context switches of a thread of the process as counted by the kernel
+void ReadCtxtSwitches(pid_t tid, uint64_t* voluntary,
+                      uint64_t* nonvoluntary) {
+  std::ifstream status("/proc/self/task/" + std::to_string(tid) + "/status");
+  std::string key;
+  uint64_t value = 0;
+  while (status >> key) {
+    if (key == "voluntary_ctxt_switches:" && status >> value) {
+      *voluntary = value;
+    } else if (key == "nonvoluntary_ctxt_switches:" && status >> value) {
+      *nonvoluntary = value;
+    }
+  }
+}
+
+}  // namespace
+
+SchedMonitor::SchedMonitor(const proto::SysMoConf& conf)
+    : run_budget_ns_(static_cast<uint64_t>(conf.run_budget_us()) * 1000),
+      wait_budget_ns_(static_cast<uint64_t>(conf.wait_budget_us()) * 1000),
+      cpu_budget_percent_(conf.cpu_budget_percent()),
+      last_collect_time_(Time::Now().ToNanosecond()),
+      last_collect_ns_(profiler::NowNs()) {}
+
+void SchedMonitor::CheckStalls() {
+  if (run_budget_ns_ == 0) {
+    return;
+  }
+  uint64_t now = Time::Now().ToNanosecond();
+  for (auto& processor : scheduler::Instance()->Processors()) {
+    auto snap = processor->ProcSnapshot();
+    uint64_t start = snap->execute_start_time.load();
+    pid_t tid = snap->processor_id.load();
+    if (start == 0 || start > now || now - start <= run_budget_ns_) {
+      continue;
+    }
+    auto& warned = stalls_[tid];
+    if (warned != start) {
+      warned = start;
+      AWARN << "processor " << tid << " stalled in " << snap->routine_name
+            << " for " << (now - start) / 1000000 << " ms";
+    }
+  }
+}
+
+void SchedMonitor::Collect(proto::SysMoReport* report) {
+  uint64_t now = Time::Now().ToNanosecond();
+  uint64_t now_ns = profiler::NowNs();
+  uint64_t interval_ns = now_ns - last_collect_ns_;
+  report->set_process_name(binary::GetName());
+  report->set_pid(static_cast<int32_t>(getpid()));
+  report->set_begin_time(last_collect_time_);
+  report->set_end_time(now);
+  last_collect_time_ = now;
+  last_collect_ns_ = now_ns;
+
+  for (auto& processor : scheduler::Instance()->Processors()) {
+    auto snap = processor->ProcSnapshot();
+    pid_t tid = snap->processor_id.load();
+    auto& last = processors_[tid];
+    ProcessorTotals totals;
+    totals.switches = snap->switches.load(std::memory_order_relaxed);
+    totals.cpu_ns = snap->cpu_ns.load(std::memory_order_relaxed);
+    totals.busy_ns = snap->busy_ns.load(std::memory_order_relaxed);
+    ReadCtxtSwitches(tid, &totals.voluntary_ctxt_switches,
+                     &totals.nonvoluntary_ctxt_switches);
+
+    auto metrics = report->add_processors();
+    metrics->set_tid(tid);
+    metrics->set_switches(totals.switches - last.switches);
+    metrics->set_cpu_ns(totals.cpu_ns - last.cpu_ns);
+    metrics->set_busy_ns(totals.busy_ns - last.busy_ns);
+    metrics->set_voluntary_ctxt_switches(totals.voluntary_ctxt_switches -
+                                         last.voluntary_ctxt_switches);
+    metrics->set_nonvoluntary_ctxt_switches(
+        totals.nonvoluntary_ctxt_switches - last.nonvoluntary_ctxt_switches);
+    uint64_t start = snap->execute_start_time.load();
+    if (start != 0 && start <= now) {
+      metrics->set_running_routine(snap->routine_name);
+      metrics->set_running_ns(now - start);
+      metrics->set_stalled(run_budget_ns_ != 0 &&
+                           now - start > run_budget_ns_);
+    }
+    last = totals;
+  }
+
+  std::vector<std::shared_ptr<CRoutine>> routines;
+  scheduler::Instance()->GetRoutines(&routines);
+  std::unordered_map<uint64_t, RoutineTotals> totals_by_id;
+  totals_by_id.reserve(routines.size());
+  for (auto& routine : routines) {
+    auto stats = routine->stats();
+    RoutineTotals totals;
+    totals.runs = stats->runs.load(std::memory_order_relaxed);
+    totals.cpu_ns = stats->cpu_ns.load(std::memory_order_relaxed);
+    totals.wall_ns = stats->wall_ns.load(std::memory_order_relaxed);
+    totals.wait_ns = stats->wait_ns.load(std::memory_order_relaxed);
+    uint64_t max_run_ns =
+        stats->max_run_ns.exchange(0, std::memory_order_relaxed);
+    uint64_t max_wait_ns =
+        stats->max_wait_ns.exchange(0, std::memory_order_relaxed);
+    // routines created since the last call start from zero
+    auto it = routines_.find(routine->id());
+    RoutineTotals last = it != routines_.end() ? it->second : RoutineTotals();
+    totals_by_id.emplace(routine->id(), totals);
+    if (totals.runs == last.runs) {
+      continue;
+    }
+
+    auto metrics = report->add_routines();
+    metrics->set_name(routine->name());
+    metrics->set_id(routine->id());
+    metrics->set_runs(totals.runs - last.runs);
+    metrics->set_cpu_ns(totals.cpu_ns - last.cpu_ns);
+    metrics->set_wall_ns(totals.wall_ns - last.wall_ns);
+    metrics->set_max_run_ns(max_run_ns);
+    metrics->set_wait_ns(totals.wait_ns - last.wait_ns);
+    metrics->set_max_wait_ns(max_wait_ns);
+    if (OverBudget(*metrics, interval_ns)) {
+      metrics->set_over_budget(true);
+      AWARN << "croutine " << metrics->name() << " over budget: "
+            << metrics->runs() << " runs, cpu "
+            << metrics->cpu_ns() / 1000 << " us, longest run "
+            << metrics->max_run_ns() / 1000 << " us, longest wait "
+            << metrics->max_wait_ns() / 1000 << " us in "
+            << interval_ns / 1000000 << " ms";
+    }
+  }
+  // forget the routines that are gone
+  routines_ = std::move(totals_by_id);
+}
+
+bool SchedMonitor::OverBudget(const proto::RoutineMetrics& metrics,
+                              uint64_t interval_ns) const {
+  if (run_budget_ns_ != 0 && metrics.max_run_ns() > run_budget_ns_) {
+    return true;
+  }
+  if (wait_budget_ns_ != 0 && metrics.max_wait_ns() > wait_budget_ns_) {
+    return true;
+  }
+  return cpu_budget_percent_ != 0 &&
+         metrics.cpu_ns() * 100 > cpu_budget_percent_ * interval_ns;
+}
+
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SYSMO_SCHED_MONITOR_H_
+#define CYBER_SYSMO_SCHED_MONITOR_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "cyber/proto/sysmo.pb.h"
+#include "cyber/proto/sysmo_conf.pb.h"
+
+namespace apollo {
+namespace cyber {
+
+/**
+ * @brief Turns the run time accounting of the croutines and processors of
+ * the scheduler into per interval metrics, and checks them against the
+ * budgets of SysMoConf.
+ */
+class SchedMonitor {
+ public:
+  explicit SchedMonitor(const proto::SysMoConf& conf);
+
+  /**
+   * @brief Warn about processors stuck in a single run for longer than the
+   * run budget, once per run.
+   */
+  void CheckStalls();
+
+  /**
+   * @brief Fill `report` with what ran since the previous call, or since
+   * the construction for the first one.
+   */
+  void Collect(proto::SysMoReport* report);
+
+ private:
+  struct RoutineTotals {
+    uint64_t runs = 0;
+    uint64_t cpu_ns = 0;
+    uint64_t wall_ns = 0;
+    uint64_t wait_ns = 0;
+  };
+
+  struct ProcessorTotals {
+    uint64_t switches = 0;
+    uint64_t cpu_ns = 0;
+    uint64_t busy_ns = 0;
+    uint64_t voluntary_ctxt_switches = 0;
+    uint64_t nonvoluntary_ctxt_switches = 0;
+  };
+
+  bool OverBudget(const proto::RoutineMetrics& metrics,
+                  uint64_t interval_ns) const;
+
+  const uint64_t run_budget_ns_;
+  const uint64_t wait_budget_ns_;
+  const uint32_t cpu_budget_percent_;
+
+  uint64_t last_collect_time_ = 0;
+  uint64_t last_collect_ns_ = 0;
+  std::unordered_map<uint64_t, RoutineTotals> routines_;
+  std::unordered_map<pid_t, ProcessorTotals> processors_;
+  // start of the run each stalled processor was warned about
+  std::unordered_map<pid_t, uint64_t> stalls_;
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SYSMO_SCHED_MONITOR_H_
@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/sysmo/sched_monitor.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "cyber/scheduler/processor.h"
+#include "cyber/scheduler/scheduler_factory.h"
+
+namespace apollo {
+namespace cyber {
+
+using apollo::cyber::scheduler::Processor;
+
+const proto::RoutineMetrics* FindRoutine(const proto::SysMoReport& report,
+                                         const std::string& name) {
+  for (auto& routine : report.routines()) {
+    if (routine.name() == name) {
+      return &routine;
+    }
+  }
+  return nullptr;
+}
+
+void Spin(std::chrono::milliseconds duration) {
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+TEST(SchedMonitorTest, collect) {
+  auto sched = scheduler::Instance();
+  Processor::EnableRoutineStats(true);
+  proto::SysMoConf conf;
+  conf.set_run_budget_us(2000);
+  SchedMonitor monitor(conf);
+
+  std::atomic<bool> spinning = {true};
+  std::atomic<int> done = {0};
+  EXPECT_TRUE(sched->CreateTask(
+      [&]() {
+        while (spinning.load()) {
+          Spin(std::chrono::milliseconds(1));
+        }
+        ++done;
+      },
+      "sched_monitor_busy"));
+  EXPECT_TRUE(sched->CreateTask([&]() { ++done; }, "sched_monitor_quick"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // the busy routine is in the middle of its run, longer than the budget
+  proto::SysMoReport report;
+  monitor.CheckStalls();
+  monitor.Collect(&report);
+  EXPECT_EQ(sched->Processors().size(), report.processors_size());
+  bool stalled = false;
+  for (auto& processor : report.processors()) {
+    if (processor.running_routine() == "sched_monitor_busy") {
+      EXPECT_GT(processor.running_ns(), 2000000);
+      stalled = stalled || processor.stalled();
+    }
+  }
+  EXPECT_TRUE(stalled);
+
+  spinning = false;
+  while (done.load() != 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  report.Clear();
+  monitor.Collect(&report);
+  auto busy = FindRoutine(report, "sched_monitor_busy");
+  ASSERT_NE(nullptr, busy);
+  EXPECT_EQ(1, busy->runs());
+  EXPECT_GT(busy->cpu_ns(), 10000000);
+  EXPECT_GE(busy->wall_ns(), busy->cpu_ns());
+  EXPECT_EQ(busy->wall_ns(), busy->max_run_ns());
+  EXPECT_TRUE(busy->over_budget());
+  uint64_t switches = 0;
+  for (auto& processor : report.processors()) {
+    switches += processor.switches();
+  }
+  EXPECT_GE(switches, 1);
+
+  // nothing ran since
+  report.Clear();
+  monitor.Collect(&report);
+  EXPECT_EQ(nullptr, FindRoutine(report, "sched_monitor_busy"));
+  EXPECT_EQ(nullptr, FindRoutine(report, "sched_monitor_quick"));
+
+  Processor::EnableRoutineStats(false);
+  sched->Shutdown();
+}
+
+TEST(SchedMonitorTest, cpu_budget) {
+  proto::SysMoConf conf;
+  conf.set_cpu_budget_percent(50);
+  conf.set_wait_budget_us(100);
+  SchedMonitor monitor(conf);
+  proto::SysMoReport report;
+  monitor.Collect(&report);
+  EXPECT_EQ(0, report.routines_size());
+}
+
+}  // namespace cyber
+}  // namespace apollo
@@ -16,21 +16,48 @@
 
 #include "cyber/sysmo/sysmo.h"
 
+#include <unistd.h>
+
+#include <vector>
+
 #include "cyber/common/environment.h"
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/data/pending_queue_registry.h"
+#include "cyber/scheduler/processor.h"
+#include "cyber/state.h"
+#include "cyber/time/time.h"
+#include "cyber/transport/dispatcher/shm_dispatcher.h"
 
 namespace apollo {
 namespace cyber {
 
 using apollo::cyber::common::GetEnv;
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::data::PendingQueueRegistry;
+using apollo::cyber::scheduler::Processor;
+using apollo::cyber::transport::ShmDispatcher;
+using apollo::cyber::transport::ShmShardStats;
 
 SysMo::SysMo() { Start(); }
 
 void SysMo::Start() {
+  const auto& conf = GlobalData::Instance()->Config().sysmo_conf();
   auto sysmo_start = GetEnv("sysmo_start");
-  if (sysmo_start != "" && std::stoi(sysmo_start)) {
-    start_ = true;
-    sysmo_ = std::thread(&SysMo::Checker, this);
+  if (!conf.enable() && (sysmo_start == "" || !std::stoi(sysmo_start))) {
+    return;
+  }
+  start_ = true;
+  if (conf.check_interval_ms() > 0) {
+    sysmo_interval_ms_ = static_cast<int>(conf.check_interval_ms());
   }
+  monitor_.reset(new SchedMonitor(conf));
+  report_interval_ns_ =
+      static_cast<uint64_t>(conf.report_interval_ms()) * 1000000;
+  metrics_channel_ = conf.metrics_channel();
+  last_report_time_ = Time::Now().ToNanosecond();
+  Processor::EnableRoutineStats(true);
+  sysmo_ = std::thread(&SysMo::Checker, this);
 }
 
 void SysMo::Shutdown() {
@@ -38,19 +65,90 @@ void SysMo::Shutdown() {
     return;
   }
 
+  Processor::EnableRoutineStats(false);
   cv_.notify_all();
   if (sysmo_.joinable()) {
     sysmo_.join();
   }
+  writer_.reset();
+  node_.reset();
 }
 
 void SysMo::Checker() {
   while (cyber_unlikely(!shut_down_.load())) {
     scheduler::Instance()->CheckSchedStatus();
+    monitor_->CheckStalls();
+    if (report_interval_ns_ > 0 &&
+        Time::Now().ToNanosecond() - last_report_time_ >=
+            report_interval_ns_ &&
+        CreateWriter()) {
+      Report();
+    }
     std::unique_lock<std::mutex> lk(lk_);
     cv_.wait_for(lk, std::chrono::milliseconds(sysmo_interval_ms_));
   }
 }
 
+bool SysMo::CreateWriter() {
+  if (writer_ != nullptr) {
+    return true;
+  }
+  // SysMo starts while cyber::Init is running, the node waits until the
+  // process is initialized
+  if (!OK()) {
+    return false;
+  }
+  node_.reset(new Node("sysmo_" + std::to_string(getpid())));
+  writer_ = node_->CreateWriter<proto::SysMoReport>(metrics_channel_);
+  if (writer_ == nullptr) {
+    AERROR << "Create sysmo metrics writer failed.";
+    report_interval_ns_ = 0;
+    return false;
+  }
+  return true;
+}
+
+void SysMo::Report() {
+  proto::SysMoReport report;
+  monitor_->Collect(&report);
+  for (const auto& entry : PendingQueueRegistry::Instance()->Entries()) {
+    const auto& stats = *entry.stats;
+    auto metrics = report.add_pending_queues();
+    metrics->set_channel_name(entry.channel_name);
+    metrics->set_node_name(entry.node_name);
+    metrics->set_policy(stats.policy);
+    metrics->set_capacity(stats.capacity);
+    metrics->set_enqueued(stats.enqueued.load(std::memory_order_relaxed));
+    metrics->set_dropped(stats.dropped.load(std::memory_order_relaxed));
+    metrics->set_conflated(stats.conflated.load(std::memory_order_relaxed));
+    metrics->set_sampled_out(stats.sampled_out.load(std::memory_order_relaxed));
+    metrics->set_block_timeouts(
+        stats.block_timeouts.load(std::memory_order_relaxed));
+    metrics->set_blocked_ns(stats.blocked_ns.load(std::memory_order_relaxed));
+    metrics->set_depth(stats.depth.load(std::memory_order_relaxed));
+    metrics->set_max_depth(stats.max_depth.load(std::memory_order_relaxed));
+  }
+  // the dispatcher is not created for the report
+  auto shm_dispatcher = ShmDispatcher::Instance(false);
+  if (shm_dispatcher != nullptr) {
+    std::vector<ShmShardStats> shards;
+    shm_dispatcher->GetShardStats(&shards);
+    for (const auto& shard : shards) {
+      auto metrics = report.add_shm_shards();
+      metrics->set_name(shard.name);
+      metrics->set_queue_depth(shard.queue_depth);
+      metrics->set_max_queue_depth(shard.max_queue_depth);
+      metrics->set_dispatched(shard.dispatched);
+      metrics->set_dropped(shard.dropped);
+      metrics->set_total_wait_ns(shard.total_wait_ns);
+      metrics->set_max_wait_ns(shard.max_wait_ns);
+      metrics->set_total_handle_ns(shard.total_handle_ns);
+      metrics->set_max_handle_ns(shard.max_handle_ns);
+    }
+  }
+  last_report_time_ = report.end_time();
+  writer_->Write(report);
+}
+
 }  // namespace cyber
 }  // namespace apollo
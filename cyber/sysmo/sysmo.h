@@ -20,17 +20,27 @@
 #include <chrono>
 #include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
+#include "cyber/proto/sysmo.pb.h"
+
+#include "cyber/node/node.h"
 #include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/sysmo/sched_monitor.h"
 
 namespace apollo {
 namespace cyber {
 
 using apollo::cyber::scheduler::Scheduler;
 
+/**
+ * @brief Watches the scheduler: logs the status of the processors, flags
+ * stalled processors and croutines over their budgets, and publishes per
+ * croutine and per processor metrics on SysMoConf.metrics_channel.
+ */
 class SysMo {
  public:
   void Start();
@@ -38,10 +48,20 @@ class SysMo {
 
  private:
   void Checker();
+  bool CreateWriter();
+  void Report();
 
   std::atomic<bool> shut_down_{false};
   bool start_ = false;
 
+  std::unique_ptr<SchedMonitor> monitor_;
+  uint64_t report_interval_ns_ = 0;
+  uint64_t last_report_time_ = 0;
+  std::string metrics_channel_;
+  // created by the checker thread on the first report
+  std::unique_ptr<Node> node_;
+  std::shared_ptr<Writer<proto::SysMoReport>> writer_;
+
   int sysmo_interval_ms_ = 100;
   std::condition_variable cv_;
   std::mutex lk_;
@@ -19,25 +19,22 @@
 
 #include <list>
 #include <memory>
-#include <mutex>
 
 #include "cyber/timer/timer_task.h"
 
 namespace apollo {
 namespace cyber {
 
+// Only touched by the tick thread of TimingWheel, hence unsynchronized.
 class TimerBucket {
  public:
   void AddTask(const std::shared_ptr<TimerTask>& task) {
-    std::lock_guard<std::mutex> lock(mutex_);
     task_list_.push_back(task);
   }
 
-  std::mutex& mutex() { return mutex_; }
   std::list<std::weak_ptr<TimerTask>>& task_list() { return task_list_; }
 
  private:
-  std::mutex mutex_;
   std::list<std::weak_ptr<TimerTask>> task_list_;
 };
 
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Firing jitter of periodic cyber::Timer instances, how far the interval
+// between two consecutive firings is off the period. Reported as
+// percentiles and as a histogram of counters (le_<bound>us: share of the
+// intervals within that bound). Arguments: period in ms, concurrent timers.
+// The wheel resolution comes from timer_conf in cyber.pb.conf.
+//
+//   bazel run -c opt //cyber/timer:timer_jitter_benchmark
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/init.h"
+#include "cyber/time/time.h"
+#include "cyber/timer/timer.h"
+
+namespace apollo {
+namespace cyber {
+
+namespace {
+
+constexpr int kFiresPerTimer = 200;
+constexpr int64_t kHistogramBoundsUs[] = {10, 50, 100, 250, 500, 1000, 2000};
+
+class JitterProbe {
+ public:
+  explicit JitterProbe(uint32_t period_ms)
+      : period_ns_(static_cast<int64_t>(period_ms) * 1000000) {
+    fires_.reserve(kFiresPerTimer);
+  }
+
+  void OnFire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fires_.size() < kFiresPerTimer) {
+      fires_.push_back(Now());
+    }
+  }
+
+  bool Done() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fires_.size() >= kFiresPerTimer;
+  }
+
+  void Collect(std::vector<int64_t>* jitter_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 1; i < fires_.size(); ++i) {
+      jitter_ns->push_back(std::abs(fires_[i] - fires_[i - 1] - period_ns_));
+    }
+  }
+
+ private:
+  static int64_t Now() {
+    return static_cast<int64_t>(Time::MonoTime().ToNanosecond());
+  }
+
+  int64_t period_ns_;
+  std::mutex mutex_;
+  std::vector<int64_t> fires_;
+};
+
+}  // namespace
+
+static void BM_TimerJitter(benchmark::State& state) {
+  const auto period_ms = static_cast<uint32_t>(state.range(0));
+  const auto timer_num = static_cast<int>(state.range(1));
+  std::vector<int64_t> jitter_ns;
+  for (auto _ : state) {
+    std::vector<std::unique_ptr<JitterProbe>> probes;
+    std::vector<std::unique_ptr<Timer>> timers;
+    for (int i = 0; i < timer_num; ++i) {
+      probes.emplace_back(new JitterProbe(period_ms));
+      auto probe = probes.back().get();
+      timers.emplace_back(
+          new Timer(period_ms, [probe]() { probe->OnFire(); }, false));
+    }
+    for (auto& timer : timers) {
+      timer->Start();
+    }
+    for (auto& probe : probes) {
+      while (!probe->Done()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(period_ms));
+      }
+    }
+    for (auto& timer : timers) {
+      timer->Stop();
+    }
+    for (auto& probe : probes) {
+      probe->Collect(&jitter_ns);
+    }
+  }
+  if (jitter_ns.empty()) {
+    return;
+  }
+  std::sort(jitter_ns.begin(), jitter_ns.end());
+  auto percentile_us = [&jitter_ns](double p) {
+    auto index = static_cast<size_t>(p * static_cast<double>(jitter_ns.size()));
+    return static_cast<double>(
+               jitter_ns[std::min(index, jitter_ns.size() - 1)]) /
+           1000.0;
+  };
+  state.counters["p50_us"] = percentile_us(0.5);
+  state.counters["p99_us"] = percentile_us(0.99);
+  state.counters["max_us"] = static_cast<double>(jitter_ns.back()) / 1000.0;
+  for (auto bound_us : kHistogramBoundsUs) {
+    auto within = std::upper_bound(jitter_ns.begin(), jitter_ns.end(),
+                                   bound_us * 1000) -
+                  jitter_ns.begin();
+    state.counters["le_" + std::to_string(bound_us) + "us"] =
+        static_cast<double>(within) / static_cast<double>(jitter_ns.size());
+  }
+}
+// 100 Hz control and 200 Hz canbus, alone and among other timers
+BENCHMARK(BM_TimerJitter)
+    ->ArgsProduct({{5, 10}, {1, 64}})
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  apollo::cyber::Init(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  apollo::cyber::Clear();
+  return 0;
+}
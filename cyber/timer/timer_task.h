@@ -17,6 +17,7 @@
 #ifndef CYBER_TIMER_TIMER_TASK_H_
 #define CYBER_TIMER_TIMER_TASK_H_
 
+#include <cstdint>
 #include <functional>
 #include <mutex>
 
@@ -29,11 +30,10 @@ struct TimerTask {
   explicit TimerTask(uint64_t timer_id) : timer_id_(timer_id) {}
   uint64_t timer_id_ = 0;
   std::function<void()> callback;
-  uint64_t interval_ms = 0;
-  uint64_t remainder_interval_ms = 0;
-  uint64_t next_fire_duration_ms = 0;
-  int64_t accumulated_error_ns = 0;
-  uint64_t last_execute_time_ns = 0;
+  uint64_t interval_ns = 0;
+  // CLOCK_MONOTONIC time of the next firing, advanced by interval_ns from
+  // the previous deadline rather than from when the callback ran
+  uint64_t deadline_ns = 0;
   std::mutex mutex;
 };
 
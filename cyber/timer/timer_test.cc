@@ -18,6 +18,7 @@
 
 #include "cyber/timer/timer.h"
 
+#include <atomic>
 #include <memory>
 #include <utility>
 
@@ -79,6 +80,24 @@ TEST(TimerTest, start_stop) {
   }
 }
 
+TEST(TimerTest, drift) {
+  // deadlines advance from the previous deadline, so neither wake-up latency
+  // nor the callback time makes a periodic timer fall behind
+  std::atomic<int> count = {0};
+  Timer timer(
+      10,
+      [&count] {
+        ++count;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      },
+      false);
+  timer.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1005));
+  timer.Stop();
+  EXPECT_GE(count, 90);
+  EXPECT_LE(count, 101);
+}
+
 TEST(TimerTest, sim_mode) {
   auto count = 0;
 
@@ -16,17 +16,54 @@
 
 #include "cyber/timer/timing_wheel.h"
 
-#include <cmath>
+#include <time.h>
 
+#include <algorithm>
+
+#include "cyber/common/global_data.h"
 #include "cyber/task/task.h"
 
 namespace apollo {
 namespace cyber {
 
+namespace {
+
+uint64_t MonoNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+void SleepUntil(uint64_t deadline_ns) {
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(deadline_ns / 1000000000ULL);
+  ts.tv_nsec = static_cast<long>(deadline_ns % 1000000000ULL);  // NOLINT
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) ==
+         EINTR) {
+  }
+}
+
+}  // namespace
+
+TimingWheel::TimingWheel() {
+  uint64_t resolution_us =
+      common::GlobalData::Instance()->Config().timer_conf().resolution_us();
+  resolution_us = std::min(std::max(resolution_us, TIMER_MIN_RESOLUTION_US),
+                           TIMER_MAX_RESOLUTION_US);
+  resolution_ns_ = resolution_us * 1000;
+}
+
+uint64_t TimingWheel::MaxIntervalMs() const {
+  return (resolution_ns_ << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) /
+         1000000;
+}
+
 void TimingWheel::Start() {
   std::lock_guard<std::mutex> lock(running_mutex_);
   if (!running_) {
-    ADEBUG << "TimeWheel start ok";
+    ADEBUG << "TimeWheel start ok, resolution: " << resolution_ns_ << " ns";
+    start_ns_ = MonoNs();
+    tick_count_ = 0;
     running_ = true;
     tick_thread_ = std::thread([this]() { this->TickFunc(); });
     scheduler::Instance()->SetInnerThreadAttr("timer", &tick_thread_);
@@ -37,111 +74,160 @@ void TimingWheel::Shutdown() {
   std::lock_guard<std::mutex> lock(running_mutex_);
   if (running_) {
     running_ = false;
+    {
+      std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+      idle_cv_.notify_one();
+    }
     if (tick_thread_.joinable()) {
       tick_thread_.join();
     }
+    Clear();
   }
 }
 
-void TimingWheel::Tick() {
-  auto& bucket = work_wheel_[current_work_wheel_index_];
-  {
-    std::lock_guard<std::mutex> lock(bucket.mutex());
-    auto ite = bucket.task_list().begin();
-    while (ite != bucket.task_list().end()) {
-      auto task = ite->lock();
-      if (task) {
-        ADEBUG << "index: " << current_work_wheel_index_
-               << " timer id: " << task->timer_id_;
-        auto* callback =
-            reinterpret_cast<std::function<void()>*>(&(task->callback));
-        cyber::Async([this, callback] {
-          if (this->running_) {
-            (*callback)();
-          }
-        });
-      }
-      ite = bucket.task_list().erase(ite);
-    }
+void TimingWheel::AddTask(const std::shared_ptr<TimerTask>& task) {
+  if (!running_) {
+    Start();
+  }
+  auto node = new PendingTask{task, pending_.load(std::memory_order_relaxed)};
+  while (!pending_.compare_exchange_weak(node->next, node)) {
+  }
+  // pairs with the idle_ store before the tick thread checks pending_
+  if (idle_.load()) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_cv_.notify_one();
   }
 }
 
-void TimingWheel::AddTask(const std::shared_ptr<TimerTask>& task) {
-  AddTask(task, current_work_wheel_index_);
+uint64_t TimingWheel::DeadlineTick(uint64_t deadline_ns) const {
+  if (deadline_ns <= start_ns_) {
+    return 0;
+  }
+  // round up, a timer never fires before its deadline
+  return (deadline_ns - start_ns_ + resolution_ns_ - 1) / resolution_ns_;
 }
 
-void TimingWheel::AddTask(const std::shared_ptr<TimerTask>& task,
-                          const uint64_t current_work_wheel_index) {
-  if (!running_) {
-    Start();
+void TimingWheel::Place(const std::shared_ptr<TimerTask>& task) {
+  const uint64_t current = tick_count_;
+  uint64_t expires = std::max(DeadlineTick(task->deadline_ns), current);
+  uint64_t delta = expires - current;
+  uint64_t level = 0;
+  while (level + 1 < TIMER_WHEEL_LEVELS &&
+         delta >= (1ULL << (TIMER_WHEEL_BITS * (level + 1)))) {
+    ++level;
+  }
+  if (level + 1 == TIMER_WHEEL_LEVELS &&
+      delta >= (1ULL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))) {
+    // out of range, park it in the farthest slot and let cascading retry
+    expires = current + (1ULL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+  }
+  uint64_t index =
+      (expires >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SIZE - 1);
+  wheel_[level][index].AddTask(task);
+  ++task_count_;
+}
+
+void TimingWheel::DrainPending() {
+  auto node = pending_.exchange(nullptr, std::memory_order_acquire);
+  while (node != nullptr) {
+    auto task = node->task.lock();
+    if (task) {
+      Place(task);
+    }
+    auto next = node->next;
+    delete node;
+    node = next;
   }
-  auto work_wheel_index = current_work_wheel_index +
-                          static_cast<uint64_t>(std::ceil(
-                              static_cast<double>(task->next_fire_duration_ms) /
-                              TIMER_RESOLUTION_MS));
-  if (work_wheel_index >= WORK_WHEEL_SIZE) {
-    auto real_work_wheel_index = GetWorkWheelIndex(work_wheel_index);
-    task->remainder_interval_ms = real_work_wheel_index;
-    auto assistant_ticks = work_wheel_index / WORK_WHEEL_SIZE;
-    if (assistant_ticks == 1 &&
-        real_work_wheel_index < current_work_wheel_index_) {
-      work_wheel_[real_work_wheel_index].AddTask(task);
-      ADEBUG << "add task to work wheel. index :" << real_work_wheel_index;
-    } else {
-      auto assistant_wheel_index = 0;
-      {
-        std::lock_guard<std::mutex> lock(current_assistant_wheel_index_mutex_);
-        assistant_wheel_index = GetAssistantWheelIndex(
-            current_assistant_wheel_index_ + assistant_ticks);
-        assistant_wheel_[assistant_wheel_index].AddTask(task);
-      }
-      ADEBUG << "add task to assistant wheel. index : "
-             << assistant_wheel_index;
+}
+
+bool TimingWheel::Cascade(uint64_t level) {
+  const uint64_t current = tick_count_;
+  uint64_t index =
+      (current >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SIZE - 1);
+  std::list<std::weak_ptr<TimerTask>> tasks;
+  tasks.swap(wheel_[level][index].task_list());
+  task_count_ -= tasks.size();
+  for (auto& weak_task : tasks) {
+    auto task = weak_task.lock();
+    if (task) {
+      Place(task);
     }
-  } else {
-    work_wheel_[work_wheel_index].AddTask(task);
-    ADEBUG << "add task [" << task->timer_id_
-           << "] to work wheel. index :" << work_wheel_index;
   }
+  return index == 0;
 }
 
-void TimingWheel::Cascade(const uint64_t assistant_wheel_index) {
-  auto& bucket = assistant_wheel_[assistant_wheel_index];
-  std::lock_guard<std::mutex> lock(bucket.mutex());
+void TimingWheel::Tick() {
+  DrainPending();
+  const uint64_t current = tick_count_;
+  // move the tasks of the upper levels down whenever a lower level wraps
+  if ((current & (TIMER_WHEEL_SIZE - 1)) == 0) {
+    for (uint64_t level = 1; level < TIMER_WHEEL_LEVELS && Cascade(level);
+         ++level) {
+    }
+  }
+  auto& bucket = wheel_[0][current & (TIMER_WHEEL_SIZE - 1)];
   auto ite = bucket.task_list().begin();
   while (ite != bucket.task_list().end()) {
     auto task = ite->lock();
     if (task) {
-      work_wheel_[task->remainder_interval_ms].AddTask(task);
+      ADEBUG << "tick: " << current << " timer id: " << task->timer_id_;
+      // the task may be dropped before the callback runs, e.g. by
+      // Timer::Stop
+      std::weak_ptr<TimerTask> weak_task = task;
+      cyber::Async([this, weak_task] {
+        auto task = weak_task.lock();
+        if (task && this->running_) {
+          task->callback();
+        }
+      });
     }
     ite = bucket.task_list().erase(ite);
+    --task_count_;
+  }
+  tick_count_ = current + 1;
+}
+
+void TimingWheel::WaitForTask() {
+  idle_.store(true);
+  {
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [this]() {
+      return !running_ || pending_.load() != nullptr;
+    });
+  }
+  idle_.store(false);
+  // nothing was due while the wheel was empty, resume at the current tick
+  const uint64_t now = MonoNs();
+  if (now > start_ns_ + tick_count_ * resolution_ns_) {
+    tick_count_ = (now - start_ns_) / resolution_ns_;
   }
 }
 
 void TimingWheel::TickFunc() {
-  Rate rate(TIMER_RESOLUTION_MS * 1000000);  // ms to ns
   while (running_) {
-    Tick();
-    // AINFO_EVERY(1000) << "Tick " << TickCount();
-    tick_count_++;
-    rate.Sleep();
-    {
-      std::lock_guard<std::mutex> lock(current_work_wheel_index_mutex_);
-      current_work_wheel_index_ =
-          GetWorkWheelIndex(current_work_wheel_index_ + 1);
+    if (task_count_ == 0 && pending_.load() == nullptr) {
+      WaitForTask();
+      continue;
     }
-    if (current_work_wheel_index_ == 0) {
-      {
-        std::lock_guard<std::mutex> lock(current_assistant_wheel_index_mutex_);
-        current_assistant_wheel_index_ =
-            GetAssistantWheelIndex(current_assistant_wheel_index_ + 1);
-      }
-      Cascade(current_assistant_wheel_index_);
+    // catch up on ticks missed while the thread was preempted instead of
+    // letting every timer slip
+    const uint64_t now = MonoNs();
+    while (running_ && start_ns_ + tick_count_ * resolution_ns_ <= now) {
+      Tick();
     }
+    SleepUntil(start_ns_ + tick_count_ * resolution_ns_);
   }
 }
 
-TimingWheel::TimingWheel() {}
+void TimingWheel::Clear() {
+  DrainPending();
+  for (auto& level : wheel_) {
+    for (auto& bucket : level) {
+      bucket.task_list().clear();
+    }
+  }
+  task_count_ = 0;
+}
 
 }  // namespace cyber
 }  // namespace apollo
@@ -17,15 +17,15 @@
 #ifndef CYBER_TIMER_TIMING_WHEEL_H_
 #define CYBER_TIMER_TIMING_WHEEL_H_
 
-#include <future>
-#include <list>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
 #include "cyber/scheduler/scheduler_factory.h"
-#include "cyber/time/rate.h"
 #include "cyber/timer/timer_bucket.h"
 
 namespace apollo {
@@ -33,12 +33,20 @@ namespace cyber {
 
 struct TimerTask;
 
-static const uint64_t WORK_WHEEL_SIZE = 512;
-static const uint64_t ASSISTANT_WHEEL_SIZE = 64;
-static const uint64_t TIMER_RESOLUTION_MS = 2;
-static const uint64_t TIMER_MAX_INTERVAL_MS =
-    WORK_WHEEL_SIZE * ASSISTANT_WHEEL_SIZE * TIMER_RESOLUTION_MS;
-
+// four levels of 64 slots, the same layout as the Linux timer wheel
+static const uint64_t TIMER_WHEEL_LEVELS = 4;
+static const uint64_t TIMER_WHEEL_BITS = 6;
+static const uint64_t TIMER_WHEEL_SIZE = 1ULL << TIMER_WHEEL_BITS;
+static const uint64_t TIMER_MIN_RESOLUTION_US = 100;
+static const uint64_t TIMER_MAX_RESOLUTION_US = 100000;
+
+/**
+ * @brief Hierarchical timing wheel driving cyber::Timer. It ticks every
+ * TimerConf.resolution_us on absolute CLOCK_MONOTONIC deadlines. Tasks are
+ * pushed on a lock-free stack and moved into the wheel by the tick thread,
+ * which is the only thread touching the buckets. The tick thread sleeps
+ * while the wheel holds no task, until AddTask wakes it.
+ */
 class TimingWheel {
  public:
   ~TimingWheel() {
@@ -51,36 +59,49 @@ class TimingWheel {
 
   void Shutdown();
 
-  void Tick();
-
+  /**
+   * @brief Fire `task` at its deadline_ns. Safe to call from any thread.
+   */
   void AddTask(const std::shared_ptr<TimerTask>& task);
 
-  void AddTask(const std::shared_ptr<TimerTask>& task,
-               const uint64_t current_work_wheel_index);
+  inline uint64_t TickCount() const { return tick_count_; }
 
-  void Cascade(const uint64_t assistant_wheel_index);
+  inline uint64_t ResolutionNs() const { return resolution_ns_; }
 
-  void TickFunc();
-
-  inline uint64_t TickCount() const { return tick_count_; }
+  /**
+   * @brief The longest timer period the wheel can hold at its resolution.
+   */
+  uint64_t MaxIntervalMs() const;
 
  private:
-  inline uint64_t GetWorkWheelIndex(const uint64_t index) {
-    return index & (WORK_WHEEL_SIZE - 1);
-  }
-  inline uint64_t GetAssistantWheelIndex(const uint64_t index) {
-    return index & (ASSISTANT_WHEEL_SIZE - 1);
-  }
+  struct PendingTask {
+    std::weak_ptr<TimerTask> task;
+    PendingTask* next;
+  };
 
-  bool running_ = false;
-  uint64_t tick_count_ = 0;
+  void TickFunc();
+  void Tick();
+  void WaitForTask();
+  void DrainPending();
+  void Place(const std::shared_ptr<TimerTask>& task);
+  bool Cascade(uint64_t level);
+  void Clear();
+  uint64_t DeadlineTick(uint64_t deadline_ns) const;
+
+  std::atomic<bool> running_ = {false};
   std::mutex running_mutex_;
-  TimerBucket work_wheel_[WORK_WHEEL_SIZE];
-  TimerBucket assistant_wheel_[ASSISTANT_WHEEL_SIZE];
-  uint64_t current_work_wheel_index_ = 0;
-  std::mutex current_work_wheel_index_mutex_;
-  uint64_t current_assistant_wheel_index_ = 0;
-  std::mutex current_assistant_wheel_index_mutex_;
+  uint64_t resolution_ns_ = 0;
+  // CLOCK_MONOTONIC time of tick 0
+  uint64_t start_ns_ = 0;
+  // next tick to process
+  std::atomic<uint64_t> tick_count_ = {0};
+  std::atomic<PendingTask*> pending_ = {nullptr};
+  TimerBucket wheel_[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SIZE];
+  // tasks in the buckets, only touched by the tick thread
+  uint64_t task_count_ = 0;
+  std::atomic<bool> idle_ = {false};
+  std::mutex idle_mutex_;
+  std::condition_variable idle_cv_;
   std::thread tick_thread_;
 
   DECLARE_SINGLETON(TimingWheel)
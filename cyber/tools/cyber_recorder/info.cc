@@ -95,9 +95,43 @@ bool Info::Display(const std::string& file) {
     return false;
   }
 
+  proto::Index idx = file_reader.GetIndex();
+
+  // compression
+  std::cout << std::setw(w) << "compress: ";
+  switch (hdr.compress()) {
+    case proto::CompressType::COMPRESS_BZ2:
+      std::cout << "bz2 (level " << hdr.compress_level() << ")";
+      break;
+    case proto::CompressType::COMPRESS_LZ4:
+      std::cout << "lz4 (level " << hdr.compress_level() << ")";
+      break;
+    default:
+      std::cout << "none";
+      break;
+  }
+  std::cout << std::endl;
+  uint64_t raw_size = 0;
+  uint64_t compressed_size = 0;
+  for (int i = 0; i < idx.indexes_size(); ++i) {
+    const auto& index = idx.indexes(i);
+    if (index.type() == proto::SectionType::SECTION_CHUNK_BODY &&
+        index.chunk_body_cache().has_compressed_size()) {
+      raw_size += index.chunk_body_cache().raw_size();
+      compressed_size += index.chunk_body_cache().compressed_size();
+    }
+  }
+  if (compressed_size > 0) {
+    std::cout << std::setw(w) << "compress_ratio: " << std::setprecision(2)
+              << static_cast<double>(raw_size) /
+                     static_cast<double>(compressed_size)
+              << " (" << static_cast<float>(raw_size) / kMB << " MB -> "
+              << static_cast<float>(compressed_size) / kMB << " MB)"
+              << std::endl;
+  }
+
   // channel info
   std::cout << std::setw(w) << "channel_info: " << std::endl;
-  proto::Index idx = file_reader.GetIndex();
   for (int i = 0; i < idx.indexes_size(); ++i) {
     ChannelCache* cache = idx.mutable_indexes(i)->mutable_channel_cache();
     if (idx.mutable_indexes(i)->type() == proto::SectionType::SECTION_CHANNEL) {
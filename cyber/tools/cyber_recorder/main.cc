@@ -33,6 +33,9 @@
 using apollo::cyber::common::GetFileName;
 using apollo::cyber::common::StringToUnixSeconds;
 using apollo::cyber::common::UnixSecondsToString;
+using apollo::cyber::proto::CompressType;
+using apollo::cyber::record::BackPressurePolicy;
+using apollo::cyber::record::FlushOptions;
 using apollo::cyber::record::HeaderBuilder;
 using apollo::cyber::record::Info;
 using apollo::cyber::record::Player;
@@ -42,7 +45,7 @@ using apollo::cyber::record::Recoverer;
 using apollo::cyber::record::Spliter;
 
 const char INFO_OPTIONS[] = "h";
-const char RECORD_OPTIONS[] = "o:ac:k:i:m:h";
+const char RECORD_OPTIONS[] = "o:ac:k:i:m:z:Z:q:x:K:DPh";
 const char PLAY_OPTIONS[] = "f:ac:k:lr:b:e:s:d:p:h";
 const char SPLIT_OPTIONS[] = "f:o:c:k:b:e:h";
 const char RECOVER_OPTIONS[] = "f:o:h";
@@ -145,6 +148,36 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-m, --segment-size <MB>\t\t\t" << command
                   << " segmented every n megabyte(s)" << std::endl;
         break;
+      case 'z':
+        std::cout << "\t-z, --compress <none|bz2|lz4>\t\t" << command
+                  << " with compressed chunks" << std::endl;
+        break;
+      case 'Z':
+        std::cout << "\t-Z, --compress-level <level>\t\t" << command
+                  << " with the codec level, 0 for default" << std::endl;
+        break;
+      case 'q':
+        std::cout << "\t-q, --chunk-buffers <4>\t\t\t" << command
+                  << " with n chunk buffers queued for the disk" << std::endl;
+        break;
+      case 'x':
+        std::cout << "\t-x, --back-pressure <block|drop|spill>\t" << command
+                  << " policy when every chunk buffer is queued" << std::endl;
+        break;
+      case 'K':
+        std::cout << "\t-K, --keep-channel <name>\t\tnever drop the"
+                  << " specified channel under -x drop" << std::endl;
+        break;
+      case 'D':
+        std::cout << "\t-D, --drop-page-cache\t\t\t" << command
+                  << " dropping written chunks from the page cache"
+                  << std::endl;
+        break;
+      case 'P':
+        std::cout << "\t-P, --preallocate\t\t\t" << command
+                  << " reserving the segment size of each file on disk"
+                  << std::endl;
+        break;
       case 'h':
         std::cout << "\t-h, --help\t\t\t\tshow help message" << std::endl;
         break;
@@ -170,7 +203,7 @@ int main(int argc, char** argv) {
   }
 
   int long_index = 0;
-  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:h";
+  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:z:Z:q:x:K:DPh";
   static const struct option long_opts[] = {
       {"files", required_argument, nullptr, 'f'},
       {"white-channel", required_argument, nullptr, 'c'},
@@ -186,6 +219,13 @@ int main(int argc, char** argv) {
       {"preload", required_argument, nullptr, 'p'},
       {"segment-interval", required_argument, nullptr, 'i'},
       {"segment-size", required_argument, nullptr, 'm'},
+      {"compress", required_argument, nullptr, 'z'},
+      {"compress-level", required_argument, nullptr, 'Z'},
+      {"chunk-buffers", required_argument, nullptr, 'q'},
+      {"back-pressure", required_argument, nullptr, 'x'},
+      {"keep-channel", required_argument, nullptr, 'K'},
+      {"drop-page-cache", no_argument, nullptr, 'D'},
+      {"preallocate", no_argument, nullptr, 'P'},
       {"help", no_argument, nullptr, 'h'}};
 
   std::vector<std::string> opt_file_vec;
@@ -201,6 +241,8 @@ int main(int argc, char** argv) {
   uint64_t opt_delay = 0;
   uint32_t opt_preload = 3;
   auto opt_header = HeaderBuilder::GetHeader();
+  FlushOptions opt_flush;
+  bool opt_preallocate = false;
 
   do {
     int opt =
@@ -346,6 +388,78 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'z': {
+        const std::string compress(optarg);
+        if (compress == "none") {
+          opt_header.set_compress(CompressType::COMPRESS_NONE);
+        } else if (compress == "bz2") {
+          opt_header.set_compress(CompressType::COMPRESS_BZ2);
+        } else if (compress == "lz4") {
+          opt_header.set_compress(CompressType::COMPRESS_LZ4);
+        } else {
+          std::cout << "Invalid argument: -z/--compress " << compress
+                    << std::endl;
+          return -1;
+        }
+        break;
+      }
+      case 'Z':
+        try {
+          opt_header.set_compress_level(std::stoi(optarg));
+        } catch (std::invalid_argument& ia) {
+          std::cout << "Invalid argument: -Z/--compress-level "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        } catch (const std::out_of_range& e) {
+          std::cout << "Argument is out of range: -Z/--compress-level "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        break;
+      case 'q':
+        try {
+          opt_flush.chunk_buffer_num = std::stoi(optarg);
+        } catch (std::invalid_argument& ia) {
+          std::cout << "Invalid argument: -q/--chunk-buffers "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        } catch (const std::out_of_range& e) {
+          std::cout << "Argument is out of range: -q/--chunk-buffers "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        break;
+      case 'x': {
+        const std::string policy(optarg);
+        if (policy == "block") {
+          opt_flush.policy = BackPressurePolicy::BLOCK;
+        } else if (policy == "drop") {
+          opt_flush.policy = BackPressurePolicy::DROP;
+        } else if (policy == "spill") {
+          opt_flush.policy = BackPressurePolicy::SPILL;
+        } else {
+          std::cout << "Invalid argument: -x/--back-pressure " << policy
+                    << std::endl;
+          return -1;
+        }
+        break;
+      }
+      case 'K':
+        opt_flush.channel_priority[optarg] = opt_flush.drop_priority;
+        for (int i = optind; i < argc; i++) {
+          if (*argv[i] != '-') {
+            opt_flush.channel_priority[argv[i]] = opt_flush.drop_priority;
+          } else {
+            break;
+          }
+        }
+        break;
+      case 'D':
+        opt_flush.drop_written_pages = true;
+        break;
+      case 'P':
+        opt_preallocate = true;
+        break;
       case 'h':
         DisplayUsage(binary, command);
         return 0;
@@ -426,6 +540,10 @@ int main(int argc, char** argv) {
     auto recorder = std::make_shared<Recorder>(opt_output_vec[0], opt_all,
                                                opt_white_channels,
                                                opt_black_channels, opt_header);
+    if (opt_preallocate) {
+      opt_flush.preallocate_size = opt_header.segment_raw_size();
+    }
+    recorder->SetFlushOptions(opt_flush);
     bool record_result = recorder->Start();
     if (record_result) {
       while (!::apollo::cyber::IsShutdown()) {
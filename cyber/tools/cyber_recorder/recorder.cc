@@ -79,6 +79,7 @@ bool Recorder::Start() {
   get_patterns_func(black_channels_, &black_channel_patterns_);
 
   writer_.reset(new RecordWriter(header_));
+  writer_->SetFlushOptions(flush_options_);
   if (!writer_->Open(output_)) {
     AERROR << "Datafile open file error.";
     return false;
@@ -115,6 +116,13 @@ bool Recorder::Stop() {
     return false;
   }
   writer_->Close();
+  const auto stats = writer_->GetFlushStats();
+  AINFO << "Flushed " << stats.written_chunks << " chunks, max queue depth "
+        << stats.max_queued_chunks << ", max write latency "
+        << stats.max_write_latency_ns / 1000000 << " ms, blocked "
+        << stats.blocked_writes << " times, dropped "
+        << stats.dropped_messages << " messages, spilled "
+        << stats.spilled_chunks << " chunks.";
   node_.reset();
   if (display_thread_ && display_thread_->joinable()) {
     display_thread_->join();
@@ -58,6 +58,9 @@ class Recorder : public std::enable_shared_from_this<Recorder> {
   ~Recorder();
   bool Start();
   bool Stop();
+  void SetFlushOptions(const FlushOptions& options) {
+    flush_options_ = options;
+  }
 
  private:
   bool is_started_ = false;
@@ -73,6 +76,7 @@ class Recorder : public std::enable_shared_from_this<Recorder> {
   std::vector<std::string> black_channels_;
   std::vector<std::regex> black_channel_patterns_;
   proto::Header header_;
+  FlushOptions flush_options_;
   std::unordered_map<std::string, std::shared_ptr<ReaderBase>>
       channel_reader_map_;
   uint64_t message_count_;
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/benchmark/benchmark_env.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <sstream>
+
+#include "cyber/proto/cyber_conf.pb.h"
+
+#include "cyber/common/environment.h"
+#include "cyber/common/file.h"
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using common::GetAbsolutePath;
+using common::GetProtoFromFile;
+using common::GlobalData;
+using common::SetProtoToASCIIFile;
+using common::WorkRoot;
+
+std::string SetUpWorkRoot(const BenchmarkConf& conf,
+                          const std::string& process_group) {
+  proto::CyberConfig cyber_conf;
+  const auto base_conf = GetAbsolutePath(WorkRoot(), "conf/cyber.pb.conf");
+  if (!GetProtoFromFile(base_conf, &cyber_conf)) {
+    AWARN << "no cyber conf at " << base_conf << ", starting from defaults";
+  }
+  auto transport_conf = cyber_conf.mutable_transport_conf();
+  transport_conf->mutable_shm_conf()->set_notifier_type(conf.notifier_type);
+  transport_conf->mutable_communication_mode()->set_same_proc(conf.same_proc);
+  transport_conf->mutable_rtps_conf()->MergeFrom(conf.rtps_conf);
+
+  proto::CyberConfig sched_conf;
+  sched_conf.mutable_scheduler_conf()->set_policy(conf.policy);
+
+  char dir[] = "/tmp/cyber_benchmark_XXXXXX";
+  if (mkdtemp(dir) == nullptr) {
+    AERROR << "failed to create a temporary work root";
+    return "";
+  }
+  const std::string work_root(dir);
+  if (!common::CreateDir(work_root + "/conf") ||
+      !SetProtoToASCIIFile(cyber_conf, work_root + "/conf/cyber.pb.conf") ||
+      !SetProtoToASCIIFile(
+          sched_conf, work_root + "/conf/" + process_group + ".conf")) {
+    AERROR << "failed to write the benchmark conf to " << work_root;
+    common::DeleteFile(work_root);
+    return "";
+  }
+
+  setenv("CYBER_PATH", work_root.c_str(), 1);
+  auto global_data = GlobalData::Instance();
+  if (global_data->Config().transport_conf().shm_conf().notifier_type() !=
+      conf.notifier_type) {
+    AERROR << "cyber conf was read before the benchmark conf was written";
+    common::DeleteFile(work_root);
+    return "";
+  }
+  global_data->SetProcessGroup(process_group);
+  return work_root;
+}
+
+uint64_t MonoTimeNs() { return Time::MonoTime().ToNanosecond(); }
+
+uint64_t ProcessCpuNs() {
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+MessagePool::MessagePool(size_t payload_size, size_t capacity)
+    : payload_(payload_size, 'x'), messages_(capacity) {}
+
+std::shared_ptr<proto::Chatter> MessagePool::Next() {
+  for (size_t i = 0; i < messages_.size(); ++i) {
+    auto& msg = messages_[next_];
+    next_ = (next_ + 1) % messages_.size();
+    if (msg == nullptr) {
+      msg = std::make_shared<proto::Chatter>();
+      msg->set_content(payload_);
+    }
+    if (msg.use_count() == 1) {
+      return msg;
+    }
+  }
+  // everything is still held by readers or queues
+  auto msg = std::make_shared<proto::Chatter>();
+  msg->set_content(payload_);
+  return msg;
+}
+
+void LatencyRecorder::Reset() {
+  profiler::HistogramSnapshot discarded;
+  histogram_.Drain(&discarded);
+}
+
+std::vector<std::string> SplitList(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.emplace_back(item);
+    }
+  }
+  return items;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_BENCHMARK_BENCHMARK_ENV_H_
+#define CYBER_TRANSPORT_BENCHMARK_BENCHMARK_ENV_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cyber/proto/transport_conf.pb.h"
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/profiler/latency_histogram.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @brief The settings the benchmarks sweep that cyber reads once per
+ * process from its configuration files.
+ */
+struct BenchmarkConf {
+  // shm notifier, "condition" or "multicast"
+  std::string notifier_type = "condition";
+  // scheduler policy, "classic" or "choreography"
+  std::string policy = "classic";
+  // transport between the writers and readers of the process
+  proto::OptionalMode same_proc = proto::OptionalMode::INTRA;
+  // batching, fragment size and flow control of rtps
+  proto::RtpsConf rtps_conf;
+};
+
+/**
+ * @brief Write conf/cyber.pb.conf, based on the one of the current work root,
+ * and conf/<process_group>.conf with `conf` applied into a new temporary
+ * work root, point CYBER_PATH at it and set the process group. Has to run
+ * before anything reads the configuration, i.e. before cyber::Init.
+ *
+ * @return The new work root, to be removed with common::DeleteFile once
+ * done, or an empty string on failure.
+ */
+std::string SetUpWorkRoot(const BenchmarkConf& conf,
+                          const std::string& process_group);
+
+uint64_t MonoTimeNs();
+
+// CPU time used by all threads of the process so far
+uint64_t ProcessCpuNs();
+
+/**
+ * @brief Messages carrying a payload of a given size, reused once nothing
+ * but the pool refers to them any more, so that publishing does not pay for
+ * building the payload every time.
+ */
+class MessagePool {
+ public:
+  MessagePool(size_t payload_size, size_t capacity);
+
+  std::shared_ptr<proto::Chatter> Next();
+
+ private:
+  std::string payload_;
+  std::vector<std::shared_ptr<proto::Chatter>> messages_;
+  size_t next_ = 0;
+};
+
+/**
+ * @brief Delivery latencies, taken as the time a reader sees a message
+ * minus the timestamp its writer put into it.
+ */
+class LatencyRecorder {
+ public:
+  void OnMessage(const proto::Chatter& msg) {
+    histogram_.Record(MonoTimeNs() - msg.timestamp());
+  }
+
+  // forget everything recorded so far, e.g. during warm up
+  void Reset();
+
+  void Snapshot(profiler::HistogramSnapshot* snapshot) const {
+    histogram_.Snapshot(snapshot);
+  }
+
+ private:
+  profiler::LatencyHistogram histogram_;
+};
+
+std::vector<std::string> SplitList(const std::string& list);
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_BENCHMARK_BENCHMARK_ENV_H_
@@ -0,0 +1,429 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Publishes through a node writer to node readers, the way components do,
+// and sweeps the transport, shm notifier, scheduler policy, payload size,
+// publish rate and number of readers:
+//
+//   bazel run -c opt //cyber/transport/benchmark:pubsub_stress -- \
+//       --transports=intra,shm --sizes=1024,1048576 --rates=100,0
+//
+// A rate of 0 publishes as fast as the writer can. The transport, notifier
+// and policy are read once per process, so every combination of them runs
+// in a process of its own. Every case prints one line with the messages
+// published and delivered, the p50/p99/p99.9/max delivery latency in us and
+// the CPU time of the whole process per published message; cases always
+// come in the same order, so two runs can be diffed. Readers keep only the
+// newest message by default, so at high rates `lost` counts the messages
+// that were overwritten before their reader ran.
+
+#include <getopt.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/common/file.h"
+#include "cyber/cyber.h"
+#include "cyber/init.h"
+#include "cyber/transport/benchmark/benchmark_env.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+using proto::Chatter;
+
+struct StressArgs {
+  std::string transports = "intra,shm,rtps";
+  std::string notifiers = "condition,multicast";
+  std::string policies = "classic,choreography";
+  std::string sizes = "64,4096,65536,1048576";
+  std::string rates = "100,1000,0";
+  std::string subscribers = "1,4,8";
+  int duration_ms = 2000;
+  bool csv = false;
+  // runs exactly one transport, notifier and policy
+  bool child = false;
+};
+
+struct CaseResult {
+  uint64_t sent = 0;
+  uint64_t delivered = 0;
+  uint64_t elapsed_ns = 0;
+  uint64_t cpu_ns = 0;
+  profiler::HistogramSnapshot latency;
+};
+
+constexpr int kArgCsv = 1000;
+constexpr int kArgChild = 1001;
+
+void DisplayUsage(const char* binary) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --transports=intra,shm,rtps   same process transport\n"
+          "  --notifiers=condition,multicast\n"
+          "  --policies=classic,choreography\n"
+          "  --sizes=64,4096,65536,1048576 payload bytes\n"
+          "  --rates=100,1000,0            messages per second, 0 for max\n"
+          "  --subscribers=1,4,8           readers per channel\n"
+          "  --duration_ms=2000            per case\n"
+          "  --csv                         comma separated output\n",
+          binary);
+}
+
+bool ParseArgs(int argc, char** argv, StressArgs* args) {
+  static const struct option long_opts[] = {
+      {"help", no_argument, nullptr, 'h'},
+      {"transports", required_argument, nullptr, 't'},
+      {"notifiers", required_argument, nullptr, 'n'},
+      {"policies", required_argument, nullptr, 'p'},
+      {"sizes", required_argument, nullptr, 's'},
+      {"rates", required_argument, nullptr, 'r'},
+      {"subscribers", required_argument, nullptr, 'c'},
+      {"duration_ms", required_argument, nullptr, 'd'},
+      {"csv", no_argument, nullptr, kArgCsv},
+      {"child", no_argument, nullptr, kArgChild},
+      {nullptr, no_argument, nullptr, 0}};
+  while (true) {
+    int opt = getopt_long(argc, argv, "h", long_opts, nullptr);
+    if (opt == -1) {
+      break;
+    }
+    switch (opt) {
+      case 't':
+        args->transports = optarg;
+        break;
+      case 'n':
+        args->notifiers = optarg;
+        break;
+      case 'p':
+        args->policies = optarg;
+        break;
+      case 's':
+        args->sizes = optarg;
+        break;
+      case 'r':
+        args->rates = optarg;
+        break;
+      case 'c':
+        args->subscribers = optarg;
+        break;
+      case 'd':
+        args->duration_ms = std::atoi(optarg);
+        break;
+      case kArgCsv:
+        args->csv = true;
+        break;
+      case kArgChild:
+        args->child = true;
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+bool ParseMode(const std::string& transport, proto::OptionalMode* mode) {
+  if (transport == "intra") {
+    *mode = proto::OptionalMode::INTRA;
+  } else if (transport == "shm") {
+    *mode = proto::OptionalMode::SHM;
+  } else if (transport == "rtps") {
+    *mode = proto::OptionalMode::RTPS;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void PrintHeader(bool csv) {
+  if (csv) {
+    printf(
+        "transport,notifier,policy,size,rate,subscribers,sent,delivered,"
+        "lost,publish_hz,p50_us,p99_us,p999_us,max_us,cpu_us_per_msg\n");
+  } else {
+    printf("%-9s %-9s %-12s %8s %5s %4s %8s %9s %8s %9s %9s %9s %9s %9s %9s\n",
+           "transport", "notifier", "policy", "size", "rate", "subs", "sent",
+           "delivered", "lost", "pub_hz", "p50_us", "p99_us", "p999_us",
+           "max_us", "cpu_us");
+  }
+  fflush(stdout);
+}
+
+void PrintResult(const StressArgs& args, int64_t size, int64_t rate,
+                 int64_t subscribers, const CaseResult& result) {
+  const std::string notifier = args.transports == "shm" ? args.notifiers : "-";
+  const std::string rate_name = rate == 0 ? "max" : std::to_string(rate);
+  const uint64_t expected = result.sent * subscribers;
+  const uint64_t lost =
+      expected > result.delivered ? expected - result.delivered : 0;
+  auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+  const double publish_hz =
+      result.elapsed_ns == 0 ? 0.0 : result.sent * 1e9 / result.elapsed_ns;
+  const double cpu_us =
+      result.sent == 0 ? 0.0 : us(result.cpu_ns) / result.sent;
+  if (args.csv) {
+    printf("%s,%s,%s,%" PRId64 ",%s,%" PRId64 ",%" PRIu64 ",%" PRIu64
+           ",%" PRIu64 ",%.0f,%.1f,%.1f,%.1f,%.1f,%.2f\n",
+           args.transports.c_str(), notifier.c_str(), args.policies.c_str(),
+           size, rate_name.c_str(), subscribers, result.sent,
+           result.delivered, lost, publish_hz,
+           us(result.latency.ValueAtPercentile(50.0)),
+           us(result.latency.ValueAtPercentile(99.0)),
+           us(result.latency.ValueAtPercentile(99.9)),
+           us(result.latency.max), cpu_us);
+  } else {
+    printf("%-9s %-9s %-12s %8" PRId64 " %5s %4" PRId64 " %8" PRIu64
+           " %9" PRIu64 " %8" PRIu64 " %9.0f %9.1f %9.1f %9.1f %9.1f %9.2f\n",
+           args.transports.c_str(), notifier.c_str(), args.policies.c_str(),
+           size, rate_name.c_str(), subscribers, result.sent,
+           result.delivered, lost, publish_hz,
+           us(result.latency.ValueAtPercentile(50.0)),
+           us(result.latency.ValueAtPercentile(99.0)),
+           us(result.latency.ValueAtPercentile(99.9)),
+           us(result.latency.max), cpu_us);
+  }
+  fflush(stdout);
+}
+
+bool RunCase(int64_t size, int64_t rate, int64_t subscribers,
+             int duration_ms, CaseResult* result) {
+  static int case_id = 0;
+  const std::string id = std::to_string(++case_id);
+  const std::string channel = "/pubsub_stress/" + std::to_string(size) + "/" +
+                              std::to_string(rate) + "/" +
+                              std::to_string(subscribers);
+
+  LatencyRecorder latencies;
+  std::vector<std::atomic<uint64_t>> received(subscribers);
+  for (auto& count : received) {
+    count = 0;
+  }
+  auto writer_node = CreateNode("pubsub_stress_writer_" + id);
+  std::vector<std::unique_ptr<Node>> reader_nodes;
+  for (int64_t i = 0; i < subscribers; ++i) {
+    reader_nodes.emplace_back(
+        CreateNode("pubsub_stress_reader_" + id + "_" + std::to_string(i)));
+    auto* count = &received[i];
+    auto reader = reader_nodes.back()->CreateReader<Chatter>(
+        channel, [&latencies, count](const std::shared_ptr<Chatter>& msg) {
+          latencies.OnMessage(*msg);
+          count->fetch_add(1, std::memory_order_relaxed);
+        });
+    if (reader == nullptr) {
+      return false;
+    }
+  }
+  auto writer = writer_node->CreateWriter<Chatter>(channel);
+  if (writer == nullptr) {
+    return false;
+  }
+  MessagePool pool(size, 64);
+  uint64_t seq = 0;
+  auto publish = [&]() {
+    auto msg = pool.Next();
+    msg->set_seq(++seq);
+    msg->set_timestamp(MonoTimeNs());
+    writer->Write(msg);
+  };
+  auto delivered = [&received]() {
+    uint64_t total = 0;
+    for (auto& count : received) {
+      total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+  };
+
+  // until every reader is discovered and got a message
+  bool ready = false;
+  for (int i = 0; i < 500 && !ready; ++i) {
+    publish();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ready = true;
+    for (auto& count : received) {
+      ready = ready && count.load() > 0;
+    }
+  }
+  if (!ready) {
+    AERROR << "readers of " << channel << " never got a message";
+    return false;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (auto& count : received) {
+    count = 0;
+  }
+  latencies.Reset();
+
+  const uint64_t period_ns = rate > 0 ? 1000000000ULL / rate : 0;
+  const uint64_t duration_ns = duration_ms * 1000000ULL;
+  const uint64_t cpu_begin = ProcessCpuNs();
+  const uint64_t begin = MonoTimeNs();
+  uint64_t next = begin;
+  while (true) {
+    const uint64_t now = MonoTimeNs();
+    if (now - begin >= duration_ns) {
+      break;
+    }
+    if (period_ns != 0) {
+      if (now < next) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(next - now));
+      }
+      next += period_ns;
+    }
+    publish();
+    ++result->sent;
+  }
+  result->elapsed_ns = MonoTimeNs() - begin;
+  // let the readers catch up with the last messages
+  const uint64_t expected = result->sent * subscribers;
+  for (int i = 0; i < 1000 && delivered() < expected; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  result->cpu_ns = ProcessCpuNs() - cpu_begin;
+  result->delivered = delivered();
+  latencies.Snapshot(&result->latency);
+  return true;
+}
+
+int RunChild(const StressArgs& args, const char* binary) {
+  BenchmarkConf conf;
+  conf.notifier_type = args.notifiers;
+  conf.policy = args.policies;
+  if (!ParseMode(args.transports, &conf.same_proc)) {
+    AERROR << "unknown transport " << args.transports;
+    return 1;
+  }
+  const std::string work_root = SetUpWorkRoot(conf, "pubsub_stress");
+  if (work_root.empty()) {
+    return 1;
+  }
+  Init(binary);
+
+  int result = 0;
+  for (const auto& size : SplitList(args.sizes)) {
+    for (const auto& subscribers : SplitList(args.subscribers)) {
+      for (const auto& rate : SplitList(args.rates)) {
+        CaseResult case_result;
+        if (!RunCase(std::stoll(size), std::stoll(rate),
+                     std::stoll(subscribers), args.duration_ms,
+                     &case_result)) {
+          result = 1;
+          continue;
+        }
+        PrintResult(args, std::stoll(size), std::stoll(rate),
+                    std::stoll(subscribers), case_result);
+      }
+    }
+  }
+  Clear();
+  common::DeleteFile(work_root);
+  return result;
+}
+
+// Runs this binary again with --child for one combination.
+bool RunProcess(const StressArgs& args, const std::string& transport,
+                const std::string& notifier, const std::string& policy) {
+  std::vector<std::string> argv_strings = {
+      "pubsub_stress",
+      "--child",
+      "--transports=" + transport,
+      "--notifiers=" + notifier,
+      "--policies=" + policy,
+      "--sizes=" + args.sizes,
+      "--rates=" + args.rates,
+      "--subscribers=" + args.subscribers,
+      "--duration_ms=" + std::to_string(args.duration_ms)};
+  if (args.csv) {
+    argv_strings.emplace_back("--csv");
+  }
+  std::vector<char*> child_argv;
+  for (auto& arg : argv_strings) {
+    child_argv.push_back(&arg[0]);
+  }
+  child_argv.push_back(nullptr);
+
+  const pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    execv("/proc/self/exe", child_argv.data());
+    _exit(127);
+  }
+  int status = 0;
+  if (waitpid(pid, &status, 0) != pid) {
+    return false;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+}  // namespace
+
+int StressMain(int argc, char** argv) {
+  StressArgs args;
+  if (!ParseArgs(argc, argv, &args)) {
+    DisplayUsage(argv[0]);
+    return 1;
+  }
+  if (args.child) {
+    return RunChild(args, argv[0]);
+  }
+
+  PrintHeader(args.csv);
+  const auto notifiers = SplitList(args.notifiers);
+  int result = 0;
+  for (const auto& transport : SplitList(args.transports)) {
+    proto::OptionalMode mode;
+    if (!ParseMode(transport, &mode)) {
+      fprintf(stderr, "unknown transport %s\n", transport.c_str());
+      return 1;
+    }
+    // the notifier only matters to shm
+    const size_t notifier_num = transport == "shm" ? notifiers.size() : 1;
+    for (size_t i = 0; i < notifier_num && i < notifiers.size(); ++i) {
+      for (const auto& policy : SplitList(args.policies)) {
+        if (!RunProcess(args, transport, notifiers[i], policy)) {
+          fprintf(stderr, "%s/%s/%s failed\n", transport.c_str(),
+                  notifiers[i].c_str(), policy.c_str());
+          result = 1;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  return apollo::cyber::transport::StressMain(argc, argv);
+}
@@ -0,0 +1,364 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Latency and throughput of every transmitter/receiver pair within one
+// process, for payloads from 64 B to 4 MB and 1 to 8 receivers per channel.
+// The shm notifier and the rtps settings are read once per process, so run
+// the suite once per notifier or rtps setting, e.g. to compare batching
+// small messages and larger fragments with the defaults:
+//
+//   bazel run -c opt //cyber/transport/benchmark:transport_benchmark -- \
+//       --notifier=multicast --benchmark_format=json
+//   bazel run -c opt //cyber/transport/benchmark:transport_benchmark -- \
+//       --benchmark_filter=rtps --rtps_batch_window_us=200 \
+//       --rtps_fragment_size=65500 --rtps_socket_buffer_size=8388608
+//
+// Each case reports the p50/p99/p99.9 delivery latency in us and the CPU
+// time of the whole process per published message. The hybrid cases let
+// every second receiver claim another process id, so that the hybrid
+// transmitter fans out over INTRA and SHM at once. The multicast notifier
+// needs a multicast route, e.g. on a host without network
+//   ip route add 239.255.0.0/16 dev lo
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/global_data.h"
+#include "cyber/common/util.h"
+#include "cyber/init.h"
+#include "cyber/transport/benchmark/benchmark_env.h"
+#include "cyber/transport/qos/qos_profile_conf.h"
+#include "cyber/transport/transport.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+using proto::Chatter;
+using proto::OptionalMode;
+
+// messages in flight per receiver in the throughput cases, well below the
+// number of blocks of a shm segment
+constexpr uint64_t kWindow = 8;
+constexpr auto kTimeout = std::chrono::seconds(2);
+
+std::string ModeName(OptionalMode mode) {
+  switch (mode) {
+    case OptionalMode::INTRA:
+      return "intra";
+    case OptionalMode::SHM:
+      return "shm";
+    case OptionalMode::RTPS:
+      return "rtps";
+    default:
+      return "hybrid";
+  }
+}
+
+/**
+ * @brief One transmitter and its receivers on a channel of their own.
+ */
+class Channel {
+ public:
+  Channel(OptionalMode mode, const std::string& name, int receivers)
+      : mode_(mode) {
+    auto global_data = common::GlobalData::Instance();
+    RoleAttributes attr;
+    attr.set_host_name(global_data->HostName());
+    attr.set_host_ip(global_data->HostIp());
+    attr.set_process_id(global_data->ProcessId());
+    attr.set_channel_name(name);
+    attr.set_channel_id(common::Hash(name));
+    attr.mutable_qos_profile()->CopyFrom(QosProfileConf::QOS_PROFILE_DEFAULT);
+    transmitter_ =
+        Transport::Instance()->CreateTransmitter<Chatter>(attr, mode);
+
+    auto listener = [this](const std::shared_ptr<Chatter>& msg,
+                           const MessageInfo&, const RoleAttributes&) {
+      latencies_.OnMessage(*msg);
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++received_;
+      cv_.notify_all();
+    };
+    for (int i = 0; i < receivers; ++i) {
+      if (mode == OptionalMode::HYBRID && i % 2 == 1) {
+        attr.set_process_id(global_data->ProcessId() + 1);
+      } else {
+        attr.set_process_id(global_data->ProcessId());
+      }
+      receivers_.emplace_back(
+          Transport::Instance()->CreateReceiver<Chatter>(attr, listener,
+                                                         mode));
+    }
+    if (mode == OptionalMode::HYBRID) {
+      for (auto& receiver : receivers_) {
+        transmitter_->Enable(receiver->attributes());
+        receiver->Enable(transmitter_->attributes());
+      }
+    }
+  }
+
+  ~Channel() {
+    if (mode_ == OptionalMode::HYBRID) {
+      for (auto& receiver : receivers_) {
+        transmitter_->Disable(receiver->attributes());
+        receiver->Disable(transmitter_->attributes());
+      }
+    }
+  }
+
+  uint64_t receivers() const { return receivers_.size(); }
+
+  /**
+   * @brief Publish until every receiver got a message, for the transports
+   * that need to discover each other first, then start over.
+   */
+  bool WarmUp(MessagePool* pool) {
+    const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+      Publish(pool);
+      if (WaitFor(receivers(), std::chrono::milliseconds(10))) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lock(mutex_);
+        received_ = 0;
+        latencies_.Reset();
+        return true;
+      }
+      // a receiver may have got several while others got none yet
+      std::lock_guard<std::mutex> lock(mutex_);
+      received_ = 0;
+    }
+    return false;
+  }
+
+  bool Publish(MessagePool* pool) {
+    auto msg = pool->Next();
+    msg->set_seq(++seq_);
+    msg->set_timestamp(MonoTimeNs());
+    return transmitter_->Transmit(msg);
+  }
+
+  template <typename Duration>
+  bool WaitFor(uint64_t received, Duration timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout,
+                        [this, received]() { return received_ >= received; });
+  }
+
+  uint64_t received() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return received_;
+  }
+
+  const LatencyRecorder& latencies() const { return latencies_; }
+
+ private:
+  OptionalMode mode_;
+  std::shared_ptr<Transmitter<Chatter>> transmitter_;
+  std::vector<std::shared_ptr<Receiver<Chatter>>> receivers_;
+  uint64_t seq_ = 0;
+
+  LatencyRecorder latencies_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t received_ = 0;
+};
+
+std::string Label(OptionalMode mode) {
+  const auto& transport_conf =
+      common::GlobalData::Instance()->Config().transport_conf();
+  std::string label = ModeName(mode);
+  if (mode == OptionalMode::SHM || mode == OptionalMode::HYBRID) {
+    label += "/" + transport_conf.shm_conf().notifier_type();
+  }
+  const auto& rtps_conf = transport_conf.rtps_conf();
+  if (mode == OptionalMode::RTPS && rtps_conf.batch_window_us() > 0) {
+    label += "/batch_" + std::to_string(rtps_conf.batch_window_us()) + "us";
+  }
+  if (mode == OptionalMode::RTPS && rtps_conf.fragment_size() > 0) {
+    label += "/fragment_" + std::to_string(rtps_conf.fragment_size());
+  }
+  return label;
+}
+
+void SetCounters(const Channel& channel, OptionalMode mode, uint64_t cpu_ns,
+                 benchmark::State* state) {
+  profiler::HistogramSnapshot snapshot;
+  channel.latencies().Snapshot(&snapshot);
+  auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+  state->counters["p50_us"] = us(snapshot.ValueAtPercentile(50.0));
+  state->counters["p99_us"] = us(snapshot.ValueAtPercentile(99.0));
+  state->counters["p999_us"] = us(snapshot.ValueAtPercentile(99.9));
+  state->counters["cpu_us_per_msg"] =
+      state->iterations() == 0
+          ? 0.0
+          : us(cpu_ns) / static_cast<double>(state->iterations());
+  state->SetItemsProcessed(state->iterations());
+  state->SetBytesProcessed(state->iterations() * state->range(0));
+  state->SetLabel(Label(mode));
+}
+
+}  // namespace
+
+// One message at a time: publish, then wait until every receiver has it.
+static void BM_Latency(benchmark::State& state, OptionalMode mode) {
+  const auto size = state.range(0);
+  const auto receivers = static_cast<int>(state.range(1));
+  Channel channel(mode,
+                  "/benchmark/latency/" + ModeName(mode) + "/" +
+                      std::to_string(size) + "/" + std::to_string(receivers),
+                  receivers);
+  MessagePool pool(size, 2 * kWindow);
+  if (!channel.WarmUp(&pool)) {
+    state.SkipWithError("receivers never got a message");
+    return;
+  }
+
+  uint64_t expected = 0;
+  const uint64_t cpu_begin = ProcessCpuNs();
+  for (auto _ : state) {
+    expected += channel.receivers();
+    if (!channel.Publish(&pool) || !channel.WaitFor(expected, kTimeout)) {
+      state.SkipWithError("message lost");
+      break;
+    }
+  }
+  SetCounters(channel, mode, ProcessCpuNs() - cpu_begin, &state);
+}
+
+// Back to back, with at most kWindow messages in flight per receiver.
+static void BM_Throughput(benchmark::State& state, OptionalMode mode) {
+  const auto size = state.range(0);
+  const auto receivers = static_cast<int>(state.range(1));
+  Channel channel(mode,
+                  "/benchmark/throughput/" + ModeName(mode) + "/" +
+                      std::to_string(size) + "/" + std::to_string(receivers),
+                  receivers);
+  MessagePool pool(size, 2 * kWindow);
+  if (!channel.WarmUp(&pool)) {
+    state.SkipWithError("receivers never got a message");
+    return;
+  }
+
+  uint64_t published = 0;
+  const uint64_t cpu_begin = ProcessCpuNs();
+  for (auto _ : state) {
+    if (published >= kWindow) {
+      // a receiver that misses a message stalls the window until kTimeout
+      channel.WaitFor((published - kWindow) * channel.receivers(), kTimeout);
+    }
+    channel.Publish(&pool);
+    ++published;
+  }
+  channel.WaitFor(published * channel.receivers(), kTimeout);
+  const uint64_t cpu_ns = ProcessCpuNs() - cpu_begin;
+  state.counters["lost"] = static_cast<double>(
+      published * channel.receivers() - channel.received());
+  SetCounters(channel, mode, cpu_ns, &state);
+}
+
+static void Arguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"size", "receivers"});
+  for (int64_t size : {64, 1 << 10, 16 << 10, 256 << 10, 1 << 20, 4 << 20}) {
+    for (int64_t receivers : {1, 4, 8}) {
+      b->Args({size, receivers});
+    }
+  }
+  b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK_CAPTURE(BM_Latency, intra, OptionalMode::INTRA)->Apply(Arguments);
+BENCHMARK_CAPTURE(BM_Latency, shm, OptionalMode::SHM)->Apply(Arguments);
+BENCHMARK_CAPTURE(BM_Latency, rtps, OptionalMode::RTPS)->Apply(Arguments);
+BENCHMARK_CAPTURE(BM_Latency, hybrid, OptionalMode::HYBRID)->Apply(Arguments);
+BENCHMARK_CAPTURE(BM_Throughput, intra, OptionalMode::INTRA)
+    ->Apply(Arguments);
+BENCHMARK_CAPTURE(BM_Throughput, shm, OptionalMode::SHM)->Apply(Arguments);
+BENCHMARK_CAPTURE(BM_Throughput, rtps, OptionalMode::RTPS)->Apply(Arguments);
+BENCHMARK_CAPTURE(BM_Throughput, hybrid, OptionalMode::HYBRID)
+    ->Apply(Arguments);
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  apollo::cyber::transport::BenchmarkConf conf;
+  auto* rtps_conf = &conf.rtps_conf;
+  const std::vector<
+      std::pair<std::string, std::function<void(const std::string&)>>>
+      flags = {
+          {"--notifier=",
+           [&conf](const std::string& value) { conf.notifier_type = value; }},
+          {"--rtps_batch_window_us=",
+           [rtps_conf](const std::string& value) {
+             rtps_conf->set_batch_window_us(std::stoul(value));
+           }},
+          {"--rtps_fragment_size=",
+           [rtps_conf](const std::string& value) {
+             rtps_conf->set_fragment_size(std::stoul(value));
+           }},
+          {"--rtps_socket_buffer_size=",
+           [rtps_conf](const std::string& value) {
+             rtps_conf->set_socket_buffer_size(std::stoul(value));
+           }},
+      };
+  // taken out of argv before google benchmark rejects them
+  int kept = 1;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    bool taken = false;
+    for (const auto& flag : flags) {
+      if (arg.compare(0, flag.first.size(), flag.first) == 0) {
+        flag.second(arg.substr(flag.first.size()));
+        taken = true;
+      }
+    }
+    if (!taken) {
+      argv[kept++] = argv[i];
+    }
+  }
+  argc = kept;
+
+  const std::string work_root =
+      apollo::cyber::transport::SetUpWorkRoot(conf, "transport_benchmark");
+  if (work_root.empty()) {
+    return 1;
+  }
+  apollo::cyber::Init(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  apollo::cyber::transport::Transport::Instance()->Shutdown();
+  apollo::cyber::common::DeleteFile(work_root);
+  return 0;
+}
@@ -20,6 +20,8 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+thread_local bool IntraDispatcher::in_delivery_ = false;
+
 IntraDispatcher::IntraDispatcher() { chain_.reset(new ChannelChain()); }
 
 IntraDispatcher::~IntraDispatcher() {}
@@ -30,6 +30,7 @@
 #include "cyber/message/message_traits.h"
 #include "cyber/message/raw_message.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/envelope.h"
 
 namespace apollo {
 namespace cyber {
@@ -207,7 +208,9 @@ class ChannelChain {
     ADEBUG << GlobalData::GetChannelById(channel_id)
            << "'s chain run, size: " << channel_handlers.size()
            << ", message type: " << message_type;
-    std::string msg;
+    // serialized at most once, shared with the transmitters of the publish
+    auto envelope = Envelope::Find<OutboundEnvelope<MessageT>>(message.get());
+    std::unique_ptr<OutboundEnvelope<MessageT>> own_envelope;
     for (const auto& ele : channel_handlers) {
       auto handler_base = ele.second;
       if (message_type == ele.first) {
@@ -221,23 +224,16 @@ class ChannelChain {
       } else {
         ADEBUG << "Run handler for message type: " << ele.first
                << " from string";
-        if (msg.empty()) {
-          auto msg_size = message::FullByteSize(*message);
-          if (msg_size < 0) {
-            AERROR << "Failed to get message size. channel["
-                   << common::GlobalData::GetChannelById(channel_id) << "]";
-            continue;
-          }
-          msg.resize(msg_size);
-          if (!message::SerializeToHC(*message, const_cast<char*>(msg.data()),
-                                      msg_size)) {
-            AERROR << "Chain Serialize error for channel id: " << channel_id;
-            msg.clear();
-          }
+        if (envelope == nullptr) {
+          own_envelope = std::make_unique<OutboundEnvelope<MessageT>>(message);
+          envelope = own_envelope.get();
         }
-        if (!msg.empty()) {
-          (handler_base)->RunFromString(msg, message_info);
+        const std::string* msg = envelope->HcBytes();
+        if (msg == nullptr) {
+          AERROR << "Chain Serialize error for channel id: " << channel_id;
+          continue;
         }
+        (handler_base)->RunFromString(*msg, message_info);
       }
     }
   }
@@ -272,9 +268,15 @@ class IntraDispatcher : public Dispatcher {
   void RemoveListener(const RoleAttributes& self_attr,
                       const RoleAttributes& opposite_attr);
 
+  // true while the calling thread, the writer's, hands a message to the
+  // readers of its own process
+  static bool InDelivery() { return in_delivery_; }
+
   DECLARE_SINGLETON(IntraDispatcher)
 
  private:
+  static thread_local bool in_delivery_;
+
   template <typename MessageT>
   std::shared_ptr<ListenerHandler<MessageT>> GetHandler(uint64_t channel_id);
 
@@ -291,29 +293,31 @@ void IntraDispatcher::OnMessage(uint64_t channel_id,
   ListenerHandlerBasePtr* handler_base = nullptr;
   ADEBUG << "intra on message, channel:"
          << common::GlobalData::GetChannelById(channel_id);
+  const bool in_delivery = in_delivery_;
+  in_delivery_ = true;
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     auto handler =
         std::dynamic_pointer_cast<ListenerHandler<MessageT>>(*handler_base);
     if (handler) {
       handler->Run(message, message_info);
     } else {
-      auto msg_size = message::FullByteSize(*message);
-      if (msg_size < 0) {
-        AERROR << "Failed to get message size. channel["
-               << common::GlobalData::GetChannelById(channel_id) << "]";
-        return;
+      auto envelope =
+          Envelope::Find<OutboundEnvelope<MessageT>>(message.get());
+      std::unique_ptr<OutboundEnvelope<MessageT>> own_envelope;
+      if (envelope == nullptr) {
+        own_envelope = std::make_unique<OutboundEnvelope<MessageT>>(message);
+        envelope = own_envelope.get();
       }
-      std::string msg;
-      msg.resize(msg_size);
-      if (message::SerializeToHC(*message, const_cast<char*>(msg.data()),
-                                 msg_size)) {
-        (*handler_base)->RunFromString(msg, message_info);
+      const std::string* msg = envelope->HcBytes();
+      if (msg != nullptr) {
+        (*handler_base)->RunFromString(*msg, message_info);
       } else {
         AERROR << "Failed to serialize message. channel["
                << common::GlobalData::GetChannelById(channel_id) << "]";
       }
     }
   }
+  in_delivery_ = in_delivery;
 }
 
 template <typename MessageT>
@@ -43,6 +43,8 @@ TEST(DispatcherTest, on_message) {
                               const std::shared_ptr<proto::Chatter>& msg,
                               const MessageInfo&) {
     AINFO << "chatter callback";
+    // readers may hold the writer's thread only here
+    EXPECT_TRUE(IntraDispatcher::InDelivery());
     chatter_msgs.push_back(msg);
   };
   auto raw_callback = [&raw_msgs](
@@ -87,6 +89,7 @@ TEST(DispatcherTest, on_message) {
   dispatcher->OnMessage<proto::Chatter>(channel_id, chatter, msg_info);
   EXPECT_EQ(1, chatter_msgs.size());
   EXPECT_EQ(1, raw_msgs.size());
+  EXPECT_FALSE(IntraDispatcher::InDelivery());
 
   // run 1, 3 + 2, 4
   msg_info.set_sender_id(identity1);
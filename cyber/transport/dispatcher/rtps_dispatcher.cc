@@ -79,6 +79,8 @@ void RtpsDispatcher::OnMessage(uint64_t channel_id,
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     auto handler =
         std::dynamic_pointer_cast<ListenerHandler<std::string>>(*handler_base);
+    // the readers of a type share one parsed message
+    InboundEnvelope envelope(msg_str.get());
     handler->Run(msg_str, msg_info);
   }
 }
@@ -25,8 +25,10 @@
 
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
+#include "cyber/message/message_allocator.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/envelope.h"
 #include "cyber/transport/rtps/attributes_filler.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/rtps/sub_listener.h"
@@ -81,11 +83,17 @@ class RtpsDispatcher : public Dispatcher {
 template <typename MessageT>
 void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
                                  const MessageListener<MessageT>& listener) {
-  auto listener_adapter = [listener](
+  auto allocator = message::MessageAllocator<MessageT>::ForChannel(
+      self_attr.channel_id(), self_attr.allocator_conf());
+  auto listener_adapter = [listener, allocator](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    auto msg = InboundEnvelope::Parse<MessageT>(
+        msg_str.get(), allocator.get(), [&msg_str, &allocator]() {
+          auto msg = allocator->Allocate();
+          return message::ParseFromString(*msg_str, msg.get()) ? msg : nullptr;
+        });
+    RETURN_IF_NULL(msg);
     listener(msg, msg_info);
   };
 
@@ -97,11 +105,17 @@ template <typename MessageT>
 void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
                                  const RoleAttributes& opposite_attr,
                                  const MessageListener<MessageT>& listener) {
-  auto listener_adapter = [listener](
+  auto allocator = message::MessageAllocator<MessageT>::ForChannel(
+      self_attr.channel_id(), self_attr.allocator_conf());
+  auto listener_adapter = [listener, allocator](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    auto msg = InboundEnvelope::Parse<MessageT>(
+        msg_str.get(), allocator.get(), [&msg_str, &allocator]() {
+          auto msg = allocator->Allocate();
+          return message::ParseFromString(*msg_str, msg.get()) ? msg : nullptr;
+        });
+    RETURN_IF_NULL(msg);
     listener(msg, msg_info);
   };
 
@@ -15,6 +15,9 @@
  *****************************************************************************/
 
 #include "cyber/transport/dispatcher/shm_dispatcher.h"
+
+#include <chrono>
+
 #include "cyber/common/global_data.h"
 #include "cyber/common/util.h"
 #include "cyber/scheduler/scheduler_factory.h"
@@ -26,6 +29,24 @@ namespace transport {
 
 using common::GlobalData;
 
+namespace {
+
+uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void UpdateMax(std::atomic<uint64_t>* max_value, uint64_t value) {
+  uint64_t old_value = max_value->load(std::memory_order_relaxed);
+  while (value > old_value &&
+         !max_value->compare_exchange_weak(old_value, value,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
 ShmDispatcher::ShmDispatcher() : host_id_(0) { Init(); }
 
 ShmDispatcher::~ShmDispatcher() { Shutdown(); }
@@ -39,6 +60,16 @@ void ShmDispatcher::Shutdown() {
     thread_.join();
   }
 
+  for (auto& shard : shards_) {
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+    }
+    shard->cv.notify_all();
+    if (shard->thread.joinable()) {
+      shard->thread.join();
+    }
+  }
+
   {
     ReadLockGuard<AtomicRWLock> lock(segments_lock_);
     segments_.clear();
@@ -60,15 +91,28 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
   ADEBUG << "Reading sharedmem message: "
          << GlobalData::GetChannelById(channel_id)
          << " from block: " << block_index;
-  auto rb = std::make_shared<ReadableBlock>();
-  rb->index = block_index;
-  if (!segments_[channel_id]->AcquireBlockToRead(rb.get())) {
+  auto segment = segments_[channel_id];
+  ReadableBlock readable_block;
+  readable_block.index = block_index;
+  if (!segment->AcquireBlockToRead(&readable_block)) {
     AWARN << "fail to acquire block, channel: "
           << GlobalData::GetChannelById(channel_id)
           << " index: " << block_index;
     return;
   }
 
+  // the read lock is held until the last reference to the block is dropped,
+  // which lets ShmMessageView listeners keep the block pinned. The mapping
+  // stays attached until then, even if the segment is remapped meanwhile.
+  readable_block.segment = segment.get();
+  auto mapping = segment->mapping();
+  std::shared_ptr<ReadableBlock> rb(
+      new ReadableBlock(readable_block),
+      [segment, mapping](ReadableBlock* block) {
+        segment->ReleaseReadBlock(*block);
+        delete block;
+      });
+
   MessageInfo msg_info;
   const char* msg_info_addr =
       reinterpret_cast<char*>(rb->buf) + rb->block->msg_size();
@@ -79,7 +123,6 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
     AERROR << "error msg info of channel:"
            << GlobalData::GetChannelById(channel_id);
   }
-  segments_[channel_id]->ReleaseReadBlock(*rb);
 }
 
 void ShmDispatcher::OnMessage(uint64_t channel_id,
@@ -92,6 +135,8 @@ void ShmDispatcher::OnMessage(uint64_t channel_id,
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     auto handler = std::dynamic_pointer_cast<ListenerHandler<ReadableBlock>>(
         *handler_base);
+    // the readers of a type share one parsed message
+    InboundEnvelope envelope(rb.get());
     handler->Run(rb, msg_info);
   } else {
     AERROR << "Cannot find " << GlobalData::GetChannelById(channel_id)
@@ -139,14 +184,144 @@ void ShmDispatcher::ThreadFunc() {
       }
       previous_index = block_index;
 
-      ReadMessage(channel_id, block_index);
+      Dispatch(channel_id, block_index);
+    }
+  }
+}
+
+void ShmDispatcher::Dispatch(uint64_t channel_id, uint32_t block_index) {
+  // NOTE: segments_lock_ is held by the caller
+  if (shards_.empty()) {
+    ReadMessage(channel_id, block_index);
+    return;
+  }
+
+  Shard* shard = ShardOf(channel_id);
+  ReadTask task;
+  task.channel_id = channel_id;
+  task.block_index = block_index;
+  task.enqueue_ns = NowNs();
+  if (!shard->queue.Enqueue(task)) {
+    shard->dropped.fetch_add(1, std::memory_order_relaxed);
+    AWARN_EVERY(100) << "shm dispatcher shard " << shard->name
+                     << " is full, drop message of channel: "
+                     << GlobalData::GetChannelById(channel_id);
+    return;
+  }
+  UpdateMax(&shard->max_queue_depth, shard->queue.Size());
+  {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+  }
+  shard->cv.notify_one();
+}
+
+ShmDispatcher::Shard* ShmDispatcher::ShardOf(uint64_t channel_id) {
+  auto itr = dedicated_shards_.find(channel_id);
+  if (itr != dedicated_shards_.end()) {
+    return shards_[itr->second].get();
+  }
+  return shards_[channel_id % hashed_shard_num_].get();
+}
+
+bool ShmDispatcher::WaitTask(Shard* shard, ReadTask* task) {
+  while (!shard->queue.Dequeue(task)) {
+    std::unique_lock<std::mutex> lock(shard->mutex);
+    shard->cv.wait(lock, [this, shard] {
+      return is_shutdown_.load() || !shard->queue.Empty();
+    });
+    if (is_shutdown_.load()) {
+      return false;
     }
   }
+  return true;
+}
+
+void ShmDispatcher::ShardThreadFunc(Shard* shard) {
+  ReadTask task;
+  while (!is_shutdown_.load()) {
+    if (!WaitTask(shard, &task)) {
+      continue;
+    }
+
+    uint64_t start_ns = NowNs();
+    uint64_t wait_ns = start_ns - task.enqueue_ns;
+    {
+      ReadLockGuard<AtomicRWLock> lock(segments_lock_);
+      if (segments_.count(task.channel_id) == 0) {
+        continue;
+      }
+      ReadMessage(task.channel_id, task.block_index);
+    }
+    uint64_t handle_ns = NowNs() - start_ns;
+
+    shard->dispatched.fetch_add(1, std::memory_order_relaxed);
+    shard->total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+    shard->total_handle_ns.fetch_add(handle_ns, std::memory_order_relaxed);
+    UpdateMax(&shard->max_wait_ns, wait_ns);
+    UpdateMax(&shard->max_handle_ns, handle_ns);
+  }
+}
+
+void ShmDispatcher::GetShardStats(std::vector<ShmShardStats>* stats) {
+  RETURN_IF_NULL(stats);
+  stats->clear();
+  for (auto& shard : shards_) {
+    ShmShardStats stat;
+    stat.name = shard->name;
+    stat.queue_depth = shard->queue.Size();
+    stat.max_queue_depth = shard->max_queue_depth.load();
+    stat.dispatched = shard->dispatched.load();
+    stat.dropped = shard->dropped.load();
+    stat.total_wait_ns = shard->total_wait_ns.load();
+    stat.max_wait_ns = shard->max_wait_ns.load();
+    stat.total_handle_ns = shard->total_handle_ns.load();
+    stat.max_handle_ns = shard->max_handle_ns.load();
+    stats->emplace_back(stat);
+  }
+}
+
+void ShmDispatcher::InitShards() {
+  auto& g_conf = GlobalData::Instance()->Config();
+  if (!g_conf.has_transport_conf() ||
+      !g_conf.transport_conf().has_shm_conf() ||
+      !g_conf.transport_conf().shm_conf().has_dispatcher_conf()) {
+    return;
+  }
+  const auto& conf = g_conf.transport_conf().shm_conf().dispatcher_conf();
+  if (conf.shard_num() <= 1 && conf.dedicated_channel_size() == 0) {
+    return;
+  }
+
+  hashed_shard_num_ = conf.shard_num() > 0 ? conf.shard_num() : 1;
+  for (uint32_t i = 0; i < hashed_shard_num_; ++i) {
+    shards_.emplace_back(new Shard());
+    shards_.back()->name = "shm_disp_" + std::to_string(i);
+  }
+  for (const auto& channel : conf.dedicated_channel()) {
+    uint64_t channel_id = common::Hash(channel);
+    if (dedicated_shards_.count(channel_id) > 0) {
+      continue;
+    }
+    dedicated_shards_[channel_id] = static_cast<uint32_t>(shards_.size());
+    shards_.emplace_back(new Shard());
+    shards_.back()->name = "shm_disp_" + channel;
+  }
+
+  for (auto& shard : shards_) {
+    // waits go through Shard::cv, the queue itself never blocks
+    shard->queue.Init(conf.queue_size(), new base::BusySpinWaitStrategy());
+    shard->thread = std::thread(&ShmDispatcher::ShardThreadFunc, this,
+                                shard.get());
+    scheduler::Instance()->SetInnerThreadAttr(shard->name, &shard->thread);
+  }
+  AINFO << "shm dispatcher runs with " << shards_.size() << " shards, "
+        << dedicated_shards_.size() << " of them dedicated.";
 }
 
 bool ShmDispatcher::Init() {
   host_id_ = common::Hash(GlobalData::Instance()->HostIp());
   notifier_ = NotifierFactory::CreateNotifier();
+  InitShards();
   thread_ = std::thread(&ShmDispatcher::ThreadFunc, this);
   scheduler::Instance()->SetInnerThreadAttr("shm_disp", &thread_);
   return true;
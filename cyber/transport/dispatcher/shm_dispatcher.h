@@ -17,20 +17,28 @@
 #ifndef CYBER_TRANSPORT_DISPATCHER_SHM_DISPATCHER_H_
 #define CYBER_TRANSPORT_DISPATCHER_SHM_DISPATCHER_H_
 
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/bounded_queue.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
+#include "cyber/message/message_allocator.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/envelope.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/shm/segment_factory.h"
+#include "cyber/transport/shm/shm_message_view.h"
 
 namespace apollo {
 namespace cyber {
@@ -42,6 +50,53 @@ using apollo::cyber::base::AtomicRWLock;
 using apollo::cyber::base::ReadLockGuard;
 using apollo::cyber::base::WriteLockGuard;
 
+template <typename MessageT>
+std::shared_ptr<MessageT> MessageFromBlock(
+    const std::shared_ptr<ReadableBlock>& rb,
+    message::MessageAllocator<MessageT>* allocator) {
+  auto msg = allocator->Allocate();
+  if (!message::ParseFromArray(rb->buf, static_cast<int>(rb->block->msg_size()),
+                               msg.get())) {
+    return nullptr;
+  }
+  return msg;
+}
+
+// ShmMessageView wraps the block without parsing, keeping it read-locked.
+// Once the segment has no pins left, the payload is copied instead and the
+// block is released right after delivery.
+template <>
+inline std::shared_ptr<ShmMessageView> MessageFromBlock<ShmMessageView>(
+    const std::shared_ptr<ReadableBlock>& rb,
+    message::MessageAllocator<ShmMessageView>* allocator) {
+  (void)allocator;
+  Segment* segment = rb->segment;
+  if (segment == nullptr || !segment->TryPinBlock()) {
+    auto view = std::make_shared<ShmMessageView>();
+    view->ParseFromString(std::string(reinterpret_cast<const char*>(rb->buf),
+                                      rb->block->msg_size()));
+    return view;
+  }
+  // rb keeps the segment alive until the pin is returned
+  std::shared_ptr<ReadableBlock> pinned_block(
+      rb.get(), [rb, segment](ReadableBlock*) { segment->UnpinBlock(); });
+  return std::make_shared<ShmMessageView>(pinned_block);
+}
+
+// Snapshot of the counters of one dispatcher shard. Waits are measured from
+// the moment the listener routes a readable info to the shard.
+struct ShmShardStats {
+  std::string name;
+  uint64_t queue_depth = 0;
+  uint64_t max_queue_depth = 0;
+  uint64_t dispatched = 0;
+  uint64_t dropped = 0;
+  uint64_t total_wait_ns = 0;
+  uint64_t max_wait_ns = 0;
+  uint64_t total_handle_ns = 0;
+  uint64_t max_handle_ns = 0;
+};
+
 class ShmDispatcher : public Dispatcher {
  public:
   // key: channel_id
@@ -51,6 +106,10 @@ class ShmDispatcher : public Dispatcher {
 
   void Shutdown() override;
 
+  // Empty when messages are read on the listener thread (shard_num is 1 and
+  // no channel is dedicated). SysMo publishes them with its metrics.
+  void GetShardStats(std::vector<ShmShardStats>* stats);
+
   template <typename MessageT>
   void AddListener(const RoleAttributes& self_attr,
                    const MessageListener<MessageT>& listener);
@@ -61,11 +120,39 @@ class ShmDispatcher : public Dispatcher {
                    const MessageListener<MessageT>& listener);
 
  private:
+  struct ReadTask {
+    uint64_t channel_id = 0;
+    uint32_t block_index = 0;
+    uint64_t enqueue_ns = 0;
+  };
+
+  struct Shard {
+    std::string name;
+    base::BoundedQueue<ReadTask> queue;
+    // the shard thread checks the queue under mutex before it waits, and the
+    // listener takes mutex after Enqueue, so no notify is lost
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread thread;
+    std::atomic<uint64_t> max_queue_depth = {0};
+    std::atomic<uint64_t> dispatched = {0};
+    std::atomic<uint64_t> dropped = {0};
+    std::atomic<uint64_t> total_wait_ns = {0};
+    std::atomic<uint64_t> max_wait_ns = {0};
+    std::atomic<uint64_t> total_handle_ns = {0};
+    std::atomic<uint64_t> max_handle_ns = {0};
+  };
+
   void AddSegment(const RoleAttributes& self_attr);
   void ReadMessage(uint64_t channel_id, uint32_t block_index);
   void OnMessage(uint64_t channel_id, const std::shared_ptr<ReadableBlock>& rb,
                  const MessageInfo& msg_info);
   void ThreadFunc();
+  void ShardThreadFunc(Shard* shard);
+  bool WaitTask(Shard* shard, ReadTask* task);
+  void InitShards();
+  void Dispatch(uint64_t channel_id, uint32_t block_index);
+  Shard* ShardOf(uint64_t channel_id);
   bool Init();
 
   uint64_t host_id_;
@@ -75,6 +162,12 @@ class ShmDispatcher : public Dispatcher {
   std::thread thread_;
   NotifierPtr notifier_;
 
+  // hashed shards come first, followed by one shard per dedicated channel
+  std::vector<std::unique_ptr<Shard>> shards_;
+  uint32_t hashed_shard_num_ = 0;
+  // key: channel_id, value: index in shards_
+  std::unordered_map<uint64_t, uint32_t> dedicated_shards_;
+
   DECLARE_SINGLETON(ShmDispatcher)
 };
 
@@ -82,11 +175,16 @@ template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const MessageListener<MessageT>& listener) {
   // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+  auto allocator = message::MessageAllocator<MessageT>::ForChannel(
+      self_attr.channel_id(), self_attr.allocator_conf());
+  auto listener_adapter = [listener, allocator](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    auto msg = InboundEnvelope::Parse<MessageT>(
+        rb.get(), allocator.get(), [&rb, &allocator]() {
+          return MessageFromBlock<MessageT>(rb, allocator.get());
+        });
+    RETURN_IF_NULL(msg);
     listener(msg, msg_info);
   };
 
@@ -99,11 +197,16 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const RoleAttributes& opposite_attr,
                                 const MessageListener<MessageT>& listener) {
   // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+  auto allocator = message::MessageAllocator<MessageT>::ForChannel(
+      self_attr.channel_id(), self_attr.allocator_conf());
+  auto listener_adapter = [listener, allocator](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    auto msg = InboundEnvelope::Parse<MessageT>(
+        rb.get(), allocator.get(), [&rb, &allocator]() {
+          return MessageFromBlock<MessageT>(rb, allocator.get());
+        });
+    RETURN_IF_NULL(msg);
     listener(msg, msg_info);
   };
 
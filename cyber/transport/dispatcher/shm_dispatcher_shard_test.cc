@@ -0,0 +1,141 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/util.h"
+#include "cyber/message/raw_message.h"
+#include "cyber/transport/common/identity.h"
+#include "cyber/transport/dispatcher/shm_dispatcher.h"
+#include "cyber/transport/transmitter/shm_transmitter.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+const char kDedicatedChannel[] = "shard_test_dedicated";
+const int kMsgNum = 50;
+
+RoleAttributes ChannelAttr(const std::string& channel) {
+  RoleAttributes attr;
+  attr.set_host_name(common::GlobalData::Instance()->HostName());
+  attr.set_host_ip(common::GlobalData::Instance()->HostIp());
+  attr.set_channel_name(channel);
+  attr.set_channel_id(common::GlobalData::RegisterChannel(channel));
+  Identity id;
+  attr.set_id(id.HashValue());
+  return attr;
+}
+
+}  // namespace
+
+TEST(ShmDispatcherShardTest, dispatch) {
+  auto dispatcher = ShmDispatcher::Instance();
+  const std::vector<std::string> channels = {
+      "shard_test_0", "shard_test_1", "shard_test_2", kDedicatedChannel};
+
+  std::vector<std::atomic<int>> received(channels.size());
+  std::vector<std::shared_ptr<Transmitter<message::RawMessage>>> transmitters;
+  for (size_t i = 0; i < channels.size(); ++i) {
+    received[i] = 0;
+    auto attr = ChannelAttr(channels[i]);
+    dispatcher->AddListener<message::RawMessage>(
+        attr, [&received, i](const std::shared_ptr<message::RawMessage>&,
+                             const MessageInfo&) { ++received[i]; });
+    transmitters.emplace_back(
+        std::make_shared<ShmTransmitter<message::RawMessage>>(attr));
+    transmitters.back()->Enable();
+  }
+
+  auto msg = std::make_shared<message::RawMessage>("shard");
+  for (int n = 0; n < kMsgNum; ++n) {
+    for (auto& transmitter : transmitters) {
+      transmitter->Transmit(msg);
+    }
+    // the shards go idle between messages, a lost wakeup would stall one
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  auto all_received = [&received]() {
+    for (auto& count : received) {
+      if (count.load() < kMsgNum) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (int retry = 0; retry < 100 && !all_received(); ++retry) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  for (size_t i = 0; i < channels.size(); ++i) {
+    EXPECT_EQ(kMsgNum, received[i].load()) << channels[i];
+  }
+
+  std::vector<ShmShardStats> stats;
+  dispatcher->GetShardStats(&stats);
+  // two hashed shards and the dedicated one
+  ASSERT_EQ(3U, stats.size());
+  uint64_t dispatched = 0;
+  for (const auto& stat : stats) {
+    EXPECT_EQ(0U, stat.dropped) << stat.name;
+    EXPECT_EQ(0U, stat.queue_depth) << stat.name;
+    EXPECT_LE(stat.max_wait_ns, stat.total_wait_ns) << stat.name;
+    dispatched += stat.dispatched;
+  }
+  EXPECT_EQ("shm_disp_" + std::string(kDedicatedChannel), stats[2].name);
+  EXPECT_EQ(static_cast<uint64_t>(kMsgNum), stats[2].dispatched);
+  EXPECT_EQ(static_cast<uint64_t>(kMsgNum * channels.size()), dispatched);
+
+  for (auto& transmitter : transmitters) {
+    transmitter->Disable();
+  }
+  dispatcher->Shutdown();
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  // the dispatcher reads its shard layout once, before the first instance
+  char dir_template[] = "/tmp/shm_dispatcher_shard_test.XXXXXX";
+  const std::string dir = mkdtemp(dir_template);
+  if (system(("mkdir -p " + dir + "/conf").c_str()) != 0) {
+    return -1;
+  }
+  std::ofstream(dir + "/conf/cyber.pb.conf")
+      << "transport_conf { shm_conf { dispatcher_conf {"
+      << " shard_num: 2 dedicated_channel: \"shard_test_dedicated\" } } }\n";
+  setenv("CYBER_PATH", dir.c_str(), 1);
+  auto res = RUN_ALL_TESTS();
+  system(("rm -rf " + dir).c_str());
+  return res;
+}
@@ -17,6 +17,8 @@
 #include "cyber/transport/dispatcher/shm_dispatcher.h"
 
 #include <memory>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "cyber/common/global_data.h"
@@ -95,6 +97,15 @@ TEST(ShmDispatcherTest, on_message) {
   EXPECT_EQ(recv_msg->message, send_msg->message);
 }
 
+TEST(ShmDispatcherTest, shard_stats) {
+  auto dispatcher = ShmDispatcher::Instance();
+  // the default config reads every channel on the listener thread
+  std::vector<ShmShardStats> stats;
+  dispatcher->GetShardStats(&stats);
+  EXPECT_TRUE(stats.empty());
+  dispatcher->GetShardStats(nullptr);
+}
+
 TEST(ShmDispatcherTest, shutdown) {
   auto dispatcher = ShmDispatcher::Instance();
   dispatcher->Shutdown();
@@ -0,0 +1,190 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_ENVELOPE_H_
+#define CYBER_TRANSPORT_MESSAGE_ENVELOPE_H_
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cyber/message/message_header.h"
+#include "cyber/message/message_traits.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @brief A message on its way through the transports of the process, whose
+ * wire bytes or parsed objects are produced on first demand and then shared
+ * by everything handling the message on the same thread. The transmitters
+ * of a writer and the local readers of other types thereby serialize a
+ * published message once, and the readers of a received message parse it
+ * once per type.
+ *
+ * An envelope lives on the stack for the duration of a publish or of a
+ * dispatch and is found by the message it wraps. It is only used by the
+ * thread that created it and takes no lock.
+ */
+class Envelope {
+ public:
+  virtual ~Envelope() { current_ = parent_; }
+
+  /**
+   * @brief The innermost envelope of type `EnvelopeT` wrapping `key` on the
+   * calling thread, nullptr if there is none.
+   */
+  template <typename EnvelopeT>
+  static EnvelopeT* Find(const void* key) {
+    for (Envelope* envelope = current_; envelope != nullptr;
+         envelope = envelope->parent_) {
+      if (envelope->key_ == key) {
+        return dynamic_cast<EnvelopeT*>(envelope);
+      }
+    }
+    return nullptr;
+  }
+
+ protected:
+  explicit Envelope(const void* key) : key_(key), parent_(current_) {
+    current_ = this;
+  }
+
+ private:
+  Envelope(const Envelope&) = delete;
+  Envelope& operator=(const Envelope&) = delete;
+
+  const void* key_;
+  Envelope* parent_;
+
+  static thread_local Envelope* current_;
+};
+
+/**
+ * @brief A message being published, serialized at most once. The bytes are
+ * kept as ListenerHandler::RunFromString takes them, behind a MessageHeader,
+ * the transports use what follows the header.
+ */
+template <typename M>
+class OutboundEnvelope : public Envelope {
+ public:
+  explicit OutboundEnvelope(const std::shared_ptr<M>& msg)
+      : Envelope(msg.get()), msg_(msg) {}
+
+  /**
+   * @brief The number of WriteContent calls to come. While more than one is
+   * expected the first one serializes into the envelope and copies from
+   * there, the last one serializes straight into its buffer.
+   */
+  void ExpectWrites(int writes) { expected_writes_ = writes; }
+
+  // -1 if M cannot be serialized
+  int ContentSize() {
+    if (content_size_ == kUnknownSize) {
+      content_size_ = message::ByteSize(*msg_);
+    }
+    return content_size_;
+  }
+
+  /**
+   * @brief Write the serialized message to `data` of ContentSize() bytes.
+   */
+  bool WriteContent(char* data, int size) {
+    if (hc_.empty() && expected_writes_-- > 1) {
+      Serialize();
+    }
+    if (hc_.empty()) {
+      return message::SerializeToArray(*msg_, data, size);
+    }
+    if (size != ContentSize()) {
+      return false;
+    }
+    std::memcpy(data, hc_.data() + sizeof(message::MessageHeader), size);
+    return true;
+  }
+
+  // the message behind its MessageHeader, nullptr if it cannot be serialized
+  const std::string* HcBytes() {
+    if (hc_.empty()) {
+      Serialize();
+    }
+    return hc_.empty() ? nullptr : &hc_;
+  }
+
+ private:
+  static constexpr int kUnknownSize = -2;
+
+  void Serialize() {
+    if (ContentSize() < 0) {
+      return;
+    }
+    hc_.resize(ContentSize() + sizeof(message::MessageHeader));
+    if (!message::SerializeToHC(*msg_, &hc_[0], static_cast<int>(hc_.size()))) {
+      hc_.clear();
+    }
+  }
+
+  std::shared_ptr<M> msg_;
+  int content_size_ = kUnknownSize;
+  int expected_writes_ = 0;
+  std::string hc_;
+};
+
+/**
+ * @brief A message being handed to the local readers of a transport, parsed
+ * once per message allocator, i.e. per channel and type, so the readers of
+ * a type share one object as they do on the intra path.
+ */
+class InboundEnvelope : public Envelope {
+ public:
+  // `data` identifies the received message, e.g. its buffer
+  explicit InboundEnvelope(const void* data) : Envelope(data) {}
+
+  /**
+   * @brief The object parsed by `parse` for `allocator`, parsed now unless
+   * a reader parsed it already while dispatching `data`.
+   */
+  template <typename M, typename AllocatorT, typename ParseFunc>
+  static std::shared_ptr<M> Parse(const void* data, AllocatorT* allocator,
+                                  const ParseFunc& parse) {
+    auto envelope = Find<InboundEnvelope>(data);
+    if (envelope == nullptr) {
+      return parse();
+    }
+    for (auto& parsed : envelope->parsed_) {
+      if (parsed.first == allocator) {
+        return std::static_pointer_cast<M>(parsed.second);
+      }
+    }
+    std::shared_ptr<M> msg = parse();
+    if (msg != nullptr) {
+      envelope->parsed_.emplace_back(allocator, msg);
+    }
+    return msg;
+  }
+
+ private:
+  std::vector<std::pair<const void*, std::shared_ptr<void>>> parsed_;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_ENVELOPE_H_
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/message/envelope.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cyber/proto/unit_test.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+// a Chatter that counts how often it gets serialized
+struct CountedChatter {
+  static std::string TypeName() { return "apollo.cyber.CountedChatter"; }
+  size_t ByteSizeLong() const { return chatter.ByteSizeLong(); }
+  bool SerializeToArray(void* data, int size) const {
+    ++serializations;
+    return chatter.SerializeToArray(data, size);
+  }
+
+  proto::Chatter chatter;
+  mutable int serializations = 0;
+};
+
+std::shared_ptr<CountedChatter> NewChatter() {
+  auto msg = std::make_shared<CountedChatter>();
+  msg->chatter.set_timestamp(42);
+  msg->chatter.set_content(std::string(1000, 'x'));
+  return msg;
+}
+
+std::string Write(OutboundEnvelope<CountedChatter>* envelope) {
+  std::string data(envelope->ContentSize(), '\0');
+  EXPECT_TRUE(envelope->WriteContent(&data[0], static_cast<int>(data.size())));
+  return data;
+}
+
+TEST(EnvelopeTest, find) {
+  auto msg = NewChatter();
+  EXPECT_EQ(nullptr, Envelope::Find<OutboundEnvelope<CountedChatter>>(
+                         msg.get()));
+  {
+    OutboundEnvelope<CountedChatter> outer(msg);
+    EXPECT_EQ(&outer, Envelope::Find<OutboundEnvelope<CountedChatter>>(
+                          msg.get()));
+    EXPECT_EQ(nullptr, Envelope::Find<InboundEnvelope>(msg.get()));
+    {
+      OutboundEnvelope<CountedChatter> inner(msg);
+      InboundEnvelope other(&inner);
+      EXPECT_EQ(&inner, Envelope::Find<OutboundEnvelope<CountedChatter>>(
+                            msg.get()));
+    }
+    EXPECT_EQ(&outer, Envelope::Find<OutboundEnvelope<CountedChatter>>(
+                          msg.get()));
+  }
+  EXPECT_EQ(nullptr, Envelope::Find<OutboundEnvelope<CountedChatter>>(
+                         msg.get()));
+}
+
+TEST(EnvelopeTest, serialize_once) {
+  auto msg = NewChatter();
+  std::string expected;
+  ASSERT_TRUE(msg->chatter.SerializeToString(&expected));
+
+  OutboundEnvelope<CountedChatter> envelope(msg);
+  envelope.ExpectWrites(2);
+  EXPECT_EQ(expected, Write(&envelope));
+  EXPECT_EQ(expected, Write(&envelope));
+  const std::string* hc = envelope.HcBytes();
+  ASSERT_NE(nullptr, hc);
+  EXPECT_EQ(1, msg->serializations);
+
+  message::MessageHeader header;
+  std::memcpy(&header, hc->data(), sizeof(header));
+  EXPECT_EQ(expected.size(), header.content_size());
+  EXPECT_EQ(expected, hc->substr(sizeof(header)));
+
+  // too small a buffer is refused rather than overrun
+  std::string small(expected.size() - 1, '\0');
+  EXPECT_FALSE(envelope.WriteContent(&small[0],
+                                     static_cast<int>(small.size())));
+}
+
+TEST(EnvelopeTest, single_write_in_place) {
+  auto msg = NewChatter();
+  OutboundEnvelope<CountedChatter> envelope(msg);
+  envelope.ExpectWrites(1);
+  Write(&envelope);
+  EXPECT_EQ(1, msg->serializations);
+  // the bytes were not kept, asking for them serializes again
+  EXPECT_NE(nullptr, envelope.HcBytes());
+  EXPECT_EQ(2, msg->serializations);
+  Write(&envelope);
+  EXPECT_EQ(2, msg->serializations);
+}
+
+TEST(EnvelopeTest, parse_once_per_allocator) {
+  const std::string data = "received";
+  int allocator = 0;
+  int other_allocator = 0;
+  int parses = 0;
+  auto parse = [&parses]() {
+    ++parses;
+    return std::make_shared<proto::Chatter>();
+  };
+
+  auto first = InboundEnvelope::Parse<proto::Chatter>(&data, &allocator,
+                                                      parse);
+  auto second = InboundEnvelope::Parse<proto::Chatter>(&data, &allocator,
+                                                       parse);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(2, parses);
+
+  parses = 0;
+  InboundEnvelope envelope(&data);
+  first = InboundEnvelope::Parse<proto::Chatter>(&data, &allocator, parse);
+  second = InboundEnvelope::Parse<proto::Chatter>(&data, &allocator, parse);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(1, parses);
+  auto other = InboundEnvelope::Parse<proto::Chatter>(&data, &other_allocator,
+                                                      parse);
+  EXPECT_NE(first, other);
+  EXPECT_EQ(2, parses);
+
+  // failed parses are not kept
+  auto fail = []() { return std::shared_ptr<proto::Chatter>(); };
+  const std::string broken = "broken";
+  InboundEnvelope broken_envelope(&broken);
+  EXPECT_EQ(nullptr,
+            InboundEnvelope::Parse<proto::Chatter>(&broken, &allocator, fail));
+  EXPECT_NE(nullptr,
+            InboundEnvelope::Parse<proto::Chatter>(&broken, &allocator, parse));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -48,6 +48,7 @@ class History {
 
   void Enable() { enabled_ = true; }
   void Disable() { enabled_ = false; }
+  bool enabled() const { return enabled_; }
 
   void Add(const MessagePtr& msg, const MessageInfo& msg_info);
   void Clear();
@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/rtps/message_batch.h"
+
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+constexpr char MessageBatch::kDataType[];
+constexpr uint32_t MessageBatch::kRecordHeaderSize;
+
+MessageBatch::MessageBatch(uint32_t window_us, uint32_t max_bytes,
+                           const PublishFunc& publish)
+    : window_(window_us), max_bytes_(max_bytes), publish_(publish) {
+  sample_.datatype(kDataType);
+  sample_.data().reserve(max_bytes_);
+}
+
+bool MessageBatch::Add(uint32_t size, const MessageInfo& msg_info,
+                       const WriteFunc& write) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (publish_ == nullptr) {
+    return false;
+  }
+  auto& data = sample_.data();
+  bool result = true;
+  if (!data.empty() && data.size() + kRecordHeaderSize + size > max_bytes_) {
+    result = FlushLocked();
+  }
+
+  const size_t offset = data.size();
+  data.resize(offset + kRecordHeaderSize + size);
+  char* record = &data[offset];
+  const uint64_t seq_num = msg_info.seq_num();
+  std::memcpy(record, &size, sizeof(size));
+  std::memcpy(record + sizeof(size), msg_info.sender_id().data(), ID_SIZE);
+  std::memcpy(record + sizeof(size) + ID_SIZE, msg_info.spare_id().data(),
+              ID_SIZE);
+  std::memcpy(record + sizeof(size) + 2 * ID_SIZE, &seq_num, sizeof(seq_num));
+  if (!write(record + kRecordHeaderSize, size)) {
+    data.resize(offset);
+    return false;
+  }
+
+  if (data.size() >= max_bytes_) {
+    return FlushLocked() && result;
+  }
+  if (offset == 0) {
+    deadline_ = std::chrono::steady_clock::now() + window_;
+    BatchFlusher::Instance()->Schedule(shared_from_this(), deadline_);
+  }
+  return result;
+}
+
+bool MessageBatch::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return FlushLocked();
+}
+
+void MessageBatch::FlushIfDue(std::chrono::steady_clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (deadline_ <= now) {
+    FlushLocked();
+  }
+}
+
+void MessageBatch::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushLocked();
+  publish_ = nullptr;
+}
+
+bool MessageBatch::FlushLocked() {
+  if (sample_.data().empty() || publish_ == nullptr) {
+    return true;
+  }
+  const bool result = publish_(&sample_);
+  if (!result) {
+    AWARN << "failed to publish a batch of " << sample_.data().size()
+          << " bytes";
+  }
+  sample_.data().clear();
+  return result;
+}
+
+bool MessageBatch::Split(const std::string& data,
+                         const MessageCallback& callback) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    if (data.size() - offset < kRecordHeaderSize) {
+      return false;
+    }
+    const char* record = data.data() + offset;
+    uint32_t size = 0;
+    std::memcpy(&size, record, sizeof(size));
+    if (data.size() - offset - kRecordHeaderSize < size) {
+      return false;
+    }
+    Identity sender_id(false);
+    sender_id.set_data(record + sizeof(size));
+    Identity spare_id(false);
+    spare_id.set_data(record + sizeof(size) + ID_SIZE);
+    uint64_t seq_num = 0;
+    std::memcpy(&seq_num, record + sizeof(size) + 2 * ID_SIZE,
+                sizeof(seq_num));
+    MessageInfo msg_info(sender_id, seq_num, spare_id);
+    callback(
+        std::make_shared<std::string>(record + kRecordHeaderSize, size),
+        msg_info);
+    offset += kRecordHeaderSize + size;
+  }
+  return true;
+}
+
+BatchFlusher::BatchFlusher() {
+  thread_ = std::thread(&BatchFlusher::Run, this);
+}
+
+void BatchFlusher::Schedule(const std::shared_ptr<MessageBatch>& batch,
+                            std::chrono::steady_clock::time_point deadline) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (shutdown_) {
+    return;
+  }
+  const bool earliest = entries_.empty() || deadline < entries_.top().first;
+  entries_.emplace(deadline, batch);
+  if (earliest) {
+    cv_.notify_one();
+  }
+}
+
+void BatchFlusher::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      return;
+    }
+    shutdown_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  decltype(entries_) entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(entries, entries_);
+  }
+  for (; !entries.empty(); entries.pop()) {
+    auto batch = entries.top().second.lock();
+    if (batch != nullptr) {
+      batch->Flush();
+    }
+  }
+}
+
+void BatchFlusher::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!shutdown_) {
+    if (entries_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+    const auto deadline = entries_.top().first;
+    if (std::chrono::steady_clock::now() < deadline) {
+      cv_.wait_until(lock, deadline);
+      continue;
+    }
+    auto batch = entries_.top().second.lock();
+    entries_.pop();
+    lock.unlock();
+    if (batch != nullptr) {
+      batch->FlushIfDue(std::chrono::steady_clock::now());
+    }
+    lock.lock();
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_RTPS_MESSAGE_BATCH_H_
+#define CYBER_TRANSPORT_RTPS_MESSAGE_BATCH_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "cyber/transport/message/message_info.h"
+#include "cyber/transport/rtps/underlay_message.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @brief Small messages of one writer coalesced into a single rtps sample,
+ * so that high rate channels pay the per-sample cost of rtps once per
+ * batch. A batch is sent once it holds max_bytes or when the window that
+ * started with its first message ends, whichever comes first.
+ *
+ * The sample carries kDataType in its datatype and a sequence of records in
+ * its data: u32 size, sender id, spare id, u64 seq num and the serialized
+ * message, in host byte order.
+ */
+class MessageBatch : public std::enable_shared_from_this<MessageBatch> {
+ public:
+  using PublishFunc = std::function<bool(UnderlayMessage* sample)>;
+  using WriteFunc = std::function<bool(char* data, uint32_t size)>;
+  using MessageCallback = std::function<void(
+      const std::shared_ptr<std::string>& msg_str, const MessageInfo&)>;
+
+  static constexpr char kDataType[] = "cyber.batch";
+  static constexpr uint32_t kRecordHeaderSize =
+      sizeof(uint32_t) + 2 * ID_SIZE + sizeof(uint64_t);
+
+  MessageBatch(uint32_t window_us, uint32_t max_bytes,
+               const PublishFunc& publish);
+
+  /**
+   * @brief Append a message of `size` bytes that `write` serializes in
+   * place.
+   */
+  bool Add(uint32_t size, const MessageInfo& msg_info,
+           const WriteFunc& write);
+
+  // Send what is pending right away.
+  bool Flush();
+
+  // Send what is pending if its window ended by `now`.
+  void FlushIfDue(std::chrono::steady_clock::time_point now);
+
+  // Send what is pending and never publish again.
+  void Close();
+
+  static bool IsBatch(const UnderlayMessage& sample) {
+    return sample.datatype() == kDataType;
+  }
+
+  /**
+   * @brief Hand every message of a batch to `callback`.
+   *
+   * @return False if the batch is truncated.
+   */
+  static bool Split(const std::string& data, const MessageCallback& callback);
+
+ private:
+  bool FlushLocked();
+
+  const std::chrono::microseconds window_;
+  const uint32_t max_bytes_;
+
+  std::mutex mutex_;
+  PublishFunc publish_;
+  UnderlayMessage sample_;
+  std::chrono::steady_clock::time_point deadline_;
+};
+
+/**
+ * @brief The thread that sends batches whose window ended, shared by all
+ * the batching writers of the process.
+ */
+class BatchFlusher {
+ public:
+  void Schedule(const std::shared_ptr<MessageBatch>& batch,
+                std::chrono::steady_clock::time_point deadline);
+
+  // Sends everything still scheduled and stops the thread.
+  void Shutdown();
+
+ private:
+  using Entry = std::pair<std::chrono::steady_clock::time_point,
+                          std::weak_ptr<MessageBatch>>;
+  struct Later {
+    bool operator()(const Entry& lhs, const Entry& rhs) const {
+      return lhs.first > rhs.first;
+    }
+  };
+
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::priority_queue<Entry, std::vector<Entry>, Later> entries_;
+  bool shutdown_ = false;
+  std::thread thread_;
+
+  DECLARE_SINGLETON(BatchFlusher)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_RTPS_MESSAGE_BATCH_H_
@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/rtps/message_batch.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+class MessageBatchTest : public ::testing::Test {
+ protected:
+  MessageBatch::PublishFunc Publish() {
+    return [this](UnderlayMessage* sample) {
+      EXPECT_TRUE(MessageBatch::IsBatch(*sample));
+      std::lock_guard<std::mutex> lock(mutex_);
+      samples_.push_back(sample->data());
+      return true;
+    };
+  }
+
+  bool Add(MessageBatch* batch, const std::string& msg, uint64_t seq_num) {
+    MessageInfo msg_info(sender_id_, seq_num, spare_id_);
+    return batch->Add(static_cast<uint32_t>(msg.size()), msg_info,
+                      [&msg](char* data, uint32_t size) {
+                        std::memcpy(data, msg.data(), size);
+                        return true;
+                      });
+  }
+
+  size_t SampleCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samples_.size();
+  }
+
+  Identity sender_id_;
+  Identity spare_id_;
+  std::mutex mutex_;
+  std::vector<std::string> samples_;
+};
+
+TEST_F(MessageBatchTest, split) {
+  auto batch =
+      std::make_shared<MessageBatch>(1000000, 1024 * 1024, Publish());
+  EXPECT_TRUE(Add(batch.get(), "chassis", 1));
+  EXPECT_TRUE(Add(batch.get(), "", 2));
+  EXPECT_TRUE(Add(batch.get(), std::string("i\0mu", 4), 3));
+  EXPECT_EQ(0, SampleCount());
+  EXPECT_TRUE(batch->Flush());
+  ASSERT_EQ(1, SampleCount());
+
+  std::vector<std::string> msgs;
+  std::vector<MessageInfo> infos;
+  EXPECT_TRUE(MessageBatch::Split(
+      samples_[0], [&](const std::shared_ptr<std::string>& msg_str,
+                       const MessageInfo& msg_info) {
+        msgs.push_back(*msg_str);
+        infos.push_back(msg_info);
+      }));
+  EXPECT_EQ(std::vector<std::string>({"chassis", "", std::string("i\0mu", 4)}),
+            msgs);
+  ASSERT_EQ(3, infos.size());
+  EXPECT_EQ(MessageInfo(sender_id_, 3, spare_id_), infos[2]);
+
+  const std::string truncated = samples_[0].substr(0, samples_[0].size() - 1);
+  EXPECT_FALSE(MessageBatch::Split(
+      truncated,
+      [](const std::shared_ptr<std::string>&, const MessageInfo&) {}));
+}
+
+TEST_F(MessageBatchTest, max_bytes) {
+  const uint32_t max_bytes = 2 * (MessageBatch::kRecordHeaderSize + 100);
+  auto batch = std::make_shared<MessageBatch>(1000000, max_bytes, Publish());
+  const std::string msg(100, 'x');
+  EXPECT_TRUE(Add(batch.get(), msg, 1));
+  EXPECT_EQ(0, SampleCount());
+  // full right after the second one
+  EXPECT_TRUE(Add(batch.get(), msg, 2));
+  EXPECT_EQ(1, SampleCount());
+  EXPECT_TRUE(Add(batch.get(), msg, 3));
+  // the fourth one does not fit next to the third one
+  EXPECT_TRUE(Add(batch.get(), std::string(101, 'x'), 4));
+  EXPECT_EQ(2, SampleCount());
+
+  batch->Close();
+  EXPECT_EQ(3, SampleCount());
+  EXPECT_FALSE(Add(batch.get(), msg, 5));
+  EXPECT_EQ(3, SampleCount());
+}
+
+TEST_F(MessageBatchTest, window) {
+  auto batch = std::make_shared<MessageBatch>(2000, 1024 * 1024, Publish());
+  EXPECT_TRUE(Add(batch.get(), "imu", 1));
+  EXPECT_TRUE(Add(batch.get(), "imu", 2));
+  for (int i = 0; i < 1000 && SampleCount() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1, SampleCount());
+  EXPECT_EQ(2 * (MessageBatch::kRecordHeaderSize + 3), samples_[0].size());
+
+  // a message whose write fails is left out
+  MessageInfo msg_info(sender_id_, 3, spare_id_);
+  EXPECT_FALSE(batch->Add(8, msg_info, [](char*, uint32_t) { return false; }));
+  EXPECT_TRUE(batch->Flush());
+  EXPECT_EQ(1, SampleCount());
+}
+
+TEST(UnderlayMessageTest, data_writer) {
+  const std::string data(1000, 'x');
+  UnderlayMessage copied;
+  copied.data(data);
+  UnderlayMessage written;
+  written.data_writer(static_cast<uint32_t>(data.size()),
+                      [&data](char* out, uint32_t size) {
+                        std::memcpy(out, data.data(), size);
+                        return true;
+                      });
+  EXPECT_EQ(UnderlayMessage::getCdrSerializedSize(copied),
+            UnderlayMessage::getCdrSerializedSize(written));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -16,6 +16,10 @@
 
 #include "cyber/transport/rtps/participant.h"
 
+#include <algorithm>
+
+#include "fastrtps/transport/UDPv4Transport.h"
+
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/proto/transport_conf.pb.h"
@@ -109,6 +113,28 @@ void Participant::CreateFastRtpsParticipant(
 
   attr.rtps.setName(name.c_str());
 
+  // larger socket buffers and datagrams cut the per-fragment overhead of
+  // large messages, but a lost datagram costs a larger resend
+  proto::RtpsConf rtps_conf;
+  if (global_conf.has_transport_conf()) {
+    rtps_conf.CopyFrom(global_conf.transport_conf().rtps_conf());
+  }
+  if (rtps_conf.socket_buffer_size() > 0) {
+    attr.rtps.sendSocketBufferSize = rtps_conf.socket_buffer_size();
+    attr.rtps.listenSocketBufferSize = rtps_conf.socket_buffer_size();
+  }
+  if (rtps_conf.fragment_size() > 0) {
+    constexpr uint32_t kMaxUdpMessageSize = 65500;
+    auto udp_transport =
+        std::make_shared<eprosima::fastrtps::rtps::UDPv4TransportDescriptor>();
+    udp_transport->maxMessageSize =
+        std::min(rtps_conf.fragment_size(), kMaxUdpMessageSize);
+    udp_transport->sendBufferSize = attr.rtps.sendSocketBufferSize;
+    udp_transport->receiveBufferSize = attr.rtps.listenSocketBufferSize;
+    attr.rtps.useBuiltinTransports = false;
+    attr.rtps.userTransports.push_back(udp_transport);
+  }
+
   std::string ip_env("127.0.0.1");
   const char* ip_val = ::getenv("CYBER_IP");
   if (ip_val != nullptr) {
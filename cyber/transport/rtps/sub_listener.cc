@@ -18,6 +18,7 @@
 
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
+#include "cyber/transport/rtps/message_batch.h"
 
 namespace apollo {
 namespace cyber {
@@ -41,6 +42,18 @@ void SubListener::onNewDataMessage(eprosima::fastrtps::Subscriber* sub) {
   RETURN_IF(!sub->takeNextData(reinterpret_cast<void*>(&m), &m_info));
   RETURN_IF(m_info.sampleKind != eprosima::fastrtps::ALIVE);
 
+  if (MessageBatch::IsBatch(m)) {
+    auto callback = [this, channel_id](
+                        const std::shared_ptr<std::string>& msg_str,
+                        const MessageInfo& msg_info) {
+      callback_(channel_id, msg_str, msg_info);
+    };
+    if (!MessageBatch::Split(m.data(), callback)) {
+      AWARN << "truncated batch on " << sub->getAttributes().topic.topicName;
+    }
+    return;
+  }
+
   // fetch MessageInfo
   char* ptr =
       reinterpret_cast<char*>(&m_info.related_sample_identity.writer_guid());
@@ -57,9 +70,9 @@ void SubListener::onNewDataMessage(eprosima::fastrtps::Subscriber* sub) {
       m_info.related_sample_identity.sequence_number().low;
   msg_info_.set_seq_num(seq_num);
 
-  // fetch message string
+  // fetch message string, m is not used any more
   std::shared_ptr<std::string> msg_str =
-      std::make_shared<std::string>(m.data());
+      std::make_shared<std::string>(std::move(m.data()));
 
   // callback
   callback_(channel_id, msg_str, msg_info_);
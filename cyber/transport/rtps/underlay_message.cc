@@ -31,6 +31,7 @@ namespace transport {
 UnderlayMessage::UnderlayMessage() {
   m_timestamp = 0;
   m_seq = 0;
+  m_data_size = 0;
 }
 
 UnderlayMessage::~UnderlayMessage() {}
@@ -40,6 +41,8 @@ UnderlayMessage::UnderlayMessage(const UnderlayMessage& x) {
   m_seq = x.m_seq;
   m_data = x.m_data;
   m_datatype = x.m_datatype;
+  m_data_size = x.m_data_size;
+  m_data_writer = x.m_data_writer;
 }
 
 UnderlayMessage::UnderlayMessage(UnderlayMessage&& x) {
@@ -47,6 +50,8 @@ UnderlayMessage::UnderlayMessage(UnderlayMessage&& x) {
   m_seq = x.m_seq;
   m_data = std::move(x.m_data);
   m_datatype = std::move(x.m_datatype);
+  m_data_size = x.m_data_size;
+  m_data_writer = std::move(x.m_data_writer);
 }
 
 UnderlayMessage& UnderlayMessage::operator=(const UnderlayMessage& x) {
@@ -54,6 +59,8 @@ UnderlayMessage& UnderlayMessage::operator=(const UnderlayMessage& x) {
   m_seq = x.m_seq;
   m_data = x.m_data;
   m_datatype = x.m_datatype;
+  m_data_size = x.m_data_size;
+  m_data_writer = x.m_data_writer;
 
   return *this;
 }
@@ -63,6 +70,8 @@ UnderlayMessage& UnderlayMessage::operator=(UnderlayMessage&& x) {
   m_seq = x.m_seq;
   m_data = std::move(x.m_data);
   m_datatype = std::move(x.m_datatype);
+  m_data_size = x.m_data_size;
+  m_data_writer = std::move(x.m_data_writer);
 
   return *this;
 }
@@ -95,9 +104,11 @@ size_t UnderlayMessage::getCdrSerializedSize(const UnderlayMessage& data,
   current_alignment +=
       4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
 
+  const size_t data_size =
+      data.m_data_writer ? data.m_data_size : data.data().size();
   current_alignment += 4 +
                        eprosima::fastcdr::Cdr::alignment(current_alignment, 4) +
-                       data.data().size() + 1;
+                       data_size + 1;
 
   current_alignment += 4 +
                        eprosima::fastcdr::Cdr::alignment(current_alignment, 4) +
@@ -111,7 +122,19 @@ void UnderlayMessage::serialize(eprosima::fastcdr::Cdr& scdr) const {
 
   scdr << m_seq;
 
-  scdr << m_data;
+  if (m_data_writer) {
+    // the layout of a cdr string: length with the terminator, bytes, '\0'
+    scdr << static_cast<uint32_t>(m_data_size + 1);
+    char* data = scdr.getBufferPointer() + scdr.getSerializedDataLength();
+    scdr.jump(m_data_size);
+    if (!m_data_writer(data, m_data_size)) {
+      throw eprosima::fastcdr::exception::BadParamException(
+          "failed to write member data");
+    }
+    scdr << '\0';
+  } else {
+    scdr << m_data;
+  }
   scdr << m_datatype;
 }
 
@@ -20,6 +20,7 @@
 #include <cstdint>
 
 #include <array>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,6 +38,8 @@ namespace transport {
  */
 class UnderlayMessage {
  public:
+  using DataWriter = std::function<bool(char* data, uint32_t size)>;
+
   /*!
    * @brief Default constructor.
    */
@@ -128,6 +131,18 @@ class UnderlayMessage {
    * @return Reference to member data
    */
   inline std::string& data() { return m_data; }
+
+  /*!
+   * @brief Serialize member data as the `size` bytes `writer` puts straight
+   * into the sample instead of as data(), which saves copying a large
+   * message into data() first. Only for publishing.
+   * @param size Size of member data
+   * @param writer Fills member data, false on failure
+   */
+  inline void data_writer(uint32_t size, const DataWriter& writer) {
+    m_data_size = size;
+    m_data_writer = writer;
+  }
   /*!
    * @brief This function copies the value in member datatype
    * @param _datatype New value to be copied in member datatype
@@ -210,6 +225,8 @@ class UnderlayMessage {
   int32_t m_seq;
   std::string m_data;
   std::string m_datatype;
+  uint32_t m_data_size;
+  DataWriter m_data_writer;
 };
 
 }  // namespace transport
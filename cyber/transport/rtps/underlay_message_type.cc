@@ -23,6 +23,7 @@
 
 #include "fastcdr/Cdr.h"
 #include "fastcdr/FastBuffer.h"
+#include "fastcdr/exceptions/Exception.h"
 
 #include "cyber/common/log.h"
 
@@ -58,9 +59,14 @@ bool UnderlayMessageType::serialize(void* data, SerializedPayload_t* payload) {
   payload->encapsulation =
       ser.endianness() == eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE
                                                                  : CDR_LE;
-  // Serialize encapsulation
-  ser.serialize_encapsulation();
-  p_type->serialize(ser);  // Serialize the object:
+  try {
+    // Serialize encapsulation
+    ser.serialize_encapsulation();
+    p_type->serialize(ser);  // Serialize the object:
+  } catch (const eprosima::fastcdr::exception::Exception& e) {
+    AERROR << "failed to serialize UnderlayMessage: " << e.what();
+    return false;
+  }
   payload->length =
       (uint32_t)ser.getSerializedDataLength();  // Get the serialized length
   return true;
@@ -127,6 +127,10 @@ bool PosixSegment::OpenOrCreate() {
     return false;
   }
 
+  std::size_t managed_shm_size = conf_.managed_shm_size();
+  mapping_.reset(managed_shm_, [managed_shm_size](void* addr) {
+    munmap(addr, managed_shm_size);
+  });
   state_->IncreaseReferenceCounts();
   init_ = true;
   return true;
@@ -209,6 +213,10 @@ bool PosixSegment::OpenOnly() {
     return false;
   }
 
+  std::size_t managed_shm_size = file_attr.st_size;
+  mapping_.reset(managed_shm_, [managed_shm_size](void* addr) {
+    munmap(addr, managed_shm_size);
+  });
   state_->IncreaseReferenceCounts();
   init_ = true;
   ADEBUG << "open only true.";
@@ -231,7 +239,8 @@ void PosixSegment::Reset() {
     block_buf_addrs_.clear();
   }
   if (managed_shm_ != nullptr) {
-    munmap(managed_shm_, conf_.managed_shm_size());
+    // unmapped once the blocks still pinned by readers are released
+    mapping_.reset();
     managed_shm_ = nullptr;
     return;
   }
@@ -106,13 +106,25 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
 }
 
 void Segment::ReleaseReadBlock(const ReadableBlock& readable_block) {
-  auto index = readable_block.index;
-  if (index >= conf_.block_num()) {
-    return;
-  }
-  blocks_[index].ReleaseReadLock();
+  // the block may belong to a mapping that was replaced since it was read,
+  // its holder keeps that mapping attached
+  RETURN_IF_NULL(readable_block.block);
+  readable_block.block->ReleaseReadLock();
+}
+
+bool Segment::TryPinBlock() {
+  uint32_t max_pinned = conf_.block_num() / 2;
+  uint32_t pinned = pinned_blocks_.load();
+  do {
+    if (pinned >= max_pinned) {
+      return false;
+    }
+  } while (!pinned_blocks_.compare_exchange_weak(pinned, pinned + 1));
+  return true;
 }
 
+void Segment::UnpinBlock() { pinned_blocks_.fetch_sub(1); }
+
 bool Segment::Destroy() {
   if (!init_) {
     return true;
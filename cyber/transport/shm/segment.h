@@ -17,6 +17,7 @@
 #ifndef CYBER_TRANSPORT_SHM_SEGMENT_H_
 #define CYBER_TRANSPORT_SHM_SEGMENT_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -38,7 +39,11 @@ struct WritableBlock {
   Block* block = nullptr;
   uint8_t* buf = nullptr;
 };
-using ReadableBlock = WritableBlock;
+
+struct ReadableBlock : public WritableBlock {
+  // the segment the block was read from, set by readers that may pin it
+  Segment* segment = nullptr;
+};
 
 class Segment {
  public:
@@ -51,6 +56,15 @@ class Segment {
   bool AcquireBlockToRead(ReadableBlock* readable_block);
   void ReleaseReadBlock(const ReadableBlock& readable_block);
 
+  // Keeps the current mapping attached, so that a block acquired from it stays
+  // valid after the segment is remapped or recreated.
+  std::shared_ptr<void> mapping() const { return mapping_; }
+
+  // Zero-copy readers of this process may keep at most half of the blocks
+  // read-locked after delivery, so that writers always find a free block.
+  bool TryPinBlock();
+  void UnpinBlock();
+
  protected:
   virtual bool Destroy();
   virtual void Reset() = 0;
@@ -67,6 +81,9 @@ class Segment {
   void* managed_shm_;
   std::mutex block_buf_lock_;
   std::unordered_map<uint32_t, uint8_t*> block_buf_addrs_;
+  // unmaps managed_shm_ when the last holder of the mapping releases it
+  std::shared_ptr<void> mapping_;
+  std::atomic<uint32_t> pinned_blocks_ = {0};
 
  private:
   bool Remap();
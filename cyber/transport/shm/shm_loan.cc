@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/shm_loan.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+ShmLoan::ShmLoan(const SegmentPtr& segment,
+                 const WritableBlock& writable_block, std::size_t capacity)
+    : segment_(segment),
+      writable_block_(writable_block),
+      capacity_(capacity),
+      size_(capacity),
+      committed_(false) {}
+
+ShmLoan::~ShmLoan() {
+  if (!committed_ && segment_ != nullptr) {
+    ADEBUG << "loan of block " << writable_block_.index
+           << " dropped without commit.";
+    segment_->ReleaseWrittenBlock(writable_block_);
+  }
+}
+
+bool ShmLoan::set_size(std::size_t size) {
+  if (size > capacity_) {
+    AERROR << "loan size " << size << " exceeds capacity " << capacity_;
+    return false;
+  }
+  size_ = size;
+  return true;
+}
+
+bool ShmLoan::Commit(const MessageInfo& msg_info) {
+  if (committed_) {
+    AERROR << "loan of block " << writable_block_.index
+           << " is already committed.";
+    return false;
+  }
+
+  writable_block_.block->set_msg_size(size_);
+  char* msg_info_addr = reinterpret_cast<char*>(writable_block_.buf) + size_;
+  if (!msg_info.SerializeTo(msg_info_addr, MessageInfo::kSize)) {
+    AERROR << "serialize message info failed.";
+    return false;
+  }
+  writable_block_.block->set_msg_info_size(MessageInfo::kSize);
+  segment_->ReleaseWrittenBlock(writable_block_);
+  committed_ = true;
+  return true;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_SHM_LOAN_H_
+#define CYBER_TRANSPORT_SHM_SHM_LOAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "cyber/transport/message/message_info.h"
+#include "cyber/transport/shm/segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+class ShmLoan;
+using ShmLoanPtr = std::shared_ptr<ShmLoan>;
+
+/**
+ * @class ShmLoan
+ * @brief A shared memory block lent to a writer, so that the serialized
+ * message can be filled in place instead of being copied by the transmitter.
+ * The block stays write-locked until the loan is committed or destroyed.
+ * A loan must be committed or dropped before the next Loan/Write on the same
+ * writer, because a segment resize would invalidate its buffer.
+ */
+class ShmLoan {
+ public:
+  ShmLoan(const SegmentPtr& segment, const WritableBlock& writable_block,
+          std::size_t capacity);
+  virtual ~ShmLoan();
+
+  ShmLoan(const ShmLoan&) = delete;
+  ShmLoan& operator=(const ShmLoan&) = delete;
+
+  uint8_t* buf() const { return writable_block_.buf; }
+  std::size_t capacity() const { return capacity_; }
+
+  std::size_t size() const { return size_; }
+  bool set_size(std::size_t size);
+
+  const WritableBlock& block() const { return writable_block_; }
+  const SegmentPtr& segment() const { return segment_; }
+  bool committed() const { return committed_; }
+
+  // Appends msg_info after the payload and hands the block over to readers.
+  bool Commit(const MessageInfo& msg_info);
+
+ private:
+  SegmentPtr segment_;
+  WritableBlock writable_block_;
+  std::size_t capacity_;
+  std::size_t size_;
+  bool committed_;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_SHM_LOAN_H_
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares the serialize/copy/parse shm path against loaned blocks read
+// through ShmMessageView, for payloads from 1 KB to 8 MB.
+//
+//   bazel run -c opt //cyber/transport:shm_loan_benchmark
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/common/util.h"
+#include "cyber/transport/shm/segment_factory.h"
+#include "cyber/transport/shm/shm_loan.h"
+#include "cyber/transport/shm/shm_message_view.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+uint64_t ChannelId(const std::string& name, int64_t size) {
+  return common::Hash(name + std::to_string(size));
+}
+
+std::shared_ptr<ReadableBlock> PinForRead(const SegmentPtr& segment,
+                                          uint32_t index) {
+  ReadableBlock readable_block;
+  readable_block.index = index;
+  if (!segment->AcquireBlockToRead(&readable_block)) {
+    return nullptr;
+  }
+  return std::shared_ptr<ReadableBlock>(
+      new ReadableBlock(readable_block), [segment](ReadableBlock* block) {
+        segment->ReleaseReadBlock(*block);
+        delete block;
+      });
+}
+
+}  // namespace
+
+// Writer fills a proto, ShmTransmitter serializes it into the block and the
+// reader parses it into a fresh message, as Transmit/ReadMessage do today.
+static void BM_ShmSerializeCopy(benchmark::State& state) {
+  const auto size = state.range(0);
+  const uint64_t channel_id = ChannelId("bm_shm_copy_", size);
+  auto writer = SegmentFactory::CreateSegment(channel_id);
+  auto reader = SegmentFactory::CreateSegment(channel_id);
+  const std::string frame(size, 'x');
+
+  for (auto _ : state) {
+    proto::Chatter chatter;
+    chatter.set_content(frame);
+    std::size_t msg_size = chatter.ByteSizeLong();
+    WritableBlock wb;
+    if (!writer->AcquireBlockToWrite(msg_size, &wb)) {
+      state.SkipWithError("acquire block failed");
+      break;
+    }
+    chatter.SerializeToArray(wb.buf, static_cast<int>(msg_size));
+    wb.block->set_msg_size(msg_size);
+    writer->ReleaseWrittenBlock(wb);
+
+    auto rb = PinForRead(reader, wb.index);
+    if (rb == nullptr) {
+      state.SkipWithError("acquire block to read failed");
+      break;
+    }
+    auto msg = std::make_shared<proto::Chatter>();
+    msg->ParseFromArray(rb->buf, static_cast<int>(rb->block->msg_size()));
+    benchmark::DoNotOptimize(msg->content().data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ShmSerializeCopy)->RangeMultiplier(8)->Range(1 << 10, 8 << 20);
+
+// Writer fills the loaned block in place and the reader keeps a pinned view.
+static void BM_ShmLoanView(benchmark::State& state) {
+  const auto size = state.range(0);
+  const uint64_t channel_id = ChannelId("bm_shm_loan_", size);
+  auto writer = SegmentFactory::CreateSegment(channel_id);
+  auto reader = SegmentFactory::CreateSegment(channel_id);
+  const std::string frame(size, 'x');
+  MessageInfo msg_info;
+
+  for (auto _ : state) {
+    WritableBlock wb;
+    if (!writer->AcquireBlockToWrite(size, &wb)) {
+      state.SkipWithError("acquire block failed");
+      break;
+    }
+    uint32_t index = wb.index;
+    {
+      ShmLoan loan(writer, wb, size);
+      memcpy(loan.buf(), frame.data(), size);
+      loan.Commit(msg_info);
+    }
+
+    auto rb = PinForRead(reader, index);
+    if (rb == nullptr) {
+      state.SkipWithError("acquire block to read failed");
+      break;
+    }
+    auto view = std::make_shared<ShmMessageView>(rb);
+    benchmark::DoNotOptimize(view->data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ShmLoanView)->RangeMultiplier(8)->Range(1 << 10, 8 << 20);
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
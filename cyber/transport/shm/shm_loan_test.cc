@@ -0,0 +1,190 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/shm_loan.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/util.h"
+#include "cyber/init.h"
+#include "cyber/transport/common/identity.h"
+#include "cyber/transport/shm/shm_message_view.h"
+#include "cyber/transport/transport.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+RoleAttributes MakeAttr(const std::string& channel_name) {
+  RoleAttributes attr;
+  attr.set_host_name(common::GlobalData::Instance()->HostName());
+  attr.set_host_ip(common::GlobalData::Instance()->HostIp());
+  attr.set_channel_name(channel_name);
+  attr.set_channel_id(common::Hash(channel_name));
+  Identity id;
+  attr.set_id(id.HashValue());
+  return attr;
+}
+
+TEST(ShmLoanTest, loan_and_publish) {
+  auto attr = MakeAttr("shm_loan_publish");
+  auto transmitter = Transport::Instance()->CreateTransmitter<proto::Chatter>(
+      attr, proto::OptionalMode::SHM);
+  ASSERT_NE(transmitter, nullptr);
+
+  std::shared_ptr<ShmMessageView> recv_view = nullptr;
+  auto self_attr = MakeAttr("shm_loan_publish");
+  ShmDispatcher::Instance()->AddListener<ShmMessageView>(
+      self_attr, [&recv_view](const std::shared_ptr<ShmMessageView>& view,
+                              const MessageInfo&) { recv_view = view; });
+
+  proto::Chatter chatter;
+  chatter.set_seq(7);
+  chatter.set_content(std::string(64 * 1024, 'x'));
+  std::size_t size = chatter.ByteSizeLong();
+
+  auto loan = transmitter->Loan(size);
+  ASSERT_NE(loan, nullptr);
+  EXPECT_EQ(loan->capacity(), size);
+  EXPECT_FALSE(loan->set_size(size + 1));
+  ASSERT_TRUE(chatter.SerializeToArray(loan->buf(), static_cast<int>(size)));
+  EXPECT_TRUE(transmitter->Publish(loan));
+  EXPECT_TRUE(loan->committed());
+  EXPECT_FALSE(transmitter->Publish(loan));
+
+  sleep(1);
+  ASSERT_NE(recv_view, nullptr);
+  EXPECT_TRUE(recv_view->is_zero_copy());
+  EXPECT_EQ(recv_view->size(), size);
+  proto::Chatter recv_chatter;
+  EXPECT_TRUE(recv_view->ParseTo(&recv_chatter));
+  EXPECT_EQ(recv_chatter.seq(), 7);
+  EXPECT_EQ(recv_chatter.content(), chatter.content());
+  recv_view = nullptr;
+}
+
+TEST(ShmLoanTest, drop_without_publish) {
+  auto attr = MakeAttr("shm_loan_drop");
+  auto transmitter = Transport::Instance()->CreateTransmitter<proto::Chatter>(
+      attr, proto::OptionalMode::SHM);
+  ASSERT_NE(transmitter, nullptr);
+
+  // every block must be returned to the segment, otherwise the second round
+  // of loans could not be served.
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 1024; ++i) {
+      auto loan = transmitter->Loan(128);
+      ASSERT_NE(loan, nullptr);
+      EXPECT_FALSE(loan->committed());
+    }
+  }
+}
+
+TEST(ShmLoanTest, pinned_views) {
+  auto attr = MakeAttr("shm_loan_pins");
+  auto transmitter = Transport::Instance()->CreateTransmitter<proto::Chatter>(
+      attr, proto::OptionalMode::SHM);
+  ASSERT_NE(transmitter, nullptr);
+
+  std::mutex views_mutex;
+  std::vector<std::shared_ptr<ShmMessageView>> views;
+  auto self_attr = MakeAttr("shm_loan_pins");
+  ShmDispatcher::Instance()->AddListener<ShmMessageView>(
+      self_attr, [&views, &views_mutex](
+                     const std::shared_ptr<ShmMessageView>& view,
+                     const MessageInfo&) {
+        std::lock_guard<std::mutex> lock(views_mutex);
+        views.push_back(view);
+      });
+
+  // the segment starts with 512 blocks, of which at most 256 may be pinned
+  const int kMsgNum = 300;
+  for (int i = 0; i < kMsgNum; ++i) {
+    auto chatter = std::make_shared<proto::Chatter>();
+    chatter->set_seq(i);
+    ASSERT_TRUE(transmitter->Transmit(chatter));
+    usleep(1000);
+  }
+  sleep(1);
+
+  std::unique_lock<std::mutex> lock(views_mutex);
+  ASSERT_GT(views.size(), 256U);
+  std::size_t zero_copy = 0;
+  for (const auto& view : views) {
+    zero_copy += view->is_zero_copy() ? 1 : 0;
+  }
+  EXPECT_EQ(256U, zero_copy);
+
+  // a larger message recreates the segment, the pinned views stay readable
+  auto large = std::make_shared<proto::Chatter>();
+  large->set_seq(kMsgNum);
+  large->set_content(std::string(1024 * 1024, 'x'));
+  lock.unlock();
+  ASSERT_TRUE(transmitter->Transmit(large));
+  sleep(1);
+  lock.lock();
+  ASSERT_FALSE(views.empty());
+  proto::Chatter recv_chatter;
+  EXPECT_TRUE(views.back()->ParseTo(&recv_chatter));
+  EXPECT_EQ(kMsgNum, recv_chatter.seq());
+  for (std::size_t i = 0; i + 1 < views.size(); ++i) {
+    EXPECT_TRUE(views[i]->ParseTo(&recv_chatter));
+    EXPECT_FALSE(recv_chatter.has_content());
+  }
+  views.clear();
+}
+
+TEST(ShmLoanTest, view_owns_copied_data) {
+  ShmMessageView view;
+  std::string data("raw bytes");
+  EXPECT_TRUE(view.ParseFromString(data));
+  EXPECT_FALSE(view.is_zero_copy());
+  ShmMessageView copy(view);
+  std::string out;
+  EXPECT_TRUE(copy.SerializeToString(&out));
+  EXPECT_EQ(out, data);
+  EXPECT_EQ(copy.ByteSize(), static_cast<int>(data.size()));
+}
+
+TEST(ShmLoanTest, non_shm_transmitter) {
+  auto attr = MakeAttr("shm_loan_intra");
+  auto transmitter = Transport::Instance()->CreateTransmitter<proto::Chatter>(
+      attr, proto::OptionalMode::INTRA);
+  ASSERT_NE(transmitter, nullptr);
+  EXPECT_EQ(transmitter->Loan(128), nullptr);
+  EXPECT_FALSE(transmitter->Publish(nullptr));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  apollo::cyber::Init(argv[0]);
+  apollo::cyber::transport::Transport::Instance();
+  auto res = RUN_ALL_TESTS();
+  apollo::cyber::transport::Transport::Instance()->Shutdown();
+  return res;
+}
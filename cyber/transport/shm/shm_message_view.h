@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_SHM_MESSAGE_VIEW_H_
+#define CYBER_TRANSPORT_SHM_SHM_MESSAGE_VIEW_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "cyber/message/protobuf_factory.h"
+#include "cyber/transport/shm/segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class ShmMessageView
+ * @brief Read-only view of a serialized message. When delivered by the shared
+ * memory dispatcher it points straight into the segment, and the block stays
+ * read-locked until the last copy of the view is released. Messages arriving
+ * from the intra or rtps path, or while the segment has no pins left, are
+ * copied into an owned buffer instead, so a Reader<ShmMessageView> behaves
+ * like a Reader<RawMessage> on every transport.
+ */
+class ShmMessageView {
+ public:
+  ShmMessageView() : pinned_block_(nullptr), data_(nullptr), size_(0) {}
+
+  explicit ShmMessageView(const std::shared_ptr<ReadableBlock>& pinned_block)
+      : pinned_block_(pinned_block),
+        data_(pinned_block->buf),
+        size_(pinned_block->block->msg_size()) {}
+
+  ShmMessageView(const ShmMessageView& other) { *this = other; }
+
+  ShmMessageView& operator=(const ShmMessageView& other) {
+    if (this != &other) {
+      pinned_block_ = other.pinned_block_;
+      owned_ = other.owned_;
+      if (pinned_block_ != nullptr) {
+        data_ = other.data_;
+      } else {
+        data_ = reinterpret_cast<const uint8_t*>(owned_.data());
+      }
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  const uint8_t* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool is_zero_copy() const { return pinned_block_ != nullptr; }
+
+  template <typename MessageT>
+  bool ParseTo(MessageT* message) const {
+    return message != nullptr &&
+           message->ParseFromArray(data_, static_cast<int>(size_));
+  }
+
+  class Descriptor {
+   public:
+    std::string full_name() const {
+      return "apollo.cyber.transport.ShmMessageView";
+    }
+    std::string name() const { return "apollo.cyber.transport.ShmMessageView"; }
+  };
+
+  static const Descriptor* descriptor() {
+    static Descriptor desc;
+    return &desc;
+  }
+
+  static void GetDescriptorString(const std::string& type,
+                                  std::string* desc_str) {
+    message::ProtobufFactory::Instance()->GetDescriptorString(type, desc_str);
+  }
+
+  bool SerializeToArray(void* data, int size) const {
+    if (data == nullptr || size < ByteSize()) {
+      return false;
+    }
+    memcpy(data, data_, size_);
+    return true;
+  }
+
+  bool SerializeToString(std::string* str) const {
+    if (str == nullptr) {
+      return false;
+    }
+    str->assign(reinterpret_cast<const char*>(data_), size_);
+    return true;
+  }
+
+  bool ParseFromArray(const void* data, int size) {
+    if (data == nullptr || size <= 0) {
+      return false;
+    }
+    pinned_block_ = nullptr;
+    owned_.assign(reinterpret_cast<const char*>(data), size);
+    data_ = reinterpret_cast<const uint8_t*>(owned_.data());
+    size_ = owned_.size();
+    return true;
+  }
+
+  bool ParseFromString(const std::string& str) {
+    pinned_block_ = nullptr;
+    owned_ = str;
+    data_ = reinterpret_cast<const uint8_t*>(owned_.data());
+    size_ = owned_.size();
+    return true;
+  }
+
+  int ByteSize() const { return static_cast<int>(size_); }
+  std::size_t ByteSizeLong() const { return size_; }
+
+  static std::string TypeName() {
+    return "apollo.cyber.transport.ShmMessageView";
+  }
+
+ private:
+  std::shared_ptr<ReadableBlock> pinned_block_;
+  std::string owned_;
+  const uint8_t* data_;
+  std::size_t size_;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_SHM_MESSAGE_VIEW_H_
@@ -127,6 +127,7 @@ bool XsiSegment::OpenOrCreate() {
     return false;
   }
 
+  mapping_.reset(managed_shm_, [](void* addr) { shmdt(addr); });
   state_->IncreaseReferenceCounts();
   init_ = true;
   ADEBUG << "open or create true.";
@@ -203,6 +204,7 @@ bool XsiSegment::OpenOnly() {
     return false;
   }
 
+  mapping_.reset(managed_shm_, [](void* addr) { shmdt(addr); });
   state_->IncreaseReferenceCounts();
   init_ = true;
   ADEBUG << "open only true.";
@@ -227,7 +229,8 @@ void XsiSegment::Reset() {
     block_buf_addrs_.clear();
   }
   if (managed_shm_ != nullptr) {
-    shmdt(managed_shm_);
+    // detached once the blocks still pinned by readers are released
+    mapping_.reset();
     managed_shm_ = nullptr;
     return;
   }
@@ -31,6 +31,7 @@
 #include "cyber/proto/role_attributes.pb.h"
 #include "cyber/proto/transport_conf.pb.h"
 #include "cyber/task/task.h"
+#include "cyber/transport/message/envelope.h"
 #include "cyber/transport/message/history.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/transmitter/intra_transmitter.h"
@@ -71,6 +72,9 @@ class HybridTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  ShmLoanPtr Loan(std::size_t size) override;
+  bool Publish(const ShmLoanPtr& loan, const MessageInfo& msg_info) override;
+
  private:
   void InitMode();
   void ObtainConfig();
@@ -165,12 +169,67 @@ bool HybridTransmitter<M>::Transmit(const MessagePtr& msg,
                                     const MessageInfo& msg_info) {
   std::lock_guard<std::mutex> lock(mutex_);
   history_->Add(msg, msg_info);
+  // serialized once for the transmitters that write bytes
+  OutboundEnvelope<M> envelope(msg);
+  int writes = 0;
+  for (auto& item : transmitters_) {
+    if (item.first != OptionalMode::INTRA && !receivers_[item.first].empty()) {
+      ++writes;
+    }
+  }
+  envelope.ExpectWrites(writes);
   for (auto& item : transmitters_) {
     item.second->Transmit(msg, msg_info);
   }
   return true;
 }
 
+template <typename M>
+ShmLoanPtr HybridTransmitter<M>::Loan(std::size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto shm_itr = transmitters_.find(OptionalMode::SHM);
+  if (shm_itr == transmitters_.end() ||
+      receivers_[OptionalMode::SHM].empty()) {
+    return nullptr;
+  }
+  return shm_itr->second->Loan(size);
+}
+
+template <typename M>
+bool HybridTransmitter<M>::Publish(const ShmLoanPtr& loan,
+                                   const MessageInfo& msg_info) {
+  RETURN_VAL_IF_NULL(loan, false);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // receivers outside the shm path still need a message object, parse it
+  // from the loaned block before the block is handed over to shm readers.
+  MessagePtr msg = nullptr;
+  bool need_msg = history_->enabled();
+  for (auto& item : transmitters_) {
+    if (item.first != OptionalMode::SHM && !receivers_[item.first].empty()) {
+      need_msg = true;
+    }
+  }
+  if (need_msg) {
+    msg = std::make_shared<M>();
+    if (!message::ParseFromArray(loan->buf(), static_cast<int>(loan->size()),
+                                 msg.get())) {
+      AERROR << "parse loaned message failed.";
+      return false;
+    }
+    history_->Add(msg, msg_info);
+  }
+
+  bool result = true;
+  for (auto& item : transmitters_) {
+    if (item.first == OptionalMode::SHM) {
+      result = item.second->Publish(loan, msg_info) && result;
+    } else if (msg != nullptr) {
+      item.second->Transmit(msg, msg_info);
+    }
+  }
+  return result;
+}
+
 template <typename M>
 void HybridTransmitter<M>::InitMode() {
   mode_ = std::make_shared<proto::CommunicationMode>();
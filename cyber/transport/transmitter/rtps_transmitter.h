@@ -20,9 +20,14 @@
 #include <memory>
 #include <string>
 
+#include "cyber/proto/transport_conf.pb.h"
+
+#include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/message/message_traits.h"
+#include "cyber/transport/message/envelope.h"
 #include "cyber/transport/rtps/attributes_filler.h"
+#include "cyber/transport/rtps/message_batch.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/transmitter/transmitter.h"
 #include "fastrtps/Domain.h"
@@ -34,6 +39,12 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+/**
+ * @brief Publishes messages as rtps samples. Messages that protobuf can
+ * serialize into an array are serialized straight into the sample. With
+ * RtpsConf.batch_window_us set, small messages are coalesced into
+ * MessageBatch samples.
+ */
 template <typename M>
 class RtpsTransmitter : public Transmitter<M> {
  public:
@@ -49,16 +60,24 @@ class RtpsTransmitter : public Transmitter<M> {
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
  private:
-  bool Transmit(const M& msg, const MessageInfo& msg_info);
+  bool Transmit(OutboundEnvelope<M>* envelope, const M& msg,
+                const MessageInfo& msg_info);
 
   ParticipantPtr participant_;
   eprosima::fastrtps::Publisher* publisher_;
+  proto::RtpsConf conf_;
+  std::shared_ptr<MessageBatch> batch_;
 };
 
 template <typename M>
 RtpsTransmitter<M>::RtpsTransmitter(const RoleAttributes& attr,
                                     const ParticipantPtr& participant)
-    : Transmitter<M>(attr), participant_(participant), publisher_(nullptr) {}
+    : Transmitter<M>(attr), participant_(participant), publisher_(nullptr) {
+  auto& global_conf = common::GlobalData::Instance()->Config();
+  if (global_conf.has_transport_conf()) {
+    conf_.CopyFrom(global_conf.transport_conf().rtps_conf());
+  }
+}
 
 template <typename M>
 RtpsTransmitter<M>::~RtpsTransmitter() {
@@ -76,15 +95,33 @@ void RtpsTransmitter<M>::Enable() {
   eprosima::fastrtps::PublisherAttributes pub_attr;
   RETURN_IF(!AttributesFiller::FillInPubAttr(
       this->attr_.channel_name(), this->attr_.qos_profile(), &pub_attr));
+  if (conf_.flow_control_bytes_per_period() > 0) {
+    pub_attr.throughputController.bytesPerPeriod =
+        conf_.flow_control_bytes_per_period();
+    pub_attr.throughputController.periodMillisecs =
+        conf_.flow_control_period_ms();
+  }
   publisher_ = eprosima::fastrtps::Domain::createPublisher(
       participant_->fastrtps_participant(), pub_attr);
   RETURN_IF_NULL(publisher_);
+  if (conf_.batch_window_us() > 0) {
+    batch_ = std::make_shared<MessageBatch>(
+        conf_.batch_window_us(), conf_.batch_max_bytes(),
+        [this](UnderlayMessage* sample) {
+          return !participant_->is_shutdown() &&
+                 publisher_->write(reinterpret_cast<void*>(sample));
+        });
+  }
   this->enabled_ = true;
 }
 
 template <typename M>
 void RtpsTransmitter<M>::Disable() {
   if (this->enabled_) {
+    if (batch_ != nullptr) {
+      batch_->Close();
+      batch_ = nullptr;
+    }
     publisher_ = nullptr;
     this->enabled_ = false;
   }
@@ -93,18 +130,43 @@ void RtpsTransmitter<M>::Disable() {
 template <typename M>
 bool RtpsTransmitter<M>::Transmit(const MessagePtr& msg,
                                   const MessageInfo& msg_info) {
-  return Transmit(*msg, msg_info);
+  auto envelope = Envelope::Find<OutboundEnvelope<M>>(msg.get());
+  if (envelope != nullptr) {
+    return Transmit(envelope, *msg, msg_info);
+  }
+  OutboundEnvelope<M> own_envelope(msg);
+  return Transmit(&own_envelope, *msg, msg_info);
 }
 
 template <typename M>
-bool RtpsTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
+bool RtpsTransmitter<M>::Transmit(OutboundEnvelope<M>* envelope, const M& msg,
+                                  const MessageInfo& msg_info) {
   if (!this->enabled_) {
     ADEBUG << "not enable.";
     return false;
   }
 
+  const int size = message::HasSerializeToArray<M>::value
+                       ? envelope->ContentSize()
+                       : -1;
+  auto serialize = [envelope](char* data, uint32_t size) {
+    return envelope->WriteContent(data, static_cast<int>(size));
+  };
+  if (batch_ != nullptr) {
+    if (size >= 0 &&
+        static_cast<uint32_t>(size) <= conf_.batch_max_message_size()) {
+      return batch_->Add(size, msg_info, serialize);
+    }
+    // keep the messages of the writer in order
+    batch_->Flush();
+  }
+
   UnderlayMessage m;
-  RETURN_VAL_IF(!message::SerializeToString(msg, &m.data()), false);
+  if (size >= 0) {
+    m.data_writer(size, serialize);
+  } else {
+    RETURN_VAL_IF(!message::SerializeToString(msg, &m.data()), false);
+  }
 
   eprosima::fastrtps::rtps::WriteParams wparams;
 
@@ -26,6 +26,7 @@
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
 #include "cyber/message/message_traits.h"
+#include "cyber/transport/message/envelope.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/shm/readable_info.h"
 #include "cyber/transport/shm/segment_factory.h"
@@ -48,8 +49,11 @@ class ShmTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  ShmLoanPtr Loan(std::size_t size) override;
+  bool Publish(const ShmLoanPtr& loan, const MessageInfo& msg_info) override;
+
  private:
-  bool Transmit(const M& msg, const MessageInfo& msg_info);
+  bool Transmit(OutboundEnvelope<M>* envelope, const MessageInfo& msg_info);
 
   SegmentPtr segment_;
   uint64_t channel_id_;
@@ -94,25 +98,32 @@ void ShmTransmitter<M>::Disable() {
 template <typename M>
 bool ShmTransmitter<M>::Transmit(const MessagePtr& msg,
                                  const MessageInfo& msg_info) {
-  return Transmit(*msg, msg_info);
+  auto envelope = Envelope::Find<OutboundEnvelope<M>>(msg.get());
+  if (envelope != nullptr) {
+    return Transmit(envelope, msg_info);
+  }
+  OutboundEnvelope<M> own_envelope(msg);
+  return Transmit(&own_envelope, msg_info);
 }
 
 template <typename M>
-bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
+bool ShmTransmitter<M>::Transmit(OutboundEnvelope<M>* envelope,
+                                 const MessageInfo& msg_info) {
   if (!this->enabled_) {
     ADEBUG << "not enable.";
     return false;
   }
 
   WritableBlock wb;
-  std::size_t msg_size = message::ByteSize(msg);
+  std::size_t msg_size = envelope->ContentSize();
   if (!segment_->AcquireBlockToWrite(msg_size, &wb)) {
     AERROR << "acquire block failed.";
     return false;
   }
 
   ADEBUG << "block index: " << wb.index;
-  if (!message::SerializeToArray(msg, wb.buf, static_cast<int>(msg_size))) {
+  if (!envelope->WriteContent(reinterpret_cast<char*>(wb.buf),
+                              static_cast<int>(msg_size))) {
     AERROR << "serialize to array failed.";
     segment_->ReleaseWrittenBlock(wb);
     return false;
@@ -136,6 +147,47 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   return notifier_->Notify(readable_info);
 }
 
+template <typename M>
+ShmLoanPtr ShmTransmitter<M>::Loan(std::size_t size) {
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    return nullptr;
+  }
+
+  WritableBlock wb;
+  if (!segment_->AcquireBlockToWrite(size, &wb)) {
+    AERROR << "acquire block failed.";
+    return nullptr;
+  }
+  return std::make_shared<ShmLoan>(segment_, wb, size);
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Publish(const ShmLoanPtr& loan,
+                                const MessageInfo& msg_info) {
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    return false;
+  }
+  RETURN_VAL_IF_NULL(loan, false);
+  if (loan->segment() != segment_) {
+    AERROR << "loan does not belong to this transmitter.";
+    return false;
+  }
+
+  uint32_t index = loan->block().index;
+  if (!loan->Commit(msg_info)) {
+    return false;
+  }
+
+  ReadableInfo readable_info(host_id_, index, channel_id_);
+
+  ADEBUG << "Publishing loaned sharedmem message: "
+         << common::GlobalData::GetChannelById(channel_id_)
+         << " to block: " << index;
+  return notifier_->Notify(readable_info);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
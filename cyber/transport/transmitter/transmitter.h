@@ -24,6 +24,7 @@
 #include "cyber/event/perf_event_cache.h"
 #include "cyber/transport/common/endpoint.h"
 #include "cyber/transport/message/message_info.h"
+#include "cyber/transport/shm/shm_loan.h"
 
 namespace apollo {
 namespace cyber {
@@ -49,6 +50,11 @@ class Transmitter : public Endpoint {
   virtual bool Transmit(const MessagePtr& msg);
   virtual bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) = 0;
 
+  // Zero-copy path, only supported by transmitters with a shm segment.
+  virtual ShmLoanPtr Loan(std::size_t size);
+  virtual bool Publish(const ShmLoanPtr& loan);
+  virtual bool Publish(const ShmLoanPtr& loan, const MessageInfo& msg_info);
+
   uint64_t NextSeqNum() { return ++seq_num_; }
 
   uint64_t seq_num() const { return seq_num_; }
@@ -76,6 +82,28 @@ bool Transmitter<M>::Transmit(const MessagePtr& msg) {
   return Transmit(msg, msg_info_);
 }
 
+template <typename M>
+ShmLoanPtr Transmitter<M>::Loan(std::size_t size) {
+  (void)size;
+  return nullptr;
+}
+
+template <typename M>
+bool Transmitter<M>::Publish(const ShmLoanPtr& loan) {
+  msg_info_.set_seq_num(NextSeqNum());
+  PerfEventCache::Instance()->AddTransportEvent(
+      TransPerf::TRANSMIT_BEGIN, attr_.channel_id(), msg_info_.seq_num());
+  return Publish(loan, msg_info_);
+}
+
+template <typename M>
+bool Transmitter<M>::Publish(const ShmLoanPtr& loan,
+                             const MessageInfo& msg_info) {
+  (void)loan;
+  (void)msg_info;
+  return false;
+}
+
 template <typename M>
 void Transmitter<M>::Enable(const RoleAttributes& opposite_attr) {
   (void)opposite_attr;
@@ -17,6 +17,7 @@
 #include "cyber/transport/transport.h"
 
 #include "cyber/common/global_data.h"
+#include "cyber/transport/rtps/message_batch.h"
 
 namespace apollo {
 namespace cyber {
@@ -38,6 +39,8 @@ void Transport::Shutdown() {
     return;
   }
 
+  // send the batches still pending while the participant is up
+  BatchFlusher::CleanUp();
   intra_dispatcher_->Shutdown();
   shm_dispatcher_->Shutdown();
   rtps_dispatcher_->Shutdown();
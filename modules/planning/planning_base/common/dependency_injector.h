@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <memory>
+#include <utility>
+
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/planning/planning_base/common/ego_info.h"
 #include "modules/planning/planning_base/common/frame.h"
@@ -29,18 +32,30 @@ namespace planning {
 class DependencyInjector {
  public:
   DependencyInjector() = default;
+  /**
+   * @brief An injector with a planning context of its own, sharing
+   * everything else with `shared`, for the tasks of a reference line that
+   * is planned next to others.
+   */
+  explicit DependencyInjector(std::shared_ptr<DependencyInjector> shared)
+      : shared_(std::move(shared)) {}
   ~DependencyInjector() = default;
 
   PlanningContext* planning_context() { return &planning_context_; }
-  FrameHistory* frame_history() { return &frame_history_; }
-  History* history() { return &history_; }
-  EgoInfo* ego_info() { return &ego_info_; }
+  FrameHistory* frame_history() {
+    return shared_ ? shared_->frame_history() : &frame_history_;
+  }
+  History* history() { return shared_ ? shared_->history() : &history_; }
+  EgoInfo* ego_info() { return shared_ ? shared_->ego_info() : &ego_info_; }
   apollo::common::VehicleStateProvider* vehicle_state() {
-    return &vehicle_state_;
+    return shared_ ? shared_->vehicle_state() : &vehicle_state_;
+  }
+  LearningBasedData* learning_based_data() {
+    return shared_ ? shared_->learning_based_data() : &learning_based_data_;
   }
-  LearningBasedData* learning_based_data() { return &learning_based_data_; }
 
  private:
+  std::shared_ptr<DependencyInjector> shared_;
   PlanningContext planning_context_;
   FrameHistory frame_history_;
   History history_;
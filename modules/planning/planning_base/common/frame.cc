@@ -310,13 +310,15 @@ const Obstacle *Frame::CreateStaticObstacle(
 
 const Obstacle *Frame::CreateStaticVirtualObstacle(const std::string &id,
                                                    const Box2d &box) {
+  std::lock_guard<std::mutex> lock(virtual_obstacle_mutex_);
   const auto *object = obstacles_.Find(id);
   if (object) {
     AWARN << "obstacle " << id << " already exist.";
     return object;
   }
-  auto *ptr =
-      obstacles_.Add(id, *Obstacle::CreateStaticVirtualObstacles(id, box));
+  auto obstacle = Obstacle::CreateStaticVirtualObstacles(id, box);
+  obstacle->SetIndex(static_cast<int32_t>(obstacles_.Size()));
+  auto *ptr = obstacles_.Add(id, *obstacle);
   if (!ptr) {
     AERROR << "Failed to create virtual obstacle " << id;
   }
@@ -364,13 +366,13 @@ Status Frame::InitFrameData(
          << FLAGS_align_prediction_time;
 
   if (FLAGS_align_prediction_time) {
-    auto prediction = *(local_view_.prediction_obstacles);
-    AlignPredictionTime(vehicle_state_.timestamp(), &prediction);
-    local_view_.prediction_obstacles->CopyFrom(prediction);
+    AlignPredictionTime(vehicle_state_.timestamp(),
+                        local_view_.prediction_obstacles.get());
   }
-  for (auto &ptr :
-       Obstacle::CreateObstacles(*local_view_.prediction_obstacles)) {
-    AddObstacle(*ptr);
+  auto obstacles = Obstacle::CreateObstacles(*local_view_.prediction_obstacles);
+  obstacles_.Reserve(obstacles.size());
+  for (auto &ptr : obstacles) {
+    AddObstacle(ptr.get());
   }
   if (planning_start_point_.v() < 1e-3) {
     const auto *collision_obstacle = FindCollisionObstacle(ego_info);
@@ -474,8 +476,11 @@ void Frame::AlignPredictionTime(const double planning_start_time,
 
 Obstacle *Frame::Find(const std::string &id) { return obstacles_.Find(id); }
 
-void Frame::AddObstacle(const Obstacle &obstacle) {
-  obstacles_.Add(obstacle.Id(), obstacle);
+void Frame::AddObstacle(Obstacle *obstacle) {
+  const auto *existing = obstacles_.Find(obstacle->Id());
+  obstacle->SetIndex(existing ? existing->Index()
+                              : static_cast<int32_t>(obstacles_.Size()));
+  obstacles_.Add(obstacle->Id(), *obstacle);
 }
 
 void Frame::ReadTrafficLights() {
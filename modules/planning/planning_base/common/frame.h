@@ -22,6 +22,7 @@
 
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -195,7 +196,11 @@ class Frame {
   const Obstacle *CreateStaticVirtualObstacle(const std::string &id,
                                               const common::math::Box2d &box);
 
-  void AddObstacle(const Obstacle &obstacle);
+  /**
+   * @brief add the obstacle to the frame, giving it the next Obstacle::Index()
+   * unless an obstacle of its id is in the frame already.
+   */
+  void AddObstacle(Obstacle *obstacle);
 
   void ReadTrafficLights();
 
@@ -219,6 +224,9 @@ class Frame {
   const ReferenceLineInfo *drive_reference_line_info_ = nullptr;
 
   ThreadSafeIndexedObstacles obstacles_;
+  // keeps tasks planning reference lines in parallel from creating the same
+  // virtual obstacle at once
+  std::mutex virtual_obstacle_mutex_;
 
   std::unordered_map<std::string, const perception::TrafficLight *>
       traffic_lights_;
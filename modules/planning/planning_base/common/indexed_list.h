@@ -43,17 +43,24 @@ class IndexedList {
    * @return The pointer to the object in the container.
    */
   T* Add(const I id, const T& object) {
-    auto obs = Find(id);
-    if (obs) {
+    auto iter = object_dict_.find(id);
+    if (iter != object_dict_.end()) {
       AWARN << "object " << id << " is already in container";
-      *obs = object;
-      return obs;
-    } else {
-      object_dict_.insert({id, object});
-      auto* ptr = &object_dict_.at(id);
-      object_list_.push_back(ptr);
-      return ptr;
+      iter->second = object;
+      return &iter->second;
     }
+    auto* ptr = &object_dict_.emplace(id, object).first->second;
+    object_list_.push_back(ptr);
+    return ptr;
+  }
+
+  /**
+   * @brief reserve room for the objects to be added to the container.
+   * @param size the number of objects the container is to hold.
+   */
+  void Reserve(const size_t size) {
+    object_dict_.reserve(size);
+    object_list_.reserve(size);
   }
 
   /**
@@ -76,6 +83,11 @@ class IndexedList {
     return apollo::common::util::FindOrNull(object_dict_, id);
   }
 
+  /**
+   * @brief the number of objects in the container.
+   */
+  size_t Size() const { return object_list_.size(); }
+
   /**
    * @brief List all the items in the container.
    * @return the list of const raw pointers of the objects in the container.
@@ -123,6 +135,16 @@ class ThreadSafeIndexedList : public IndexedList<I, T> {
     return IndexedList<I, T>::Items();
   }
 
+  size_t Size() const {
+    boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
+    return IndexedList<I, T>::Size();
+  }
+
+  void Reserve(const size_t size) {
+    boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
+    IndexedList<I, T>::Reserve(size);
+  }
+
  private:
   mutable boost::shared_mutex mutex_;
 };
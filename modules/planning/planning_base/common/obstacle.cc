@@ -44,6 +44,13 @@ namespace {
 const double kStBoundaryDeltaS = 0.2;        // meters
 const double kStBoundarySparseDeltaS = 1.0;  // meters
 const double kStBoundaryDeltaT = 0.05;       // seconds
+
+// the snapshot of the obstacles constructed without perception
+const std::shared_ptr<ObstacleSnapshot>& EmptySnapshot() {
+  static const auto* const snapshot = new std::shared_ptr<ObstacleSnapshot>(
+      std::make_shared<ObstacleSnapshot>());
+  return *snapshot;
+}
 }  // namespace
 
 const std::unordered_map<ObjectDecisionType::ObjectTagCase, int,
@@ -60,23 +67,29 @@ const std::unordered_map<ObjectDecisionType::ObjectTagCase, int,
     Obstacle::s_lateral_decision_safety_sorter_ = {
         {ObjectDecisionType::kIgnore, 0}, {ObjectDecisionType::kNudge, 100}};
 
+Obstacle::Obstacle() : snapshot_(EmptySnapshot()) {}
+
 Obstacle::Obstacle(const std::string& id,
                    const PerceptionObstacle& perception_obstacle,
                    const ObstaclePriority::Priority& obstacle_priority,
                    const bool is_static)
-    : id_(id),
-      perception_id_(perception_obstacle.id()),
-      perception_obstacle_(perception_obstacle),
-      perception_bounding_box_({perception_obstacle_.position().x(),
-                                perception_obstacle_.position().y()},
-                               perception_obstacle_.theta(),
-                               perception_obstacle_.length(),
-                               perception_obstacle_.width()) {
-  is_caution_level_obstacle_ = (obstacle_priority == ObstaclePriority::CAUTION);
+    : snapshot_(std::make_shared<ObstacleSnapshot>()) {
+  auto& snapshot = *snapshot_;
+  snapshot.id = id;
+  snapshot.perception_id = perception_obstacle.id();
+  snapshot.perception_obstacle = perception_obstacle;
+  snapshot.perception_bounding_box =
+      common::math::Box2d({perception_obstacle.position().x(),
+                           perception_obstacle.position().y()},
+                          perception_obstacle.theta(),
+                          perception_obstacle.length(),
+                          perception_obstacle.width());
+  snapshot.is_caution_level_obstacle =
+      (obstacle_priority == ObstaclePriority::CAUTION);
   std::vector<common::math::Vec2d> polygon_points;
   if (FLAGS_use_navigation_mode ||
       perception_obstacle.polygon_point_size() <= 2) {
-    perception_bounding_box_.GetAllCorners(&polygon_points);
+    snapshot.perception_bounding_box.GetAllCorners(&polygon_points);
   } else {
     ACHECK(perception_obstacle.polygon_point_size() > 2)
         << "object " << id << "has less than 3 polygon points";
@@ -84,15 +97,16 @@ Obstacle::Obstacle(const std::string& id,
       polygon_points.emplace_back(point.x(), point.y());
     }
   }
-  ACHECK(common::math::Polygon2d::ComputeConvexHull(polygon_points,
-                                                    &perception_polygon_))
+  ACHECK(common::math::Polygon2d::ComputeConvexHull(
+      polygon_points, &snapshot.perception_polygon))
       << "object[" << id << "] polygon is not a valid convex hull.\n"
       << perception_obstacle.DebugString();
 
-  is_static_ = (is_static || obstacle_priority == ObstaclePriority::IGNORE);
-  is_virtual_ = (perception_obstacle.id() < 0);
-  speed_ = std::hypot(perception_obstacle.velocity().x(),
-                      perception_obstacle.velocity().y());
+  snapshot.is_static =
+      (is_static || obstacle_priority == ObstaclePriority::IGNORE);
+  snapshot.is_virtual = (perception_obstacle.id() < 0);
+  snapshot.speed = std::hypot(perception_obstacle.velocity().x(),
+                              perception_obstacle.velocity().y());
 }
 
 Obstacle::Obstacle(const std::string& id,
@@ -101,8 +115,8 @@ Obstacle::Obstacle(const std::string& id,
                    const ObstaclePriority::Priority& obstacle_priority,
                    const bool is_static)
     : Obstacle(id, perception_obstacle, obstacle_priority, is_static) {
-  trajectory_ = trajectory;
-  auto& trajectory_points = *trajectory_.mutable_trajectory_point();
+  snapshot_->trajectory = trajectory;
+  auto& trajectory_points = *snapshot_->trajectory.mutable_trajectory_point();
   double cumulative_s = 0.0;
   if (trajectory_points.size() > 0) {
     trajectory_points[0].mutable_path_point()->set_s(0.0);
@@ -121,15 +135,30 @@ Obstacle::Obstacle(const std::string& id,
   }
 }
 
+void Obstacle::SetId(const std::string& id) { mutable_snapshot()->id = id; }
+
+void Obstacle::SetIndex(const int32_t index) {
+  if (snapshot_->index != index) {
+    mutable_snapshot()->index = index;
+  }
+}
+
+ObstacleSnapshot* Obstacle::mutable_snapshot() {
+  if (snapshot_.use_count() > 1) {
+    snapshot_ = std::make_shared<ObstacleSnapshot>(*snapshot_);
+  }
+  return snapshot_.get();
+}
+
 common::TrajectoryPoint Obstacle::GetPointAtTime(
     const double relative_time) const {
-  const auto& points = trajectory_.trajectory_point();
+  const auto& points = Trajectory().trajectory_point();
   if (points.size() < 2) {
     common::TrajectoryPoint point;
-    point.mutable_path_point()->set_x(perception_obstacle_.position().x());
-    point.mutable_path_point()->set_y(perception_obstacle_.position().y());
-    point.mutable_path_point()->set_z(perception_obstacle_.position().z());
-    point.mutable_path_point()->set_theta(perception_obstacle_.theta());
+    point.mutable_path_point()->set_x(Perception().position().x());
+    point.mutable_path_point()->set_y(Perception().position().y());
+    point.mutable_path_point()->set_z(Perception().position().z());
+    point.mutable_path_point()->set_theta(Perception().theta());
     point.mutable_path_point()->set_s(0.0);
     point.mutable_path_point()->set_kappa(0.0);
     point.mutable_path_point()->set_dkappa(0.0);
@@ -159,9 +188,8 @@ common::TrajectoryPoint Obstacle::GetPointAtTime(
 common::math::Box2d Obstacle::GetBoundingBox(
     const common::TrajectoryPoint& point) const {
   return common::math::Box2d({point.path_point().x(), point.path_point().y()},
-                             point.path_point().theta(),
-                             perception_obstacle_.length(),
-                             perception_obstacle_.width());
+                             point.path_point().theta(), Perception().length(),
+                             Perception().width());
 }
 
 bool Obstacle::IsValidPerceptionObstacle(const PerceptionObstacle& obstacle) {
@@ -271,7 +299,7 @@ std::unique_ptr<Obstacle> Obstacle::CreateStaticVirtualObstacles(
   }
   auto* obstacle =
       new Obstacle(id, perception_obstacle, ObstaclePriority::NORMAL, true);
-  obstacle->is_virtual_ = true;
+  obstacle->snapshot_->is_virtual = true;
   return std::unique_ptr<Obstacle>(obstacle);
 }
 
@@ -318,14 +346,14 @@ void Obstacle::BuildReferenceLineStBoundary(const ReferenceLine& reference_line,
   const auto& adc_param =
       VehicleConfigHelper::Instance()->GetConfig().vehicle_param();
   const double half_adc_width = adc_param.width() / 2;
-  if (is_static_ || trajectory_.trajectory_point().empty()) {
+  if (IsStatic() || Trajectory().trajectory_point().empty()) {
     std::vector<std::pair<STPoint, STPoint>> point_pairs;
     double start_s = sl_boundary_.start_s();
     double end_s = sl_boundary_.end_s();
     if (end_s - start_s < kStBoundaryDeltaS) {
       end_s = start_s + kStBoundaryDeltaS;
     }
-    if (!reference_line.IsBlockRoad(perception_bounding_box_, half_adc_width)) {
+    if (!reference_line.IsBlockRoad(PerceptionBoundingBox(), half_adc_width)) {
       return;
     }
     point_pairs.emplace_back(STPoint(start_s - adc_start_s, 0.0),
@@ -336,13 +364,13 @@ void Obstacle::BuildReferenceLineStBoundary(const ReferenceLine& reference_line,
   } else {
     if (BuildTrajectoryStBoundary(reference_line, adc_start_s,
                                   &reference_line_st_boundary_)) {
-      ADEBUG << "Found st_boundary for obstacle " << id_;
+      ADEBUG << "Found st_boundary for obstacle " << Id();
       ADEBUG << "st_boundary: min_t = " << reference_line_st_boundary_.min_t()
              << ", max_t = " << reference_line_st_boundary_.max_t()
              << ", min_s = " << reference_line_st_boundary_.min_s()
              << ", max_s = " << reference_line_st_boundary_.max_s();
     } else {
-      ADEBUG << "No st_boundary for obstacle " << id_;
+      ADEBUG << "No st_boundary for obstacle " << Id();
     }
   }
 }
@@ -350,17 +378,17 @@ void Obstacle::BuildReferenceLineStBoundary(const ReferenceLine& reference_line,
 bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
                                          const double adc_start_s,
                                          STBoundary* const st_boundary) {
-  if (!IsValidObstacle(perception_obstacle_)) {
+  if (!IsValidObstacle(Perception())) {
     AERROR << "Fail to build trajectory st boundary because object is not "
               "valid. PerceptionObstacle: "
-           << perception_obstacle_.DebugString();
+           << Perception().DebugString();
     return false;
   }
-  const double object_width = perception_obstacle_.width();
-  const double object_length = perception_obstacle_.length();
-  const auto& trajectory_points = trajectory_.trajectory_point();
+  const double object_width = Perception().width();
+  const double object_length = Perception().length();
+  const auto& trajectory_points = Trajectory().trajectory_point();
   if (trajectory_points.empty()) {
-    AWARN << "object " << id_ << " has no trajectory points";
+    AWARN << "object " << Id() << " has no trajectory points";
     return false;
   }
   const auto& adc_param =
@@ -674,7 +702,7 @@ void Obstacle::AddLateralDecision(const std::string& decider_tag,
 
 std::string Obstacle::DebugString() const {
   std::stringstream ss;
-  ss << "Obstacle id: " << id_;
+  ss << "Obstacle id: " << Id();
   for (size_t i = 0; i < decisions_.size(); ++i) {
     ss << " decision: " << decisions_[i].DebugString() << ", made by "
        << decider_tags_[i];
@@ -772,16 +800,15 @@ void Obstacle::SetLaneChangeBlocking(const bool is_distance_clear) {
 // ouput: obstacle polygon
 common::math::Polygon2d Obstacle::GetObstacleTrajectoryPolygon(
     const common::TrajectoryPoint& point) const {
-  double delta_heading =
-      point.path_point().theta() - perception_obstacle_.theta();
+  double delta_heading = point.path_point().theta() - Perception().theta();
   double cos_delta_heading = cos(delta_heading);
   double sin_delta_heading = sin(delta_heading);
   std::vector<common::math::Vec2d> polygon_point;
-  polygon_point.reserve(perception_polygon_.points().size());
+  polygon_point.reserve(PerceptionPolygon().points().size());
 
-  for (auto& iter : perception_polygon_.points()) {
-    double relative_x = iter.x() - perception_obstacle_.position().x();
-    double relative_y = iter.y() - perception_obstacle_.position().y();
+  for (auto& iter : PerceptionPolygon().points()) {
+    double relative_x = iter.x() - Perception().position().x();
+    double relative_y = iter.y() - Perception().position().y();
     double x = relative_x * cos_delta_heading - relative_y * sin_delta_heading +
                point.path_point().x();
     double y = relative_x * sin_delta_heading + relative_y * cos_delta_heading +
@@ -41,6 +41,28 @@
 namespace apollo {
 namespace planning {
 
+/**
+ * @class ObstacleSnapshot
+ * @brief What an obstacle is in a frame, from perception and prediction. The
+ * copies of the obstacle on all the reference lines share one, changing it
+ * through an obstacle copies it first.
+ */
+struct ObstacleSnapshot {
+  std::string id;
+  // the integer id of the obstacle in its frame, -1 if it is in none
+  int32_t index = -1;
+  int32_t perception_id = 0;
+  bool is_static = false;
+  bool is_virtual = false;
+  bool is_caution_level_obstacle = false;
+  double speed = 0.0;
+
+  prediction::Trajectory trajectory;
+  perception::PerceptionObstacle perception_obstacle;
+  common::math::Box2d perception_bounding_box;
+  common::math::Polygon2d perception_polygon;
+};
+
 /**
  * @class Obstacle
  * @brief This is the class that associates an Obstacle with its path
@@ -57,10 +79,13 @@ namespace planning {
  *
  * Ignore decision belongs to both lateral decision and longitudinal decision,
  * and it has the lowest priority.
+ *
+ * The perception and prediction of the obstacle are in an ObstacleSnapshot
+ * its copies share, a copy only has path properties and decisions of its own.
  */
 class Obstacle {
  public:
-  Obstacle() = default;
+  Obstacle();
   Obstacle(const std::string& id,
            const perception::PerceptionObstacle& perception_obstacle,
            const prediction::ObstaclePriority::Priority& obstacle_priority,
@@ -71,15 +96,22 @@ class Obstacle {
            const prediction::ObstaclePriority::Priority& obstacle_priority,
            const bool is_static);
 
-  const std::string& Id() const { return id_; }
-  void SetId(const std::string& id) { id_ = id; }
+  const std::string& Id() const { return snapshot_->id; }
+  void SetId(const std::string& id);
+
+  /**
+   * @brief the integer id Frame and PathDecision index the obstacle by,
+   * -1 if it is in no frame
+   */
+  int32_t Index() const { return snapshot_->index; }
+  void SetIndex(const int32_t index);
 
-  double speed() const { return speed_; }
+  double speed() const { return snapshot_->speed; }
 
-  int32_t PerceptionId() const { return perception_id_; }
+  int32_t PerceptionId() const { return snapshot_->perception_id; }
 
-  bool IsStatic() const { return is_static_; }
-  bool IsVirtual() const { return is_virtual_; }
+  bool IsStatic() const { return snapshot_->is_static; }
+  bool IsVirtual() const { return snapshot_->is_virtual; }
 
   common::TrajectoryPoint GetPointAtTime(const double time) const;
 
@@ -87,19 +119,21 @@ class Obstacle {
       const common::TrajectoryPoint& point) const;
 
   const common::math::Box2d& PerceptionBoundingBox() const {
-    return perception_bounding_box_;
+    return snapshot_->perception_bounding_box;
   }
   const common::math::Polygon2d& PerceptionPolygon() const {
-    return perception_polygon_;
+    return snapshot_->perception_polygon;
+  }
+  const prediction::Trajectory& Trajectory() const {
+    return snapshot_->trajectory;
   }
-  const prediction::Trajectory& Trajectory() const { return trajectory_; }
 
   bool HasTrajectory() const {
-    return !(trajectory_.trajectory_point().empty());
+    return !(snapshot_->trajectory.trajectory_point().empty());
   }
 
   const perception::PerceptionObstacle& Perception() const {
-    return perception_obstacle_;
+    return snapshot_->perception_obstacle;
   }
 
   /**
@@ -121,7 +155,7 @@ class Obstacle {
   static bool IsValidTrajectoryPoint(const common::TrajectoryPoint& point);
 
   inline bool IsCautionLevelObstacle() const {
-    return is_caution_level_obstacle_;
+    return snapshot_->is_caution_level_obstacle;
   }
 
   // const Obstacle* obstacle() const;
@@ -237,20 +271,14 @@ class Obstacle {
   bool IsValidObstacle(
       const perception::PerceptionObstacle& perception_obstacle);
 
+  // the snapshot to change, a copy if another obstacle shares it
+  ObstacleSnapshot* mutable_snapshot();
+
  private:
-  std::string id_;
-  int32_t perception_id_ = 0;
-  bool is_static_ = false;
-  bool is_virtual_ = false;
-  double speed_ = 0.0;
+  std::shared_ptr<ObstacleSnapshot> snapshot_;
 
   bool path_st_boundary_initialized_ = false;
 
-  prediction::Trajectory trajectory_;
-  perception::PerceptionObstacle perception_obstacle_;
-  common::math::Box2d perception_bounding_box_;
-  common::math::Polygon2d perception_polygon_;
-
   std::vector<ObjectDecisionType> decisions_;
   std::vector<std::string> decider_tags_;
   SLBoundary sl_boundary_;
@@ -268,8 +296,6 @@ class Obstacle {
 
   bool is_lane_change_blocking_ = false;
 
-  bool is_caution_level_obstacle_ = false;
-
   double min_radius_stop_distance_ = -1.0;
 
   struct ObjectTagCaseHash {
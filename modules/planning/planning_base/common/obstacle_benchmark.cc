@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * The obstacles of a planning cycle in a dense urban scene, range(0) of them
+ * with two predicted trajectories each, created from the prediction as
+ * Frame::InitFrameData does and added to the path decisions of three
+ * reference lines as ReferenceLineInfo::AddObstacle does, reporting the heap
+ * allocations of a cycle:
+ *
+ *   bazel run -c opt //modules/planning/planning_base:obstacle_benchmark
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common_msgs/prediction_msgs/prediction_obstacle.pb.h"
+
+#include "modules/planning/planning_base/common/obstacle.h"
+#include "modules/planning/planning_base/common/path_decision.h"
+
+namespace {
+std::atomic<uint64_t> allocation_count{0};
+}  // namespace
+
+void* operator new(size_t size) {
+  ++allocation_count;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr int kReferenceLines = 3;
+constexpr int kTrajectoryPoints = 80;
+
+prediction::PredictionObstacles MakePrediction(int obstacle_num) {
+  prediction::PredictionObstacles prediction;
+  prediction.mutable_header()->set_timestamp_sec(0.0);
+  for (int i = 0; i < obstacle_num; ++i) {
+    auto* prediction_obstacle = prediction.add_prediction_obstacle();
+    auto* perception_obstacle =
+        prediction_obstacle->mutable_perception_obstacle();
+    const double x = 5.0 * (i % 40);
+    const double y = 4.0 * (i / 40) - 10.0;
+    perception_obstacle->set_id(1000 + i);
+    perception_obstacle->mutable_position()->set_x(x);
+    perception_obstacle->mutable_position()->set_y(y);
+    perception_obstacle->mutable_velocity()->set_x(5.0);
+    perception_obstacle->mutable_velocity()->set_y(0.0);
+    perception_obstacle->mutable_velocity()->set_z(0.0);
+    perception_obstacle->set_theta(0.0);
+    perception_obstacle->set_length(4.5);
+    perception_obstacle->set_width(1.8);
+    perception_obstacle->set_height(1.5);
+    for (int k = 0; k < 8; ++k) {
+      auto* point = perception_obstacle->add_polygon_point();
+      point->set_x(x + 2.25 * std::cos(k * M_PI / 4.0));
+      point->set_y(y + 0.9 * std::sin(k * M_PI / 4.0));
+    }
+    prediction_obstacle->mutable_priority()->set_priority(
+        prediction::ObstaclePriority::NORMAL);
+    for (int lane = 0; lane < 2; ++lane) {
+      auto* trajectory = prediction_obstacle->add_trajectory();
+      trajectory->set_probability(0.5);
+      for (int k = 0; k < kTrajectoryPoints; ++k) {
+        auto* point = trajectory->add_trajectory_point();
+        auto* path_point = point->mutable_path_point();
+        path_point->set_x(x + 0.5 * k);
+        path_point->set_y(y + lane * 0.02 * k);
+        path_point->set_theta(0.0);
+        point->set_v(5.0);
+        point->set_relative_time(0.1 * k);
+      }
+    }
+  }
+  return prediction;
+}
+
+}  // namespace
+
+static void BM_ObstaclesOfCycle(benchmark::State& state) {
+  const auto prediction = MakePrediction(static_cast<int>(state.range(0)));
+  ObjectDecisionType ignore;
+  ignore.mutable_ignore();
+  uint64_t allocations = 0;
+  for (auto _ : state) {
+    const uint64_t start_count = allocation_count;
+    ThreadSafeIndexedObstacles frame_obstacles;
+    auto obstacles = Obstacle::CreateObstacles(prediction);
+    frame_obstacles.Reserve(obstacles.size());
+    for (auto& obstacle : obstacles) {
+      obstacle->SetIndex(static_cast<int32_t>(frame_obstacles.Size()));
+      frame_obstacles.Add(obstacle->Id(), *obstacle);
+    }
+    for (int line = 0; line < kReferenceLines; ++line) {
+      PathDecision path_decision;
+      path_decision.Reserve(obstacles.size());
+      for (const auto* obstacle : frame_obstacles.Items()) {
+        auto* mutable_obstacle = path_decision.AddObstacle(*obstacle);
+        SLBoundary sl_boundary;
+        sl_boundary.set_start_s(obstacle->Perception().position().x() - 2.0);
+        sl_boundary.set_end_s(obstacle->Perception().position().x() + 2.0);
+        sl_boundary.set_start_l(obstacle->Perception().position().y() - 1.0);
+        sl_boundary.set_end_l(obstacle->Perception().position().y() + 1.0);
+        mutable_obstacle->SetPerceptionSlBoundary(sl_boundary);
+        // the ones off the reference line
+        if (std::fabs(sl_boundary.start_l()) > 8.0) {
+          mutable_obstacle->AddLateralDecision("reference_line_filter",
+                                               ignore);
+          mutable_obstacle->AddLongitudinalDecision("reference_line_filter",
+                                                    ignore);
+        }
+      }
+      benchmark::DoNotOptimize(path_decision.obstacles().Items().size());
+    }
+    allocations += allocation_count - start_count;
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ObstaclesOfCycle)
+    ->Arg(50)
+    ->Arg(200)
+    ->Arg(400)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
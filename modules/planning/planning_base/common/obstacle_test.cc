@@ -27,6 +27,7 @@
 
 #include "cyber/common/file.h"
 #include "modules/common/util/util.h"
+#include "modules/planning/planning_base/common/path_decision.h"
 #include "modules/planning/planning_base/gflags/planning_gflags.h"
 
 namespace apollo {
@@ -93,6 +94,29 @@ TEST_F(ObstacleTest, Id) {
   EXPECT_EQ(2156, obstacle->PerceptionId());
 }
 
+TEST_F(ObstacleTest, Index) {
+  const auto* obstacle = indexed_obstacles_.Find("2156_0");
+  ASSERT_TRUE(obstacle);
+  EXPECT_EQ(-1, obstacle->Index());
+
+  Obstacle copy = *obstacle;
+  EXPECT_EQ(&obstacle->Trajectory(), &copy.Trajectory());
+  copy.SetIndex(3);
+  EXPECT_EQ(3, copy.Index());
+  EXPECT_EQ(-1, obstacle->Index());
+  copy.SetId("2156_2");
+  EXPECT_EQ("2156_2", copy.Id());
+  EXPECT_EQ("2156_0", obstacle->Id());
+  EXPECT_EQ(obstacle->Trajectory().trajectory_point_size(),
+            copy.Trajectory().trajectory_point_size());
+
+  PathDecision path_decision;
+  auto* added = path_decision.AddObstacle(copy);
+  EXPECT_EQ(added, path_decision.Find(3));
+  EXPECT_EQ(added, path_decision.Find("2156_2"));
+  EXPECT_EQ(nullptr, path_decision.Find(0));
+}
+
 TEST_F(ObstacleTest, GetPointAtTime) {
   const auto* obstacle = indexed_obstacles_.Find("2156_0");
   ASSERT_TRUE(obstacle);
@@ -29,7 +29,20 @@ namespace apollo {
 namespace planning {
 
 Obstacle *PathDecision::AddObstacle(const Obstacle &obstacle) {
-  return obstacles_.Add(obstacle.Id(), obstacle);
+  auto *added = obstacles_.Add(obstacle.Id(), obstacle);
+  const int32_t index = obstacle.Index();
+  if (index >= 0) {
+    if (static_cast<size_t>(index) >= obstacles_by_index_.size()) {
+      obstacles_by_index_.resize(index + 1, nullptr);
+    }
+    obstacles_by_index_[index] = added;
+  }
+  return added;
+}
+
+void PathDecision::Reserve(const size_t size) {
+  obstacles_.Reserve(size);
+  obstacles_by_index_.reserve(size);
 }
 
 const IndexedObstacles &PathDecision::obstacles() const { return obstacles_; }
@@ -42,6 +55,16 @@ const Obstacle *PathDecision::Find(const std::string &object_id) const {
   return obstacles_.Find(object_id);
 }
 
+Obstacle *PathDecision::Find(const int32_t index) {
+  return index >= 0 && static_cast<size_t>(index) < obstacles_by_index_.size()
+             ? obstacles_by_index_[index]
+             : nullptr;
+}
+
+const Obstacle *PathDecision::Find(const int32_t index) const {
+  return const_cast<PathDecision *>(this)->Find(index);
+}
+
 const perception::PerceptionObstacle *PathDecision::FindPerceptionObstacle(
     const std::string &perception_obstacle_id) const {
   for (const auto *obstacle : obstacles_.Items()) {
@@ -22,6 +22,7 @@
 
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "modules/common_msgs/planning_msgs/decision.pb.h"
 
@@ -57,6 +58,16 @@ class PathDecision {
 
   Obstacle *Find(const std::string &object_id);
 
+  /**
+   * @brief find the obstacle by its integer id in the frame, which is cheaper
+   * than by its string id.
+   * @return nullptr if no obstacle of the index is on the path.
+   */
+  const Obstacle *Find(const int32_t index) const;
+  Obstacle *Find(const int32_t index);
+
+  void Reserve(const size_t size);
+
   void SetSTBoundary(const std::string &id, const STBoundary &boundary);
   void EraseStBoundaries();
   MainStop main_stop() const { return main_stop_; }
@@ -67,6 +78,8 @@ class PathDecision {
 
  private:
   IndexedList<std::string, Obstacle> obstacles_;
+  // the obstacles of obstacles_ by their Obstacle::Index()
+  std::vector<Obstacle *> obstacles_by_index_;
   MainStop main_stop_;
   double stop_reference_line_s_ = std::numeric_limits<double>::max();
 };
@@ -16,6 +16,8 @@
 
 #include "modules/planning/planning_base/common/planning_context.h"
 
+#include "google/protobuf/util/message_differencer.h"
+
 namespace apollo {
 namespace planning {
 
@@ -23,5 +25,28 @@ void PlanningContext::Init() {}
 
 void PlanningContext::Clear() { planning_status_.Clear(); }
 
+void PlanningContext::MergeChanges(const PlanningStatus& base,
+                                   const PlanningStatus& changed) {
+  const auto* descriptor = PlanningStatus::descriptor();
+  const auto* reflection = PlanningStatus::GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const auto* field = descriptor->field(i);
+    const bool has_base = reflection->HasField(base, field);
+    const bool has_changed = reflection->HasField(changed, field);
+    if (has_base == has_changed &&
+        (!has_base || google::protobuf::util::MessageDifferencer::Equals(
+                          reflection->GetMessage(base, field),
+                          reflection->GetMessage(changed, field)))) {
+      continue;
+    }
+    if (has_changed) {
+      reflection->MutableMessage(&planning_status_, field)
+          ->CopyFrom(reflection->GetMessage(changed, field));
+    } else {
+      reflection->ClearField(&planning_status_, field);
+    }
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -45,6 +45,13 @@ class PlanningContext {
   const PlanningStatus& planning_status() const { return planning_status_; }
   PlanningStatus* mutable_planning_status() { return &planning_status_; }
 
+  /**
+   * @brief Apply the changes `changed` made to `base`, one status of
+   * PlanningStatus at a time: a status that differs from the one in `base`
+   * replaces the current one, the others are left as they are.
+   */
+  void MergeChanges(const PlanningStatus& base, const PlanningStatus& changed);
+
  private:
   PlanningStatus planning_status_;
 };
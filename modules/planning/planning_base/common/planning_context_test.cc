@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planning_base/common/planning_context.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/planning_base/common/dependency_injector.h"
+
+namespace apollo {
+namespace planning {
+
+TEST(PlanningContextTest, MergeChanges) {
+  PlanningContext planning_context;
+  auto* planning_status = planning_context.mutable_planning_status();
+  planning_status->mutable_change_lane()->set_path_id("left");
+  planning_status->mutable_crosswalk()->set_crosswalk_id("crosswalk_1");
+  planning_status->mutable_pull_over()->set_plan_pull_over_path(true);
+  const PlanningStatus base = *planning_status;
+
+  // two reference lines planned from the same status
+  PlanningStatus first = base;
+  first.mutable_change_lane()->set_path_id("right");
+  first.mutable_destination()->set_has_passed_destination(true);
+  PlanningStatus second = base;
+  second.mutable_change_lane()->set_path_id("straight");
+  second.clear_pull_over();
+
+  planning_context.MergeChanges(base, first);
+  planning_context.MergeChanges(base, second);
+  EXPECT_EQ("straight", planning_status->change_lane().path_id());
+  EXPECT_TRUE(planning_status->destination().has_passed_destination());
+  EXPECT_EQ("crosswalk_1", planning_status->crosswalk().crosswalk_id());
+  EXPECT_FALSE(planning_status->has_pull_over());
+
+  // nothing changed, nothing to apply
+  planning_context.MergeChanges(base, base);
+  EXPECT_EQ("straight", planning_status->change_lane().path_id());
+}
+
+TEST(PlanningContextTest, SharedDependencyInjector) {
+  auto injector = std::make_shared<DependencyInjector>();
+  DependencyInjector line_injector(injector);
+  EXPECT_EQ(injector->frame_history(), line_injector.frame_history());
+  EXPECT_EQ(injector->history(), line_injector.history());
+  EXPECT_EQ(injector->ego_info(), line_injector.ego_info());
+  EXPECT_EQ(injector->vehicle_state(), line_injector.vehicle_state());
+  EXPECT_EQ(injector->learning_based_data(),
+            line_injector.learning_based_data());
+  EXPECT_NE(injector->planning_context(), line_injector.planning_context());
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -367,7 +367,6 @@ bool ReferenceLineInfo::AddObstacleHelper(
   return AddObstacle(obstacle.get()) != nullptr;
 }
 
-// AddObstacle is thread safe
 Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
   if (!obstacle) {
     AERROR << "The provided obstacle is empty";
@@ -378,7 +377,12 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
     AERROR << "failed to add obstacle " << obstacle->Id();
     return nullptr;
   }
+  return InitObstacle(mutable_obstacle);
+}
 
+// InitObstacle is thread safe for different obstacles
+Obstacle* ReferenceLineInfo::InitObstacle(Obstacle* mutable_obstacle) {
+  const Obstacle* obstacle = mutable_obstacle;
   SLBoundary perception_sl;
   if (!reference_line_.GetSLBoundary(obstacle->PerceptionPolygon(),
                                      &perception_sl)) {
@@ -396,10 +400,8 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
   if (IsIrrelevantObstacle(*mutable_obstacle)) {
     ObjectDecisionType ignore;
     ignore.mutable_ignore();
-    path_decision_.AddLateralDecision("reference_line_filter", obstacle->Id(),
-                                      ignore);
-    path_decision_.AddLongitudinalDecision("reference_line_filter",
-                                           obstacle->Id(), ignore);
+    mutable_obstacle->AddLateralDecision("reference_line_filter", ignore);
+    mutable_obstacle->AddLongitudinalDecision("reference_line_filter", ignore);
     ADEBUG << "NO build reference line st boundary. id:" << obstacle->Id();
   } else {
     ADEBUG << "build reference line st boundary. id:" << obstacle->Id();
@@ -417,11 +419,24 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
 
 bool ReferenceLineInfo::AddObstacles(
     const std::vector<const Obstacle*>& obstacles) {
+  path_decision_.Reserve(obstacles.size());
   if (FLAGS_use_multi_thread_to_add_obstacles) {
-    std::vector<std::future<Obstacle*>> results;
+    // the path decision is not thread safe, only the obstacles on the path
+    // are initialized in parallel
+    std::vector<Obstacle*> mutable_obstacles;
+    mutable_obstacles.reserve(obstacles.size());
     for (const auto* obstacle : obstacles) {
-      results.push_back(
-          cyber::Async(&ReferenceLineInfo::AddObstacle, this, obstacle));
+      auto* mutable_obstacle = path_decision_.AddObstacle(*obstacle);
+      if (!mutable_obstacle) {
+        AERROR << "Failed to add obstacle " << obstacle->Id();
+        return false;
+      }
+      mutable_obstacles.push_back(mutable_obstacle);
+    }
+    std::vector<std::future<Obstacle*>> results;
+    for (auto* mutable_obstacle : mutable_obstacles) {
+      results.push_back(cyber::Async(&ReferenceLineInfo::InitObstacle, this,
+                                     mutable_obstacle));
     }
     for (auto& result : results) {
       if (!result.get()) {
@@ -289,6 +289,10 @@ class ReferenceLineInfo {
 
   bool AddObstacleHelper(const std::shared_ptr<Obstacle>& obstacle);
 
+  // computes the sl boundary, lane blocking, reference line st boundary and
+  // the reference_line_filter decisions of an obstacle on the path
+  Obstacle* InitObstacle(Obstacle* mutable_obstacle);
+
   bool GetFirstOverlap(const std::vector<hdmap::PathOverlap>& path_overlaps,
                        hdmap::PathOverlap* path_overlap);
 
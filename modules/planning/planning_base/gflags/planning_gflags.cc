@@ -207,6 +207,11 @@ DEFINE_double(speed_fallback_distance, 3.0,
 /// thread pool
 DEFINE_bool(use_multi_thread_to_add_obstacles, false,
             "use multiple thread to add obstacles.");
+DEFINE_bool(enable_parallel_reference_line_tasks, false,
+            "True to run the tasks of the reference lines of a stage in "
+            "parallel, each line with tasks and planning status of its own.");
+DEFINE_int32(max_parallel_reference_lines, 3,
+             "The most reference lines a stage plans at once in parallel.");
 
 /// Lattice Planner
 DEFINE_double(numerical_epsilon, 1e-6, "Epsilon in lattice planner.");
@@ -336,6 +341,9 @@ DEFINE_bool(
 
 DEFINE_bool(enable_osqp_debug, false,
             "True to turn on OSQP verbose debug output in log.");
+DEFINE_bool(enable_piecewise_jerk_workspace, false,
+            "True to keep the OSQP workspaces of the piecewise jerk problems "
+            "across planning cycles and warm start them.");
 DEFINE_double(path_bounds_horizon, 100, "path bounds horizon");
 DEFINE_bool(export_chart, false, "export chart in planning");
 DEFINE_bool(enable_record_debug, false,
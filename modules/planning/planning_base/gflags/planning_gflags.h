@@ -101,6 +101,8 @@ DECLARE_double(slowdown_profile_deceleration);
 DECLARE_double(speed_fallback_distance);
 /// thread pool
 DECLARE_bool(use_multi_thread_to_add_obstacles);
+DECLARE_bool(enable_parallel_reference_line_tasks);
+DECLARE_int32(max_parallel_reference_lines);
 
 DECLARE_double(numerical_epsilon);
 DECLARE_double(default_cruise_speed);
@@ -171,6 +173,7 @@ DECLARE_bool(enable_parallel_trajectory_smoothing);
 DECLARE_bool(enable_parallel_hybrid_a);
 
 DECLARE_bool(enable_osqp_debug);
+DECLARE_bool(enable_piecewise_jerk_workspace);
 DECLARE_bool(export_chart);
 DECLARE_bool(enable_record_debug);
 DECLARE_bool(enable_print_curve);
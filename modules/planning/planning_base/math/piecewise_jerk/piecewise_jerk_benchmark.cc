@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * The path and speed problems of consecutive planning cycles, the vehicle
+ * moving on and an obstacle ahead of it, solved with a new OSQP workspace
+ * each (range(0) == 0) and in a PiecewiseJerkWorkspace (range(0) == 1),
+ * reporting how many problems the workspace set up and reused. The reuse is
+ * off by default, the workspace runs turn enable_piecewise_jerk_workspace on:
+ *
+ *   bazel run -c opt //modules/planning/planning_base:piecewise_jerk_benchmark
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_path_problem.h"
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_speed_problem.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr double kCycleTime = 0.1;
+constexpr double kSpeed = 10.0;
+
+// 100m of path in 0.5m knots, nudging around an obstacle at 40m to 50m
+// from where the first cycle starts
+bool SolvePath(int cycle, PiecewiseJerkWorkspace* workspace) {
+  constexpr size_t kNumKnots = 200;
+  constexpr double kDeltaS = 0.5;
+  const double start_s = cycle * kSpeed * kCycleTime;
+  // where the previous cycles left the vehicle, drifting slightly
+  const std::array<double, 3> init_l = {0.05 * std::sin(0.3 * cycle), 0.0,
+                                        0.0};
+  PiecewiseJerkPathProblem problem(kNumKnots, kDeltaS, init_l);
+
+  std::vector<std::pair<double, double>> l_bounds(kNumKnots, {-1.75, 1.75});
+  std::vector<std::pair<double, double>> ddl_bounds(kNumKnots, {-0.2, 0.2});
+  std::vector<double> l_ref(kNumKnots, 0.0);
+  std::vector<double> l_ref_weight(kNumKnots, 0.0);
+  for (size_t i = 0; i < kNumKnots; ++i) {
+    const double s = start_s + i * kDeltaS;
+    if (s > 40.0 && s < 50.0) {
+      l_bounds[i].first = -0.5;
+      l_ref[i] = 0.6;
+      l_ref_weight[i] = 10.0;
+    }
+  }
+  problem.set_end_state_ref({1000.0, 0.0, 0.0}, {0.0, 0.0, 0.0});
+  problem.set_x_ref(std::move(l_ref_weight), std::move(l_ref));
+  problem.set_weight_x(1.0);
+  problem.set_weight_dx(20.0);
+  problem.set_weight_ddx(1000.0);
+  problem.set_weight_dddx(50000.0);
+  problem.set_scale_factor({1.0, 10.0, 100.0});
+  problem.set_x_bounds(std::move(l_bounds));
+  problem.set_dx_bounds(-2.0, 2.0);
+  problem.set_ddx_bounds(std::move(ddl_bounds));
+  problem.set_dddx_bound(0.1);
+  return workspace == nullptr
+             ? problem.Optimize(4000)
+             : problem.Optimize(workspace, start_s, 4000);
+}
+
+// 7s of speed profile in 0.1s knots, following a slower vehicle at 40m
+bool SolveSpeed(int cycle, PiecewiseJerkWorkspace* workspace) {
+  constexpr size_t kNumKnots = 71;
+  constexpr double kDeltaT = 0.1;
+  constexpr double kLeadSpeed = 6.0;
+  const double start_t = cycle * kCycleTime;
+  const double lead_s =
+      40.0 - cycle * (kSpeed - kLeadSpeed) * kCycleTime * 0.25;
+  PiecewiseJerkSpeedProblem problem(kNumKnots, kDeltaT, {0.0, kSpeed, 0.0});
+
+  std::vector<std::pair<double, double>> s_bounds;
+  std::vector<double> x_ref;
+  for (size_t i = 0; i < kNumKnots; ++i) {
+    const double t = i * kDeltaT;
+    s_bounds.emplace_back(0.0, lead_s - 10.0 + kLeadSpeed * t);
+    x_ref.push_back(std::min(kSpeed * t, s_bounds.back().second));
+  }
+  problem.set_weight_ddx(1.0);
+  problem.set_weight_dddx(10.0);
+  problem.set_x_bounds(0.0, 100.0);
+  problem.set_ddx_bounds(-6.0, 2.0);
+  problem.set_dddx_bound(-4.0, 2.0);
+  problem.set_x_bounds(std::move(s_bounds));
+  problem.set_dx_ref(5.0, kSpeed);
+  problem.set_x_ref(10.0, std::move(x_ref));
+  problem.set_penalty_dx(std::vector<double>(kNumKnots, 0.0));
+  problem.set_dx_bounds(0.0, 15.0);
+  return workspace == nullptr ? problem.Optimize()
+                              : problem.Optimize(workspace, start_t);
+}
+
+void RunCycles(bool (*solve)(int, PiecewiseJerkWorkspace*),
+               benchmark::State& state) {
+  FLAGS_enable_piecewise_jerk_workspace = state.range(0) != 0;
+  PiecewiseJerkWorkspace workspace;
+  int cycle = 0;
+  for (auto _ : state) {
+    if (!solve(cycle++ % 100, state.range(0) == 0 ? nullptr : &workspace)) {
+      state.SkipWithError("Piecewise jerk problem failed");
+      break;
+    }
+  }
+  state.counters["setups"] = static_cast<double>(workspace.setup_count());
+  state.counters["reuses"] = static_cast<double>(workspace.reuse_count());
+}
+
+}  // namespace
+
+static void BM_PathCycles(benchmark::State& state) {
+  RunCycles(SolvePath, state);
+}
+BENCHMARK(BM_PathCycles)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
+
+static void BM_SpeedCycles(benchmark::State& state) {
+  RunCycles(SolveSpeed, state);
+}
+BENCHMARK(BM_SpeedCycles)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
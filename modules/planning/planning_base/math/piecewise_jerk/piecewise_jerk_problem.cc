@@ -16,6 +16,10 @@
 
 #include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_problem.h"
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 #include "cyber/common/log.h"
 #include "modules/planning/planning_base/gflags/planning_gflags.h"
 
@@ -133,6 +137,213 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
   return true;
 }
 
+bool PiecewiseJerkProblem::Optimize(PiecewiseJerkWorkspace* workspace,
+                                    const double knots_start,
+                                    const int max_iter) {
+  if (workspace == nullptr || !FLAGS_enable_piecewise_jerk_workspace) {
+    return Optimize(max_iter);
+  }
+  PiecewiseJerkWorkspace::Entry problem;
+  CalculateKernel(&problem.P_data, &problem.P_indices, &problem.P_indptr);
+  CalculateAffineConstraint(&problem.A_data, &problem.A_indices,
+                            &problem.A_indptr, &problem.lower_bounds,
+                            &problem.upper_bounds);
+  CalculateOffset(&problem.q);
+  CHECK_EQ(problem.lower_bounds.size(), problem.upper_bounds.size());
+  if (CheckLowUpperBound(problem.lower_bounds, problem.upper_bounds)) {
+    return false;
+  }
+
+  auto* entry = workspace->Find(problem.P_indices, problem.P_indptr,
+                                problem.A_indices, problem.A_indptr);
+  if (entry != nullptr) {
+    if (UpdateWorkspace(problem, max_iter, entry)) {
+      WarmStart(knots_start, *entry);
+      ++workspace->reuse_count_;
+    } else {
+      AWARN << "Failed to update the OSQP workspace, set up a new one";
+      workspace->Release(entry);
+      entry = nullptr;
+    }
+  }
+  if (entry == nullptr) {
+    entry = workspace->Allocate();
+    entry->P_data = std::move(problem.P_data);
+    entry->P_indices = std::move(problem.P_indices);
+    entry->P_indptr = std::move(problem.P_indptr);
+    entry->A_data = std::move(problem.A_data);
+    entry->A_indices = std::move(problem.A_indices);
+    entry->A_indptr = std::move(problem.A_indptr);
+    entry->q = std::move(problem.q);
+    entry->lower_bounds = std::move(problem.lower_bounds);
+    entry->upper_bounds = std::move(problem.upper_bounds);
+    if (!SetUpWorkspace(max_iter, entry)) {
+      AERROR << "Failed to set up the OSQP workspace";
+      return false;
+    }
+    ++workspace->setup_count_;
+  }
+
+  OSQPWorkspace* osqp_work = entry->work;
+  osqp_solve(osqp_work);
+  auto status = osqp_work->info->status_val;
+  if (status < 0 || (status != 1 && status != 2)) {
+    AERROR << "failed optimization status:\t" << osqp_work->info->status;
+    // not a solution to start the next problems from
+    workspace->Release(entry);
+    return false;
+  } else if (osqp_work->solution == nullptr) {
+    AERROR << "The solution from OSQP is nullptr";
+    workspace->Release(entry);
+    return false;
+  }
+
+  // extract primal results
+  x_.resize(num_of_knots_);
+  dx_.resize(num_of_knots_);
+  ddx_.resize(num_of_knots_);
+  for (size_t i = 0; i < num_of_knots_; ++i) {
+    x_.at(i) = osqp_work->solution->x[i] / scale_factor_[0];
+    dx_.at(i) = osqp_work->solution->x[i + num_of_knots_] / scale_factor_[1];
+    ddx_.at(i) =
+        osqp_work->solution->x[i + 2 * num_of_knots_] / scale_factor_[2];
+  }
+  const size_t n = entry->P_indptr.size() - 1;
+  const size_t m = entry->lower_bounds.size();
+  entry->x.assign(osqp_work->solution->x, osqp_work->solution->x + n);
+  entry->y.assign(osqp_work->solution->y, osqp_work->solution->y + m);
+  entry->knots_start = knots_start;
+  return true;
+}
+
+bool PiecewiseJerkProblem::SetUpWorkspace(
+    const int max_iter, PiecewiseJerkWorkspace::Entry* entry) {
+  const c_int kernel_dim = static_cast<c_int>(entry->P_indptr.size() - 1);
+  const c_int num_affine_constraint =
+      static_cast<c_int>(entry->lower_bounds.size());
+  auto* data = &entry->data;
+  data->n = kernel_dim;
+  data->m = num_affine_constraint;
+  data->P = csc_matrix(kernel_dim, kernel_dim, entry->P_data.size(),
+                       entry->P_data.data(), entry->P_indices.data(),
+                       entry->P_indptr.data());
+  data->q = entry->q.data();
+  data->A = csc_matrix(num_affine_constraint, kernel_dim,
+                       entry->A_data.size(), entry->A_data.data(),
+                       entry->A_indices.data(), entry->A_indptr.data());
+  data->l = entry->lower_bounds.data();
+  data->u = entry->upper_bounds.data();
+
+  OSQPSettings* settings = SolverDefaultSettings();
+  settings->max_iter = max_iter;
+  entry->work = osqp_setup(data, settings);
+  c_free(settings);
+  if (entry->work == nullptr) {
+    c_free(data->P);
+    c_free(data->A);
+    return false;
+  }
+  return true;
+}
+
+bool PiecewiseJerkProblem::UpdateWorkspace(
+    const PiecewiseJerkWorkspace::Entry& problem, const int max_iter,
+    PiecewiseJerkWorkspace::Entry* entry) {
+  if (problem.lower_bounds.size() != entry->lower_bounds.size()) {
+    return false;
+  }
+  // A changes with delta_s only, and the values of P that do not change
+  // need no new factorization of the KKT system
+  const bool P_changed = problem.P_data != entry->P_data;
+  const bool A_changed = problem.A_data != entry->A_data;
+  // osqp_setup keeps the upper triangular part of P only, and its values are
+  // the ones to update
+  std::vector<c_float> P_upper;
+  if (P_changed) {
+    P_upper.reserve(problem.P_data.size());
+    for (size_t col = 0; col + 1 < problem.P_indptr.size(); ++col) {
+      for (c_int k = problem.P_indptr[col]; k < problem.P_indptr[col + 1];
+           ++k) {
+        if (problem.P_indices[k] <= static_cast<c_int>(col)) {
+          P_upper.push_back(problem.P_data[k]);
+        }
+      }
+    }
+  }
+  OSQPWorkspace* osqp_work = entry->work;
+  c_int flag = 0;
+  if (P_changed && A_changed) {
+    flag = osqp_update_P_A(osqp_work, P_upper.data(), OSQP_NULL,
+                           P_upper.size(), problem.A_data.data(), OSQP_NULL,
+                           problem.A_data.size());
+  } else if (P_changed) {
+    flag = osqp_update_P(osqp_work, P_upper.data(), OSQP_NULL,
+                         P_upper.size());
+  } else if (A_changed) {
+    flag = osqp_update_A(osqp_work, problem.A_data.data(), OSQP_NULL,
+                         problem.A_data.size());
+  }
+  if (flag != 0 || osqp_update_lin_cost(osqp_work, problem.q.data()) != 0 ||
+      osqp_update_bounds(osqp_work, problem.lower_bounds.data(),
+                         problem.upper_bounds.data()) != 0 ||
+      osqp_update_max_iter(osqp_work, max_iter) != 0) {
+    return false;
+  }
+  // same sizes, the buffers the workspace was set up with stay in place
+  entry->P_data = problem.P_data;
+  entry->A_data = problem.A_data;
+  entry->q = problem.q;
+  entry->lower_bounds = problem.lower_bounds;
+  entry->upper_bounds = problem.upper_bounds;
+  return true;
+}
+
+void PiecewiseJerkProblem::WarmStart(
+    const double knots_start, const PiecewiseJerkWorkspace::Entry& entry) {
+  const size_t n = num_of_knots_;
+  if (entry.x.size() != 3 * n) {
+    return;
+  }
+  const double shift_knots = (knots_start - entry.knots_start) / delta_s_;
+  if (!(shift_knots > -0.5 && shift_knots < n - 0.5)) {
+    // moved backward or past all the knots, nothing in common to start from
+    return;
+  }
+  const size_t shift = static_cast<size_t>(std::lround(shift_knots));
+  // the knots of a block that are past the previous ones keep its last value
+  auto shift_block = [shift](const c_float* from, size_t size, c_float* to) {
+    for (size_t i = 0; i < size; ++i) {
+      to[i] = from[std::min(i + shift, size - 1)];
+    }
+  };
+
+  std::vector<c_float> x(3 * n);
+  for (size_t block = 0; block < 3; ++block) {
+    shift_block(entry.x.data() + block * n, n, x.data() + block * n);
+  }
+  // x as in the previous solution, but from x_init
+  const c_float offset = x_init_[0] * scale_factor_[0] - x[0];
+  for (size_t i = 0; i < n; ++i) {
+    x[i] += offset;
+  }
+
+  // the duals go with the constraints of CalculateAffineConstraint, bounds on
+  // x, x', x'', then on the n - 1 jerks, x' and x steps, then on x_init
+  const size_t num_of_constraints = 3 * n + 3 * (n - 1) + 3;
+  if (entry.y.size() != num_of_constraints) {
+    osqp_warm_start_x(entry.work, x.data());
+    return;
+  }
+  std::vector<c_float> y(num_of_constraints);
+  size_t begin = 0;
+  for (const size_t size : {n, n, n, n - 1, n - 1, n - 1, size_t(3)}) {
+    shift_block(entry.y.data() + begin, size, y.data() + begin);
+    begin += size;
+  }
+  std::copy(entry.y.end() - 3, entry.y.end(), y.end() - 3);
+  osqp_warm_start(entry.work, x.data(), y.data());
+}
+
 void PiecewiseJerkProblem::CalculateAffineConstraint(
     std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
     std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
@@ -26,6 +26,8 @@
 
 #include "osqp/osqp.h"
 
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_workspace.h"
+
 namespace apollo {
 namespace planning {
 
@@ -110,6 +112,18 @@ class PiecewiseJerkProblem {
 
   virtual bool Optimize(const int max_iter = 4000);
 
+  /**
+   * @brief Optimize in a workspace kept in `workspace` from the problems
+   * solved before, see PiecewiseJerkWorkspace, or as Optimize(max_iter)
+   * does if it is nullptr or FLAGS_enable_piecewise_jerk_workspace is off.
+   *
+   * @param knots_start: where the first knot lies along s or t, in a frame
+   * the knots of the problems solved before are in too, to shift their
+   * solution by for a warm start
+   */
+  bool Optimize(PiecewiseJerkWorkspace* workspace, const double knots_start,
+                const int max_iter = 4000);
+
   const std::vector<double>& opt_x() const { return x_; }
 
   const std::vector<double>& opt_dx() const { return dx_; }
@@ -139,6 +153,16 @@ class PiecewiseJerkProblem {
   bool CheckLowUpperBound(std::vector<c_float>& lower,
                           std::vector<c_float>& upper);
 
+  bool SetUpWorkspace(const int max_iter,
+                      PiecewiseJerkWorkspace::Entry* entry);
+
+  bool UpdateWorkspace(const PiecewiseJerkWorkspace::Entry& problem,
+                       const int max_iter,
+                       PiecewiseJerkWorkspace::Entry* entry);
+
+  void WarmStart(const double knots_start,
+                 const PiecewiseJerkWorkspace::Entry& entry);
+
   template <typename T>
   T* CopyData(const std::vector<T>& vec) {
     T* data = new T[vec.size()];
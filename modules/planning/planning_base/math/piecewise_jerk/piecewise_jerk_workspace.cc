@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_workspace.h"
+
+namespace apollo {
+namespace planning {
+
+PiecewiseJerkWorkspace::~PiecewiseJerkWorkspace() {
+  for (auto& entry : entries_) {
+    Release(&entry);
+  }
+}
+
+PiecewiseJerkWorkspace::Entry* PiecewiseJerkWorkspace::Find(
+    const std::vector<c_int>& P_indices, const std::vector<c_int>& P_indptr,
+    const std::vector<c_int>& A_indices, const std::vector<c_int>& A_indptr) {
+  for (auto& entry : entries_) {
+    if (entry.work != nullptr && entry.P_indptr == P_indptr &&
+        entry.A_indptr == A_indptr && entry.P_indices == P_indices &&
+        entry.A_indices == A_indices) {
+      entry.last_used = ++use_count_;
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+PiecewiseJerkWorkspace::Entry* PiecewiseJerkWorkspace::Allocate() {
+  for (auto& entry : entries_) {
+    if (entry.work == nullptr) {
+      entry.last_used = ++use_count_;
+      return &entry;
+    }
+  }
+  if (entries_.size() < kMaxWorkspaces) {
+    // the entries refer to their own data, they must never move
+    entries_.reserve(kMaxWorkspaces);
+    entries_.emplace_back();
+    entries_.back().last_used = ++use_count_;
+    return &entries_.back();
+  }
+  // all in use, replace the least recently used one
+  Entry* entry = &entries_.front();
+  for (auto& candidate : entries_) {
+    if (candidate.last_used < entry->last_used) {
+      entry = &candidate;
+    }
+  }
+  Release(entry);
+  entry->last_used = ++use_count_;
+  return entry;
+}
+
+void PiecewiseJerkWorkspace::Release(Entry* entry) {
+  if (entry->work != nullptr) {
+    osqp_cleanup(entry->work);
+    entry->work = nullptr;
+    c_free(entry->data.P);
+    c_free(entry->data.A);
+  }
+  entry->x.clear();
+  entry->y.clear();
+}
+
+}  // namespace planning
+}  // namespace apollo
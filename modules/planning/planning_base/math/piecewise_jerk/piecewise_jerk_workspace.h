@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "osqp/osqp.h"
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace planning {
+
+/*
+ * @brief:
+ * The OSQP workspaces of the piecewise jerk problems a task solves, kept from
+ * one planning cycle to the next. A problem whose kernel and constraint
+ * matrices have the same sparsity as one solved before only updates the
+ * values of the workspace that one was set up with, which spares allocating
+ * it and ordering its KKT system again, and starts from the solution of that
+ * one, shifted to its knots. Other problems get a workspace of their own,
+ * replacing the least recently used one once there are kMaxWorkspaces.
+ *
+ * Not thread safe, each task instance keeps its own.
+ */
+class PiecewiseJerkWorkspace {
+ public:
+  static constexpr size_t kMaxWorkspaces = 4;
+
+  PiecewiseJerkWorkspace() = default;
+
+  ~PiecewiseJerkWorkspace();
+
+  // the number of problems solved with a new workspace and with one reused
+  uint64_t setup_count() const { return setup_count_; }
+  uint64_t reuse_count() const { return reuse_count_; }
+
+ private:
+  friend class PiecewiseJerkProblem;
+
+  struct Entry {
+    OSQPWorkspace* work = nullptr;
+    // the data the workspace was set up with, which it may refer to
+    OSQPData data;
+    std::vector<c_float> P_data;
+    std::vector<c_int> P_indices;
+    std::vector<c_int> P_indptr;
+    std::vector<c_float> A_data;
+    std::vector<c_int> A_indices;
+    std::vector<c_int> A_indptr;
+    std::vector<c_float> q;
+    std::vector<c_float> lower_bounds;
+    std::vector<c_float> upper_bounds;
+    // the last solution, and where the first of its knots lies
+    std::vector<c_float> x;
+    std::vector<c_float> y;
+    double knots_start = 0.0;
+    uint64_t last_used = 0;
+  };
+
+  // the entry set up for the sparsity of a problem, or nullptr
+  Entry* Find(const std::vector<c_int>& P_indices,
+              const std::vector<c_int>& P_indptr,
+              const std::vector<c_int>& A_indices,
+              const std::vector<c_int>& A_indptr);
+
+  // an entry without a workspace, in place of the least recently used one
+  Entry* Allocate();
+
+  void Release(Entry* entry);
+
+  std::vector<Entry> entries_;
+  uint64_t use_count_ = 0;
+  uint64_t setup_count_ = 0;
+  uint64_t reuse_count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(PiecewiseJerkWorkspace);
+};
+
+}  // namespace planning
+}  // namespace apollo
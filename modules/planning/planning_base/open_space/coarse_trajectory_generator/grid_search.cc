@@ -20,6 +20,10 @@
 
 #include "modules/planning/planning_base/open_space/coarse_trajectory_generator/grid_search.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 namespace apollo {
 namespace planning {
 
@@ -35,21 +39,89 @@ double GridSearch::EuclidDistance(const double x1, const double y1,
 }
 
 bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
-  const double node_grid_x = node->GetGridX();
-  const double node_grid_y = node->GetGridY();
-  if (node_grid_x > max_grid_x_ || node_grid_x < 0 ||
-      node_grid_y > max_grid_y_ || node_grid_y < 0) {
+  const int node_grid_x = static_cast<int>(node->GetGridX());
+  const int node_grid_y = static_cast<int>(node->GetGridY());
+  if (!IsInGrid(node_grid_x, node_grid_y)) {
     return false;
   }
-  if (obstacles_linesegments_vec_.empty()) {
-    return true;
+  return obstacle_grid_[GridIndex(node_grid_x, node_grid_y)] == 0;
+}
+
+bool GridSearch::IsSameObstacles(
+    const std::vector<std::vector<common::math::LineSegment2d>>&
+        obstacles_linesegments_vec) const {
+  if (obstacles_linesegments_vec.size() !=
+      obstacles_linesegments_vec_.size()) {
+    return false;
   }
+  for (size_t i = 0; i < obstacles_linesegments_vec.size(); ++i) {
+    const auto& lhs = obstacles_linesegments_vec[i];
+    const auto& rhs = obstacles_linesegments_vec_[i];
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+    for (size_t j = 0; j < lhs.size(); ++j) {
+      if (lhs[j].start().x() != rhs[j].start().x() ||
+          lhs[j].start().y() != rhs[j].start().y() ||
+          lhs[j].end().x() != rhs[j].end().x() ||
+          lhs[j].end().y() != rhs[j].end().y()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool GridSearch::UpdateObstacleGrid(
+    const std::vector<double>& XYbounds,
+    const std::vector<std::vector<common::math::LineSegment2d>>&
+        obstacles_linesegments_vec) {
+  if (!obstacle_grid_.empty() && XYbounds == XYbounds_ &&
+      IsSameObstacles(obstacles_linesegments_vec)) {
+    return false;
+  }
+  XYbounds_ = XYbounds;
+  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
+  dp_map_end_index_ = -1;
+  // XYbounds with xmin, xmax, ymin, ymax
+  max_grid_y_ = std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_);
+  max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
+  grid_x_num_ = static_cast<int>(max_grid_x_) + 1;
+  grid_y_num_ = static_cast<int>(max_grid_y_) + 1;
+  obstacle_grid_.assign(grid_x_num_ * grid_y_num_, 0);
+
+  // a grid is at xmin + grid_x * resolution, ymin + grid_y * resolution,
+  // only those around the bounding box of a segment can be close to it
+  auto lower_grid = [this](const double coord, const double min_coord) {
+    return std::max(0, static_cast<int>(std::floor(
+                           (coord - node_radius_ - min_coord) /
+                           xy_grid_resolution_)));
+  };
+  auto upper_grid = [this](const double coord, const double min_coord,
+                           const int grid_num) {
+    return std::min(grid_num - 1, static_cast<int>(std::ceil(
+                                      (coord + node_radius_ - min_coord) /
+                                      xy_grid_resolution_)));
+  };
   for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
     for (const common::math::LineSegment2d& linesegment :
          obstacle_linesegments) {
-      if (linesegment.DistanceTo({node->GetGridX(), node->GetGridY()}) <
-          node_radius_) {
-        return false;
+      const common::math::AABox2d box(linesegment.start(), linesegment.end());
+      const int min_grid_x = lower_grid(box.min_x(), XYbounds_[0]);
+      const int max_grid_x = upper_grid(box.max_x(), XYbounds_[0], grid_x_num_);
+      const int min_grid_y = lower_grid(box.min_y(), XYbounds_[2]);
+      const int max_grid_y = upper_grid(box.max_y(), XYbounds_[2], grid_y_num_);
+      for (int grid_y = min_grid_y; grid_y <= max_grid_y; ++grid_y) {
+        for (int grid_x = min_grid_x; grid_x <= max_grid_x; ++grid_x) {
+          uint8_t& obstacle = obstacle_grid_[GridIndex(grid_x, grid_y)];
+          if (obstacle == 0 &&
+              linesegment.DistanceTo(
+                  {XYbounds_[0] + grid_x * xy_grid_resolution_,
+                   XYbounds_[2] + grid_y * xy_grid_resolution_}) <
+                  node_radius_) {
+            obstacle = 1;
+          }
+        }
       }
     }
   }
@@ -110,13 +182,12 @@ bool GridSearch::GenerateAStarPath(
       open_pq;
   std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
   std::unordered_map<std::string, std::shared_ptr<Node2d>> close_set;
-  XYbounds_ = XYbounds;
+  UpdateObstacleGrid(XYbounds, obstacles_linesegments_vec);
   std::shared_ptr<Node2d> start_node =
       std::make_shared<Node2d>(sx, sy, xy_grid_resolution_, XYbounds_);
   std::shared_ptr<Node2d> end_node =
       std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
   std::shared_ptr<Node2d> final_node_ = nullptr;
-  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
   open_set.emplace(start_node->GetIndex(), start_node);
   open_pq.emplace(start_node->GetIndex(), start_node->GetCost());
 
@@ -166,61 +237,96 @@ bool GridSearch::GenerateDpMap(
     const double ex, const double ey, const std::vector<double>& XYbounds,
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
-      open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  dp_map_ = decltype(dp_map_)();
-  XYbounds_ = XYbounds;
-  // XYbounds with xmin, xmax, ymin, ymax
-  max_grid_y_ = std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_);
-  max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
-  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
-  open_set.emplace(end_node->GetIndex(), end_node);
-  open_pq.emplace(end_node->GetIndex(), end_node->GetCost());
+  UpdateObstacleGrid(XYbounds, obstacles_linesegments_vec);
+  const int end_grid_x =
+      static_cast<int>((ex - XYbounds_[0]) / xy_grid_resolution_);
+  const int end_grid_y =
+      static_cast<int>((ey - XYbounds_[2]) / xy_grid_resolution_);
+  if (!IsInGrid(end_grid_x, end_grid_y)) {
+    AERROR << "end of the dp map out of XYbounds: " << ex << ", " << ey;
+    dp_map_end_index_ = -1;
+    return false;
+  }
+  const int end_index = GridIndex(end_grid_x, end_grid_y);
+  if (end_index == dp_map_end_index_) {
+    ADEBUG << "reuse the dp map of the same end and obstacles";
+    return true;
+  }
+
+  // Dijkstra with a bucket queue: bucket k holds the grids whose cost is in
+  // [k, k + 1). Steps cost at least a grid, so every grid of the lowest
+  // bucket is final, and at most sqrt(2) grids, so three buckets reused in
+  // turn hold all the pending ones.
+  static constexpr int kBucketNum = 3;
+  static constexpr int kNextGridNum = 8;
+  static const double kDiagonalDistance = std::sqrt(2.0);
+  static const std::array<int, kNextGridNum> kDx = {0, 1, 1, 1, 0, -1, -1, -1};
+  static const std::array<int, kNextGridNum> kDy = {1, 1, 0, -1, -1, -1, 0, 1};
+  static const std::array<double, kNextGridNum> kStepCost = {
+      1.0, kDiagonalDistance, 1.0, kDiagonalDistance,
+      1.0, kDiagonalDistance, 1.0, kDiagonalDistance};
+
+  dp_map_.assign(grid_x_num_ * grid_y_num_,
+                 std::numeric_limits<double>::infinity());
+  std::vector<uint8_t> closed(dp_map_.size(), 0);
+  std::array<std::vector<int>, kBucketNum> buckets;
+  dp_map_[end_index] = 0.0;
+  buckets[0].push_back(end_index);
+  size_t pending_num = 1;
 
-  // Grid a star begins
   size_t explored_node_num = 0;
-  while (!open_pq.empty()) {
-    const std::string current_id = open_pq.top().first;
-    open_pq.pop();
-    std::shared_ptr<Node2d> current_node = open_set[current_id];
-    dp_map_.emplace(current_node->GetIndex(), current_node);
-    std::vector<std::shared_ptr<Node2d>> next_nodes =
-        std::move(GenerateNextNodes(current_node));
-    for (auto& next_node : next_nodes) {
-      if (!CheckConstraints(next_node)) {
-        continue;
-      }
-      if (dp_map_.find(next_node->GetIndex()) != dp_map_.end()) {
+  for (int bucket = 0; pending_num > 0; ++bucket) {
+    std::vector<int>& current = buckets[bucket % kBucketNum];
+    for (const int index : current) {
+      --pending_num;
+      // queued again with a lower cost, or already expanded
+      if (closed[index] != 0 || static_cast<int>(dp_map_[index]) != bucket) {
         continue;
       }
-      if (open_set.find(next_node->GetIndex()) == open_set.end()) {
-        ++explored_node_num;
-        next_node->SetPreNode(current_node);
-        open_set.emplace(next_node->GetIndex(), next_node);
-        open_pq.emplace(next_node->GetIndex(), next_node->GetCost());
-      } else {
-        if (open_set[next_node->GetIndex()]->GetCost() > next_node->GetCost()) {
-          open_set[next_node->GetIndex()]->SetCost(next_node->GetCost());
-          open_set[next_node->GetIndex()]->SetPreNode(current_node);
+      closed[index] = 1;
+      const int grid_x = index % grid_x_num_;
+      const int grid_y = index / grid_x_num_;
+      for (int i = 0; i < kNextGridNum; ++i) {
+        const int next_grid_x = grid_x + kDx[i];
+        const int next_grid_y = grid_y + kDy[i];
+        if (!IsInGrid(next_grid_x, next_grid_y)) {
+          continue;
+        }
+        const int next_index = GridIndex(next_grid_x, next_grid_y);
+        if (closed[next_index] != 0 || obstacle_grid_[next_index] != 0) {
+          continue;
+        }
+        const double next_cost = dp_map_[index] + kStepCost[i];
+        if (next_cost < dp_map_[next_index]) {
+          if (std::isinf(dp_map_[next_index])) {
+            ++explored_node_num;
+          }
+          dp_map_[next_index] = next_cost;
+          buckets[static_cast<int>(next_cost) % kBucketNum].push_back(
+              next_index);
+          ++pending_num;
         }
       }
     }
+    current.clear();
   }
+  dp_map_end_index_ = end_index;
   ADEBUG << "explored node num is " << explored_node_num;
   return true;
 }
 
 double GridSearch::CheckDpMap(const double sx, const double sy) {
-  std::string index = Node2d::CalcIndex(sx, sy, xy_grid_resolution_, XYbounds_);
-  if (dp_map_.find(index) != dp_map_.end()) {
-    return dp_map_[index]->GetCost() * xy_grid_resolution_;
-  } else {
+  if (dp_map_end_index_ < 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  const int grid_x =
+      static_cast<int>((sx - XYbounds_[0]) / xy_grid_resolution_);
+  const int grid_y =
+      static_cast<int>((sy - XYbounds_[2]) / xy_grid_resolution_);
+  if (!IsInGrid(grid_x, grid_y)) {
     return std::numeric_limits<double>::infinity();
   }
+  return dp_map_[GridIndex(grid_x, grid_y)] * xy_grid_resolution_;
 }
 
 void GridSearch::LoadGridAStarResult(GridAStartResult* result) {
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <queue>
@@ -33,6 +34,7 @@
 #include "modules/planning/planning_base/proto/planner_open_space_config.pb.h"
 
 #include "cyber/common/log.h"
+#include "modules/common/math/aabox2d.h"
 #include "modules/common/math/line_segment2d.h"
 
 namespace apollo {
@@ -113,6 +115,11 @@ class GridSearch {
       const std::vector<std::vector<common::math::LineSegment2d>>&
           obstacles_linesegments_vec,
       GridAStartResult* result);
+  /**
+   * @brief Compute the cost of reaching (ex, ey) from every grid around the
+   * obstacles. The map of the previous call is kept if neither the end grid
+   * nor the bounds and obstacles changed.
+   */
   bool GenerateDpMap(
       const double ex, const double ey, const std::vector<double>& XYbounds,
       const std::vector<std::vector<common::math::LineSegment2d>>&
@@ -126,6 +133,21 @@ class GridSearch {
       std::shared_ptr<Node2d> node);
   bool CheckConstraints(std::shared_ptr<Node2d> node);
   void LoadGridAStarResult(GridAStartResult* result);
+  // rasterize the obstacles within XYbounds, false if they did not change
+  bool UpdateObstacleGrid(
+      const std::vector<double>& XYbounds,
+      const std::vector<std::vector<common::math::LineSegment2d>>&
+          obstacles_linesegments_vec);
+  bool IsSameObstacles(
+      const std::vector<std::vector<common::math::LineSegment2d>>&
+          obstacles_linesegments_vec) const;
+  bool IsInGrid(const int grid_x, const int grid_y) const {
+    return grid_x >= 0 && grid_x < grid_x_num_ && grid_y >= 0 &&
+           grid_y < grid_y_num_;
+  }
+  int GridIndex(const int grid_x, const int grid_y) const {
+    return grid_y * grid_x_num_ + grid_x;
+  }
 
  private:
   double xy_grid_resolution_ = 0.0;
@@ -145,7 +167,14 @@ class GridSearch {
       return left.second >= right.second;
     }
   };
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> dp_map_;
+  int grid_x_num_ = 0;
+  int grid_y_num_ = 0;
+  // 1 for the grids closer than node_radius_ to an obstacle
+  std::vector<uint8_t> obstacle_grid_;
+  // cost to the end grid in grids, infinity where it cannot be reached
+  std::vector<double> dp_map_;
+  // index of the end grid of dp_map_, -1 if there is no map
+  int dp_map_end_index_ = -1;
 };
 }  // namespace planning
 }  // namespace apollo
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+#include "modules/planning/planning_base/open_space/coarse_trajectory_generator/grid_search.h"
+
+#include <cmath>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/math/vec2d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+class GridSearchTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    PlannerOpenSpaceConfig planner_open_space_config;
+    auto* warm_start_config =
+        planner_open_space_config.mutable_warm_start_config();
+    warm_start_config->set_grid_a_star_xy_resolution(1.0);
+    warm_start_config->set_node_radius(0.5);
+    grid_search_ =
+        std::unique_ptr<GridSearch>(new GridSearch(planner_open_space_config));
+  }
+
+ protected:
+  std::unique_ptr<GridSearch> grid_search_;
+  const std::vector<double> XYbounds_ = {0.0, 10.0, 0.0, 10.0};
+  const double kSqrt2 = std::sqrt(2.0);
+};
+
+TEST_F(GridSearchTest, DpMapWithoutObstacles) {
+  EXPECT_EQ(grid_search_->CheckDpMap(3.0, 4.0),
+            std::numeric_limits<double>::infinity());
+  ASSERT_TRUE(grid_search_->GenerateDpMap(0.0, 0.0, XYbounds_, {}));
+  EXPECT_DOUBLE_EQ(grid_search_->CheckDpMap(0.0, 0.0), 0.0);
+  EXPECT_DOUBLE_EQ(grid_search_->CheckDpMap(3.0, 0.0), 3.0);
+  // 8-connected shortest paths take the diagonal as long as they can
+  EXPECT_DOUBLE_EQ(grid_search_->CheckDpMap(3.0, 4.0), 1.0 + 3.0 * kSqrt2);
+  EXPECT_DOUBLE_EQ(grid_search_->CheckDpMap(10.0, 10.0), 10.0 * kSqrt2);
+  EXPECT_EQ(grid_search_->CheckDpMap(10.5, 11.0),
+            std::numeric_limits<double>::infinity());
+
+  EXPECT_FALSE(grid_search_->GenerateDpMap(12.0, 0.0, XYbounds_, {}));
+  EXPECT_EQ(grid_search_->CheckDpMap(0.0, 0.0),
+            std::numeric_limits<double>::infinity());
+}
+
+TEST_F(GridSearchTest, DpMapAroundObstacles) {
+  const std::vector<std::vector<LineSegment2d>> wall = {
+      {LineSegment2d(Vec2d(5.0, -1.0), Vec2d(5.0, 8.0))}};
+  ASSERT_TRUE(grid_search_->GenerateDpMap(0.0, 0.0, XYbounds_, wall));
+  EXPECT_EQ(grid_search_->CheckDpMap(5.0, 3.0),
+            std::numeric_limits<double>::infinity());
+  // around the end of the wall at (5, 9)
+  EXPECT_NEAR(grid_search_->CheckDpMap(9.0, 0.0), 9.0 + 9.0 * kSqrt2, 1e-9);
+
+  // the same end with a shorter wall, around its end at (5, 5)
+  const std::vector<std::vector<LineSegment2d>> lower_wall = {
+      {LineSegment2d(Vec2d(5.0, -1.0), Vec2d(5.0, 4.0))}};
+  ASSERT_TRUE(grid_search_->GenerateDpMap(0.0, 0.0, XYbounds_, lower_wall));
+  EXPECT_NEAR(grid_search_->CheckDpMap(9.0, 0.0), 1.0 + 9.0 * kSqrt2, 1e-9);
+
+  // another end with the same wall
+  ASSERT_TRUE(grid_search_->GenerateDpMap(9.0, 0.0, XYbounds_, lower_wall));
+  EXPECT_DOUBLE_EQ(grid_search_->CheckDpMap(9.0, 0.0), 0.0);
+  EXPECT_NEAR(grid_search_->CheckDpMap(0.0, 0.0), 1.0 + 9.0 * kSqrt2, 1e-9);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -130,6 +130,25 @@ bool HybridAStar::RSPCheck(
   return ValidityCheck(node);
 }
 
+void HybridAStar::BuildObstacleSegmentsKDTree() {
+  obstacle_segments_kdtree_.reset();
+  obstacle_segments_.clear();
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
+    for (const auto& linesegment : obstacle_linesegments) {
+      obstacle_segments_.emplace_back(&linesegment);
+    }
+  }
+  if (obstacle_segments_.empty()) {
+    return;
+  }
+  common::math::AABoxKDTreeParams params;
+  params.max_leaf_dimension = 5.0;  // meters.
+  params.max_leaf_size = 4;
+  obstacle_segments_kdtree_ =
+      std::make_unique<common::math::AABoxKDTree2d<ObstacleSegment>>(
+          obstacle_segments_, params);
+}
+
 bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
   CHECK_NOTNULL(node);
   CHECK_GT(node->GetStepSize(), 0U);
@@ -159,16 +178,21 @@ bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
     }
     Box2d bounding_box = Node3d::GetBoundingBox(
         vehicle_param_, traversed_x[i], traversed_y[i], traversed_phi[i]);
-    for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
-      for (const common::math::LineSegment2d& linesegment :
-           obstacle_linesegments) {
-        if (bounding_box.HasOverlap(linesegment)) {
-          ADEBUG << "collision start at x: " << linesegment.start().x();
-          ADEBUG << "collision start at y: " << linesegment.start().y();
-          ADEBUG << "collision end at x: " << linesegment.end().x();
-          ADEBUG << "collision end at y: " << linesegment.end().y();
-          return false;
-        }
+    if (obstacle_segments_kdtree_ == nullptr) {
+      // the obstacles have no segment
+      continue;
+    }
+    // only segments within the circumcircle of the box can overlap it
+    const auto candidates = obstacle_segments_kdtree_->GetObjects(
+        bounding_box.center(), bounding_box.diagonal() / 2.0);
+    for (const ObstacleSegment* candidate : candidates) {
+      const common::math::LineSegment2d& linesegment = candidate->segment();
+      if (bounding_box.HasOverlap(linesegment)) {
+        ADEBUG << "collision start at x: " << linesegment.start().x();
+        ADEBUG << "collision start at y: " << linesegment.start().y();
+        ADEBUG << "collision end at x: " << linesegment.end().x();
+        ADEBUG << "collision end at y: " << linesegment.end().y();
+        return false;
       }
     }
   }
@@ -698,6 +722,7 @@ bool HybridAStar::Plan(
   close_set_.clear();
   open_pq_ = decltype(open_pq_)();
   final_node_ = nullptr;
+  explored_node_num_ = 0;
   PrintCurves print_curves;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec;
@@ -712,6 +737,7 @@ bool HybridAStar::Plan(
     obstacles_linesegments_vec.emplace_back(obstacle_linesegments);
   }
   obstacles_linesegments_vec_ = std::move(obstacles_linesegments_vec);
+  BuildObstacleSegmentsKDTree();
   for (size_t i = 0; i < obstacles_linesegments_vec_.size(); i++) {
     for (auto linesg : obstacles_linesegments_vec_[i]) {
       std::string name = std::to_string(i) + "roi_boundary";
@@ -845,6 +871,7 @@ bool HybridAStar::Plan(
     }
     open_set_.insert(temp_set.begin(), temp_set.end());
   }
+  explored_node_num_ = explored_node_num;
 
   if (final_node_ == nullptr) {
     AERROR << "Hybird A* cannot find a valid path";
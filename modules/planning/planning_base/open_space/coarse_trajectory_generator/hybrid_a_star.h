@@ -36,6 +36,8 @@
 #include "cyber/common/macros.h"
 #include "cyber/time/clock.h"
 #include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/common/math/aaboxkdtree2d.h"
+#include "modules/common/math/line_segment2d.h"
 #include "modules/common/math/math_utils.h"
 #include "modules/planning/planning_base/common/obstacle.h"
 #include "modules/planning/planning_base/gflags/planning_gflags.h"
@@ -56,6 +58,22 @@ struct HybridAStartResult {
   std::vector<double> accumulated_s;
 };
 
+// an obstacle line segment as stored in the AABoxKDTree2d of a search
+class ObstacleSegment {
+ public:
+  explicit ObstacleSegment(const common::math::LineSegment2d* segment)
+      : segment_(segment), aabox_(segment->start(), segment->end()) {}
+  const common::math::AABox2d& aabox() const { return aabox_; }
+  double DistanceSquareTo(const common::math::Vec2d& point) const {
+    return segment_->DistanceSquareTo(point);
+  }
+  const common::math::LineSegment2d& segment() const { return *segment_; }
+
+ private:
+  const common::math::LineSegment2d* segment_;
+  common::math::AABox2d aabox_;
+};
+
 class HybridAStar {
  public:
   explicit HybridAStar(const PlannerOpenSpaceConfig& open_space_conf);
@@ -67,8 +85,12 @@ class HybridAStar {
             HybridAStartResult* result);
   bool TrajectoryPartition(const HybridAStartResult& result,
                            std::vector<HybridAStartResult>* partitioned_result);
+  // number of nodes the last Plan expanded
+  size_t GetExploredNodeNum() const { return explored_node_num_; }
 
  private:
+  // index obstacles_linesegments_vec_ for ValidityCheck
+  void BuildObstacleSegmentsKDTree();
   bool AnalyticExpansion(std::shared_ptr<Node3d> current_node,
                          std::shared_ptr<Node3d>* candidate_final_node);
   // check collision and validity
@@ -121,12 +143,16 @@ class HybridAStar {
   double max_reverse_acc_ = 0.0;
   double max_acc_jerk_ = 0.0;
   double arc_length_ = 0.0;
+  size_t explored_node_num_ = 0;
   std::vector<double> XYbounds_;
   std::shared_ptr<Node3d> start_node_;
   std::shared_ptr<Node3d> end_node_;
   std::shared_ptr<Node3d> final_node_;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
+  std::vector<ObstacleSegment> obstacle_segments_;
+  std::unique_ptr<common::math::AABoxKDTree2d<ObstacleSegment>>
+      obstacle_segments_kdtree_;
 
   struct cmp {
     bool operator()(
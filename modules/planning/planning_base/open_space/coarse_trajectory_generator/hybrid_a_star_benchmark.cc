@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ * Benchmarks the Hybrid A* searches of the hybrid_a_star_test scenario and
+ * of a parking slot whose curbs come as the many short segments
+ * OpenSpaceRoiDecider produces, and the holonomic heuristic map of a whole
+ * parking lot they start with. The searches report their node expansions
+ * per second. To run it:
+ *
+ *   bazel run -c opt //modules/planning/planning_base:hybrid_a_star_benchmark
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
+#include "modules/planning/planning_base/open_space/coarse_trajectory_generator/hybrid_a_star.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Vec2d;
+
+namespace {
+
+struct Scenario {
+  double sx, sy, sphi;
+  double ex, ey, ephi;
+  std::vector<double> XYbounds;
+  std::vector<std::vector<Vec2d>> obstacles_list;
+};
+
+// the open space planner configuration of the planning module
+PlannerOpenSpaceConfig LoadConfig() {
+  PlannerOpenSpaceConfig planner_open_space_config;
+  ACHECK(apollo::cyber::common::GetProtoFromFile(
+      FLAGS_planner_open_space_config_filename, &planner_open_space_config))
+      << "Failed to load open space config file "
+      << FLAGS_planner_open_space_config_filename;
+  return planner_open_space_config;
+}
+
+// a polyline through `corners` with vertices every `step` meters
+std::vector<Vec2d> Densify(const std::vector<Vec2d>& corners, double step) {
+  std::vector<Vec2d> vertices = {corners.front()};
+  for (size_t i = 1; i < corners.size(); ++i) {
+    const Vec2d edge = corners[i] - corners[i - 1];
+    const int pieces = std::max(1, static_cast<int>(edge.Length() / step));
+    for (int j = 1; j <= pieces; ++j) {
+      vertices.push_back(corners[i - 1] + edge * (j / double(pieces)));
+    }
+  }
+  return vertices;
+}
+
+Scenario OpenField() {
+  Scenario scenario{-15.0, 0.0, 0.0, 15.0, 0.0, 0.0};
+  scenario.XYbounds = {-50.0, 50.0, -50.0, 50.0};
+  scenario.obstacles_list = {{Vec2d(1.0, 0.0), Vec2d(-1.0, 0.0)}};
+  return scenario;
+}
+
+// reverse into a 3m x 6m perpendicular slot off an 8m wide aisle
+Scenario ParkingSlot() {
+  Scenario scenario{-10.0, 2.5, 0.0, 0.0, -6.0, M_PI_2};
+  scenario.XYbounds = {-20.0, 20.0, -10.0, 10.0};
+  constexpr double kCurbStep = 0.25;
+  scenario.obstacles_list = {
+      Densify({Vec2d(-20.0, -1.5), Vec2d(-1.5, -1.5), Vec2d(-1.5, -7.5),
+               Vec2d(1.5, -7.5), Vec2d(1.5, -1.5), Vec2d(20.0, -1.5)},
+              kCurbStep),
+      Densify({Vec2d(20.0, 6.5), Vec2d(-20.0, 6.5)}, kCurbStep)};
+  return scenario;
+}
+
+// rows of curbs across a 100m x 100m lot
+Scenario ParkingLot() {
+  Scenario scenario{-45.0, 0.0, 0.0, 45.0, 0.0, 0.0};
+  scenario.XYbounds = {-50.0, 50.0, -50.0, 50.0};
+  constexpr double kCurbStep = 0.25;
+  for (double y = -42.0; y <= 42.0; y += 12.0) {
+    scenario.obstacles_list.push_back(
+        Densify({Vec2d(-50.0, y), Vec2d(35.0, y)}, kCurbStep));
+  }
+  return scenario;
+}
+
+void RunScenario(const Scenario& scenario, benchmark::State& state) {
+  HybridAStar hybrid_a_star(LoadConfig());
+  size_t explored_node_num = 0;
+  size_t segment_num = 0;
+  for (const auto& obstacle : scenario.obstacles_list) {
+    segment_num += obstacle.size() - 1;
+  }
+  for (auto _ : state) {
+    HybridAStartResult result;
+    if (!hybrid_a_star.Plan(scenario.sx, scenario.sy, scenario.sphi,
+                            scenario.ex, scenario.ey, scenario.ephi,
+                            scenario.XYbounds, scenario.obstacles_list,
+                            &result)) {
+      state.SkipWithError("Hybrid A* failed");
+      break;
+    }
+    explored_node_num += hybrid_a_star.GetExploredNodeNum();
+  }
+  state.counters["expansions"] = benchmark::Counter(
+      static_cast<double>(explored_node_num), benchmark::Counter::kIsRate);
+  state.counters["segments"] = static_cast<double>(segment_num);
+}
+
+}  // namespace
+
+static void BM_OpenField(benchmark::State& state) {
+  RunScenario(OpenField(), state);
+}
+BENCHMARK(BM_OpenField)->Unit(benchmark::kMillisecond);
+
+static void BM_ParkingSlot(benchmark::State& state) {
+  RunScenario(ParkingSlot(), state);
+}
+BENCHMARK(BM_ParkingSlot)->Unit(benchmark::kMillisecond);
+
+std::vector<std::vector<common::math::LineSegment2d>> LineSegments(
+    const std::vector<std::vector<Vec2d>>& obstacles_list, double shift) {
+  std::vector<std::vector<common::math::LineSegment2d>>
+      obstacles_linesegments_vec;
+  for (const auto& obstacle_vertices : obstacles_list) {
+    std::vector<common::math::LineSegment2d> obstacle_linesegments;
+    for (size_t i = 0; i + 1 < obstacle_vertices.size(); ++i) {
+      obstacle_linesegments.emplace_back(
+          obstacle_vertices[i] + Vec2d(0.0, shift),
+          obstacle_vertices[i + 1] + Vec2d(0.0, shift));
+    }
+    obstacles_linesegments_vec.emplace_back(std::move(obstacle_linesegments));
+  }
+  return obstacles_linesegments_vec;
+}
+
+// The map of the lot when replanning with range(0) of
+// 0: obstacles that moved, 1: another end, 2: the same end and obstacles.
+static void BM_GenerateDpMap(benchmark::State& state) {
+  const Scenario scenario = ParkingLot();
+  const std::vector<std::vector<common::math::LineSegment2d>>
+      obstacles_linesegments_vecs[] = {
+          LineSegments(scenario.obstacles_list, 0.0),
+          LineSegments(scenario.obstacles_list, 0.1)};
+  GridSearch grid_search(LoadConfig());
+  int replan = 0;
+  for (auto _ : state) {
+    const int variant = state.range(0) < 2 ? replan++ % 2 : 0;
+    const double ey = state.range(0) == 1 ? variant * 6.0 : 0.0;
+    grid_search.GenerateDpMap(
+        scenario.ex, ey, scenario.XYbounds,
+        obstacles_linesegments_vecs[state.range(0) == 0 ? variant : 0]);
+    benchmark::DoNotOptimize(
+        grid_search.CheckDpMap(scenario.sx, scenario.sy));
+  }
+}
+BENCHMARK(BM_GenerateDpMap)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -20,16 +20,20 @@
 
 #include "modules/planning/planning_interface_base/scenario_base/stage.h"
 
+#include <algorithm>
+#include <future>
 #include <unordered_map>
 #include <utility>
 
 #include "cyber/plugin_manager/plugin_manager.h"
+#include "cyber/task/task.h"
 #include "cyber/time/clock.h"
 #include "modules/planning/planning_base/common/frame.h"
 #include "modules/planning/planning_base/common/planning_context.h"
 #include "modules/planning/planning_base/common/speed_profile_generator.h"
 #include "modules/planning/planning_base/common/trajectory/publishable_trajectory.h"
 #include "modules/planning/planning_base/common/util/config_util.h"
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
 #include "modules/planning/planning_interface_base/task_base/task.h"
 
 namespace apollo {
@@ -54,6 +58,28 @@ bool Stage::Init(const StagePipeline& config,
       ->set_stage_type(name_);
   std::string path_name = ConfigUtil::TransformToPathName(name_);
   std::string task_config_dir = config_dir + "/" + path_name;
+  if (!CreateTasks(injector, task_config_dir, &task_list_, &fallback_task_)) {
+    return false;
+  }
+  parallel_pipelines_.clear();
+  if (FLAGS_enable_parallel_reference_line_tasks) {
+    for (int i = 0; i < FLAGS_max_parallel_reference_lines; ++i) {
+      TaskPipeline pipeline;
+      pipeline.injector = std::make_shared<DependencyInjector>(injector);
+      if (!CreateTasks(pipeline.injector, task_config_dir,
+                       &pipeline.task_list, &pipeline.fallback_task)) {
+        return false;
+      }
+      parallel_pipelines_.push_back(std::move(pipeline));
+    }
+  }
+  return true;
+}
+
+bool Stage::CreateTasks(const std::shared_ptr<DependencyInjector>& injector,
+                        const std::string& task_config_dir,
+                        std::vector<std::shared_ptr<Task>>* task_list,
+                        std::shared_ptr<Task>* fallback_task) const {
   // Load task plugin.
   for (int i = 0; i < pipeline_config_.task_size(); ++i) {
     auto task = pipeline_config_.task(i);
@@ -66,7 +92,7 @@ bool Stage::Init(const StagePipeline& config,
       return false;
     }
     if (task_ptr->Init(task_config_dir, task.name(), injector)) {
-      task_list_.push_back(task_ptr);
+      task_list->push_back(task_ptr);
     } else {
       AERROR << task.name() << " init failed!";
       return false;
@@ -80,16 +106,16 @@ bool Stage::Init(const StagePipeline& config,
     fallback_task_type = pipeline_config_.fallback_task().type();
     fallback_task_name = pipeline_config_.fallback_task().name();
   }
-  fallback_task_ =
+  *fallback_task =
       apollo::cyber::plugin_manager::PluginManager::Instance()
           ->CreateInstance<Task>(
               ConfigUtil::GetFullPlanningClassName(fallback_task_type));
-  if (nullptr == fallback_task_) {
+  if (nullptr == *fallback_task) {
     AERROR << "Create fallback task " << fallback_task_name << " of " << name_
            << " failed!";
     return false;
   }
-  if (!fallback_task_->Init(task_config_dir, fallback_task_name, injector)) {
+  if (!(*fallback_task)->Init(task_config_dir, fallback_task_name, injector)) {
     AERROR << fallback_task_name << " init failed!";
     return false;
   }
@@ -105,6 +131,7 @@ StageResult Stage::ExecuteTaskOnReferenceLine(
     AERROR << "referenceline is empty in stage" << name_;
     return stage_result.SetStageStatus(StageStatusType::ERROR);
   }
+  std::vector<ReferenceLineInfo*> reference_line_infos;
   for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
     if (!reference_line_info.IsDrivable()) {
       AERROR << "The generated path is not drivable skip";
@@ -117,46 +144,132 @@ StageResult Stage::ExecuteTaskOnReferenceLine(
       reference_line_info.SetDrivable(false);
       continue;
     }
-    common::Status ret = common::Status::OK();
-    for (auto task : task_list_) {
-      const double start_timestamp = Clock::NowInSeconds();
-
-      ret = task->Execute(frame, &reference_line_info);
-
-      const double end_timestamp = Clock::NowInSeconds();
-      const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
-      ADEBUG << "after task[" << task->Name()
-             << "]: " << reference_line_info.PathSpeedDebugString();
-      ADEBUG << task->Name() << " time spend: " << time_diff_ms << " ms.";
-      RecordDebugInfo(&reference_line_info, task->Name(), time_diff_ms);
-
-      if (!ret.ok()) {
-        stage_result.SetTaskStatus(ret);
-        AERROR << "Failed to run tasks[" << task->Name()
-               << "], Error message: " << ret.error_message();
-        break;
-      }
-    }
-    // Generate fallback trajectory in case of task error.
-    if (!ret.ok()) {
-      fallback_task_->Execute(frame, &reference_line_info);
-    }
-    DiscretizedTrajectory trajectory;
-    if (!reference_line_info.CombinePathAndSpeedProfile(
-            planning_start_point.relative_time(),
-            planning_start_point.path_point().s(), &trajectory)) {
-      AERROR << "Fail to aggregate planning trajectory."
-             << reference_line_info.IsChangeLanePath();
-      reference_line_info.SetDrivable(false);
+    if (IsParallel()) {
+      reference_line_infos.push_back(&reference_line_info);
       continue;
     }
-    reference_line_info.SetTrajectory(trajectory);
-    reference_line_info.SetDrivable(true);
+    if (ExecuteTasks(task_list_, fallback_task_.get(), planning_start_point,
+                     frame, &reference_line_info, &stage_result)) {
+      return stage_result;
+    }
+  }
+  if (reference_line_infos.empty()) {
     return stage_result;
   }
+
+  const auto results = PlanInParallel(
+      reference_line_infos,
+      [&](const TaskPipeline& pipeline,
+          ReferenceLineInfo* reference_line_info) {
+        StageResult result;
+        if (!ExecuteTasks(pipeline.task_list, pipeline.fallback_task.get(),
+                          planning_start_point, frame, reference_line_info,
+                          &result)) {
+          result.SetStageStatus(StageStatusType::ERROR);
+        }
+        return result;
+      },
+      [](const StageResult& result, const ReferenceLineInfo&) {
+        return !result.HasError();
+      });
+  for (size_t i = 0; i < reference_line_infos.size(); ++i) {
+    if (i >= results.size()) {
+      // planned all the same, but past the one to drive on
+      reference_line_infos[i]->SetDrivable(false);
+    } else if (results[i].IsTaskError()) {
+      stage_result.SetTaskStatus(results[i].GetTaskStatus());
+    }
+  }
   return stage_result;
 }
 
+bool Stage::ExecuteTasks(const std::vector<std::shared_ptr<Task>>& task_list,
+                         Task* fallback_task,
+                         const common::TrajectoryPoint& planning_start_point,
+                         Frame* frame, ReferenceLineInfo* reference_line_info,
+                         StageResult* stage_result) {
+  common::Status ret = common::Status::OK();
+  for (auto task : task_list) {
+    const double start_timestamp = Clock::NowInSeconds();
+
+    ret = task->Execute(frame, reference_line_info);
+
+    const double end_timestamp = Clock::NowInSeconds();
+    const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+    ADEBUG << "after task[" << task->Name()
+           << "]: " << reference_line_info->PathSpeedDebugString();
+    ADEBUG << task->Name() << " time spend: " << time_diff_ms << " ms.";
+    RecordDebugInfo(reference_line_info, task->Name(), time_diff_ms);
+
+    if (!ret.ok()) {
+      stage_result->SetTaskStatus(ret);
+      AERROR << "Failed to run tasks[" << task->Name()
+             << "], Error message: " << ret.error_message();
+      break;
+    }
+  }
+  // Generate fallback trajectory in case of task error.
+  if (!ret.ok()) {
+    fallback_task->Execute(frame, reference_line_info);
+  }
+  DiscretizedTrajectory trajectory;
+  if (!reference_line_info->CombinePathAndSpeedProfile(
+          planning_start_point.relative_time(),
+          planning_start_point.path_point().s(), &trajectory)) {
+    AERROR << "Fail to aggregate planning trajectory."
+           << reference_line_info->IsChangeLanePath();
+    reference_line_info->SetDrivable(false);
+    return false;
+  }
+  reference_line_info->SetTrajectory(trajectory);
+  reference_line_info->SetDrivable(true);
+  return true;
+}
+
+std::vector<StageResult> Stage::PlanInParallel(
+    const std::vector<ReferenceLineInfo*>& reference_line_infos,
+    const PlanFunc& plan, const DoneFunc& done) {
+  std::vector<StageResult> results;
+  auto* planning_context = injector_->planning_context();
+  const size_t pipeline_num = parallel_pipelines_.size();
+  for (size_t begin = 0; begin < reference_line_infos.size();
+       begin += pipeline_num) {
+    const size_t end =
+        std::min(begin + pipeline_num, reference_line_infos.size());
+    const PlanningStatus base = planning_context->planning_status();
+    for (size_t i = begin; i < end; ++i) {
+      parallel_pipelines_[i - begin]
+          .injector->planning_context()
+          ->mutable_planning_status()
+          ->CopyFrom(base);
+    }
+    // the last line of the batch is planned right here, while the task pool
+    // plans the others
+    std::vector<std::future<StageResult>> futures;
+    for (size_t i = begin; i + 1 < end; ++i) {
+      futures.push_back(cyber::Async(plan,
+                                     std::cref(parallel_pipelines_[i - begin]),
+                                     reference_line_infos[i]));
+    }
+    const StageResult last_result = plan(parallel_pipelines_[end - 1 - begin],
+                                         reference_line_infos[end - 1]);
+    for (auto& future : futures) {
+      results.push_back(future.get());
+    }
+    results.push_back(last_result);
+    for (size_t i = begin; i < end; ++i) {
+      planning_context->MergeChanges(base, parallel_pipelines_[i - begin]
+                                               .injector->planning_context()
+                                               ->planning_status());
+      if (done(results[i], *reference_line_infos[i])) {
+        results.resize(i + 1);
+        return results;
+      }
+    }
+  }
+  return results;
+}
+
 StageResult Stage::ExecuteTaskOnReferenceLineForOnlineLearning(
     const common::TrajectoryPoint& planning_start_point, Frame* frame) {
   // online learning mode
@@ -20,11 +20,14 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "gtest/gtest_prod.h"
+
 #include "modules/planning/planning_interface_base/scenario_base/proto/scenario_pipeline.pb.h"
 
 #include "modules/planning/planning_base/common/dependency_injector.h"
@@ -79,11 +82,58 @@ class Stage {
 
   StageResult ExecuteTaskOnOpenSpace(Frame* frame);
 
+  /**
+   * @brief The tasks, with the dependency injector they were created with,
+   * a reference line is planned with.
+   */
+  struct TaskPipeline {
+    std::shared_ptr<DependencyInjector> injector;
+    std::vector<std::shared_ptr<Task>> task_list;
+    std::shared_ptr<Task> fallback_task;
+  };
+
+  using PlanFunc = std::function<StageResult(
+      const TaskPipeline& pipeline, ReferenceLineInfo* reference_line_info)>;
+  using DoneFunc = std::function<bool(
+      const StageResult& result, const ReferenceLineInfo& reference_line_info)>;
+
+  /**
+   * @brief Whether the reference lines are to be planned with
+   * PlanInParallel, see FLAGS_enable_parallel_reference_line_tasks.
+   */
+  bool IsParallel() const { return !parallel_pipelines_.empty(); }
+
+  /**
+   * @brief Plan `reference_line_infos` with `plan` at the same time on the
+   * task pool, FLAGS_max_parallel_reference_lines at a time, up to the first
+   * line `done` holds for, as planning them one after another would.
+   * Each line is planned with a pipeline and a planning context of its own,
+   * so that the tasks of one line do not see what those of another do; the
+   * changes the lines up to that one make to the planning status are applied
+   * to the one of the stage afterwards, in the order of the lines.
+   * @return The results of `plan`, in the order of the lines, up to and
+   * including the one `done` holds for.
+   */
+  std::vector<StageResult> PlanInParallel(
+      const std::vector<ReferenceLineInfo*>& reference_line_infos,
+      const PlanFunc& plan, const DoneFunc& done);
+
   virtual StageResult FinishScenario();
 
   void RecordDebugInfo(ReferenceLineInfo* reference_line_info,
                        const std::string& name, const double time_diff_ms);
 
+  /**
+   * @brief Run `task_list` on a reference line, then `fallback_task` if one
+   * of them fails, and combine its path and speed into its trajectory.
+   * @return False if there is no trajectory to combine.
+   */
+  bool ExecuteTasks(const std::vector<std::shared_ptr<Task>>& task_list,
+                    Task* fallback_task,
+                    const common::TrajectoryPoint& planning_start_point,
+                    Frame* frame, ReferenceLineInfo* reference_line_info,
+                    StageResult* stage_result);
+
   std::vector<std::shared_ptr<Task>> task_list_;
   std::shared_ptr<Task> fallback_task_;
   std::string next_stage_;
@@ -92,7 +142,15 @@ class Stage {
   StagePipeline pipeline_config_;
 
  private:
+  FRIEND_TEST(StageTest, PlanInParallel);
+
+  bool CreateTasks(const std::shared_ptr<DependencyInjector>& injector,
+                   const std::string& task_config_dir,
+                   std::vector<std::shared_ptr<Task>>* task_list,
+                   std::shared_ptr<Task>* fallback_task) const;
+
   std::string name_;
+  std::vector<TaskPipeline> parallel_pipelines_;
 };
 
 }  // namespace planning
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planning_interface_base/scenario_base/stage.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/planning_base/common/reference_line_info.h"
+
+namespace apollo {
+namespace planning {
+
+class TestStage : public Stage {
+ public:
+  StageResult Process(const common::TrajectoryPoint& planning_init_point,
+                      Frame* frame) override {
+    return StageResult();
+  }
+};
+
+TEST(StageTest, PlanInParallel) {
+  TestStage stage;
+  stage.injector_ = std::make_shared<DependencyInjector>();
+  for (int i = 0; i < 2; ++i) {
+    Stage::TaskPipeline pipeline;
+    pipeline.injector = std::make_shared<DependencyInjector>(stage.injector_);
+    stage.parallel_pipelines_.push_back(pipeline);
+  }
+  ASSERT_TRUE(stage.IsParallel());
+  auto* planning_status =
+      stage.injector_->planning_context()->mutable_planning_status();
+
+  std::vector<ReferenceLineInfo> lines(2);
+  const std::vector<ReferenceLineInfo*> reference_line_infos = {&lines[0],
+                                                                &lines[1]};
+  // each line changes the status of its own context, and is drivable when
+  // it is in `drivable_lines`
+  std::vector<bool> drivable_lines;
+  auto plan = [&](const Stage::TaskPipeline& pipeline,
+                  ReferenceLineInfo* reference_line_info) {
+    const size_t index = reference_line_info == &lines[0] ? 0 : 1;
+    auto* line_status =
+        pipeline.injector->planning_context()->mutable_planning_status();
+    // every line starts from the status of the stage
+    EXPECT_EQ("base", line_status->change_lane().path_id());
+    EXPECT_FALSE(line_status->destination().has_passed_destination());
+    line_status->mutable_change_lane()->set_path_id("line_" +
+                                                    std::to_string(index));
+    if (index == 1) {
+      line_status->mutable_destination()->set_has_passed_destination(true);
+    }
+    StageResult result;
+    if (!drivable_lines[index]) {
+      result.SetStageStatus(StageStatusType::ERROR);
+    }
+    return result;
+  };
+  auto done = [](const StageResult& result, const ReferenceLineInfo&) {
+    return !result.HasError();
+  };
+
+  // the first line fails, the changes of both are applied in line order
+  planning_status->mutable_change_lane()->set_path_id("base");
+  drivable_lines = {false, true};
+  auto results = stage.PlanInParallel(reference_line_infos, plan, done);
+  ASSERT_EQ(2, results.size());
+  EXPECT_TRUE(results[0].HasError());
+  EXPECT_FALSE(results[1].HasError());
+  EXPECT_EQ("line_1", planning_status->change_lane().path_id());
+  EXPECT_TRUE(planning_status->destination().has_passed_destination());
+
+  // the first line is the one to drive on, the second one is left out
+  planning_status->Clear();
+  planning_status->mutable_change_lane()->set_path_id("base");
+  drivable_lines = {true, true};
+  results = stage.PlanInParallel(reference_line_infos, plan, done);
+  ASSERT_EQ(1, results.size());
+  EXPECT_FALSE(results[0].HasError());
+  EXPECT_EQ("line_0", planning_status->change_lane().path_id());
+  EXPECT_FALSE(planning_status->destination().has_passed_destination());
+}
+
+}  // namespace planning
+}  // namespace apollo
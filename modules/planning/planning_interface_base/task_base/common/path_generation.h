@@ -22,6 +22,7 @@
 #include "modules/common/status/status.h"
 #include "modules/planning/planning_base/common/frame.h"
 #include "modules/planning/planning_base/common/path_boundary.h"
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_workspace.h"
 #include "modules/planning/planning_interface_base/task_base/common/path_util/path_bounds_decider_util.h"
 #include "modules/planning/planning_interface_base/task_base/task.h"
 
@@ -79,6 +80,9 @@ class PathGeneration : public Task {
                      SLBoundary* const sl_boundary);
 
   SLState init_sl_state_;
+
+  // the OSQP workspaces of the paths optimized by the task
+  PiecewiseJerkWorkspace path_workspace_;
 };
 
 }  // namespace planning
@@ -99,7 +99,8 @@ bool PathOptimizerUtil::OptimizePath(
     const PathBoundary& path_boundary,
     const std::vector<std::pair<double, double>>& ddl_bounds, double dddl_bound,
     const PiecewiseJerkPathConfig& config, std::vector<double>* x,
-    std::vector<double>* dx, std::vector<double>* ddx) {
+    std::vector<double>* dx, std::vector<double>* ddx,
+    PiecewiseJerkWorkspace* workspace) {
   // num of knots
   const auto& lat_boundaries = path_boundary.boundary();
   const size_t kNumKnots = lat_boundaries.size();
@@ -152,7 +153,8 @@ bool PathOptimizerUtil::OptimizePath(
 
   piecewise_jerk_problem.set_dddx_bound(dddl_bound);
 
-  bool success = piecewise_jerk_problem.Optimize(config.max_iteration());
+  bool success = piecewise_jerk_problem.Optimize(
+      workspace, path_boundary.start_s(), config.max_iteration());
 
   auto end_time = std::chrono::system_clock::now();
   std::chrono::duration<double> diff = end_time - start_time;
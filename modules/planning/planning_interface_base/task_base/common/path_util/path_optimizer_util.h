@@ -21,6 +21,7 @@
 
 #include "modules/planning/planning_base/common/path/path_data.h"
 #include "modules/planning/planning_base/common/path_boundary.h"
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_workspace.h"
 
 namespace apollo {
 namespace planning {
@@ -47,6 +48,8 @@ class PathOptimizerUtil {
 
   /**
    * @brief Piecewise jerk path optimizer.
+   * @param workspace the OSQP workspaces of the paths optimized before to
+   * solve in, or nullptr to set up a new one
    */
   static bool OptimizePath(
       const SLState& init_state, const std::array<double, 3>& end_state,
@@ -55,7 +58,7 @@ class PathOptimizerUtil {
       const std::vector<std::pair<double, double>>& ddl_bounds,
       double dddl_bound, const PiecewiseJerkPathConfig& config,
       std::vector<double>* x, std::vector<double>* dx,
-      std::vector<double>* ddx);
+      std::vector<double>* ddx, PiecewiseJerkWorkspace* workspace = nullptr);
 
   /**
    * @brief If ref_l is below or above path boundary, will update its values and
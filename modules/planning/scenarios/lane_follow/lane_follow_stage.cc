@@ -20,7 +20,9 @@
 
 #include "modules/planning/scenarios/lane_follow/lane_follow_stage.h"
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/log.h"
 #include "cyber/time/clock.h"
@@ -90,6 +92,30 @@ StageResult LaneFollowStage::Process(
   ADEBUG << "Number of reference lines:\t"
          << frame->mutable_reference_line_info()->size();
 
+  // The lines are planned up front in parallel, up to the one a sequential
+  // pass stops at, and picked from below in the same way.
+  std::vector<StageResult> results;
+  if (IsParallel()) {
+    std::vector<ReferenceLineInfo*> reference_line_infos;
+    for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
+      reference_line_infos.push_back(&reference_line_info);
+    }
+    results = PlanInParallel(
+        reference_line_infos,
+        [&](const TaskPipeline& pipeline,
+            ReferenceLineInfo* reference_line_info) {
+          return PlanOnReferenceLine(planning_start_point, frame,
+                                     reference_line_info, pipeline.task_list,
+                                     pipeline.fallback_task.get());
+        },
+        [](const StageResult& result,
+           const ReferenceLineInfo& reference_line_info) {
+          return !result.HasError() &&
+                 (!reference_line_info.IsChangeLanePath() ||
+                  reference_line_info.Cost() < kStraightForwardLineCost);
+        });
+  }
+
   unsigned int count = 0;
   StageResult result;
   for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
@@ -102,11 +128,16 @@ StageResult LaneFollowStage::Process(
 
     if (has_drivable_reference_line) {
       reference_line_info.SetDrivable(false);
+      if (IsParallel()) {
+        // may have been planned all the same
+        continue;
+      }
       break;
     }
 
-    result =
-        PlanOnReferenceLine(planning_start_point, frame, &reference_line_info);
+    result = IsParallel() ? results[count - 1]
+                          : PlanOnReferenceLine(planning_start_point, frame,
+                                                &reference_line_info);
 
     if (!result.HasError()) {
       if (!reference_line_info.IsChangeLanePath()) {
@@ -136,6 +167,14 @@ StageResult LaneFollowStage::Process(
 StageResult LaneFollowStage::PlanOnReferenceLine(
     const TrajectoryPoint& planning_start_point, Frame* frame,
     ReferenceLineInfo* reference_line_info) {
+  return PlanOnReferenceLine(planning_start_point, frame, reference_line_info,
+                             task_list_, fallback_task_.get());
+}
+
+StageResult LaneFollowStage::PlanOnReferenceLine(
+    const TrajectoryPoint& planning_start_point, Frame* frame,
+    ReferenceLineInfo* reference_line_info,
+    const std::vector<std::shared_ptr<Task>>& task_list, Task* fallback_task) {
   if (!reference_line_info->IsChangeLanePath()) {
     reference_line_info->AddCost(kStraightForwardLineCost);
   }
@@ -144,7 +183,7 @@ StageResult LaneFollowStage::PlanOnReferenceLine(
          << reference_line_info->IsChangeLanePath();
 
   StageResult ret;
-  for (auto task : task_list_) {
+  for (auto task : task_list) {
     const double start_timestamp = Clock::NowInSeconds();
 
     ret.SetTaskStatus(task->Execute(frame, reference_line_info));
@@ -175,7 +214,7 @@ StageResult LaneFollowStage::PlanOnReferenceLine(
   // check path and speed results for path or speed fallback
   reference_line_info->set_trajectory_type(ADCTrajectory::NORMAL);
   if (ret.IsTaskError()) {
-    fallback_task_->Execute(frame, reference_line_info);
+    fallback_task->Execute(frame, reference_line_info);
   }
 
   DiscretizedTrajectory trajectory;
@@ -45,9 +45,6 @@ using common::math::Box2d;
 using common::math::LineSegment2d;
 using common::math::Vec2d;
 
-int PathReferenceDecider::valid_path_reference_counter_ = 0;
-int PathReferenceDecider::total_path_counter_ = 0;
-
 bool PathReferenceDecider::Init(
     const std::string &config_dir, const std::string &name,
     const std::shared_ptr<DependencyInjector> &injector) {
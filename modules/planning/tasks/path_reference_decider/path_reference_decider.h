@@ -123,9 +123,9 @@ class PathReferenceDecider : public Task {
                        ReferenceLineInfo *const reference_line_info);
 
  private:
-  static int valid_path_reference_counter_;  // count valid path reference
-  static int total_path_counter_;            // count total path
-  PathReferenceDeciderConfig config_;        // the config the task
+  int valid_path_reference_counter_ = 0;  // count valid path reference
+  int total_path_counter_ = 0;            // count total path
+  PathReferenceDeciderConfig config_;     // the config the task
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(apollo::planning::PathReferenceDecider,
@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 #include "modules/common_msgs/basic_msgs/pnc_point.pb.h"
+#include "cyber/time/clock.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/planning/planning_base/gflags/planning_gflags.h"
 #include "modules/planning/planning_base/common/speed_profile_generator.h"
@@ -39,6 +40,7 @@ using apollo::common::PathPoint;
 using apollo::common::SpeedPoint;
 using apollo::common::Status;
 using apollo::common::TrajectoryPoint;
+using apollo::cyber::Clock;
 
 bool PiecewiseJerkSpeedOptimizer::Init(
     const std::string& config_dir, const std::string& name,
@@ -178,15 +180,16 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   piecewise_jerk_problem.set_penalty_dx(penalty_dx);
   piecewise_jerk_problem.set_dx_bounds(std::move(s_dot_bounds));
 
-  // Solve the problem
-  if (!piecewise_jerk_problem.Optimize()) {
+  // Solve the problem, the knots start from now in time
+  const double knots_start = Clock::NowInSeconds();
+  if (!piecewise_jerk_problem.Optimize(&workspace_, knots_start)) {
     const std::string msg = "Piecewise jerk speed optimizer failed!";
     AERROR << msg << ".try to fallback.";
     piecewise_jerk_problem.set_dx_bounds(
         0.0, std::fmax(FLAGS_planning_upper_speed_limit,
                        st_graph_data.init_point().v()));
     if (!FLAGS_speed_optimize_fail_relax_velocity_constraint ||
-        !piecewise_jerk_problem.Optimize()) {
+        !piecewise_jerk_problem.Optimize(&workspace_, knots_start)) {
       speed_data->clear();
       print_debug.AddPoint("optimize_st_curve", 0, init_s[0]);
       print_debug.AddPoint("optimize_vt_curve", 0, init_s[1]);
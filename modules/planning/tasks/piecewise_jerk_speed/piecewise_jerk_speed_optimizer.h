@@ -26,6 +26,7 @@
 #include <vector>
 #include "modules/planning/tasks/piecewise_jerk_speed/proto/piecewise_jerk_speed.pb.h"
 #include "cyber/plugin_manager/plugin_manager.h"
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_workspace.h"
 #include "modules/planning/planning_interface_base/task_base/common/speed_optimizer.h"
 
 namespace apollo {
@@ -46,6 +47,8 @@ class PiecewiseJerkSpeedOptimizer : public SpeedOptimizer {
       const std::vector<std::pair<double, double>> s_dot_bound, double delta_t,
       std::array<double, 3>& init_s);
   PiecewiseJerkSpeedOptimizerConfig config_;
+  // the OSQP workspaces of the speed profiles optimized by the task
+  PiecewiseJerkWorkspace workspace_;
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(
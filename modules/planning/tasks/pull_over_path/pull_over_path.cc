@@ -210,7 +210,8 @@ bool PullOverPath::OptimizePath(
 
     bool res_opt = PathOptimizerUtil::OptimizePath(
         init_sl_state_, end_state, ref_l, weight_ref_l, path_boundary,
-        ddl_bounds, jerk_bound, path_config, &opt_l, &opt_dl, &opt_ddl);
+        ddl_bounds, jerk_bound, path_config, &opt_l, &opt_dl, &opt_ddl,
+        &path_workspace_);
     if (res_opt) {
       auto frenet_frame_path = PathOptimizerUtil::ToPiecewiseJerkPath(
           opt_l, opt_dl, opt_ddl, path_boundary.delta_s(),
@@ -134,24 +134,21 @@ void RuleBasedStopDecider::AddPathEndStop(
 
 void RuleBasedStopDecider::StopOnSidePass(
     Frame *const frame, ReferenceLineInfo *const reference_line_info) {
-  static bool check_clear;
-  static common::PathPoint change_lane_stop_path_point;
-
   const PathData &path_data = reference_line_info->path_data();
   double stop_s_on_pathdata = 0.0;
 
   if (path_data.path_label().find("self") != std::string::npos) {
-    check_clear = false;
-    change_lane_stop_path_point.Clear();
+    side_pass_check_clear_ = false;
+    side_pass_stop_point_.Clear();
     return;
   }
 
-  if (check_clear &&
-      CheckClearDone(*reference_line_info, change_lane_stop_path_point)) {
-    check_clear = false;
+  if (side_pass_check_clear_ &&
+      CheckClearDone(*reference_line_info, side_pass_stop_point_)) {
+    side_pass_check_clear_ = false;
   }
 
-  if (!check_clear &&
+  if (!side_pass_check_clear_ &&
       CheckSidePassStop(path_data, *reference_line_info, &stop_s_on_pathdata)) {
     if (!IsPerceptionBlocked(*reference_line_info, config_.search_beam_length(),
                              config_.search_beam_radius_intensity(),
@@ -162,13 +159,13 @@ void RuleBasedStopDecider::StopOnSidePass(
     }
     if (!CheckADCStop(path_data, *reference_line_info, stop_s_on_pathdata)) {
       if (!BuildSidePassStopFence(path_data, stop_s_on_pathdata,
-                                  &change_lane_stop_path_point, frame,
+                                  &side_pass_stop_point_, frame,
                                   reference_line_info)) {
         AERROR << "Set side pass stop fail";
       }
     } else {
       if (IsClearToChangeLane(reference_line_info)) {
-        check_clear = true;
+        side_pass_check_clear_ = true;
       }
     }
   }
@@ -73,6 +73,10 @@ class RuleBasedStopDecider : public Decider {
   RuleBasedStopDeciderConfig config_;
   bool is_clear_to_change_lane_ = false;
   bool is_change_lane_planning_succeed_ = false;
+  // StopOnSidePass state kept across frames, per task instance so that
+  // reference lines planned in parallel do not share it
+  bool side_pass_check_clear_ = false;
+  common::PathPoint side_pass_stop_point_;
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(apollo::planning::RuleBasedStopDecider,
@@ -0,0 +1,15 @@
+"""Loads the bzip2 library"""
+
+# Sanitize a dependency so that it works correctly from code that includes
+# Apollo as a submodule.
+def clean_dep(dep):
+    return str(Label(dep))
+
+# Installed via libbz2-dev
+def repo():
+    # bzip2
+    native.new_local_repository(
+        name = "bzip2",
+        build_file = clean_dep("//third_party/bzip2:bzip2.BUILD"),
+        path = "/usr/include",
+    )
@@ -6,6 +6,7 @@ load("//third_party/ad_rss_lib:workspace.bzl", ad_rss_lib = "repo")
 load("//third_party/atlas:workspace.bzl", atlas = "repo")
 load("//third_party/benchmark:workspace.bzl", benchmark = "repo")
 load("//third_party/boost:workspace.bzl", boost = "repo")
+load("//third_party/bzip2:workspace.bzl", bzip2 = "repo")
 load("//third_party/caddn_infer_op:workspace.bzl", caddn_infer_op = "repo")
 load("//third_party/centerpoint_infer_op:workspace.bzl", centerpoint_infer_op = "repo")
 load("//third_party/civetweb:workspace.bzl", civetweb = "repo")
@@ -20,6 +21,7 @@ load("//third_party/gtest:workspace.bzl", gtest = "repo")
 load("//third_party/gflags:workspace.bzl", gflags = "repo")
 load("//third_party/ipopt:workspace.bzl", ipopt = "repo")
 load("//third_party/libtorch:workspace.bzl", libtorch_cpu = "repo_cpu", libtorch_gpu = "repo_gpu")
+load("//third_party/lz4:workspace.bzl", lz4 = "repo")
 load("//third_party/ncurses5:workspace.bzl", ncurses5 = "repo")
 load("//third_party/nlohmann_json:workspace.bzl", nlohmann_json = "repo")
 load("//third_party/npp:workspace.bzl", npp = "repo")
@@ -56,6 +58,7 @@ def initialize_third_party():
     atlas()
     benchmark()
     boost()
+    bzip2()
     caddn_infer_op()
     centerpoint_infer_op()
     cpplint()
@@ -70,6 +73,7 @@ def initialize_third_party():
     ipopt()
     libtorch_cpu()
     libtorch_gpu()
+    lz4()
     ncurses5()
     nlohmann_json()
     npp()